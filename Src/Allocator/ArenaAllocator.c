@@ -0,0 +1,286 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     ArenaAllocator.c
+ * @brief    Bump (arena) allocator implementation.
+ * @ingroup  MISC
+ */
+
+#include "Include/Allocator.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Block of memory the arena allocates from. */
+typedef struct ARENA_BLOCK
+{
+   struct ARENA_BLOCK* Next;     /** Previously filled block        */
+   size_t              Capacity; /** Number of bytes after a header */
+   size_t              Used;     /** Number of bytes handed out     */
+} ARENA_BLOCK;
+
+
+/** Size of the block header with padding for the first allocation. */
+#define ARENA_BLOCK_HEADER_SIZE ALLOCATOR_ALIGN_UP(sizeof(ARENA_BLOCK))
+
+
+/** Arena allocator protocol implementation. */
+typedef struct ARENA_ALLOCATOR_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   ALLOCATOR VTable;      /** API                 */
+
+   ALLOCATOR*   Backing;   /** Allocator for arena blocks            */
+   ARENA_BLOCK* Current;   /** Block the memory is carved from       */
+   size_t       BlockSize; /** Capacity of a regular block           */
+} ARENA_ALLOCATOR_IMPL;
+
+
+/** Unique identificator for ARENA_ALLOCATOR_IMPL */
+#define ARENA_ALLOCATOR_IMPL_STRUCT_ID \
+   STRUCT_ID_64('A', 'R', 'E', 'N', 'A', '.', '.', '.')
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Returns the beginning of the usable memory of the block.
+ *
+ * @param[in]  Block  Arena block
+ *
+ * @return  Pointer to the first byte after the block header
+ */
+static
+char*
+InGetBlockMemory(
+   IN ARENA_BLOCK* Block)
+{
+   return (char*)Block + ARENA_BLOCK_HEADER_SIZE;
+}
+
+
+/**
+ * Allocates a new block and makes it current.
+ *
+ * @param[in]  Arena     Arena allocator
+ * @param[in]  Capacity  Capacity of the block
+ *
+ * @retval  ARENA_BLOCK*  If the block is successfully created
+ * @retval  NULL          On failure
+ */
+static
+ARENA_BLOCK*
+InCreateBlock(
+   IN ARENA_ALLOCATOR_IMPL* Arena,
+   IN size_t                Capacity)
+{
+   if (Capacity > SIZE_MAX - ARENA_BLOCK_HEADER_SIZE) { return NULL; }
+
+   ARENA_BLOCK* block =
+      Arena->Backing->Alloc(Arena->Backing, ARENA_BLOCK_HEADER_SIZE + Capacity);
+   if (NULL == block) { return NULL; }
+
+   block->Next = Arena->Current;
+   block->Capacity = Capacity;
+   block->Used = 0;
+   Arena->Current = block;
+
+   return block;
+}
+
+
+/**
+ * Releases blocks starting from Block.
+ *
+ * @param[in]  Arena  Arena allocator
+ * @param[in]  Block  First block to release
+ */
+static
+void
+InDeleteBlocks(
+   IN ARENA_ALLOCATOR_IMPL* Arena,
+   IN ARENA_BLOCK*          Block)
+{
+   while (Block != NULL)
+   {
+      ARENA_BLOCK* next = Block->Next;
+      Arena->Backing->Free(Arena->Backing,
+                          Block,
+                          ARENA_BLOCK_HEADER_SIZE + Block->Capacity);
+      Block = next;
+   }
+}
+
+
+///////////////////////////////////////////////////////////
+///            Allocator API implementation             ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Carves Size bytes from the current block.
+ *
+ * @param[in]  This  Pointer to Allocator protocol
+ * @param[in]  Size  Number of bytes to allocate
+ *
+ * @retval  void*  Pointer to the allocated memory
+ * @retval  NULL   If This is invalid or memory can't be allocated
+ */
+static
+void*
+ArenaAllocatorAlloc(
+   IN ALLOCATOR* This,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, ARENA_ALLOCATOR_IMPL);
+
+      // Larger sizes wrap around when they are aligned
+      if ((0 == Size) || (Size > SIZE_MAX - ALLOCATOR_ALIGNMENT))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      size_t alignedSize = ALLOCATOR_ALIGN_UP(Size);
+      ARENA_BLOCK* block = this->Current;
+
+      if ((NULL == block) || (block->Capacity - block->Used < alignedSize))
+      {
+         size_t capacity = (alignedSize > this->BlockSize) ?
+                           alignedSize : this->BlockSize;
+
+         block = InCreateBlock(this, capacity);
+         if (NULL == block) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+      }
+
+      void* memory = InGetBlockMemory(block) + block->Used;
+      block->Used += alignedSize;
+
+      return memory;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Rolls back Memory if it is the latest allocation, otherwise does nothing.
+ *
+ * @param[in]  This    Pointer to Allocator protocol
+ * @param[in]  Memory  Memory to release
+ * @param[in]  Size    Size of the memory
+ */
+static
+void
+ArenaAllocatorFree(
+   IN ALLOCATOR* This,
+   IN void*      Memory,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, ARENA_ALLOCATOR_IMPL);
+      if ((NULL == Memory) || (NULL == this->Current)) { break; }
+
+      ARENA_BLOCK* block = this->Current;
+      size_t alignedSize = ALLOCATOR_ALIGN_UP(Size);
+
+      if ((block->Used >= alignedSize) &&
+          ((char*)Memory == InGetBlockMemory(block) + block->Used - alignedSize))
+      {
+         block->Used -= alignedSize;
+      }
+
+   } while (false);
+}
+
+
+ALLOCATOR*
+ArenaAllocatorCreate(
+   IN          size_t     BlockSize,
+   IN OPTIONAL ALLOCATOR* Backing)
+{
+   if ((0 == BlockSize) || (BlockSize > SIZE_MAX - ALLOCATOR_ALIGNMENT)) { return NULL; }
+   if (NULL == Backing) { Backing = GetSystemAllocator(); }
+
+   ARENA_ALLOCATOR_IMPL* this = Backing->Alloc(Backing, sizeof(ARENA_ALLOCATOR_IMPL));
+   if (NULL == this) { return NULL; }
+
+   this->StructureId = ARENA_ALLOCATOR_IMPL_STRUCT_ID;
+   this->Backing = Backing;
+   this->Current = NULL;
+   this->BlockSize = ALLOCATOR_ALIGN_UP(BlockSize);
+
+   this->VTable.Alloc = ArenaAllocatorAlloc;
+   this->VTable.Free  = ArenaAllocatorFree;
+
+   return &this->VTable;
+}
+
+
+STATUS_CODE
+ArenaAllocatorReset(
+   IN ALLOCATOR* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, ARENA_ALLOCATOR_IMPL);
+      if (NULL == this->Current) { break; }
+
+      // Keep the oldest block, it is usually a regular one
+      ARENA_BLOCK* first = this->Current;
+      ARENA_BLOCK* newer = NULL;
+      while (first->Next != NULL)
+      {
+         newer = first;
+         first = first->Next;
+      }
+
+      if (newer != NULL)
+      {
+         newer->Next = NULL;
+         InDeleteBlocks(this, this->Current);
+      }
+
+      first->Used = 0;
+      this->Current = first;
+
+   } while (false);
+
+   return status;
+}
+
+
+STATUS_CODE
+ArenaAllocatorDelete(
+   IN ALLOCATOR* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, ARENA_ALLOCATOR_IMPL);
+
+      InDeleteBlocks(this, this->Current);
+      this->StructureId = 0;
+      this->Backing->Free(this->Backing, this, sizeof(ARENA_ALLOCATOR_IMPL));
+
+   } while (false);
+
+   return status;
+}
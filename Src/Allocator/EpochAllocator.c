@@ -0,0 +1,473 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     EpochAllocator.c
+ * @brief    Allocator that defers frees until concurrent readers leave.
+ * @ingroup  MISC
+ */
+
+#include <stdatomic.h>
+#include <threads.h>
+
+#include "Include/Allocator.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Header in front of every block, used once the block is freed. */
+typedef struct EPOCH_HEADER
+{
+   struct EPOCH_HEADER* Next;  /** Next retired block                   */
+   size_t               Size;  /** Size passed to Alloc                 */
+   uint64_t             Epoch; /** Global epoch when the block was freed */
+} EPOCH_HEADER;
+
+
+/** Size of the block header with padding for the user memory. */
+#define EPOCH_HEADER_SIZE ALLOCATOR_ALIGN_UP(sizeof(EPOCH_HEADER))
+
+
+/** Number of frees after which the retired blocks are collected. */
+#define EPOCH_COLLECT_BATCH 64U
+
+
+/** Size of the padding that keeps the records of threads apart. */
+#define EPOCH_CACHE_LINE 64U
+
+
+/**
+ * Reader record of a thread. Records are found by the thread id and live
+ * as long as the allocator.
+ */
+typedef struct EPOCH_RECORD
+{
+   atomic_uint_fast64_t Epoch;   /** Epoch seen on entry, 0 outside of sections */
+   size_t               Nesting; /** Depth of nested sections, owner only      */
+   thrd_t               Owner;   /** Thread that owns the record               */
+   struct EPOCH_RECORD* Next;    /** Next record, never changes                */
+   char                 Padding[EPOCH_CACHE_LINE];
+} EPOCH_RECORD;
+
+
+/**
+ * Epoch allocator protocol implementation.
+ *
+ * A freed block is tagged with the global epoch and retired. The global
+ * epoch moves forward only when every reader inside a section has seen
+ * it, so once it is two epochs ahead of the tag, readers that could see
+ * the block have left and the block goes back to Backing.
+ */
+typedef struct EPOCH_ALLOCATOR_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   ALLOCATOR VTable;      /** API                 */
+
+   ALLOCATOR*             Backing;      /** Allocator for blocks and records      */
+   uint64_t               Id;           /** Identifies the allocator in caches    */
+   atomic_uint_fast64_t   Epoch;        /** Global epoch, starts at 1             */
+   _Atomic(EPOCH_RECORD*) Records;      /** Reader records of all threads         */
+   _Atomic(EPOCH_HEADER*) Retired;      /** Freed blocks waiting for readers      */
+   atomic_size_t          RetiredCount; /** Number of retired blocks              */
+   atomic_size_t          NextCollect;  /** RetiredCount that starts a collection */
+   atomic_flag            IsCollecting; /** A thread collects retired blocks      */
+} EPOCH_ALLOCATOR_IMPL;
+
+
+/** Unique identificator for EPOCH_ALLOCATOR_IMPL */
+#define EPOCH_ALLOCATOR_IMPL_STRUCT_ID \
+   STRUCT_ID_64('E', 'P', 'O', 'C', 'H', 'A', 'L', 'C')
+
+
+/** Id of the next epoch allocator, ids are never reused. */
+static atomic_uint_fast64_t g_NextId = 1;
+
+/** Id of the allocator whose record the current thread used last. */
+static _Thread_local uint64_t g_CachedId = 0;
+
+/** Record of the current thread in the allocator g_CachedId. */
+static _Thread_local EPOCH_RECORD* g_CachedRecord = NULL;
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Returns the record of the current thread, adds it on the first call.
+ *
+ * @param[in]  Allocator  Epoch allocator
+ *
+ * @return  Record or NULL if memory allocation failed
+ */
+static
+EPOCH_RECORD*
+InGetRecord(
+   IN EPOCH_ALLOCATOR_IMPL* Allocator)
+{
+   if (g_CachedId == Allocator->Id) { return g_CachedRecord; }
+
+   thrd_t self = thrd_current();
+   EPOCH_RECORD* record = atomic_load(&Allocator->Records);
+   while ((record != NULL) && !thrd_equal(record->Owner, self)) { record = record->Next; }
+
+   if (NULL == record)
+   {
+      record = Allocator->Backing->Alloc(Allocator->Backing, sizeof(EPOCH_RECORD));
+      if (NULL == record) { return NULL; }
+
+      atomic_init(&record->Epoch, 0);
+      record->Nesting = 0;
+      record->Owner = self;
+
+      EPOCH_RECORD* first = atomic_load(&Allocator->Records);
+      do
+      {
+         record->Next = first;
+      } while (!atomic_compare_exchange_weak(&Allocator->Records, &first, record));
+   }
+
+   g_CachedId = Allocator->Id;
+   g_CachedRecord = record;
+
+   return record;
+}
+
+
+/**
+ * Moves the global epoch forward if every reader inside a section has
+ * seen the current one.
+ *
+ * @param[in]  Allocator  Epoch allocator
+ */
+static
+void
+InTryAdvance(
+   IN EPOCH_ALLOCATOR_IMPL* Allocator)
+{
+   uint64_t epoch = atomic_load(&Allocator->Epoch);
+
+   // Pairs with the fence in EpochAllocatorEnter: either the reader is seen
+   // here or it sees every unlink made before the blocks were freed
+   atomic_thread_fence(memory_order_seq_cst);
+
+   for (EPOCH_RECORD* record = atomic_load(&Allocator->Records);
+        record != NULL;
+        record = record->Next)
+   {
+      uint64_t seen = atomic_load(&record->Epoch);
+      if ((seen != 0) && (seen != epoch)) { return; }
+   }
+
+   atomic_compare_exchange_strong(&Allocator->Epoch, &epoch, epoch + 1);
+}
+
+
+/**
+ * Returns the chain [First, Last] of blocks to the retired list.
+ *
+ * @param[in]  Allocator  Epoch allocator
+ * @param[in]  First      First block of the chain
+ * @param[in]  Last       Last block of the chain
+ */
+static
+void
+InRetireChain(
+   IN EPOCH_ALLOCATOR_IMPL* Allocator,
+   IN EPOCH_HEADER*         First,
+   IN EPOCH_HEADER*         Last)
+{
+   EPOCH_HEADER* head = atomic_load(&Allocator->Retired);
+   do
+   {
+      Last->Next = head;
+   } while (!atomic_compare_exchange_weak(&Allocator->Retired, &head, First));
+}
+
+
+/**
+ * Tries to move the global epoch forward and releases the retired blocks
+ * no reader can see. Does nothing if another thread collects.
+ *
+ * @param[in]  Allocator  Epoch allocator
+ *
+ * @return  true if the blocks were collected
+ */
+static
+bool
+InCollect(
+   IN EPOCH_ALLOCATOR_IMPL* Allocator)
+{
+   if (atomic_flag_test_and_set(&Allocator->IsCollecting)) { return false; }
+
+   InTryAdvance(Allocator);
+
+   EPOCH_HEADER* block = atomic_exchange(&Allocator->Retired, NULL);
+   uint64_t epoch = atomic_load(&Allocator->Epoch);
+
+   EPOCH_HEADER* first = NULL;
+   EPOCH_HEADER* last = NULL;
+   size_t freed = 0;
+   while (block != NULL)
+   {
+      EPOCH_HEADER* next = block->Next;
+      if (block->Epoch + 2 <= epoch)
+      {
+         Allocator->Backing->Free(Allocator->Backing, block, EPOCH_HEADER_SIZE + block->Size);
+         ++freed;
+      }
+      else
+      {
+         block->Next = first;
+         first = block;
+         if (NULL == last) { last = block; }
+      }
+
+      block = next;
+   }
+
+   if (first != NULL) { InRetireChain(Allocator, first, last); }
+
+   size_t left = atomic_fetch_sub(&Allocator->RetiredCount, freed) - freed;
+   atomic_store(&Allocator->NextCollect, left + EPOCH_COLLECT_BATCH);
+
+   atomic_flag_clear(&Allocator->IsCollecting);
+
+   return true;
+}
+
+
+///////////////////////////////////////////////////////////
+///            Allocator API implementation             ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Allocates Size bytes of memory from the backing allocator.
+ *
+ * @param[in]  This  Pointer to Allocator protocol
+ * @param[in]  Size  Number of bytes to allocate
+ *
+ * @retval  void*  Pointer to the allocated memory
+ * @retval  NULL   If This is invalid or memory can't be allocated
+ */
+static
+void*
+EpochAllocatorAlloc(
+   IN ALLOCATOR* This,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, EPOCH_ALLOCATOR_IMPL);
+
+      // Larger sizes wrap around when the header is added
+      if ((0 == Size) || (Size > SIZE_MAX - EPOCH_HEADER_SIZE))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      EPOCH_HEADER* header = this->Backing->Alloc(this->Backing, EPOCH_HEADER_SIZE + Size);
+      if (NULL == header) { break; }
+
+      header->Size = Size;
+
+      return (char*)header + EPOCH_HEADER_SIZE;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Retires the memory, it goes back to the backing allocator once no reader
+ * that entered a section before this call is inside it.
+ *
+ * @param[in]  This    Pointer to Allocator protocol
+ * @param[in]  Memory  Memory to release
+ * @param[in]  Size    Size of the memory (unused, kept in the header)
+ */
+static
+void
+EpochAllocatorFree(
+   IN ALLOCATOR* This,
+   IN void*      Memory,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   (void)Size;
+
+   do
+   {
+      GET_THIS(This, EPOCH_ALLOCATOR_IMPL);
+      if (NULL == Memory) { break; }
+
+      EPOCH_HEADER* header = (EPOCH_HEADER*)((char*)Memory - EPOCH_HEADER_SIZE);
+
+      // The block was unlinked before, readers that see a later epoch
+      // can't reach it
+      atomic_thread_fence(memory_order_seq_cst);
+      header->Epoch = atomic_load(&this->Epoch);
+
+      // Counted first, so a collection never frees more blocks than counted
+      size_t count = atomic_fetch_add(&this->RetiredCount, 1) + 1;
+      InRetireChain(this, header, header);
+
+      if (count >= atomic_load(&this->NextCollect)) { InCollect(this); }
+
+   } while (false);
+}
+
+
+ALLOCATOR*
+EpochAllocatorCreate(
+   IN OPTIONAL ALLOCATOR* Backing)
+{
+   if (NULL == Backing) { Backing = GetSystemAllocator(); }
+
+   EPOCH_ALLOCATOR_IMPL* this = Backing->Alloc(Backing, sizeof(EPOCH_ALLOCATOR_IMPL));
+   if (NULL == this) { return NULL; }
+
+   this->StructureId = EPOCH_ALLOCATOR_IMPL_STRUCT_ID;
+   this->Backing = Backing;
+   this->Id = atomic_fetch_add(&g_NextId, 1);
+   atomic_init(&this->Epoch, 1);
+   atomic_init(&this->Records, NULL);
+   atomic_init(&this->Retired, NULL);
+   atomic_init(&this->RetiredCount, 0);
+   atomic_init(&this->NextCollect, EPOCH_COLLECT_BATCH);
+   atomic_flag_clear(&this->IsCollecting);
+
+   this->VTable.Alloc = EpochAllocatorAlloc;
+   this->VTable.Free  = EpochAllocatorFree;
+
+   return &this->VTable;
+}
+
+
+STATUS_CODE
+EpochAllocatorEnter(
+   IN ALLOCATOR* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, EPOCH_ALLOCATOR_IMPL);
+
+      EPOCH_RECORD* record = InGetRecord(this);
+      if (NULL == record) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      if (0 == record->Nesting++)
+      {
+         atomic_store_explicit(&record->Epoch, atomic_load(&this->Epoch), memory_order_relaxed);
+
+         // The record is visible before the reader loads any link
+         atomic_thread_fence(memory_order_seq_cst);
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+STATUS_CODE
+EpochAllocatorLeave(
+   IN ALLOCATOR* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, EPOCH_ALLOCATOR_IMPL);
+
+      EPOCH_RECORD* record = InGetRecord(this);
+      if ((NULL == record) || (0 == record->Nesting)) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      if (0 == --record->Nesting)
+      {
+         atomic_store_explicit(&record->Epoch, 0, memory_order_release);
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+STATUS_CODE
+EpochAllocatorSynchronize(
+   IN ALLOCATOR* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, EPOCH_ALLOCATOR_IMPL);
+
+      // The thread's own section would never let the epoch move
+      if ((g_CachedId == this->Id) && (g_CachedRecord->Nesting != 0))
+      {
+         SET_SC(SC_UNSUCCESSFUL);
+         break;
+      }
+
+      // Blocks retired before the call are tagged with an epoch two behind
+      // the target, any collection that starts after it releases them
+      uint64_t target = atomic_load(&this->Epoch) + 2;
+      for (;;)
+      {
+         bool isTarget = atomic_load(&this->Epoch) >= target;
+         if (InCollect(this) && isTarget) { break; }
+         thrd_yield();
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+STATUS_CODE
+EpochAllocatorDelete(
+   IN ALLOCATOR* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, EPOCH_ALLOCATOR_IMPL);
+      ALLOCATOR* backing = this->Backing;
+
+      EPOCH_HEADER* block = atomic_load(&this->Retired);
+      while (block != NULL)
+      {
+         EPOCH_HEADER* next = block->Next;
+         backing->Free(backing, block, EPOCH_HEADER_SIZE + block->Size);
+         block = next;
+      }
+
+      EPOCH_RECORD* record = atomic_load(&this->Records);
+      while (record != NULL)
+      {
+         EPOCH_RECORD* next = record->Next;
+         backing->Free(backing, record, sizeof(EPOCH_RECORD));
+         record = next;
+      }
+
+      // Ids are never reused, so no thread cache points here any more
+      this->StructureId = 0;
+      backing->Free(backing, this, sizeof(EPOCH_ALLOCATOR_IMPL));
+
+   } while (false);
+
+   return status;
+}
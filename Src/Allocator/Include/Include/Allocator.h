@@ -0,0 +1,201 @@
+/**
+ * @file     Allocator.h
+ * @brief    Implementations of the allocator protocol.
+ * @ingroup  MISC
+ */
+
+#ifndef  __ALLOCATOR_H__
+#define  __ALLOCATOR_H__
+
+#include "Include/Misc.h"
+
+
+/** Alignment of every block returned by the allocators below. */
+#define ALLOCATOR_ALIGNMENT 16U
+
+
+/** Rounds Size up to a multiple of ALLOCATOR_ALIGNMENT. */
+#define ALLOCATOR_ALIGN_UP(Size) \
+   (((Size) + (ALLOCATOR_ALIGNMENT - 1)) & ~((size_t)ALLOCATOR_ALIGNMENT - 1))
+
+
+/**
+ * Returns the allocator protocol backed by malloc/free.
+ *
+ * @return  Pointer to the process-wide system allocator. Never NULL.
+ */
+ALLOCATOR*
+GetSystemAllocator();
+
+
+/**
+ * Creates a bump (arena) allocator.
+ *
+ * Memory is carved sequentially from blocks of BlockSize bytes. Free only
+ * rolls back the most recent allocation; everything else is released at
+ * once by ArenaAllocatorReset or ArenaAllocatorDelete.
+ *
+ * @param[in]  BlockSize  Size of one arena block. Requests larger than
+ *                        the block get a dedicated block.
+ * @param[in]  Backing    Allocator for arena blocks. If NULL then the
+ *                        system allocator is used.
+ *
+ * @return  On success, returns the pointer to allocator protocol.
+ *          On failure, returns a NULL pointer.
+ */
+ALLOCATOR*
+ArenaAllocatorCreate(
+   IN          size_t     BlockSize,
+   IN OPTIONAL ALLOCATOR* Backing);
+
+
+/**
+ * Releases every allocation made from the arena but keeps the first block
+ * for reuse.
+ *
+ * @param[in]  This  Pointer to the arena allocator protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+ArenaAllocatorReset(
+   IN ALLOCATOR* This);
+
+
+/**
+ * Destroys the arena allocator and all memory allocated from it.
+ *
+ * @param[in]  This  Pointer to the arena allocator protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+ArenaAllocatorDelete(
+   IN ALLOCATOR* This);
+
+
+/**
+ * Creates a fixed-size object pool allocator.
+ *
+ * Objects are carved from blocks of ObjectsPerBlock objects and recycled
+ * through an internal free list, so Alloc and Free are O(1) and don't call
+ * the backing allocator in the steady state. Requests larger than
+ * ObjectSize fail.
+ *
+ * @param[in]  ObjectSize       Size of one object
+ * @param[in]  ObjectsPerBlock  Number of objects requested from Backing at once
+ * @param[in]  Backing          Allocator for pool blocks. If NULL then the
+ *                              system allocator is used.
+ *
+ * @return  On success, returns the pointer to allocator protocol.
+ *          On failure, returns a NULL pointer.
+ */
+ALLOCATOR*
+PoolAllocatorCreate(
+   IN          size_t     ObjectSize,
+   IN          size_t     ObjectsPerBlock,
+   IN OPTIONAL ALLOCATOR* Backing);
+
+
+/**
+ * Destroys the pool allocator and all objects allocated from it.
+ *
+ * @param[in]  This  Pointer to the pool allocator protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+PoolAllocatorDelete(
+   IN ALLOCATOR* This);
+
+
+/**
+ * Creates an epoch allocator that defers frees until concurrent readers
+ * can no longer see the memory.
+ *
+ * Readers enclose every traversal of a structure allocated from the
+ * allocator in EpochAllocatorEnter and EpochAllocatorLeave. Free retires
+ * the memory instead of releasing it, it goes back to Backing once every
+ * reader that was inside a section at the time of Free has left it. A
+ * CList created by CListCreateWithAllocator or CListCreateEx with this
+ * allocator defers the frees of its nodes and data, so readers may walk
+ * it with Front and Next while one writer removes nodes; concurrent
+ * writers still need a lock. Lists that keep nodes in a pool, fixed ones
+ * and compacted ones, recycle nodes at once and are not covered.
+ *
+ * Every block carries a 32-byte header. Backing is called from the
+ * threads that allocate, free and enter for the first time, so it must
+ * be thread-safe if these are different threads.
+ *
+ * @param[in]  Backing  Allocator for blocks. If NULL then the system
+ *                      allocator is used.
+ *
+ * @return  On success, returns the pointer to allocator protocol.
+ *          On failure, returns a NULL pointer.
+ */
+ALLOCATOR*
+EpochAllocatorCreate(
+   IN OPTIONAL ALLOCATOR* Backing);
+
+
+/**
+ * Enters a read-side section of the current thread. Sections nest, memory
+ * freed after the outermost Enter stays valid until the matching Leave.
+ *
+ * @param[in]  This  Pointer to the epoch allocator protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  The first call of the thread can't allocate its record
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+EpochAllocatorEnter(
+   IN ALLOCATOR* This);
+
+
+/**
+ * Leaves the read-side section entered by EpochAllocatorEnter.
+ *
+ * @param[in]  This  Pointer to the epoch allocator protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The thread is not inside a section
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+EpochAllocatorLeave(
+   IN ALLOCATOR* This);
+
+
+/**
+ * Waits until the readers inside sections have left them and releases
+ * the memory freed before the call. Must not be called inside a section.
+ *
+ * @param[in]  This  Pointer to the epoch allocator protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The current thread is inside a section
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+EpochAllocatorSynchronize(
+   IN ALLOCATOR* This);
+
+
+/**
+ * Destroys the epoch allocator and releases the memory that waits for
+ * readers. No thread may be inside a section.
+ *
+ * @param[in]  This  Pointer to the epoch allocator protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+EpochAllocatorDelete(
+   IN ALLOCATOR* This);
+
+#endif  // __ALLOCATOR_H__
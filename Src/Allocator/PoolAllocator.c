@@ -0,0 +1,236 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     PoolAllocator.c
+ * @brief    Fixed-size object pool allocator implementation.
+ * @ingroup  MISC
+ */
+
+#include "Include/Allocator.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Block of objects requested from the backing allocator. */
+typedef struct POOL_BLOCK
+{
+   struct POOL_BLOCK* Next; /** Previously allocated block */
+} POOL_BLOCK;
+
+
+/** Size of the block header with padding for the first object. */
+#define POOL_BLOCK_HEADER_SIZE ALLOCATOR_ALIGN_UP(sizeof(POOL_BLOCK))
+
+
+/** Free object. The link is stored in the object memory itself. */
+typedef struct POOL_FREE_OBJECT
+{
+   struct POOL_FREE_OBJECT* Next; /** Next free object */
+} POOL_FREE_OBJECT;
+
+
+/** Pool allocator protocol implementation. */
+typedef struct POOL_ALLOCATOR_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   ALLOCATOR VTable;      /** API                 */
+
+   ALLOCATOR*        Backing;         /** Allocator for pool blocks          */
+   POOL_BLOCK*       Blocks;          /** All blocks of the pool             */
+   POOL_FREE_OBJECT* FreeList;        /** Objects ready to be handed out     */
+   size_t            ObjectSize;      /** Aligned size of one object         */
+   size_t            ObjectsPerBlock; /** Number of objects in one block     */
+   size_t            BlockSize;       /** Size of a block with its header    */
+} POOL_ALLOCATOR_IMPL;
+
+
+/** Unique identificator for POOL_ALLOCATOR_IMPL */
+#define POOL_ALLOCATOR_IMPL_STRUCT_ID \
+   STRUCT_ID_64('P', 'O', 'O', 'L', '.', '.', '.', '.')
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Allocates a new block and threads its objects into the free list.
+ *
+ * @param[in]  Pool  Pool allocator
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InGrowPool(
+   IN POOL_ALLOCATOR_IMPL* Pool)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      POOL_BLOCK* block = Pool->Backing->Alloc(Pool->Backing, Pool->BlockSize);
+      if (NULL == block) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      block->Next = Pool->Blocks;
+      Pool->Blocks = block;
+
+      // Thread in reverse so that objects are handed out in address order
+      char* objects = (char*)block + POOL_BLOCK_HEADER_SIZE;
+      for (size_t i = Pool->ObjectsPerBlock; i > 0; --i)
+      {
+         POOL_FREE_OBJECT* object =
+            (POOL_FREE_OBJECT*)(objects + (i - 1) * Pool->ObjectSize);
+         object->Next = Pool->FreeList;
+         Pool->FreeList = object;
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+///////////////////////////////////////////////////////////
+///            Allocator API implementation             ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Takes an object from the free list.
+ *
+ * @param[in]  This  Pointer to Allocator protocol
+ * @param[in]  Size  Number of bytes to allocate, up to the object size
+ *
+ * @retval  void*  Pointer to the allocated memory
+ * @retval  NULL   If This is invalid, Size is too large or memory can't
+ *                 be allocated
+ */
+static
+void*
+PoolAllocatorAlloc(
+   IN ALLOCATOR* This,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, POOL_ALLOCATOR_IMPL);
+      if ((0 == Size) || (Size > this->ObjectSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (NULL == this->FreeList)
+      {
+         status = InGrowPool(this);
+         if (SC_ERROR(status)) { break; }
+      }
+
+      POOL_FREE_OBJECT* object = this->FreeList;
+      this->FreeList = object->Next;
+
+      return object;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns an object to the free list.
+ *
+ * @param[in]  This    Pointer to Allocator protocol
+ * @param[in]  Memory  Memory to release
+ * @param[in]  Size    Size of the memory (unused)
+ */
+static
+void
+PoolAllocatorFree(
+   IN ALLOCATOR* This,
+   IN void*      Memory,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   (void)Size;
+
+   do
+   {
+      GET_THIS(This, POOL_ALLOCATOR_IMPL);
+      if (NULL == Memory) { break; }
+
+      POOL_FREE_OBJECT* object = Memory;
+      object->Next = this->FreeList;
+      this->FreeList = object;
+
+   } while (false);
+}
+
+
+ALLOCATOR*
+PoolAllocatorCreate(
+   IN          size_t     ObjectSize,
+   IN          size_t     ObjectsPerBlock,
+   IN OPTIONAL ALLOCATOR* Backing)
+{
+   if ((0 == ObjectSize) || (0 == ObjectsPerBlock)) { return NULL; }
+
+   // Blocks whose size doesn't fit size_t are rejected, not cut short
+   if (ObjectSize > SIZE_MAX - ALLOCATOR_ALIGNMENT) { return NULL; }
+
+   size_t objectSize = ALLOCATOR_ALIGN_UP(ObjectSize);
+   if (ObjectsPerBlock > (SIZE_MAX - POOL_BLOCK_HEADER_SIZE) / objectSize) { return NULL; }
+
+   if (NULL == Backing) { Backing = GetSystemAllocator(); }
+
+   POOL_ALLOCATOR_IMPL* this = Backing->Alloc(Backing, sizeof(POOL_ALLOCATOR_IMPL));
+   if (NULL == this) { return NULL; }
+
+   this->StructureId = POOL_ALLOCATOR_IMPL_STRUCT_ID;
+   this->Backing = Backing;
+   this->Blocks = NULL;
+   this->FreeList = NULL;
+   this->ObjectSize = objectSize;
+   this->ObjectsPerBlock = ObjectsPerBlock;
+   this->BlockSize = POOL_BLOCK_HEADER_SIZE + objectSize * ObjectsPerBlock;
+
+   this->VTable.Alloc = PoolAllocatorAlloc;
+   this->VTable.Free  = PoolAllocatorFree;
+
+   return &this->VTable;
+}
+
+
+STATUS_CODE
+PoolAllocatorDelete(
+   IN ALLOCATOR* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, POOL_ALLOCATOR_IMPL);
+
+      POOL_BLOCK* block = this->Blocks;
+      while (block != NULL)
+      {
+         POOL_BLOCK* next = block->Next;
+         this->Backing->Free(this->Backing, block, this->BlockSize);
+         block = next;
+      }
+
+      this->StructureId = 0;
+      this->Backing->Free(this->Backing, this, sizeof(POOL_ALLOCATOR_IMPL));
+
+   } while (false);
+
+   return status;
+}
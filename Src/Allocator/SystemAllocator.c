@@ -0,0 +1,105 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     SystemAllocator.c
+ * @brief    Allocator protocol on top of malloc/free.
+ * @ingroup  MISC
+ */
+
+#include <stdlib.h>
+
+#include "Include/Allocator.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** System allocator protocol implementation. */
+typedef struct SYSTEM_ALLOCATOR_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   ALLOCATOR VTable;      /** API                 */
+} SYSTEM_ALLOCATOR_IMPL;
+
+
+/** Unique identificator for SYSTEM_ALLOCATOR_IMPL */
+#define SYSTEM_ALLOCATOR_IMPL_STRUCT_ID \
+   STRUCT_ID_64('S', 'Y', 'S', 'A', 'L', 'L', 'O', 'C')
+
+
+///////////////////////////////////////////////////////////
+///            Allocator API implementation             ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Allocates Size bytes of memory with malloc.
+ *
+ * @param[in]  This  Pointer to Allocator protocol
+ * @param[in]  Size  Number of bytes to allocate
+ *
+ * @retval  void*  Pointer to the allocated memory
+ * @retval  NULL   If This is invalid or memory can't be allocated
+ */
+static
+void*
+SystemAllocatorAlloc(
+   IN ALLOCATOR* This,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, SYSTEM_ALLOCATOR_IMPL);
+      if (0 == Size) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      return malloc(Size);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Releases memory with free.
+ *
+ * @param[in]  This    Pointer to Allocator protocol
+ * @param[in]  Memory  Memory to release
+ * @param[in]  Size    Size of the memory (unused)
+ */
+static
+void
+SystemAllocatorFree(
+   IN ALLOCATOR* This,
+   IN void*      Memory,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   (void)Size;
+
+   do
+   {
+      GET_THIS(This, SYSTEM_ALLOCATOR_IMPL);
+      free(Memory);
+
+   } while (false);
+}
+
+
+/** The only instance of the system allocator. */
+static SYSTEM_ALLOCATOR_IMPL g_SystemAllocator =
+{
+   SYSTEM_ALLOCATOR_IMPL_STRUCT_ID,
+   { SystemAllocatorAlloc, SystemAllocatorFree }
+};
+
+
+ALLOCATOR*
+GetSystemAllocator()
+{
+   return &g_SystemAllocator.VTable;
+}
@@ -0,0 +1,286 @@
+/**
+ * @file  AllocatorTest.cpp
+ * @brief Unit Tests for ALLOCATOR implementations
+ */
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+extern "C"
+{
+   #include "Include/Allocator.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                   System allocator                    //
+///////////////////////////////////////////////////////////
+
+TEST(SystemAllocator, AllocFree)
+{
+   /*** Arrange ***/
+   ALLOCATOR* allocator = GetSystemAllocator();
+   ASSERT_FALSE(NULL == allocator);
+
+   /*** Act ***/
+   void* memory = allocator->Alloc(allocator, 64);
+
+   /*** Assert ***/
+   ASSERT_FALSE(NULL == memory);
+   memset(memory, 0xAB, 64);
+   allocator->Free(allocator, memory, 64);
+
+   EXPECT_TRUE(NULL == allocator->Alloc(NULL, 64));
+   EXPECT_TRUE(NULL == allocator->Alloc(allocator, 0));
+}
+
+
+///////////////////////////////////////////////////////////
+//                    Arena allocator                    //
+///////////////////////////////////////////////////////////
+
+TEST(ArenaAllocator, CreateInvPrms)
+{
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == ArenaAllocatorCreate(0, NULL));
+   EXPECT_TRUE(NULL == ArenaAllocatorCreate(SIZE_MAX, NULL));
+   EXPECT_TRUE(SC_ERROR(ArenaAllocatorDelete(NULL)));
+   EXPECT_TRUE(SC_ERROR(ArenaAllocatorReset(NULL)));
+}
+
+
+TEST(ArenaAllocator, BumpAllocation)
+{
+   /*** Arrange ***/
+   ALLOCATOR* arena = ArenaAllocatorCreate(256, NULL);
+   ASSERT_FALSE(NULL == arena);
+
+   /*** Act ***/
+   char* first = (char*)arena->Alloc(arena, 10);
+   char* second = (char*)arena->Alloc(arena, 10);
+   char* large = (char*)arena->Alloc(arena, 1024);
+
+   /*** Assert ***/
+   ASSERT_FALSE(NULL == first);
+   ASSERT_FALSE(NULL == second);
+   ASSERT_FALSE(NULL == large);
+   EXPECT_TRUE(second - first == ALLOCATOR_ALIGNMENT);
+   EXPECT_TRUE(0 == (uintptr_t)large % ALLOCATOR_ALIGNMENT);
+   memset(large, 0, 1024);
+
+   // Sizes that overflow when aligned or with the block header
+   EXPECT_TRUE(NULL == arena->Alloc(arena, SIZE_MAX - 3));
+   EXPECT_TRUE(NULL == arena->Alloc(arena, SIZE_MAX - 32));
+   EXPECT_FALSE(NULL == arena->Alloc(arena, 16));
+
+   EXPECT_FALSE(SC_ERROR(ArenaAllocatorDelete(arena)));
+}
+
+
+TEST(ArenaAllocator, FreeRollsBackLastAllocation)
+{
+   /*** Arrange ***/
+   ALLOCATOR* arena = ArenaAllocatorCreate(256, NULL);
+   ASSERT_FALSE(NULL == arena);
+
+   /*** Act && Assert ***/
+   void* first = arena->Alloc(arena, 32);
+   void* second = arena->Alloc(arena, 32);
+   arena->Free(arena, second, 32);
+   EXPECT_TRUE(second == arena->Alloc(arena, 32));
+
+   // Not the last allocation, nothing to roll back
+   arena->Free(arena, first, 32);
+   EXPECT_FALSE(first == arena->Alloc(arena, 32));
+
+   EXPECT_FALSE(SC_ERROR(ArenaAllocatorReset(arena)));
+   EXPECT_TRUE(first == arena->Alloc(arena, 32));
+
+   EXPECT_FALSE(SC_ERROR(ArenaAllocatorDelete(arena)));
+}
+
+
+///////////////////////////////////////////////////////////
+//                    Pool allocator                     //
+///////////////////////////////////////////////////////////
+
+TEST(PoolAllocator, CreateInvPrms)
+{
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == PoolAllocatorCreate(0, 16, NULL));
+   EXPECT_TRUE(NULL == PoolAllocatorCreate(16, 0, NULL));
+   EXPECT_TRUE(NULL == PoolAllocatorCreate(SIZE_MAX, 1, NULL));
+   EXPECT_TRUE(NULL == PoolAllocatorCreate(64, SIZE_MAX / 32, NULL));
+   EXPECT_TRUE(SC_ERROR(PoolAllocatorDelete(NULL)));
+}
+
+
+TEST(PoolAllocator, RecyclesObjects)
+{
+   /*** Arrange ***/
+   ALLOCATOR* pool = PoolAllocatorCreate(24, 4, NULL);
+   ASSERT_FALSE(NULL == pool);
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == pool->Alloc(pool, 64));
+
+   void* objects[10] = {};
+   for (size_t i = 0; i < 10; ++i)
+   {
+      objects[i] = pool->Alloc(pool, 24);
+      ASSERT_FALSE(NULL == objects[i]);
+      memset(objects[i], (int)i, 24);
+   }
+
+   pool->Free(pool, objects[3], 24);
+   EXPECT_TRUE(objects[3] == pool->Alloc(pool, 16));
+
+   EXPECT_FALSE(SC_ERROR(PoolAllocatorDelete(pool)));
+}
+
+
+TEST(PoolAllocator, ArenaBacked)
+{
+   /*** Arrange ***/
+   ALLOCATOR* arena = ArenaAllocatorCreate(4096, NULL);
+   ASSERT_FALSE(NULL == arena);
+   ALLOCATOR* pool = PoolAllocatorCreate(32, 8, arena);
+   ASSERT_FALSE(NULL == pool);
+
+   /*** Act && Assert ***/
+   for (size_t i = 0; i < 100; ++i)
+   {
+      ASSERT_FALSE(NULL == pool->Alloc(pool, 32));
+   }
+
+   EXPECT_FALSE(SC_ERROR(PoolAllocatorDelete(pool)));
+   EXPECT_FALSE(SC_ERROR(ArenaAllocatorDelete(arena)));
+}
+
+
+///////////////////////////////////////////////////////////
+//                    Epoch allocator                    //
+///////////////////////////////////////////////////////////
+
+/** Number of blocks the epoch allocator returned to g_CountingBacking. */
+static std::atomic<size_t> g_BackingFrees(0);
+
+
+/** Backing allocator that counts frees in g_BackingFrees. */
+static ALLOCATOR g_CountingBacking =
+{
+   [](ALLOCATOR*, size_t Size) -> void* { return malloc(Size); },
+   [](ALLOCATOR*, void* Memory, size_t)
+   {
+      g_BackingFrees.fetch_add(1);
+      free(Memory);
+   }
+};
+
+
+TEST(EpochAllocator, InvPrms)
+{
+   /*** Arrange ***/
+   ALLOCATOR* pool = PoolAllocatorCreate(16, 4, NULL);
+   ASSERT_FALSE(NULL == pool);
+   ALLOCATOR* epoch = EpochAllocatorCreate(NULL);
+   ASSERT_FALSE(NULL == epoch);
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(EpochAllocatorEnter(NULL)));
+   EXPECT_TRUE(SC_ERROR(EpochAllocatorEnter(pool)));
+   EXPECT_TRUE(SC_ERROR(EpochAllocatorDelete(pool)));
+   EXPECT_TRUE(NULL == epoch->Alloc(epoch, 0));
+   EXPECT_TRUE(NULL == epoch->Alloc(epoch, SIZE_MAX - 8));
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(EpochAllocatorLeave(epoch)));
+
+   // The thread's own section would block forever
+   ASSERT_FALSE(SC_ERROR(EpochAllocatorEnter(epoch)));
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(EpochAllocatorSynchronize(epoch)));
+   ASSERT_FALSE(SC_ERROR(EpochAllocatorLeave(epoch)));
+   EXPECT_FALSE(SC_ERROR(EpochAllocatorSynchronize(epoch)));
+
+   EXPECT_FALSE(SC_ERROR(EpochAllocatorDelete(epoch)));
+   EXPECT_FALSE(SC_ERROR(PoolAllocatorDelete(pool)));
+}
+
+
+TEST(EpochAllocator, DefersFreeWhileReaderIsInside)
+{
+   /*** Arrange ***/
+   ALLOCATOR* epoch = EpochAllocatorCreate(&g_CountingBacking);
+   ASSERT_FALSE(NULL == epoch);
+   g_BackingFrees.store(0);
+
+   std::atomic<int> step(0);
+   std::thread reader([epoch, &step]()
+   {
+      EXPECT_FALSE(SC_ERROR(EpochAllocatorEnter(epoch)));
+      EXPECT_FALSE(SC_ERROR(EpochAllocatorEnter(epoch)));
+      EXPECT_FALSE(SC_ERROR(EpochAllocatorLeave(epoch)));
+      step.store(1);
+      while (step.load() != 2) { std::this_thread::yield(); }
+      EXPECT_FALSE(SC_ERROR(EpochAllocatorLeave(epoch)));
+   });
+   while (step.load() != 1) { std::this_thread::yield(); }
+
+   /*** Act ***/
+   // Enough frees to start several collections
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      void* memory = epoch->Alloc(epoch, 40);
+      ASSERT_FALSE(NULL == memory);
+      memset(memory, 0xCD, 40);
+      epoch->Free(epoch, memory, 40);
+   }
+
+   /*** Assert ***/
+   // The nested section is still open
+   EXPECT_TRUE(0 == g_BackingFrees.load());
+
+   step.store(2);
+   reader.join();
+
+   EXPECT_FALSE(SC_ERROR(EpochAllocatorSynchronize(epoch)));
+   EXPECT_TRUE(1000 == g_BackingFrees.load());
+
+   EXPECT_FALSE(SC_ERROR(EpochAllocatorDelete(epoch)));
+}
+
+
+TEST(EpochAllocator, FreesWithoutReaders)
+{
+   /*** Arrange ***/
+   ALLOCATOR* epoch = EpochAllocatorCreate(&g_CountingBacking);
+   ASSERT_FALSE(NULL == epoch);
+   g_BackingFrees.store(0);
+
+   /*** Act ***/
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(EpochAllocatorEnter(epoch)));
+      void* memory = epoch->Alloc(epoch, 8);
+      ASSERT_FALSE(NULL == memory);
+      ASSERT_FALSE(SC_ERROR(EpochAllocatorLeave(epoch)));
+      epoch->Free(epoch, memory, 8);
+   }
+
+   /*** Assert ***/
+   // Collections keep the number of waiting blocks bounded
+   EXPECT_TRUE(g_BackingFrees.load() > 800);
+
+   EXPECT_FALSE(SC_ERROR(EpochAllocatorDelete(epoch)));
+}
+
+
+int main(int argc, char** argv)
+{
+   ::testing::InitGoogleTest(&argc, argv);
+
+   return RUN_ALL_TESTS();
+}
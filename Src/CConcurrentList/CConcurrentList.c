@@ -0,0 +1,1744 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     CConcurrentList.c
+ * @brief    Thread-safe doubly linked list implementation.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#include "Include/CConcurrentList.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Node of a concurrent list. */
+typedef struct CCONCURRENT_NODE
+{
+   struct CCONCURRENT_NODE*          Prev;     /** Pointer to previous node    */
+   _Atomic(struct CCONCURRENT_NODE*) Next;     /** Pointer to next node        */
+   void*                             Data;     /** Data stored in the node     */
+   size_t                            DataSize; /** Size of data stored in the node */
+} CCONCURRENT_NODE;
+
+
+/** Size of the padding that keeps the head and tail fields apart. */
+#define CCONCURRENT_CACHE_LINE 64U
+
+
+/** Access a method needs, see InAcquire. */
+typedef enum CCONCURRENT_ACCESS
+{
+   CCONCURRENT_ACCESS_READ,  /** Reads the list                */
+   CCONCURRENT_ACCESS_HEAD,  /** Removes the first node        */
+   CCONCURRENT_ACCESS_TAIL,  /** Adds nodes at the end         */
+   CCONCURRENT_ACCESS_WRITE  /** Changes the list in any way   */
+} CCONCURRENT_ACCESS;
+
+
+/**
+ * Concurrent list implementation of the CList protocol.
+ *
+ * Head is a dummy node that precedes the first node, so the ends meet in
+ * the Next link of one node only. PopFront turns the first node into the
+ * new dummy node. Methods announce themselves in the counter of their
+ * access and back off while Writer is set; the writer waits until the
+ * counters drain. Fields of the head and the tail end are kept in separate
+ * cache lines.
+ */
+typedef struct CCONCURRENT_LIST_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   CLIST     VTable;      /** API                 */
+
+   CCONCURRENT_NODE* Head;      /** Dummy node before the first node    */
+   size_t            Popped;    /** Number of nodes ever removed        */
+   mtx_t             HeadLock;  /** Lock of the head end in queue mode  */
+   atomic_size_t     HeadUsers; /** Methods running with HEAD access    */
+   char              HeadPadding[CCONCURRENT_CACHE_LINE];
+
+   CCONCURRENT_NODE* Tail;      /** Last node, Head if the list is empty */
+   size_t            Pushed;    /** Number of nodes ever added           */
+   mtx_t             TailLock;  /** Lock of the tail end in queue mode   */
+   atomic_size_t     TailUsers; /** Methods running with TAIL access     */
+   char              TailPadding[CCONCURRENT_CACHE_LINE];
+
+   atomic_size_t Readers;    /** Methods running with READ access      */
+   atomic_bool   Writer;     /** A method waits for or has WRITE access */
+   atomic_uint   Mode;       /** CCONCURRENT_LIST_MODE_*               */
+   mtx_t         WriterLock; /** Serializes methods with WRITE access  */
+} CCONCURRENT_LIST_IMPL;
+
+
+/** Unique identificator for CCONCURRENT_LIST_IMPL */
+#define CCONCURRENT_LIST_IMPL_STRUCT_ID \
+   STRUCT_ID_64('C', 'C', 'O', 'N', 'C', 'U', 'R', '.')
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Returns the node that follows the Node.
+ *
+ * @param[in]  Node  Node
+ *
+ * @return  Next node or NULL
+ */
+static
+CCONCURRENT_NODE*
+InGetNext(
+   IN CCONCURRENT_NODE* Node)
+{
+   return atomic_load_explicit(&Node->Next, memory_order_acquire);
+}
+
+
+/**
+ * Links the Next node after the Node. Everything written to Next before
+ * becomes visible to the thread that reads the link.
+ *
+ * @param[in]  Node  Node
+ * @param[in]  Next  Next node or NULL
+ */
+static
+void
+InSetNext(
+   IN CCONCURRENT_NODE* Node,
+   IN CCONCURRENT_NODE* Next)
+{
+   atomic_store_explicit(&Node->Next, Next, memory_order_release);
+}
+
+
+/**
+ * Returns the counter of methods running with the Access.
+ *
+ * @param[in]  List    List
+ * @param[in]  Access  READ, HEAD or TAIL access
+ *
+ * @return  Counter
+ */
+static
+atomic_size_t*
+InGetUsers(
+   IN CCONCURRENT_LIST_IMPL* List,
+   IN CCONCURRENT_ACCESS     Access)
+{
+   switch (Access)
+   {
+      case CCONCURRENT_ACCESS_HEAD: return &List->HeadUsers;
+      case CCONCURRENT_ACCESS_TAIL: return &List->TailUsers;
+      default:                      return &List->Readers;
+   }
+}
+
+
+/**
+ * Acquires the Access to the List, or WRITE access if the mode of the list
+ * doesn't allow the Access to run in parallel.
+ *
+ * READ access runs in parallel in shared mode, HEAD and TAIL access run
+ * in parallel in queue mode and take the lock of their end.
+ *
+ * @param[in]  List    List
+ * @param[in]  Access  Access the method needs
+ *
+ * @return  Access to pass to InRelease
+ */
+static
+CCONCURRENT_ACCESS
+InAcquire(
+   IN CCONCURRENT_LIST_IMPL* List,
+   IN CCONCURRENT_ACCESS     Access)
+{
+   if (Access != CCONCURRENT_ACCESS_WRITE)
+   {
+      atomic_size_t* users = InGetUsers(List, Access);
+      unsigned int mode = (CCONCURRENT_ACCESS_READ == Access) ?
+                          CCONCURRENT_LIST_MODE_SHARED : CCONCURRENT_LIST_MODE_QUEUE;
+
+      for (;;)
+      {
+         // The writer sets its flag before it checks the counters, so one
+         // of the sides always sees the other
+         atomic_fetch_add(users, 1);
+         if (!atomic_load(&List->Writer))
+         {
+            // The mode is changed with WRITE access only
+            if (atomic_load(&List->Mode) != mode)
+            {
+               atomic_fetch_sub(users, 1);
+               break;
+            }
+
+            if (CCONCURRENT_ACCESS_HEAD == Access) { mtx_lock(&List->HeadLock); }
+            if (CCONCURRENT_ACCESS_TAIL == Access) { mtx_lock(&List->TailLock); }
+            return Access;
+         }
+
+         atomic_fetch_sub(users, 1);
+         while (atomic_load(&List->Writer)) { thrd_yield(); }
+      }
+   }
+
+   mtx_lock(&List->WriterLock);
+   atomic_store(&List->Writer, true);
+   while ((atomic_load(&List->HeadUsers) != 0) ||
+          (atomic_load(&List->TailUsers) != 0) ||
+          (atomic_load(&List->Readers) != 0))
+   {
+      thrd_yield();
+   }
+
+   return CCONCURRENT_ACCESS_WRITE;
+}
+
+
+/**
+ * Releases the Access acquired by InAcquire.
+ *
+ * @param[in]  List    List
+ * @param[in]  Access  Access returned by InAcquire
+ */
+static
+void
+InRelease(
+   IN CCONCURRENT_LIST_IMPL* List,
+   IN CCONCURRENT_ACCESS     Access)
+{
+   if (CCONCURRENT_ACCESS_WRITE == Access)
+   {
+      atomic_store(&List->Writer, false);
+      mtx_unlock(&List->WriterLock);
+      return;
+   }
+
+   if (CCONCURRENT_ACCESS_HEAD == Access) { mtx_unlock(&List->HeadLock); }
+   if (CCONCURRENT_ACCESS_TAIL == Access) { mtx_unlock(&List->TailLock); }
+
+   atomic_fetch_sub(InGetUsers(List, Access), 1);
+}
+
+
+/**
+ * Creates an unlinked node.
+ *
+ * @param[in]  Data      Data that will be stored in the node
+ * @param[in]  DataSize  Data size
+ * @param[in]  TakeData  Adopt the malloc Data buffer instead of copying it
+ *
+ * @retval  CCONCURRENT_NODE*  If the node is successfully created
+ * @retval  NULL               On failure, the Data buffer stays with the caller
+ */
+static
+CCONCURRENT_NODE*
+InCreateNode(
+   IN void*  Data,
+   IN size_t DataSize,
+   IN bool   TakeData)
+{
+   CCONCURRENT_NODE* node = malloc(sizeof(CCONCURRENT_NODE));
+   if (NULL == node) { return NULL; }
+
+   node->Data = Data;
+   if (!TakeData)
+   {
+      node->Data = malloc(DataSize);
+      if (NULL == node->Data)
+      {
+         free(node);
+         return NULL;
+      }
+
+      memcpy(node->Data, Data, DataSize);
+   }
+
+   node->Prev = NULL;
+   atomic_init(&node->Next, NULL);
+   node->DataSize = DataSize;
+
+   return node;
+}
+
+
+/**
+ * Releases the Node and its data.
+ *
+ * @param[in]  Node  Unlinked node
+ */
+static
+void
+InDeleteNode(
+   IN CCONCURRENT_NODE* Node)
+{
+   free(Node->Data);
+   free(Node);
+}
+
+
+/**
+ * Creates a chain of nodes for Count records linked through Next and Prev.
+ *
+ * @param[in]   Records   Array of records
+ * @param[in]   DataSize  Size of one record
+ * @param[in]   Stride    Distance between records
+ * @param[in]   Count     Number of records, not 0
+ * @param[out]  First     First node of the chain
+ * @param[out]  Last      Last node of the chain
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, no nodes are left
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InCreateChain(
+   IN  void*              Records,
+   IN  size_t             DataSize,
+   IN  size_t             Stride,
+   IN  size_t             Count,
+   OUT CCONCURRENT_NODE** First,
+   OUT CCONCURRENT_NODE** Last)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   CCONCURRENT_NODE* first = NULL;
+   CCONCURRENT_NODE* last = NULL;
+   char* record = Records;
+
+   for (size_t i = 0; i < Count; ++i, record += Stride)
+   {
+      CCONCURRENT_NODE* node = InCreateNode(record, DataSize, false);
+      if (NULL == node)
+      {
+         while (first != NULL)
+         {
+            CCONCURRENT_NODE* next = InGetNext(first);
+            InDeleteNode(first);
+            first = next;
+         }
+
+         SET_SC(SC_NOT_ENOUGH_MEMORY);
+         return status;
+      }
+
+      node->Prev = last;
+      if (last != NULL) { InSetNext(last, node); }
+      else              { first = node; }
+      last = node;
+   }
+
+   *First = first;
+   *Last = last;
+
+   return status;
+}
+
+
+/**
+ * Links the chain [First, Last] of Count nodes after the Prev node.
+ *
+ * With TAIL access Prev must be the Tail, the link to the chain is
+ * published last, so HEAD access sees the chain complete.
+ *
+ * @param[in]  List   List
+ * @param[in]  Prev   Node of the list or the dummy node
+ * @param[in]  First  First node of the chain
+ * @param[in]  Last   Last node of the chain
+ * @param[in]  Count  Number of nodes in the chain
+ */
+static
+void
+InLinkChain(
+   IN CCONCURRENT_LIST_IMPL* List,
+   IN CCONCURRENT_NODE*      Prev,
+   IN CCONCURRENT_NODE*      First,
+   IN CCONCURRENT_NODE*      Last,
+   IN size_t                 Count)
+{
+   CCONCURRENT_NODE* next = InGetNext(Prev);
+
+   First->Prev = Prev;
+   InSetNext(Last, next);
+   if (next != NULL) { next->Prev = Last; }
+   else              { List->Tail = Last; }
+
+   List->Pushed += Count;
+   InSetNext(Prev, First);
+}
+
+
+/**
+ * Excludes the Node from the list without releasing it. Needs WRITE access.
+ *
+ * @param[in]  List  List
+ * @param[in]  Node  Node of the list
+ */
+static
+void
+InUnlinkNode(
+   IN CCONCURRENT_LIST_IMPL* List,
+   IN CCONCURRENT_NODE*      Node)
+{
+   CCONCURRENT_NODE* prev = Node->Prev;
+   CCONCURRENT_NODE* next = InGetNext(Node);
+
+   InSetNext(prev, next);
+   if (next != NULL) { next->Prev = prev; }
+   else              { List->Tail = prev; }
+
+   ++List->Popped;
+}
+
+
+/**
+ * Removes the first node and takes its data.
+ *
+ * The first node becomes the new dummy node and the old dummy node is
+ * released, so the tail end is never touched.
+ *
+ * @param[in]   List      List
+ * @param[out]  Data      Data of the removed node
+ * @param[out]  DataSize  Data size
+ *
+ * @return  false if the list is empty
+ */
+static
+bool
+InPopFront(
+   IN  CCONCURRENT_LIST_IMPL* List,
+   OUT void**                 Data,
+   OUT size_t*                DataSize)
+{
+   CCONCURRENT_ACCESS access = InAcquire(List, CCONCURRENT_ACCESS_HEAD);
+
+   CCONCURRENT_NODE* dummy = List->Head;
+   CCONCURRENT_NODE* first = InGetNext(dummy);
+   if (first != NULL)
+   {
+      *Data = first->Data;
+      *DataSize = first->DataSize;
+      first->Data = NULL;
+
+      List->Head = first;
+      ++List->Popped;
+   }
+
+   InRelease(List, access);
+
+   if (NULL == first) { return false; }
+
+   free(dummy);
+   return true;
+}
+
+
+/**
+ * Returns the node for the Position handle.
+ *
+ * @param[in]  Position  Handle
+ *
+ * @return  Node
+ */
+static
+CCONCURRENT_NODE*
+InToNode(
+   IN CLIST_NODE* Position)
+{
+   return (CCONCURRENT_NODE*)Position;
+}
+
+
+/**
+ * Returns the handle for the Node.
+ *
+ * @param[in]  List  List
+ * @param[in]  Node  Node of the list, the dummy node or NULL
+ *
+ * @return  Handle, NULL for the dummy node
+ */
+static
+CLIST_NODE*
+InToHandle(
+   IN CCONCURRENT_LIST_IMPL* List,
+   IN CCONCURRENT_NODE*      Node)
+{
+   return (Node != List->Head) ? (CLIST_NODE*)Node : NULL;
+}
+
+
+/**
+ * Creates an empty list in queue mode.
+ *
+ * @retval  CCONCURRENT_LIST_IMPL*  If the list is successfully created
+ * @retval  NULL                    On failure
+ */
+static
+CCONCURRENT_LIST_IMPL*
+InCreateList();
+
+
+///////////////////////////////////////////////////////////
+///          CConcurrentList API implementation         ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Creates a node at the beginning of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListPushFront(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_NODE* node = InCreateNode(Data, DataSize, false);
+      if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      InLinkChain(this, this->Head, node, node, 1);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListPushBack(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_NODE* node = InCreateNode(Data, DataSize, false);
+      if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_TAIL);
+      InLinkChain(this, this->Tail, node, node, 1);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the first node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  The first node or NULL if the list is empty or This is invalid
+ */
+static
+CLIST_NODE*
+CConcurrentListFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_READ);
+      CLIST_NODE* front = (CLIST_NODE*)InGetNext(this->Head);
+      InRelease(this, access);
+
+      return front;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the last node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  The last node or NULL if the list is empty or This is invalid
+ */
+static
+CLIST_NODE*
+CConcurrentListBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_READ);
+      CLIST_NODE* back = InToHandle(this, this->Tail);
+      InRelease(this, access);
+
+      return back;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Removes the first node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CConcurrentListPopFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+
+      void* data = NULL;
+      size_t dataSize = 0;
+      if (InPopFront(this, &data, &dataSize)) { free(data); }
+
+   } while (false);
+}
+
+
+/**
+ * Removes the last node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CConcurrentListPopBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      CCONCURRENT_NODE* back = this->Tail;
+      if (back != this->Head) { InUnlinkNode(this, back); }
+      else                    { back = NULL; }
+      InRelease(this, access);
+
+      if (back != NULL) { InDeleteNode(back); }
+
+   } while (false);
+}
+
+
+/**
+ * Removes the Position node from the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListRemove(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      InUnlinkNode(this, InToNode(Position));
+      InRelease(this, access);
+
+      InDeleteNode(InToNode(Position));
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes all nodes of the list, the dummy node stays.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListClear(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      CCONCURRENT_NODE* node = InGetNext(this->Head);
+      InSetNext(this->Head, NULL);
+      this->Tail = this->Head;
+      this->Popped = this->Pushed;
+      InRelease(this, access);
+
+      // Released nodes are out of reach of other threads
+      while (node != NULL)
+      {
+         CCONCURRENT_NODE* next = InGetNext(node);
+         InDeleteNode(node);
+         node = next;
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the node following the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  The next node or NULL
+ */
+static
+CLIST_NODE*
+CConcurrentListNext(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_READ);
+      CLIST_NODE* next = (CLIST_NODE*)InGetNext(InToNode(Position));
+      InRelease(this, access);
+
+      return next;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the node preceding the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  The previous node or NULL
+ */
+static
+CLIST_NODE*
+CConcurrentListPrev(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_READ);
+      CLIST_NODE* prev = InToHandle(this, InToNode(Position)->Prev);
+      InRelease(this, access);
+
+      return prev;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Gets a link to the data stored in the Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Triple pointer to data
+ * @param[in]  DataSize  Pointer to pointer to data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListGetRefToData(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void***     Data,
+   IN size_t**    DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // The link outlives the call, the lock only orders it after the
+      // creation of the node
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_READ);
+      *Data = &InToNode(Position)->Data;
+      *DataSize = &InToNode(Position)->DataSize;
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Gets a copy of the data stored in the Position node. The copy is
+ * allocated with malloc and released by the caller.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[in]   Position  Position in the list
+ * @param[out]  Data      Copy of the data
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListGetCopyData(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void**      Data,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_READ);
+
+      CCONCURRENT_NODE* node = InToNode(Position);
+      *Data = malloc(node->DataSize);
+      if (*Data != NULL)
+      {
+         memcpy(*Data, node->Data, node->DataSize);
+         *DataSize = node->DataSize;
+      }
+
+      InRelease(this, access);
+
+      if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node before the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListInsertBefore(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Data,
+   IN size_t      DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CCONCURRENT_NODE* node = InCreateNode(Data, DataSize, false);
+      if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      InLinkChain(this, InToNode(Position)->Prev, node, node, 1);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node after the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListInsertAfter(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Data,
+   IN size_t      DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CCONCURRENT_NODE* node = InCreateNode(Data, DataSize, false);
+      if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      InLinkChain(this, InToNode(Position), node, node, 1);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the number of nodes in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  Number of nodes, 0 if This is invalid
+ */
+static
+size_t
+CConcurrentListSize(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_READ);
+      size_t size = this->Pushed - this->Popped;
+      InRelease(this, access);
+
+      return size;
+
+   } while (false);
+
+   return 0;
+}
+
+
+/**
+ * Adopts the malloc Data buffer in a node at the beginning of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Buffer allocated with malloc
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, Data stays with the caller
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListPushFrontTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_NODE* node = InCreateNode(Data, DataSize, true);
+      if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      InLinkChain(this, this->Head, node, node, 1);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Adopts the malloc Data buffer in a node at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Buffer allocated with malloc
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, Data stays with the caller
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListPushBackTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_NODE* node = InCreateNode(Data, DataSize, true);
+      if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_TAIL);
+      InLinkChain(this, this->Tail, node, node, 1);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the first node and returns its malloc data buffer.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListPopFrontTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      if (!InPopFront(this, Data, DataSize)) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the last node and returns its malloc data buffer.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListPopBackTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      CCONCURRENT_NODE* back = this->Tail;
+      if (back != this->Head) { InUnlinkNode(this, back); }
+      else                    { back = NULL; }
+      InRelease(this, access);
+
+      if (NULL == back) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      *Data = back->Data;
+      *DataSize = back->DataSize;
+      free(back);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Copies the data stored in the Position node into the caller's Buffer.
+ *
+ * @param[in]   This        Pointer to CList protocol
+ * @param[in]   Position    Position in the list
+ * @param[out]  Buffer      Buffer for the data
+ * @param[in]   BufferSize  Buffer size
+ * @param[out]  DataSize    Data size, also set if the buffer is too small
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_BUFFER_TOO_SMALL   BufferSize is less than the data size
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListGetCopyDataInto(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void*       Buffer,
+   IN  size_t      BufferSize,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Position) || (NULL == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_READ);
+
+      CCONCURRENT_NODE* node = InToNode(Position);
+      *DataSize = node->DataSize;
+      bool isCopied = (Buffer != NULL) && (BufferSize >= node->DataSize);
+      if (isCopied) { memcpy(Buffer, node->Data, node->DataSize); }
+
+      InRelease(this, access);
+
+      if (!isCopied) { SET_SC(SC_BUFFER_TOO_SMALL); break; }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes for Count records at the beginning of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListPushFrontBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Records) || (0 == DataSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (0 == Count) { break; }
+
+      CCONCURRENT_NODE* first = NULL;
+      CCONCURRENT_NODE* last = NULL;
+      status = InCreateChain(Records, DataSize, Stride, Count, &first, &last);
+      if (SC_ERROR(status)) { break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      InLinkChain(this, this->Head, first, last, Count);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes for Count records at the end of the list. The nodes are
+ * created before the tail is locked and appear to other threads at once.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListPushBackBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Records) || (0 == DataSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (0 == Count) { break; }
+
+      CCONCURRENT_NODE* first = NULL;
+      CCONCURRENT_NODE* last = NULL;
+      status = InCreateChain(Records, DataSize, Stride, Count, &first, &last);
+      if (SC_ERROR(status)) { break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_TAIL);
+      InLinkChain(this, this->Tail, first, last, Count);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes for Count records after the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListInsertAfterBatch(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Records,
+   IN size_t      DataSize,
+   IN size_t      Stride,
+   IN size_t      Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Records) || (0 == DataSize) ||
+          (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (0 == Count) { break; }
+
+      CCONCURRENT_NODE* first = NULL;
+      CCONCURRENT_NODE* last = NULL;
+      status = InCreateChain(Records, DataSize, Stride, Count, &first, &last);
+      if (SC_ERROR(status)) { break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      InLinkChain(this, InToNode(Position), first, last, Count);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Moves the nodes after Position into a new list. Nodes are relinked, so
+ * their handles stay valid.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  On success, returns the pointer to the new list. On failure,
+ *          returns a NULL pointer and This list is unchanged.
+ */
+static
+CLIST*
+CConcurrentListSplitAfter(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_LIST_IMPL* other = InCreateList();
+      if (NULL == other) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+
+      CCONCURRENT_NODE* position = InToNode(Position);
+      CCONCURRENT_NODE* first = InGetNext(position);
+      if (first != NULL)
+      {
+         size_t count = 0;
+         for (CCONCURRENT_NODE* node = first; node != NULL; node = InGetNext(node)) { ++count; }
+
+         CCONCURRENT_NODE* last = this->Tail;
+         InSetNext(position, NULL);
+         this->Tail = position;
+         this->Popped += count;
+
+         InLinkChain(other, other->Head, first, last, count);
+      }
+
+      InRelease(this, access);
+
+      return &other->VTable;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Moves all nodes of the Other list to the end of This list. Nodes are
+ * relinked, so their handles stay valid.
+ *
+ * @param[in]  This   Pointer to CList protocol
+ * @param[in]  Other  Concurrent list to empty into This, not This itself
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListAppend(
+   IN CLIST* This,
+   IN CLIST* Other)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      CCONCURRENT_LIST_IMPL* other = GET_STRUCT_FIELD(Other, CCONCURRENT_LIST_IMPL, VTable);
+      if ((NULL == other) || (other->StructureId != CCONCURRENT_LIST_IMPL_STRUCT_ID) ||
+          (other == this))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // Both lists are locked in the order of their addresses, so two
+      // opposite Appends don't deadlock
+      CCONCURRENT_LIST_IMPL* lower = (this < other) ? this : other;
+      CCONCURRENT_LIST_IMPL* upper = (this < other) ? other : this;
+      CCONCURRENT_ACCESS lowerAccess = InAcquire(lower, CCONCURRENT_ACCESS_WRITE);
+      CCONCURRENT_ACCESS upperAccess = InAcquire(upper, CCONCURRENT_ACCESS_WRITE);
+
+      CCONCURRENT_NODE* first = InGetNext(other->Head);
+      if (first != NULL)
+      {
+         size_t count = other->Pushed - other->Popped;
+         CCONCURRENT_NODE* last = other->Tail;
+
+         InSetNext(other->Head, NULL);
+         other->Tail = other->Head;
+         other->Popped += count;
+
+         InLinkChain(this, this->Tail, first, last, count);
+      }
+
+      InRelease(upper, upperAccess);
+      InRelease(lower, lowerAccess);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Sorts the list by relinking the nodes. The sort is stable.
+ *
+ * @param[in]  This        Pointer to CList protocol
+ * @param[in]  Comparator  Comparator of the node data
+ * @param[in]  Context     Context for the Comparator, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CConcurrentListSort(
+   IN          CLIST*           This,
+   IN          CLIST_COMPARATOR Comparator,
+   IN OPTIONAL void*            Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if (NULL == Comparator) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+
+      size_t size = this->Pushed - this->Popped;
+      CCONCURRENT_NODE** nodes = (size > 1) ? malloc(2 * size * sizeof(CCONCURRENT_NODE*)) : NULL;
+      if ((size > 1) && (NULL == nodes)) { SET_SC(SC_NOT_ENOUGH_MEMORY); }
+
+      if (nodes != NULL)
+      {
+         size_t count = 0;
+         for (CCONCURRENT_NODE* node = InGetNext(this->Head); node != NULL; node = InGetNext(node))
+         {
+            nodes[count++] = node;
+         }
+
+         // Bottom-up merge sort, the left run wins among equivalent nodes
+         CCONCURRENT_NODE** from = nodes;
+         CCONCURRENT_NODE** to = nodes + size;
+         for (size_t width = 1; width < size; width *= 2)
+         {
+            for (size_t begin = 0; begin < size; begin += 2 * width)
+            {
+               size_t middle = (begin + width < size) ? begin + width : size;
+               size_t end = (begin + 2 * width < size) ? begin + 2 * width : size;
+               size_t left = begin;
+               size_t right = middle;
+
+               for (size_t i = begin; i < end; ++i)
+               {
+                  if ((left < middle) &&
+                      ((right >= end) ||
+                       (Comparator(from[right]->Data, from[right]->DataSize,
+                                   from[left]->Data, from[left]->DataSize,
+                                   Context) >= 0)))
+                  {
+                     to[i] = from[left++];
+                  }
+                  else
+                  {
+                     to[i] = from[right++];
+                  }
+               }
+            }
+
+            CCONCURRENT_NODE** swap = from;
+            from = to;
+            to = swap;
+         }
+
+         CCONCURRENT_NODE* prev = this->Head;
+         for (size_t i = 0; i < size; ++i)
+         {
+            from[i]->Prev = prev;
+            InSetNext(prev, from[i]);
+            prev = from[i];
+         }
+         InSetNext(prev, NULL);
+         this->Tail = prev;
+
+         free(nodes);
+      }
+
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+static
+CCONCURRENT_LIST_IMPL*
+InCreateList()
+{
+   CCONCURRENT_LIST_IMPL* this = malloc(sizeof(CCONCURRENT_LIST_IMPL));
+   if (NULL == this) { return NULL; }
+
+   this->Head = InCreateNode(NULL, 0, true);
+   if (NULL == this->Head)
+   {
+      free(this);
+      return NULL;
+   }
+
+   if (mtx_init(&this->HeadLock, mtx_plain) != thrd_success)
+   {
+      free(this->Head);
+      free(this);
+      return NULL;
+   }
+
+   if (mtx_init(&this->TailLock, mtx_plain) != thrd_success)
+   {
+      mtx_destroy(&this->HeadLock);
+      free(this->Head);
+      free(this);
+      return NULL;
+   }
+
+   if (mtx_init(&this->WriterLock, mtx_plain) != thrd_success)
+   {
+      mtx_destroy(&this->TailLock);
+      mtx_destroy(&this->HeadLock);
+      free(this->Head);
+      free(this);
+      return NULL;
+   }
+
+   this->StructureId = CCONCURRENT_LIST_IMPL_STRUCT_ID;
+   this->Tail = this->Head;
+   this->Pushed = this->Popped = 0;
+   atomic_init(&this->HeadUsers, 0);
+   atomic_init(&this->TailUsers, 0);
+   atomic_init(&this->Readers, 0);
+   atomic_init(&this->Writer, false);
+   atomic_init(&this->Mode, CCONCURRENT_LIST_MODE_QUEUE);
+
+   this->VTable.PushFront    = CConcurrentListPushFront;
+   this->VTable.PushBack     = CConcurrentListPushBack;
+   this->VTable.Front        = CConcurrentListFront;
+   this->VTable.Back         = CConcurrentListBack;
+   this->VTable.PopFront     = CConcurrentListPopFront;
+   this->VTable.PopBack      = CConcurrentListPopBack;
+   this->VTable.Next         = CConcurrentListNext;
+   this->VTable.Prev         = CConcurrentListPrev;
+   this->VTable.GetRefToData = CConcurrentListGetRefToData;
+   this->VTable.GetCopyData  = CConcurrentListGetCopyData;
+   this->VTable.InsertBefore = CConcurrentListInsertBefore;
+   this->VTable.InsertAfter  = CConcurrentListInsertAfter;
+   this->VTable.Size         = CConcurrentListSize;
+   this->VTable.Remove       = CConcurrentListRemove;
+   this->VTable.Clear        = CConcurrentListClear;
+
+   this->VTable.PushFrontTake   = CConcurrentListPushFrontTake;
+   this->VTable.PushBackTake    = CConcurrentListPushBackTake;
+   this->VTable.PopFrontTake    = CConcurrentListPopFrontTake;
+   this->VTable.PopBackTake     = CConcurrentListPopBackTake;
+   this->VTable.GetCopyDataInto = CConcurrentListGetCopyDataInto;
+
+   this->VTable.PushFrontBatch   = CConcurrentListPushFrontBatch;
+   this->VTable.PushBackBatch    = CConcurrentListPushBackBatch;
+   this->VTable.InsertAfterBatch = CConcurrentListInsertAfterBatch;
+
+   this->VTable.Splice     = NULL;
+   this->VTable.SplitAfter = CConcurrentListSplitAfter;
+   this->VTable.Append     = CConcurrentListAppend;
+
+   this->VTable.Sort         = CConcurrentListSort;
+   this->VTable.SortParallel = NULL;
+
+   this->VTable.ForEach   = NULL;
+   this->VTable.NextBatch = NULL;
+
+   this->VTable.ParallelForEach = NULL;
+   this->VTable.ParallelReduce  = NULL;
+
+   this->VTable.GetStats = NULL;
+
+   this->VTable.Compact = NULL;
+
+   return this;
+}
+
+
+CLIST*
+CConcurrentListCreate()
+{
+   CCONCURRENT_LIST_IMPL* this = InCreateList();
+   if (NULL == this) { return NULL; }
+
+   return &this->VTable;
+}
+
+
+STATUS_CODE
+CConcurrentListSetMode(
+   IN CLIST*   This,
+   IN uint32_t Mode)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CCONCURRENT_LIST_IMPL);
+      if ((Mode != CCONCURRENT_LIST_MODE_QUEUE) && (Mode != CCONCURRENT_LIST_MODE_SHARED))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CCONCURRENT_ACCESS access = InAcquire(this, CCONCURRENT_ACCESS_WRITE);
+      atomic_store(&this->Mode, Mode);
+      InRelease(this, access);
+
+   } while (false);
+
+   return status;
+}
+
+
+void
+CConcurrentListDelete(
+   IN OPTIONAL CLIST* This)
+{
+   CCONCURRENT_LIST_IMPL* this = GET_STRUCT_FIELD(This, CCONCURRENT_LIST_IMPL, VTable);
+   if ((NULL == this) || (this->StructureId != CCONCURRENT_LIST_IMPL_STRUCT_ID)) { return; }
+
+   // The dummy node has no data
+   CCONCURRENT_NODE* node = this->Head;
+   while (node != NULL)
+   {
+      CCONCURRENT_NODE* next = InGetNext(node);
+      InDeleteNode(node);
+      node = next;
+   }
+
+   mtx_destroy(&this->WriterLock);
+   mtx_destroy(&this->TailLock);
+   mtx_destroy(&this->HeadLock);
+
+   this->StructureId = 0;
+   free(this);
+}
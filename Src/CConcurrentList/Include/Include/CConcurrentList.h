@@ -0,0 +1,79 @@
+/**
+ * @file     CConcurrentList.h
+ * @brief    Thread-safe doubly linked list implementation of the CList protocol.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#ifndef  __CCONCURRENT_LIST_H__
+#define  __CCONCURRENT_LIST_H__
+
+#include "Include/CList.h"
+
+
+/**
+ * Queue mode, the default. PushBack and PushBackBatch take only the tail
+ * lock and PopFront and PopFrontTake take only the head lock, so producers
+ * and consumers don't contend. All other methods, reading ones included,
+ * have the list to themselves.
+ */
+#define CCONCURRENT_LIST_MODE_QUEUE 0U
+
+/**
+ * Shared mode for traversal-heavy phases. Methods that only read the list
+ * (Front, Back, Next, Prev, Size, GetCopyData, GetCopyDataInto) run in
+ * parallel, methods that change the list have it to themselves.
+ */
+#define CCONCURRENT_LIST_MODE_SHARED 1U
+
+
+/**
+ * Creates a doubly linked list whose methods may be called from many
+ * threads at once.
+ *
+ * Every method is atomic with respect to the others. Locking follows the
+ * mode of the list, see CCONCURRENT_LIST_MODE_*. Nodes and data buffers are
+ * allocated with malloc, buffers passed to the Take methods must be
+ * allocated with malloc too. CLIST_NODE handles follow the CList rules:
+ *    - A handle is valid until its node is removed, by any thread. Threads
+ *      that keep handles between calls agree on who removes nodes;
+ *    - The link returned by GetRefToData is valid as long as the handle,
+ *      the data behind it is not protected by the list;
+ *    - Append locks both lists, SplitAfter locks This list;
+ *    - Splice, SortParallel, ForEach, NextBatch, ParallelForEach,
+ *      ParallelReduce, GetStats and Compact are not supported and are set
+ *      to NULL.
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, returns a NULL pointer.
+ */
+CLIST*
+CConcurrentListCreate();
+
+
+/**
+ * Switches the locking mode of the list. Waits until the methods running
+ * in other threads return, methods called later use the new mode.
+ *
+ * @param[in]  This  List created by CConcurrentListCreate
+ * @param[in]  Mode  CCONCURRENT_LIST_MODE_QUEUE or CCONCURRENT_LIST_MODE_SHARED
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+CConcurrentListSetMode(
+   IN CLIST*   This,
+   IN uint32_t Mode);
+
+
+/**
+ * Releases the list created by CConcurrentListCreate, its nodes and data.
+ * No other thread may use the list.
+ *
+ * @param[in]  This  Pointer to CList protocol. NULL is ignored.
+ */
+void
+CConcurrentListDelete(
+   IN OPTIONAL CLIST* This);
+
+#endif  // __CCONCURRENT_LIST_H__
@@ -0,0 +1,428 @@
+/**
+ * @file  CConcurrentListTest.cpp
+ * @brief Unit, stress and throughput Tests for the concurrent CLIST implementation
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CConcurrentList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                       Helpers                         //
+///////////////////////////////////////////////////////////
+
+/** Returns the size_t values stored in the List. */
+static std::vector<size_t> InToVector(CLIST* List)
+{
+   std::vector<size_t> values;
+   for (CLIST_NODE* position = List->Front(List);
+        position != NULL;
+        position = List->Next(List, position))
+   {
+      size_t data = 0;
+      size_t dataSize = 0;
+      EXPECT_FALSE(SC_ERROR(List->GetCopyDataInto(List, position, &data,
+                                                  sizeof(data), &dataSize)));
+      values.push_back(data);
+   }
+
+   // Backward traversal must see the same nodes
+   size_t count = 0;
+   for (CLIST_NODE* position = List->Back(List);
+        position != NULL;
+        position = List->Prev(List, position))
+   {
+      ++count;
+   }
+   EXPECT_TRUE(values.size() == count);
+   EXPECT_TRUE(List->Size(List) == count);
+
+   return values;
+}
+
+
+/** Value pushed by a producer: the producer index and a sequence number. */
+static size_t InMakeValue(size_t Producer, size_t Sequence)
+{
+   return (Producer << 32) | Sequence;
+}
+
+
+/**
+ * Runs Producers threads that push Count values each to the end of the
+ * List and Consumers threads that pop them from the beginning. Checks
+ * that every value is popped once and values of one producer are popped
+ * by one consumer in the order they were pushed.
+ *
+ * @return  Duration of the run in seconds
+ */
+static double InRunQueue(CLIST* List, size_t Producers, size_t Consumers, size_t Count,
+                         const std::function<void()>& Background = nullptr)
+{
+   std::atomic<size_t> popped(0);
+   std::atomic<bool> isDone(false);
+   std::vector<std::vector<size_t>> seen(Consumers);
+   std::vector<std::thread> threads;
+
+   auto start = std::chrono::steady_clock::now();
+
+   for (size_t p = 0; p < Producers; ++p)
+   {
+      threads.emplace_back([List, p, Count]()
+      {
+         for (size_t i = 0; i < Count; ++i)
+         {
+            size_t value = InMakeValue(p, i);
+            while (SC_ERROR(List->PushBack(List, &value, sizeof(value)))) {}
+         }
+      });
+   }
+
+   for (size_t c = 0; c < Consumers; ++c)
+   {
+      threads.emplace_back([List, c, Producers, Count, &popped, &seen]()
+      {
+         std::vector<size_t> last(Producers, SIZE_MAX);
+         while (popped.load() < Producers * Count)
+         {
+            void* data = NULL;
+            size_t dataSize = 0;
+            if (SC_ERROR(List->PopFrontTake(List, &data, &dataSize))) { continue; }
+
+            size_t value = *(size_t*)data;
+            free(data);
+            popped.fetch_add(1);
+
+            size_t producer = value >> 32;
+            size_t sequence = value & 0xFFFFFFFFU;
+            EXPECT_TRUE((SIZE_MAX == last[producer]) || (last[producer] < sequence));
+            last[producer] = sequence;
+            seen[c].push_back(value);
+         }
+      });
+   }
+
+   std::thread background;
+   if (Background)
+   {
+      background = std::thread([&isDone, &Background]()
+      {
+         while (!isDone.load()) { Background(); }
+      });
+   }
+
+   for (std::thread& thread : threads) { thread.join(); }
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+   isDone.store(true);
+   if (background.joinable()) { background.join(); }
+
+   std::vector<char> isSeen(Producers * Count, 0);
+   for (const std::vector<size_t>& values : seen)
+   {
+      for (size_t value : values)
+      {
+         size_t index = (value >> 32) * Count + (value & 0xFFFFFFFFU);
+         EXPECT_TRUE(0 == isSeen[index]);
+         isSeen[index] = 1;
+      }
+   }
+   EXPECT_TRUE(0 == List->Size(List));
+
+   return seconds;
+}
+
+
+///////////////////////////////////////////////////////////
+//                CConcurrentList Fixtures               //
+///////////////////////////////////////////////////////////
+
+struct CConcurrentListEmpty : public testing::Test
+{
+   CLIST* list = NULL;
+
+   // Per-test set-up
+   void SetUp() override
+   {
+      list = CConcurrentListCreate();
+      ASSERT_FALSE(list == NULL);
+   }
+
+   // Per-test tear-down
+   void TearDown() override
+   {
+      CConcurrentListDelete(list);
+   }
+};
+
+
+///////////////////////////////////////////////////////////
+//                       Tests                           //
+///////////////////////////////////////////////////////////
+
+TEST_F(CConcurrentListEmpty, InvPrms)
+{
+   /*** Arrange ***/
+   size_t data = 25;
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->PushFront(NULL, &data, sizeof(size_t))));
+   EXPECT_TRUE(SC_ERROR(list->PushBack(list, NULL, sizeof(size_t))));
+   EXPECT_TRUE(SC_ERROR(list->PushBack(list, &data, 0)));
+   EXPECT_TRUE(SC_ERROR(list->InsertAfter(list, NULL, &data, sizeof(size_t))));
+   EXPECT_TRUE(SC_ERROR(CConcurrentListSetMode(list, 2)));
+   EXPECT_TRUE(SC_ERROR(CConcurrentListSetMode(NULL, CCONCURRENT_LIST_MODE_SHARED)));
+   EXPECT_TRUE(SC_ERROR(list->Append(list, list)));
+
+   void* buffer = NULL;
+   size_t bufferSize = 0;
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(list->PopFrontTake(list, &buffer, &bufferSize)));
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(list->PopBackTake(list, &buffer, &bufferSize)));
+   list->PopFront(list);
+   list->PopBack(list);
+
+   EXPECT_TRUE(NULL == list->Front(list));
+   EXPECT_TRUE(NULL == list->Back(list));
+   EXPECT_TRUE(0 == list->Size(list));
+   EXPECT_TRUE(NULL == list->Splice);
+}
+
+
+TEST_F(CConcurrentListEmpty, Operations)
+{
+   /*** Arrange ***/
+   size_t records[5] = { 0, 1, 2, 3, 4 };
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, &records[1], sizeof(size_t),
+                                             sizeof(size_t), 2)));
+   ASSERT_FALSE(SC_ERROR(list->PushFront(list, &records[0], sizeof(size_t))));
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &records[4], sizeof(size_t))));
+   ASSERT_FALSE(SC_ERROR(list->InsertBefore(list, list->Back(list), &records[3],
+                                            sizeof(size_t))));
+
+   /*** Assert ***/
+   EXPECT_TRUE((std::vector<size_t>{ 0, 1, 2, 3, 4 }) == InToVector(list));
+
+   list->PopFront(list);
+   list->PopBack(list);
+   EXPECT_TRUE((std::vector<size_t>{ 1, 2, 3 }) == InToVector(list));
+
+   // Nodes keep their handles when they move to another list
+   CLIST_NODE* last = list->Back(list);
+   CLIST* tail = list->SplitAfter(list, list->Front(list));
+   ASSERT_FALSE(NULL == tail);
+   EXPECT_TRUE((std::vector<size_t>{ 1 }) == InToVector(list));
+   EXPECT_TRUE((std::vector<size_t>{ 2, 3 }) == InToVector(tail));
+   EXPECT_TRUE(last == tail->Back(tail));
+
+   ASSERT_FALSE(SC_ERROR(tail->Append(tail, list)));
+   EXPECT_TRUE((std::vector<size_t>{ 2, 3, 1 }) == InToVector(tail));
+   EXPECT_TRUE(0 == list->Size(list));
+
+   auto compare = [](void* Left, size_t, void* Right, size_t, void*) -> int
+   {
+      size_t left = *(size_t*)Left;
+      size_t right = *(size_t*)Right;
+      return (left < right) ? -1 : (left > right) ? 1 : 0;
+   };
+   ASSERT_FALSE(SC_ERROR(CConcurrentListSetMode(tail, CCONCURRENT_LIST_MODE_SHARED)));
+   ASSERT_FALSE(SC_ERROR(tail->Sort(tail, compare, NULL)));
+   EXPECT_TRUE((std::vector<size_t>{ 1, 2, 3 }) == InToVector(tail));
+
+   void* data = NULL;
+   size_t dataSize = 0;
+   ASSERT_FALSE(SC_ERROR(tail->PopBackTake(tail, &data, &dataSize)));
+   EXPECT_TRUE(3 == *(size_t*)data);
+   free(data);
+
+   CConcurrentListDelete(tail);
+}
+
+
+TEST_F(CConcurrentListEmpty, RemoveAndClear)
+{
+   /*** Arrange ***/
+   size_t records[5] = { 0, 1, 2, 3, 4 };
+   ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, records, sizeof(size_t),
+                                             sizeof(size_t), 5)));
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, NULL)));
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, list->Next(list, list->Front(list)))));
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, list->Front(list))));
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, list->Back(list))));
+   EXPECT_TRUE((std::vector<size_t>{ 2, 3 }) == InToVector(list));
+   EXPECT_TRUE(2 == list->Size(list));
+
+   EXPECT_TRUE(SC_ERROR(list->Clear(NULL)));
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+   EXPECT_TRUE(0 == list->Size(list));
+   EXPECT_TRUE(NULL == list->Back(list));
+
+   // Nodes pushed while the list is cleared are either removed or kept whole
+   std::thread producer([this]()
+   {
+      for (size_t i = 0; i < 10000; ++i)
+      {
+         EXPECT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      }
+   });
+   for (size_t i = 0; i < 100; ++i) { EXPECT_FALSE(SC_ERROR(list->Clear(list))); }
+   producer.join();
+
+   std::vector<size_t> values = InToVector(list);
+   EXPECT_TRUE(values.size() == list->Size(list));
+   EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+
+TEST_F(CConcurrentListEmpty, StressQueue)
+{
+   /*** Act ***/
+   InRunQueue(list, 4, 4, 20000);
+
+   /*** Assert ***/
+   EXPECT_TRUE(NULL == list->Front(list));
+}
+
+
+TEST_F(CConcurrentListEmpty, StressQueueWhileModeChanges)
+{
+   /*** Arrange ***/
+   CLIST* list = this->list;
+   size_t switches = 0;
+
+   /*** Act ***/
+   // Every switch waits for the running methods, the queue stays consistent
+   InRunQueue(list, 2, 2, 20000, [list, &switches]()
+   {
+      uint32_t mode = (switches++ % 2 == 0) ? CCONCURRENT_LIST_MODE_SHARED :
+                                              CCONCURRENT_LIST_MODE_QUEUE;
+      EXPECT_FALSE(SC_ERROR(CConcurrentListSetMode(list, mode)));
+      std::this_thread::yield();
+   });
+
+   /*** Assert ***/
+   EXPECT_TRUE(switches > 0);
+}
+
+
+TEST_F(CConcurrentListEmpty, StressSharedTraversal)
+{
+   /*** Arrange ***/
+   ASSERT_FALSE(SC_ERROR(CConcurrentListSetMode(list, CCONCURRENT_LIST_MODE_SHARED)));
+   std::atomic<bool> isDone(false);
+   std::vector<std::thread> readers;
+
+   /*** Act ***/
+   for (size_t r = 0; r < 4; ++r)
+   {
+      readers.emplace_back([this, &isDone]()
+      {
+         // Values are appended in order, so every traversal sees 0, 1, 2...
+         while (!isDone.load())
+         {
+            size_t expected = 0;
+            for (CLIST_NODE* position = list->Front(list);
+                 position != NULL;
+                 position = list->Next(list, position), ++expected)
+            {
+               size_t data = 0;
+               size_t dataSize = 0;
+               EXPECT_FALSE(SC_ERROR(list->GetCopyDataInto(list, position, &data,
+                                                           sizeof(data), &dataSize)));
+               EXPECT_TRUE(expected == data);
+            }
+         }
+      });
+   }
+
+   for (size_t i = 0; i < 2000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+   }
+
+   isDone.store(true);
+   for (std::thread& reader : readers) { reader.join(); }
+
+   /*** Assert ***/
+   EXPECT_TRUE(2000 == list->Size(list));
+}
+
+
+TEST(CConcurrentListThroughput, QueueAgainstMutex)
+{
+   /*** Arrange ***/
+   const size_t count = 100000;
+
+   // The usual setup before: one mutex around a plain CList
+   struct LockedList
+   {
+      CLIST      VTable;
+      CLIST*     List;
+      std::mutex Lock;
+   };
+
+   LockedList locked = {};
+   locked.List = CListCreate();
+   ASSERT_FALSE(NULL == locked.List);
+   locked.VTable.PushBack = [](CLIST* This, void* Data, size_t DataSize) -> STATUS_CODE
+   {
+      LockedList* self = reinterpret_cast<LockedList*>(This);
+      std::lock_guard<std::mutex> guard(self->Lock);
+      return self->List->PushBack(self->List, Data, DataSize);
+   };
+   locked.VTable.PopFrontTake = [](CLIST* This, void** Data, size_t* DataSize) -> STATUS_CODE
+   {
+      LockedList* self = reinterpret_cast<LockedList*>(This);
+      std::lock_guard<std::mutex> guard(self->Lock);
+      return self->List->PopFrontTake(self->List, Data, DataSize);
+   };
+   locked.VTable.Size = [](CLIST* This) -> size_t
+   {
+      LockedList* self = reinterpret_cast<LockedList*>(This);
+      std::lock_guard<std::mutex> guard(self->Lock);
+      return self->List->Size(self->List);
+   };
+
+   CLIST* concurrent = CConcurrentListCreate();
+   ASSERT_FALSE(NULL == concurrent);
+
+   /*** Act ***/
+   double lockedSeconds = InRunQueue(&locked.VTable, 2, 2, count);
+   double concurrentSeconds = InRunQueue(concurrent, 2, 2, count);
+
+   /*** Assert ***/
+   std::printf("Queue of %zu values, 2 producers, 2 consumers: "
+               "mutex %.3f s, two-lock %.3f s\n",
+               2 * count, lockedSeconds, concurrentSeconds);
+   RecordProperty("MutexSeconds", std::to_string(lockedSeconds));
+   RecordProperty("TwoLockSeconds", std::to_string(concurrentSeconds));
+
+   CListDelete(locked.List);
+   CConcurrentListDelete(concurrent);
+}
+
+
+int main(int argc, char** argv)
+{
+   ::testing::InitGoogleTest(&argc, argv);
+
+   return RUN_ALL_TESTS();
+}
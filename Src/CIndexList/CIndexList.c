@@ -0,0 +1,1456 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     CIndexList.c
+ * @brief    Index-linked doubly linked list implementation.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Include/CIndexList.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Links of a slot. The element follows them in the slot. */
+typedef struct CINDEX_SLOT
+{
+   uint32_t Prev; /** Index of previous slot, CINDEX_FREE if recycled */
+   uint32_t Next; /** Index of next slot or next recycled slot       */
+} CINDEX_SLOT;
+
+
+/** Index that links to nothing. Slot 0 is reserved for it. */
+#define CINDEX_NONE 0U
+
+/** Prev of recycled slots. Also the limit of the number of slots. */
+#define CINDEX_FREE UINT32_MAX
+
+/** Number of slots of the first array. */
+#define CINDEX_INITIAL_CAPACITY 16U
+
+
+/** Index-linked list implementation of the CList protocol. */
+typedef struct CINDEX_LIST_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   CLIST     VTable;      /** API                 */
+
+   unsigned char* Slots;       /** Array of slots                          */
+   size_t         SlotSize;    /** Distance between slots                  */
+   size_t         ElementSize; /** Size of every element                   */
+   uint32_t       Capacity;    /** Number of slots in the array            */
+   uint32_t       Used;        /** Number of slots ever used, with slot 0  */
+   uint32_t       FreeHead;    /** First recycled slot                     */
+   uint32_t       Head;        /** Index of the first slot in the list     */
+   uint32_t       Tail;        /** Index of the last slot in the list      */
+   size_t         Size;        /** Number of elements                      */
+   void*          RefData;     /** Target of the link of GetRefToData      */
+} CINDEX_LIST_IMPL;
+
+
+/** Unique identificator for CINDEX_LIST_IMPL */
+#define CINDEX_LIST_IMPL_STRUCT_ID \
+   STRUCT_ID_64('C', 'I', 'N', 'D', 'E', 'X', '.', '.')
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Returns the slot with the Index.
+ *
+ * @param[in]  List   List
+ * @param[in]  Index  Slot index
+ *
+ * @return  Slot
+ */
+static
+CINDEX_SLOT*
+InGetSlot(
+   IN CINDEX_LIST_IMPL* List,
+   IN uint32_t          Index)
+{
+   return (CINDEX_SLOT*)(List->Slots + Index * List->SlotSize);
+}
+
+
+/**
+ * Returns the element stored in the slot with the Index.
+ *
+ * @param[in]  List   List
+ * @param[in]  Index  Slot index
+ *
+ * @return  Pointer to the element
+ */
+static
+void*
+InGetData(
+   IN CINDEX_LIST_IMPL* List,
+   IN uint32_t          Index)
+{
+   return (unsigned char*)InGetSlot(List, Index) + sizeof(CINDEX_SLOT);
+}
+
+
+/**
+ * Converts the slot Index into a CLIST_NODE handle.
+ *
+ * @param[in]  Index  Slot index
+ *
+ * @return  Handle, NULL for CINDEX_NONE
+ */
+static
+CLIST_NODE*
+InToHandle(
+   IN uint32_t Index)
+{
+   return (CLIST_NODE*)(uintptr_t)Index;
+}
+
+
+/**
+ * Converts the CLIST_NODE handle into the index of a slot in use.
+ *
+ * @param[in]  List      List
+ * @param[in]  Position  Handle
+ *
+ * @return  Slot index, CINDEX_NONE if Position isn't an element of the List
+ */
+static
+uint32_t
+InToIndex(
+   IN CINDEX_LIST_IMPL* List,
+   IN CLIST_NODE*       Position)
+{
+   uintptr_t index = (uintptr_t)Position;
+
+   if ((CINDEX_NONE == index) || (index >= List->Used) ||
+       (CINDEX_FREE == InGetSlot(List, (uint32_t)index)->Prev))
+   {
+      return CINDEX_NONE;
+   }
+
+   return (uint32_t)index;
+}
+
+
+/**
+ * Makes sure that Count slots can be taken without growing the array.
+ *
+ * @param[in]  List   List
+ * @param[in]  Count  Number of slots
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InReserve(
+   IN CINDEX_LIST_IMPL* List,
+   IN size_t            Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      // Slot 0 is never given out
+      size_t available = (List->Capacity > 0) ? List->Capacity - 1 - List->Size : 0;
+      if (Count <= available) { break; }
+
+      size_t needed = (size_t)List->Capacity + (Count - available) +
+                      ((0 == List->Capacity) ? 1 : 0);
+      size_t capacity = (List->Capacity > 0) ? 2 * (size_t)List->Capacity :
+                                               CINDEX_INITIAL_CAPACITY;
+      if (capacity < needed) { capacity = needed; }
+      if (capacity > CINDEX_FREE) { capacity = CINDEX_FREE; }
+      if (capacity < needed) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      unsigned char* slots = realloc(List->Slots, capacity * List->SlotSize);
+      if (NULL == slots) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      List->Slots = slots;
+      List->Capacity = (uint32_t)capacity;
+      if (0 == List->Used) { List->Used = 1; }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Takes a reserved slot, a recycled one if there is any.
+ *
+ * @param[in]  List  List with a reserved slot
+ *
+ * @return  Slot index
+ */
+static
+uint32_t
+InTakeSlot(
+   IN CINDEX_LIST_IMPL* List)
+{
+   uint32_t index = List->FreeHead;
+
+   if (index != CINDEX_NONE)
+   {
+      List->FreeHead = InGetSlot(List, index)->Next;
+      return index;
+   }
+
+   return List->Used++;
+}
+
+
+/**
+ * Links the slot with the Index between Prev and Next slots.
+ *
+ * @param[in]  List   List
+ * @param[in]  Index  Slot index
+ * @param[in]  Prev   Index of previous slot or CINDEX_NONE
+ * @param[in]  Next   Index of next slot or CINDEX_NONE
+ */
+static
+void
+InLink(
+   IN CINDEX_LIST_IMPL* List,
+   IN uint32_t          Index,
+   IN uint32_t          Prev,
+   IN uint32_t          Next)
+{
+   CINDEX_SLOT* slot = InGetSlot(List, Index);
+   slot->Prev = Prev;
+   slot->Next = Next;
+
+   if (Prev != CINDEX_NONE) { InGetSlot(List, Prev)->Next = Index; }
+   else                     { List->Head = Index; }
+
+   if (Next != CINDEX_NONE) { InGetSlot(List, Next)->Prev = Index; }
+   else                     { List->Tail = Index; }
+
+   ++List->Size;
+}
+
+
+/**
+ * Unlinks the slot with the Index and puts it on the free list.
+ *
+ * @param[in]  List   List
+ * @param[in]  Index  Index of a slot in the list
+ */
+static
+void
+InRemove(
+   IN CINDEX_LIST_IMPL* List,
+   IN uint32_t          Index)
+{
+   CINDEX_SLOT* slot = InGetSlot(List, Index);
+
+   if (slot->Prev != CINDEX_NONE) { InGetSlot(List, slot->Prev)->Next = slot->Next; }
+   else                           { List->Head = slot->Next; }
+
+   if (slot->Next != CINDEX_NONE) { InGetSlot(List, slot->Next)->Prev = slot->Prev; }
+   else                           { List->Tail = slot->Prev; }
+
+   --List->Size;
+
+   slot->Prev = CINDEX_FREE;
+   slot->Next = List->FreeHead;
+   List->FreeHead = Index;
+}
+
+
+/**
+ * Copies Count records into new slots between Prev and Next slots.
+ *
+ * @param[in]  List     List
+ * @param[in]  Prev     Index of previous slot or CINDEX_NONE
+ * @param[in]  Next     Index of next slot or CINDEX_NONE
+ * @param[in]  Records  Array of records of ElementSize bytes
+ * @param[in]  Stride   Distance between records
+ * @param[in]  Count    Number of records
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InInsert(
+   IN CINDEX_LIST_IMPL* List,
+   IN uint32_t          Prev,
+   IN uint32_t          Next,
+   IN void*             Records,
+   IN size_t            Stride,
+   IN size_t            Count)
+{
+   STATUS_CODE status = InReserve(List, Count);
+   if (SC_ERROR(status)) { return status; }
+
+   const unsigned char* record = Records;
+   for (size_t i = 0; i < Count; ++i, record += Stride)
+   {
+      uint32_t index = InTakeSlot(List);
+      memcpy(InGetData(List, index), record, List->ElementSize);
+      InLink(List, index, Prev, Next);
+      Prev = index;
+   }
+
+   return status;
+}
+
+
+/**
+ * Copies the element of the slot with the Index into a new malloc buffer
+ * and removes the slot.
+ *
+ * @param[in]   List      List
+ * @param[in]   Index     Index of a slot in the list
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InTake(
+   IN  CINDEX_LIST_IMPL* List,
+   IN  uint32_t          Index,
+   OUT void**            Data,
+   OUT size_t*           DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      *Data = malloc(List->ElementSize);
+      if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(*Data, InGetData(List, Index), List->ElementSize);
+      *DataSize = List->ElementSize;
+      InRemove(List, Index);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates an empty list.
+ *
+ * @param[in]  ElementSize  Size of every element
+ *
+ * @retval  CINDEX_LIST_IMPL*  If the list is successfully created
+ * @retval  NULL               On failure
+ */
+static
+CINDEX_LIST_IMPL*
+InCreateList(
+   IN size_t ElementSize);
+
+
+/**
+ * Moves the elements after the slot with the Index to the end of the
+ * Other list, copying them.
+ *
+ * @param[in]  List   List
+ * @param[in]  Index  Slot index, CINDEX_NONE to move all elements
+ * @param[in]  Other  Compatible list, not List
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, lists are unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InMoveAfter(
+   IN CINDEX_LIST_IMPL* List,
+   IN uint32_t          Index,
+   IN CINDEX_LIST_IMPL* Other)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      uint32_t first = (Index != CINDEX_NONE) ? InGetSlot(List, Index)->Next : List->Head;
+
+      size_t count = 0;
+      for (uint32_t i = first; i != CINDEX_NONE; i = InGetSlot(List, i)->Next) { ++count; }
+
+      status = InReserve(Other, count);
+      if (SC_ERROR(status)) { break; }
+
+      while (first != CINDEX_NONE)
+      {
+         uint32_t next = InGetSlot(List, first)->Next;
+         uint32_t index = InTakeSlot(Other);
+
+         memcpy(InGetData(Other, index), InGetData(List, first), List->ElementSize);
+         InLink(Other, index, Other->Tail, CINDEX_NONE);
+         InRemove(List, first);
+
+         first = next;
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+///////////////////////////////////////////////////////////
+///            CIndexList API implementation            ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Creates a node at the beginning of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size, equal to the element size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListPushFront(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if ((NULL == Data) || (DataSize != this->ElementSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, CINDEX_NONE, this->Head, Data, DataSize, 1);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size, equal to the element size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListPushBack(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if ((NULL == Data) || (DataSize != this->ElementSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, this->Tail, CINDEX_NONE, Data, DataSize, 1);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the first node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  The first node or NULL if the list is empty or This is invalid
+ */
+static
+CLIST_NODE*
+CIndexListFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      return InToHandle(this->Head);
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the last node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  The last node or NULL if the list is empty or This is invalid
+ */
+static
+CLIST_NODE*
+CIndexListBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      return InToHandle(this->Tail);
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Removes the first node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CIndexListPopFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if (this->Head != CINDEX_NONE) { InRemove(this, this->Head); }
+   } while (false);
+}
+
+
+/**
+ * Removes the last node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CIndexListPopBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if (this->Tail != CINDEX_NONE) { InRemove(this, this->Tail); }
+   } while (false);
+}
+
+
+/**
+ * Removes the Position node from the list, its slot is recycled.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListRemove(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if (CINDEX_NONE == index) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      InRemove(this, index);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes all nodes from the list. The array is kept for new elements.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListClear(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+
+      // Slot 0 stays reserved, all other slots become unused
+      this->Used = (this->Capacity > 0) ? 1 : 0;
+      this->FreeHead = this->Head = this->Tail = CINDEX_NONE;
+      this->Size = 0;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the node following the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  The next node or NULL
+ */
+static
+CLIST_NODE*
+CIndexListNext(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if (CINDEX_NONE == index) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      return InToHandle(InGetSlot(this, index)->Next);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the node preceding the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  The previous node or NULL
+ */
+static
+CLIST_NODE*
+CIndexListPrev(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if (CINDEX_NONE == index) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      return InToHandle(InGetSlot(this, index)->Prev);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Gets a link to the data stored in the Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Triple pointer to data
+ * @param[in]  DataSize  Pointer to pointer to data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListGetRefToData(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void***     Data,
+   IN size_t**    DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if ((CINDEX_NONE == index) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      this->RefData = InGetData(this, index);
+      *Data = &this->RefData;
+      *DataSize = &this->ElementSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Gets a copy of the data stored in the Position node. The copy is
+ * allocated with malloc and released by the caller.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[in]   Position  Position in the list
+ * @param[out]  Data      Copy of the data
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListGetCopyData(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void**      Data,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if ((CINDEX_NONE == index) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      *Data = malloc(this->ElementSize);
+      if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(*Data, InGetData(this, index), this->ElementSize);
+      *DataSize = this->ElementSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node before the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size, equal to the element size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListInsertBefore(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Data,
+   IN size_t      DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if ((CINDEX_NONE == index) || (NULL == Data) || (DataSize != this->ElementSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, InGetSlot(this, index)->Prev, index, Data, DataSize, 1);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node after the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size, equal to the element size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListInsertAfter(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Data,
+   IN size_t      DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if ((CINDEX_NONE == index) || (NULL == Data) || (DataSize != this->ElementSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, index, InGetSlot(this, index)->Next, Data, DataSize, 1);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the number of nodes in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  Number of nodes, 0 if This is invalid
+ */
+static
+size_t
+CIndexListSize(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      return this->Size;
+   } while (false);
+
+   return 0;
+}
+
+
+/**
+ * Copies the Data buffer to the beginning of the list and releases it
+ * with free.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Buffer allocated with malloc
+ * @param[in]  DataSize  Data size, equal to the element size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, Data stays with the caller
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListPushFrontTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = CIndexListPushFront(This, Data, DataSize);
+   if (!SC_ERROR(status)) { free(Data); }
+
+   return status;
+}
+
+
+/**
+ * Copies the Data buffer to the end of the list and releases it with free.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Buffer allocated with malloc
+ * @param[in]  DataSize  Data size, equal to the element size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, Data stays with the caller
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListPushBackTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = CIndexListPushBack(This, Data, DataSize);
+   if (!SC_ERROR(status)) { free(Data); }
+
+   return status;
+}
+
+
+/**
+ * Removes the first node and returns its data in a malloc buffer.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListPopFrontTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (CINDEX_NONE == this->Head) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      status = InTake(this, this->Head, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the last node and returns its data in a malloc buffer.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListPopBackTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (CINDEX_NONE == this->Tail) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      status = InTake(this, this->Tail, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Copies the data stored in the Position node into the caller's Buffer.
+ *
+ * @param[in]   This        Pointer to CList protocol
+ * @param[in]   Position    Position in the list
+ * @param[out]  Buffer      Buffer for the data
+ * @param[in]   BufferSize  Buffer size
+ * @param[out]  DataSize    Data size, also set if the buffer is too small
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_BUFFER_TOO_SMALL   BufferSize is less than the data size
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListGetCopyDataInto(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void*       Buffer,
+   IN  size_t      BufferSize,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if ((CINDEX_NONE == index) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      *DataSize = this->ElementSize;
+      if ((NULL == Buffer) || (BufferSize < this->ElementSize))
+      {
+         SET_SC(SC_BUFFER_TOO_SMALL);
+         break;
+      }
+
+      memcpy(Buffer, InGetData(this, index), this->ElementSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes for Count records at the beginning of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record, equal to the element size
+ * @param[in]  Stride    Distance between records
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListPushFrontBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if ((NULL == Records) || (DataSize != this->ElementSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, CINDEX_NONE, this->Head, Records, Stride, Count);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes for Count records at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record, equal to the element size
+ * @param[in]  Stride    Distance between records
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListPushBackBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if ((NULL == Records) || (DataSize != this->ElementSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, this->Tail, CINDEX_NONE, Records, Stride, Count);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes for Count records after the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record, equal to the element size
+ * @param[in]  Stride    Distance between records
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListInsertAfterBatch(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Records,
+   IN size_t      DataSize,
+   IN size_t      Stride,
+   IN size_t      Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if ((CINDEX_NONE == index) || (NULL == Records) ||
+          (DataSize != this->ElementSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, index, InGetSlot(this, index)->Next, Records, Stride, Count);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Moves the nodes after Position into a new list, copying them.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  On success, returns the pointer to the new list. On failure,
+ *          returns a NULL pointer and This list is unchanged.
+ */
+static
+CLIST*
+CIndexListSplitAfter(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      uint32_t index = InToIndex(this, Position);
+      if (CINDEX_NONE == index) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CINDEX_LIST_IMPL* other = InCreateList(this->ElementSize);
+      if (NULL == other) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      status = InMoveAfter(this, index, other);
+      if (SC_ERROR(status))
+      {
+         CIndexListDelete(&other->VTable);
+         break;
+      }
+
+      return &other->VTable;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Moves all nodes of the Other list to the end of This list, copying them.
+ *
+ * @param[in]  This   Pointer to CList protocol
+ * @param[in]  Other  Index list with the same element size, not This
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or the lists
+ *                                are incompatible
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, lists are unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListAppend(
+   IN CLIST* This,
+   IN CLIST* Other)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      CINDEX_LIST_IMPL* other = GET_STRUCT_FIELD(Other, CINDEX_LIST_IMPL, VTable);
+      if ((NULL == other) || (other->StructureId != CINDEX_LIST_IMPL_STRUCT_ID) ||
+          (other == this) || (other->ElementSize != this->ElementSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InMoveAfter(other, CINDEX_NONE, this);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Sorts the list by relinking the slots. The sort is stable.
+ *
+ * @param[in]  This        Pointer to CList protocol
+ * @param[in]  Comparator  Comparator of the node data
+ * @param[in]  Context     Context for the Comparator, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIndexListSort(
+   IN          CLIST*           This,
+   IN          CLIST_COMPARATOR Comparator,
+   IN OPTIONAL void*            Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINDEX_LIST_IMPL);
+      if (NULL == Comparator) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      size_t size = this->Size;
+      if (size < 2) { break; }
+
+      uint32_t* indices = malloc(2 * size * sizeof(uint32_t));
+      if (NULL == indices) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      size_t count = 0;
+      for (uint32_t i = this->Head; i != CINDEX_NONE; i = InGetSlot(this, i)->Next)
+      {
+         indices[count++] = i;
+      }
+
+      // Bottom-up merge sort, the left run wins among equivalent elements
+      size_t elementSize = this->ElementSize;
+      uint32_t* from = indices;
+      uint32_t* to = indices + size;
+      for (size_t width = 1; width < size; width *= 2)
+      {
+         for (size_t begin = 0; begin < size; begin += 2 * width)
+         {
+            size_t middle = (begin + width < size) ? begin + width : size;
+            size_t end = (begin + 2 * width < size) ? begin + 2 * width : size;
+            size_t left = begin;
+            size_t right = middle;
+
+            for (size_t i = begin; i < end; ++i)
+            {
+               if ((left < middle) &&
+                   ((right >= end) ||
+                    (Comparator(InGetData(this, from[right]), elementSize,
+                                InGetData(this, from[left]), elementSize,
+                                Context) >= 0)))
+               {
+                  to[i] = from[left++];
+               }
+               else
+               {
+                  to[i] = from[right++];
+               }
+            }
+         }
+
+         uint32_t* swap = from;
+         from = to;
+         to = swap;
+      }
+
+      for (size_t i = 0; i < size; ++i)
+      {
+         CINDEX_SLOT* slot = InGetSlot(this, from[i]);
+         slot->Prev = (i > 0) ? from[i - 1] : CINDEX_NONE;
+         slot->Next = (i + 1 < size) ? from[i + 1] : CINDEX_NONE;
+      }
+
+      this->Head = from[0];
+      this->Tail = from[size - 1];
+
+      free(indices);
+
+   } while (false);
+
+   return status;
+}
+
+
+static
+CINDEX_LIST_IMPL*
+InCreateList(
+   IN size_t ElementSize)
+{
+   CINDEX_LIST_IMPL* this = malloc(sizeof(CINDEX_LIST_IMPL));
+   if (NULL == this) { return NULL; }
+
+   // Elements are aligned like the links and the slots
+   size_t alignment = sizeof(void*);
+
+   this->StructureId = CINDEX_LIST_IMPL_STRUCT_ID;
+   this->Slots = NULL;
+   this->SlotSize = sizeof(CINDEX_SLOT) +
+                    (ElementSize + alignment - 1) / alignment * alignment;
+   this->ElementSize = ElementSize;
+   this->Capacity = 0;
+   this->Used = 0;
+   this->FreeHead = CINDEX_NONE;
+   this->Head = this->Tail = CINDEX_NONE;
+   this->Size = 0;
+   this->RefData = NULL;
+
+   this->VTable.PushFront    = CIndexListPushFront;
+   this->VTable.PushBack     = CIndexListPushBack;
+   this->VTable.Front        = CIndexListFront;
+   this->VTable.Back         = CIndexListBack;
+   this->VTable.PopFront     = CIndexListPopFront;
+   this->VTable.PopBack      = CIndexListPopBack;
+   this->VTable.Next         = CIndexListNext;
+   this->VTable.Prev         = CIndexListPrev;
+   this->VTable.GetRefToData = CIndexListGetRefToData;
+   this->VTable.GetCopyData  = CIndexListGetCopyData;
+   this->VTable.InsertBefore = CIndexListInsertBefore;
+   this->VTable.InsertAfter  = CIndexListInsertAfter;
+   this->VTable.Size         = CIndexListSize;
+   this->VTable.Remove       = CIndexListRemove;
+   this->VTable.Clear        = CIndexListClear;
+
+   this->VTable.PushFrontTake   = CIndexListPushFrontTake;
+   this->VTable.PushBackTake    = CIndexListPushBackTake;
+   this->VTable.PopFrontTake    = CIndexListPopFrontTake;
+   this->VTable.PopBackTake     = CIndexListPopBackTake;
+   this->VTable.GetCopyDataInto = CIndexListGetCopyDataInto;
+
+   this->VTable.PushFrontBatch   = CIndexListPushFrontBatch;
+   this->VTable.PushBackBatch    = CIndexListPushBackBatch;
+   this->VTable.InsertAfterBatch = CIndexListInsertAfterBatch;
+
+   this->VTable.Splice     = NULL;
+   this->VTable.SplitAfter = CIndexListSplitAfter;
+   this->VTable.Append     = CIndexListAppend;
+
+   this->VTable.Sort         = CIndexListSort;
+   this->VTable.SortParallel = NULL;
+
+   this->VTable.ForEach   = NULL;
+   this->VTable.NextBatch = NULL;
+
+   this->VTable.ParallelForEach = NULL;
+   this->VTable.ParallelReduce  = NULL;
+
+   this->VTable.GetStats = NULL;
+
+   this->VTable.Compact = NULL;
+
+   return this;
+}
+
+
+CLIST*
+CIndexListCreate(
+   IN size_t ElementSize)
+{
+   if (0 == ElementSize) { return NULL; }
+
+   CINDEX_LIST_IMPL* this = InCreateList(ElementSize);
+   if (NULL == this) { return NULL; }
+
+   return &this->VTable;
+}
+
+
+void
+CIndexListDelete(
+   IN OPTIONAL CLIST* This)
+{
+   CINDEX_LIST_IMPL* this = GET_STRUCT_FIELD(This, CINDEX_LIST_IMPL, VTable);
+   if ((NULL == this) || (this->StructureId != CINDEX_LIST_IMPL_STRUCT_ID)) { return; }
+
+   this->StructureId = 0;
+   free(this->Slots);
+   free(this);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file     CIndexList.h
+ * @brief    Index-linked doubly linked list implementation of the CList protocol.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#ifndef  __CINDEX_LIST_H__
+#define  __CINDEX_LIST_H__
+
+#include "Include/CList.h"
+
+
+/**
+ * Creates a doubly linked list of ElementSize-byte elements that keeps all
+ * nodes in one growable array and links them by 32-bit slot indices.
+ *
+ * A slot holds two links and the element, removed slots are recycled
+ * through a free list. CLIST_NODE handles are slot indices, not addresses:
+ *    - Handles stay valid until their element is removed, also when the
+ *      array grows;
+ *    - Pointers into the data are invalidated by any insertion, which may
+ *      grow the array;
+ *    - DataSize passed to the list methods must be equal to ElementSize,
+ *      the data is aligned to sizeof(void*);
+ *    - GetRefToData links to a field of the list that points to the data,
+ *      the link is valid until the next call of GetRefToData. The data may
+ *      be modified in place, but *Data and *DataSize must not be changed;
+ *    - SplitAfter and Append copy the moved elements into the other array,
+ *      the handles of the moved elements are invalidated;
+ *    - Sort relinks the slots and keeps all handles valid;
+ *    - Splice, SortParallel, ForEach, NextBatch, ParallelForEach,
+ *      ParallelReduce, GetStats and Compact are not supported and are set
+ *      to NULL.
+ *
+ * @param[in]  ElementSize  Size of every element of the list
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, returns a NULL pointer.
+ */
+CLIST*
+CIndexListCreate(
+   IN size_t ElementSize);
+
+
+/**
+ * Releases the list created by CIndexListCreate.
+ *
+ * @param[in]  This  Pointer to CList protocol. NULL is ignored.
+ */
+void
+CIndexListDelete(
+   IN OPTIONAL CLIST* This);
+
+#endif  // __CINDEX_LIST_H__
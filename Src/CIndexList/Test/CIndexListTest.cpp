@@ -0,0 +1,413 @@
+/**
+ * @file  CIndexListTest.cpp
+ * @brief Unit Tests for the index-linked CLIST implementation
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <iterator>
+#include <list>
+#include <random>
+
+extern "C"
+{
+   #include "Include/CIndexList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                       Helpers                         //
+///////////////////////////////////////////////////////////
+
+/** Checks that the list holds the same values as the model in both directions. */
+static void InExpectEqual(CLIST* List, const std::list<size_t>& Model)
+{
+   ASSERT_TRUE(Model.size() == List->Size(List));
+
+   CLIST_NODE* position = List->Front(List);
+   for (size_t expected : Model)
+   {
+      ASSERT_TRUE(NULL != position);
+
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      ASSERT_FALSE(SC_ERROR(List->GetRefToData(List, position, &data, &dataSize)));
+      ASSERT_TRUE(sizeof(size_t) == *dataSize);
+      ASSERT_TRUE(expected == **((size_t**)data));
+
+      position = List->Next(List, position);
+   }
+   ASSERT_TRUE(NULL == position);
+
+   position = List->Back(List);
+   for (auto it = Model.rbegin(); it != Model.rend(); ++it)
+   {
+      ASSERT_TRUE(NULL != position);
+
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      ASSERT_FALSE(SC_ERROR(List->GetRefToData(List, position, &data, &dataSize)));
+      ASSERT_TRUE(*it == **((size_t**)data));
+
+      position = List->Prev(List, position);
+   }
+   ASSERT_TRUE(NULL == position);
+}
+
+
+///////////////////////////////////////////////////////////
+//                   CIndexList Fixtures                 //
+///////////////////////////////////////////////////////////
+
+struct CIndexListEmpty : public testing::Test
+{
+   CLIST* list = NULL;
+
+   // Per-test set-up
+   void SetUp() override
+   {
+      list = CIndexListCreate(sizeof(size_t));
+      ASSERT_FALSE(list == NULL);
+   }
+
+   // Per-test tear-down
+   void TearDown() override
+   {
+      CIndexListDelete(list);
+   }
+};
+
+
+///////////////////////////////////////////////////////////
+//                       Tests                           //
+///////////////////////////////////////////////////////////
+
+TEST_F(CIndexListEmpty, InvPrms)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   size_t data = 25;
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == CIndexListCreate(0));
+
+   status = list->PushFront(NULL, &data, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->PushBack(list, NULL, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->PushBack(list, &data, sizeof(uint32_t));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->InsertAfter(list, NULL, &data, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->InsertBefore(list, NULL, &data, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+
+   // Handles of slots that were never used are rejected
+   status = list->InsertAfter(list, (CLIST_NODE*)(uintptr_t)7, &data, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+
+   EXPECT_TRUE(NULL == list->Front(list));
+   EXPECT_TRUE(NULL == list->Back(list));
+   EXPECT_TRUE(0 == list->Size(list));
+   EXPECT_TRUE(NULL == list->Splice);
+}
+
+
+TEST_F(CIndexListEmpty, PushAndPop)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+
+   /*** Act && Assert ***/
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      if (i % 2 == 0)
+      {
+         ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+         model.push_back(i);
+      }
+      else
+      {
+         ASSERT_FALSE(SC_ERROR(list->PushFront(list, &i, sizeof(size_t))));
+         model.push_front(i);
+      }
+   }
+   InExpectEqual(list, model);
+
+   for (size_t i = 0; i < 300; ++i)
+   {
+      list->PopFront(list);
+      model.pop_front();
+      list->PopBack(list);
+      model.pop_back();
+   }
+   InExpectEqual(list, model);
+
+   while (!model.empty())
+   {
+      list->PopBack(list);
+      model.pop_back();
+   }
+   InExpectEqual(list, model);
+   list->PopFront(list);
+   list->PopBack(list);
+   EXPECT_TRUE(0 == list->Size(list));
+}
+
+
+TEST_F(CIndexListEmpty, HandlesSurviveGrowthAndRecycle)
+{
+   /*** Arrange ***/
+   size_t value = 42;
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &value, sizeof(size_t))));
+   CLIST_NODE* first = list->Front(list);
+
+   /*** Act ***/
+   // The array grows many times, the first handle has to stay valid
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+   }
+
+   /*** Assert ***/
+   size_t copy = 0;
+   size_t copySize = 0;
+   ASSERT_FALSE(SC_ERROR(list->GetCopyDataInto(list, first, &copy, sizeof(copy), &copySize)));
+   EXPECT_TRUE(42 == copy);
+
+   // A removed handle is rejected, and its slot is reused by the next push
+   CLIST_NODE* back = list->Back(list);
+   list->PopBack(list);
+   EXPECT_TRUE(NULL == list->Next(list, back));
+   ASSERT_FALSE(SC_ERROR(list->PushFront(list, &value, sizeof(size_t))));
+   EXPECT_TRUE(back == list->Front(list));
+   EXPECT_TRUE(1001 == list->Size(list));
+}
+
+
+TEST_F(CIndexListEmpty, RemoveAndClear)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+   for (size_t i = 0; i < 10; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      model.push_back(i);
+   }
+   CLIST_NODE* middle = list->Next(list, list->Front(list));
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, NULL)));
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, middle)));
+   model.erase(std::next(model.begin()));
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, list->Back(list))));
+   model.pop_back();
+   InExpectEqual(list, model);
+
+   // The removed handle is rejected until its slot is reused
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, middle)));
+
+   CLIST_NODE* front = list->Front(list);
+   EXPECT_TRUE(SC_ERROR(list->Clear(NULL)));
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+   model.clear();
+   InExpectEqual(list, model);
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, front)));
+
+   // The slots are given out again from the beginning of the array
+   size_t value = 42;
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &value, sizeof(size_t))));
+   model.push_back(value);
+   EXPECT_TRUE(front == list->Front(list));
+   InExpectEqual(list, model);
+}
+
+
+TEST_F(CIndexListEmpty, RandomOperations)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+   std::mt19937 random(25);
+
+   /*** Act && Assert ***/
+   for (size_t i = 0; i < 5000; ++i)
+   {
+      size_t index = model.empty() ? 0 : random() % model.size();
+      CLIST_NODE* position = list->Front(list);
+      for (size_t j = 0; j < index; ++j) { position = list->Next(list, position); }
+
+      switch (random() % 5)
+      {
+         case 0:
+            ASSERT_FALSE(SC_ERROR(list->PushFront(list, &i, sizeof(size_t))));
+            model.push_front(i);
+            break;
+         case 1:
+            ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+            model.push_back(i);
+            break;
+         case 2:
+            if (model.empty()) { break; }
+            ASSERT_FALSE(SC_ERROR(list->InsertBefore(list, position, &i, sizeof(size_t))));
+            model.insert(std::next(model.begin(), index), i);
+            break;
+         case 3:
+            if (model.empty()) { break; }
+            ASSERT_FALSE(SC_ERROR(list->InsertAfter(list, position, &i, sizeof(size_t))));
+            model.insert(std::next(model.begin(), index + 1), i);
+            break;
+         default:
+            if (model.empty()) { break; }
+            if (random() % 2 == 0) { list->PopFront(list); model.pop_front(); }
+            else                   { list->PopBack(list); model.pop_back(); }
+            break;
+      }
+   }
+
+   /*** Assert ***/
+   InExpectEqual(list, model);
+}
+
+
+TEST_F(CIndexListEmpty, Take)
+{
+   /*** Arrange ***/
+   size_t* buffer = (size_t*)malloc(sizeof(size_t));
+   ASSERT_FALSE(NULL == buffer);
+   *buffer = 25;
+
+   /*** Act ***/
+   STATUS_CODE status = list->PushBackTake(list, buffer, sizeof(size_t));
+   ASSERT_FALSE(SC_ERROR(status));
+
+   void* data = NULL;
+   size_t dataSize = 0;
+   status = list->PopFrontTake(list, &data, &dataSize);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(sizeof(size_t) == dataSize);
+   EXPECT_TRUE(25 == *(size_t*)data);
+   EXPECT_TRUE(0 == list->Size(list));
+   free(data);
+
+   status = list->PopBackTake(list, &data, &dataSize);
+   EXPECT_TRUE(SC_CODE(status) == SC_CODE(SC_UNSUCCESSFUL));
+}
+
+
+TEST_F(CIndexListEmpty, Batch)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   std::list<size_t> model;
+   size_t records[1000];
+   for (size_t i = 0; i < 1000; ++i) { records[i] = i; }
+
+   /*** Act ***/
+   // Every other element of the first half, stored with a stride
+   status = list->PushBackBatch(list, &records[0], sizeof(size_t),
+                                2 * sizeof(size_t), 250);
+   ASSERT_FALSE(SC_ERROR(status));
+   for (size_t i = 0; i < 500; i += 2) { model.push_back(i); }
+
+   status = list->PushFrontBatch(list, &records[500], sizeof(size_t),
+                                 sizeof(size_t), 200);
+   ASSERT_FALSE(SC_ERROR(status));
+   model.insert(model.begin(), &records[500], &records[700]);
+
+   CLIST_NODE* position = list->Front(list);
+   for (size_t i = 0; i < 150; ++i) { position = list->Next(list, position); }
+   status = list->InsertAfterBatch(list, position, &records[700],
+                                   sizeof(size_t), sizeof(size_t), 300);
+   ASSERT_FALSE(SC_ERROR(status));
+   model.insert(std::next(model.begin(), 151), &records[700], &records[1000]);
+
+   /*** Assert ***/
+   InExpectEqual(list, model);
+}
+
+
+TEST_F(CIndexListEmpty, SplitAfterAndAppend)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      model.push_back(i);
+   }
+
+   CLIST_NODE* position = list->Front(list);
+   for (size_t i = 0; i < 300; ++i) { position = list->Next(list, position); }
+
+   /*** Act ***/
+   CLIST* tail = list->SplitAfter(list, position);
+   ASSERT_FALSE(NULL == tail);
+
+   /*** Assert ***/
+   std::list<size_t> tailModel;
+   tailModel.splice(tailModel.begin(), model, std::next(model.begin(), 301), model.end());
+   InExpectEqual(list, model);
+   InExpectEqual(tail, tailModel);
+
+   CLIST* other = CIndexListCreate(sizeof(uint32_t));
+   ASSERT_FALSE(NULL == other);
+   EXPECT_TRUE(SC_ERROR(list->Append(list, other)));
+   EXPECT_TRUE(SC_ERROR(list->Append(list, list)));
+   CIndexListDelete(other);
+
+   ASSERT_FALSE(SC_ERROR(list->Append(list, tail)));
+   model.splice(model.end(), tailModel);
+   InExpectEqual(list, model);
+   InExpectEqual(tail, tailModel);
+
+   CIndexListDelete(tail);
+}
+
+
+TEST_F(CIndexListEmpty, Sort)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+   std::mt19937 random(25);
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      size_t value = random() % 100;
+      ASSERT_FALSE(SC_ERROR(list->PushFront(list, &value, sizeof(size_t))));
+      model.push_front(value);
+   }
+   CLIST_NODE* front = list->Front(list);
+   size_t frontValue = model.front();
+
+   auto compare = [](void* Left, size_t, void* Right, size_t, void*) -> int
+   {
+      size_t left = *(size_t*)Left;
+      size_t right = *(size_t*)Right;
+      return (left < right) ? -1 : (left > right) ? 1 : 0;
+   };
+
+   /*** Act ***/
+   STATUS_CODE status = list->Sort(list, compare, NULL);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   model.sort();
+   InExpectEqual(list, model);
+   EXPECT_TRUE(SC_ERROR(list->Sort(list, NULL, NULL)));
+
+   // Sort relinks the slots, the handle still refers to the same element
+   size_t copy = 0;
+   size_t copySize = 0;
+   ASSERT_FALSE(SC_ERROR(list->GetCopyDataInto(list, front, &copy, sizeof(copy), &copySize)));
+   EXPECT_TRUE(frontValue == copy);
+}
+
+
+int main(int argc, char** argv)
+{
+   ::testing::InitGoogleTest(&argc, argv);
+
+   return RUN_ALL_TESTS();
+}
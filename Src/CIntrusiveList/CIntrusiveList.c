@@ -0,0 +1,572 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     CIntrusiveList.c
+ * @brief    Intrusive doubly linked list implementation.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#include <stdlib.h>
+
+#include "Include/CIntrusiveList.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * CIntrusiveList protocol implementation. The links form a ring closed by
+ * Root, so linked links never have NULL neighbours.
+ */
+typedef struct CINTRUSIVE_LIST_IMPL
+{
+   STRUCT_ID       StructureId; /** Structure unique id */
+   CINTRUSIVE_LIST VTable;      /** API                 */
+
+   CINTRUSIVE_LINK Root; /** Sentinel link: Next is the head, Prev is the tail */
+   size_t          Size; /** Number of links */
+} CINTRUSIVE_LIST_IMPL;
+
+
+/** Unique identificator for CINTRUSIVE_LIST_IMPL */
+#define CINTRUSIVE_LIST_IMPL_STRUCT_ID \
+   STRUCT_ID_64('C', 'I', 'N', 'T', 'R', 'U', 'S', 'I')
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Checks whether the Link is in a list.
+ *
+ * @param[in]  Link  Link
+ *
+ * @return  true if the Link is linked
+ */
+static
+bool
+InIsLinked(
+   IN CINTRUSIVE_LINK* Link)
+{
+   return (Link->Next != NULL) && (Link->Prev != NULL);
+}
+
+
+/**
+ * Checks whether the Link is in the List. The root is not a link of it.
+ *
+ * @param[in]  List  Intrusive list
+ * @param[in]  Link  Link
+ *
+ * @return  true if the Link is linked into the List
+ */
+static
+bool
+InIsLinkOf(
+   IN CINTRUSIVE_LIST_IMPL* List,
+   IN CINTRUSIVE_LINK*      Link)
+{
+   return InIsLinked(Link) && (Link->Owner == &List->VTable);
+}
+
+
+/**
+ * Links the Link between Prev and Next.
+ *
+ * @param[in]  List  Intrusive list
+ * @param[in]  Prev  Link or root before the new link
+ * @param[in]  Link  Link to insert
+ */
+static
+void
+InLinkAfter(
+   IN CINTRUSIVE_LIST_IMPL* List,
+   IN CINTRUSIVE_LINK*      Prev,
+   IN CINTRUSIVE_LINK*      Link)
+{
+   Link->Prev = Prev;
+   Link->Next = Prev->Next;
+   Link->Owner = &List->VTable;
+   Prev->Next->Prev = Link;
+   Prev->Next = Link;
+
+   ++List->Size;
+}
+
+
+/**
+ * Unlinks the Link and marks it as not linked.
+ *
+ * @param[in]  List  Intrusive list
+ * @param[in]  Link  Link to remove
+ */
+static
+void
+InUnlink(
+   IN CINTRUSIVE_LIST_IMPL* List,
+   IN CINTRUSIVE_LINK*      Link)
+{
+   Link->Prev->Next = Link->Next;
+   Link->Next->Prev = Link->Prev;
+   Link->Prev = Link->Next = NULL;
+   Link->Owner = NULL;
+
+   --List->Size;
+}
+
+
+/**
+ * Converts a neighbour pointer to a public link, hiding the root.
+ *
+ * @param[in]  List  Intrusive list
+ * @param[in]  Link  Link or root
+ *
+ * @return  Link, or NULL if Link is the root
+ */
+static
+CINTRUSIVE_LINK*
+InGetLink(
+   IN CINTRUSIVE_LIST_IMPL* List,
+   IN CINTRUSIVE_LINK*      Link)
+{
+   return (Link != &List->Root) ? Link : NULL;
+}
+
+
+///////////////////////////////////////////////////////////
+///         CIntrusiveList API implementation           ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Links the Link at the head of the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ * @param[in]  Link  Unlinked link
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or Link is in a list
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIntrusiveListPushFront(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Link)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      if ((NULL == Link) || InIsLinked(Link))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      InLinkAfter(this, &this->Root, Link);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Links the Link at the end of the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ * @param[in]  Link  Unlinked link
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or Link is in a list
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIntrusiveListPushBack(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Link)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      if ((NULL == Link) || InIsLinked(Link))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      InLinkAfter(this, this->Root.Prev, Link);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Links the Link before the Position link.
+ *
+ * @param[in]  This      Pointer to CIntrusiveList protocol
+ * @param[in]  Position  Link in the list
+ * @param[in]  Link      Unlinked link
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter, Position isn't in
+ *                                this list or Link is in a list
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIntrusiveListInsertBefore(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Position,
+   IN CINTRUSIVE_LINK* Link)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      if ((NULL == Position) || !InIsLinkOf(this, Position) ||
+          (NULL == Link) || InIsLinked(Link))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      InLinkAfter(this, Position->Prev, Link);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Links the Link after the Position link.
+ *
+ * @param[in]  This      Pointer to CIntrusiveList protocol
+ * @param[in]  Position  Link in the list
+ * @param[in]  Link      Unlinked link
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter, Position isn't in
+ *                                this list or Link is in a list
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIntrusiveListInsertAfter(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Position,
+   IN CINTRUSIVE_LINK* Link)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      if ((NULL == Position) || !InIsLinkOf(this, Position) ||
+          (NULL == Link) || InIsLinked(Link))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      InLinkAfter(this, Position, Link);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Unlinks the Link from the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ * @param[in]  Link  Link in the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or Link isn't in this list
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CIntrusiveListRemove(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Link)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      if ((NULL == Link) || !InIsLinkOf(this, Link))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      InUnlink(this, Link);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Unlinks the first link of the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @retval  CINTRUSIVE_LINK*  Unlinked link
+ * @retval  NULL              If This is invalid or the list is empty
+ */
+static
+CINTRUSIVE_LINK*
+CIntrusiveListPopFront(
+   IN CINTRUSIVE_LIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+
+      CINTRUSIVE_LINK* link = InGetLink(this, this->Root.Next);
+      if (NULL == link) { break; }
+
+      InUnlink(this, link);
+      return link;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Unlinks the last link of the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @retval  CINTRUSIVE_LINK*  Unlinked link
+ * @retval  NULL              If This is invalid or the list is empty
+ */
+static
+CINTRUSIVE_LINK*
+CIntrusiveListPopBack(
+   IN CINTRUSIVE_LIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+
+      CINTRUSIVE_LINK* link = InGetLink(this, this->Root.Prev);
+      if (NULL == link) { break; }
+
+      InUnlink(this, link);
+      return link;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the first link in the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @retval  NULL              If This is invalid or the list is empty
+ * @retval  CINTRUSIVE_LINK*  List head
+ */
+static
+CINTRUSIVE_LINK*
+CIntrusiveListFront(
+   IN CINTRUSIVE_LIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      return InGetLink(this, this->Root.Next);
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the last link in the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @retval  NULL              If This is invalid or the list is empty
+ * @retval  CINTRUSIVE_LINK*  List tail
+ */
+static
+CINTRUSIVE_LINK*
+CIntrusiveListBack(
+   IN CINTRUSIVE_LIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      return InGetLink(this, this->Root.Prev);
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the next link in the list.
+ *
+ * @param[in]  This      Pointer to CIntrusiveList protocol
+ * @param[in]  Position  Link in the list
+ *
+ * @retval  CINTRUSIVE_LINK*  Next link
+ * @retval  NULL              If Invalid input parameter, Position isn't in
+ *                            this list or there is no next link
+ */
+static
+CINTRUSIVE_LINK*
+CIntrusiveListNext(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      if ((NULL == Position) || !InIsLinkOf(this, Position))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      return InGetLink(this, Position->Next);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the previous link in the list.
+ *
+ * @param[in]  This      Pointer to CIntrusiveList protocol
+ * @param[in]  Position  Link in the list
+ *
+ * @retval  CINTRUSIVE_LINK*  Previous link
+ * @retval  NULL              If Invalid input parameter, Position isn't in
+ *                            this list or there is no previous link
+ */
+static
+CINTRUSIVE_LINK*
+CIntrusiveListPrev(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      if ((NULL == Position) || !InIsLinkOf(this, Position))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      return InGetLink(this, Position->Prev);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the number of links.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @return  Number of links. If This is invalid then returns 0.
+ */
+static
+size_t
+CIntrusiveListSize(
+   IN CINTRUSIVE_LIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CINTRUSIVE_LIST_IMPL);
+      return this->Size;
+   } while (false);
+
+   return 0;
+}
+
+
+CINTRUSIVE_LIST*
+CIntrusiveListCreate()
+{
+   CINTRUSIVE_LIST_IMPL* this = malloc(sizeof(CINTRUSIVE_LIST_IMPL));
+   if (NULL == this) { return NULL; }
+
+   this->StructureId = CINTRUSIVE_LIST_IMPL_STRUCT_ID;
+   this->Root.Prev = this->Root.Next = &this->Root;
+   this->Root.Owner = NULL;
+   this->Size = 0;
+
+   this->VTable.PushFront    = CIntrusiveListPushFront;
+   this->VTable.PushBack     = CIntrusiveListPushBack;
+   this->VTable.InsertBefore = CIntrusiveListInsertBefore;
+   this->VTable.InsertAfter  = CIntrusiveListInsertAfter;
+   this->VTable.Remove       = CIntrusiveListRemove;
+   this->VTable.PopFront     = CIntrusiveListPopFront;
+   this->VTable.PopBack      = CIntrusiveListPopBack;
+   this->VTable.Front        = CIntrusiveListFront;
+   this->VTable.Back         = CIntrusiveListBack;
+   this->VTable.Next         = CIntrusiveListNext;
+   this->VTable.Prev         = CIntrusiveListPrev;
+   this->VTable.Size         = CIntrusiveListSize;
+
+   return &this->VTable;
+}
+
+
+void
+CIntrusiveListDelete(
+   IN OPTIONAL CINTRUSIVE_LIST* This)
+{
+   CINTRUSIVE_LIST_IMPL* this = GET_STRUCT_FIELD(This, CINTRUSIVE_LIST_IMPL, VTable);
+   if ((NULL == this) || (this->StructureId != CINTRUSIVE_LIST_IMPL_STRUCT_ID)) { return; }
+
+   // Links outlive the list, they are left ready for another list
+   while (this->Root.Next != &this->Root)
+   {
+      InUnlink(this, this->Root.Next);
+   }
+
+   this->StructureId = 0;
+   free(this);
+}
@@ -0,0 +1,271 @@
+/**
+ * @file     CIntrusiveList.h
+ * @brief    Intrusive doubly linked list protocol declaration.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#ifndef  __CINTRUSIVE_LIST_H__
+#define  __CINTRUSIVE_LIST_H__
+
+#include "Include/Misc.h"
+
+
+/**
+ * Link embedded into the objects stored in an intrusive list. The list
+ * never allocates or copies anything, it only relinks the embedded links.
+ * A link must be initialized with CINTRUSIVE_LINK_INIT before the first
+ * use and can belong to one list at a time. Methods that take a linked
+ * link reject links of other lists.
+ */
+typedef struct CINTRUSIVE_LINK
+{
+   struct CINTRUSIVE_LINK* Prev;  /** Previous link, NULL if not in a list */
+   struct CINTRUSIVE_LINK* Next;  /** Next link, NULL if not in a list     */
+   struct CINTRUSIVE_LIST* Owner; /** List of the link, NULL if not in a list */
+} CINTRUSIVE_LINK;
+
+
+/** Initializer of an unlinked CINTRUSIVE_LINK. */
+#define CINTRUSIVE_LINK_INIT { NULL, NULL, NULL }
+
+
+/**
+ * By pointer to the link(Link) get the pointer to the object(Type)
+ * that embeds it in the field(Field). Returns NULL if Link is NULL.
+ */
+#define CINTRUSIVE_LIST_GET_ENTRY(Link, Type, Field) \
+   (GET_STRUCT_FIELD(Link, Type, Field))
+
+
+/** Intrusive doubly linked list protocol. */
+typedef struct CINTRUSIVE_LIST CINTRUSIVE_LIST;
+
+
+/**
+ * Links the Link at the head of the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ * @param[in]  Link  Unlinked link
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or Link is in a list
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CINTRUSIVE_LIST_PUSH_FRONT)(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Link);
+
+
+/**
+ * Links the Link at the end of the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ * @param[in]  Link  Unlinked link
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or Link is in a list
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CINTRUSIVE_LIST_PUSH_BACK)(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Link);
+
+
+/**
+ * Links the Link before the Position link.
+ *
+ * @param[in]  This      Pointer to CIntrusiveList protocol
+ * @param[in]  Position  Link in the list
+ * @param[in]  Link      Unlinked link
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter, Position isn't in
+ *                                this list or Link is in a list
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CINTRUSIVE_LIST_INSERT_BEFORE)(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Position,
+   IN CINTRUSIVE_LINK* Link);
+
+
+/**
+ * Links the Link after the Position link.
+ *
+ * @param[in]  This      Pointer to CIntrusiveList protocol
+ * @param[in]  Position  Link in the list
+ * @param[in]  Link      Unlinked link
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter, Position isn't in
+ *                                this list or Link is in a list
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CINTRUSIVE_LIST_INSERT_AFTER)(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Position,
+   IN CINTRUSIVE_LINK* Link);
+
+
+/**
+ * Unlinks the Link from the list. The object that embeds it is untouched.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ * @param[in]  Link  Link in the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or Link isn't in this list
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CINTRUSIVE_LIST_REMOVE)(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Link);
+
+
+/**
+ * Unlinks the first link of the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @retval  CINTRUSIVE_LINK*  Unlinked link
+ * @retval  NULL              If This is invalid or the list is empty
+ */
+typedef
+CINTRUSIVE_LINK*
+(*CINTRUSIVE_LIST_POP_FRONT)(
+   IN CINTRUSIVE_LIST* This);
+
+
+/**
+ * Unlinks the last link of the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @retval  CINTRUSIVE_LINK*  Unlinked link
+ * @retval  NULL              If This is invalid or the list is empty
+ */
+typedef
+CINTRUSIVE_LINK*
+(*CINTRUSIVE_LIST_POP_BACK)(
+   IN CINTRUSIVE_LIST* This);
+
+
+/**
+ * Returns the first link in the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @retval  NULL              If This is invalid or the list is empty
+ * @retval  CINTRUSIVE_LINK*  List head
+ */
+typedef
+CINTRUSIVE_LINK*
+(*CINTRUSIVE_LIST_FRONT)(
+   IN CINTRUSIVE_LIST* This);
+
+
+/**
+ * Returns the last link in the list.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @retval  NULL              If This is invalid or the list is empty
+ * @retval  CINTRUSIVE_LINK*  List tail
+ */
+typedef
+CINTRUSIVE_LINK*
+(*CINTRUSIVE_LIST_BACK)(
+   IN CINTRUSIVE_LIST* This);
+
+
+/**
+ * Returns the next link in the list.
+ *
+ * @param[in]  This      Pointer to CIntrusiveList protocol
+ * @param[in]  Position  Link in the list
+ *
+ * @retval  CINTRUSIVE_LINK*  Next link
+ * @retval  NULL              If Invalid input parameter, Position isn't in
+ *                            this list or there is no next link
+ */
+typedef
+CINTRUSIVE_LINK*
+(*CINTRUSIVE_LIST_NEXT)(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Position);
+
+
+/**
+ * Returns the previous link in the list.
+ *
+ * @param[in]  This      Pointer to CIntrusiveList protocol
+ * @param[in]  Position  Link in the list
+ *
+ * @retval  CINTRUSIVE_LINK*  Previous link
+ * @retval  NULL              If Invalid input parameter, Position isn't in
+ *                            this list or there is no previous link
+ */
+typedef
+CINTRUSIVE_LINK*
+(*CINTRUSIVE_LIST_PREV)(
+   IN CINTRUSIVE_LIST* This,
+   IN CINTRUSIVE_LINK* Position);
+
+
+/**
+ * Returns the number of links.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol
+ *
+ * @return  Number of links. If This is invalid then returns 0.
+ */
+typedef
+size_t
+(*CINTRUSIVE_LIST_SIZE)(
+   IN CINTRUSIVE_LIST* This);
+
+
+/** Intrusive doubly linked list protocol. */
+typedef struct CINTRUSIVE_LIST
+{
+   CINTRUSIVE_LIST_PUSH_FRONT    PushFront;    /** Links at the beginning */
+   CINTRUSIVE_LIST_PUSH_BACK     PushBack;     /** Links at the end */
+   CINTRUSIVE_LIST_INSERT_BEFORE InsertBefore; /** Links before the specified link */
+   CINTRUSIVE_LIST_INSERT_AFTER  InsertAfter;  /** Links after the specified link */
+   CINTRUSIVE_LIST_REMOVE        Remove;       /** Unlinks the specified link */
+   CINTRUSIVE_LIST_POP_FRONT     PopFront;     /** Unlinks the first link */
+   CINTRUSIVE_LIST_POP_BACK      PopBack;      /** Unlinks the last link */
+   CINTRUSIVE_LIST_FRONT         Front;        /** Returns the first link */
+   CINTRUSIVE_LIST_BACK          Back;         /** Returns the last link */
+   CINTRUSIVE_LIST_NEXT          Next;         /** Returns the next link */
+   CINTRUSIVE_LIST_PREV          Prev;         /** Returns the previous link */
+   CINTRUSIVE_LIST_SIZE          Size;         /** Returns the number of links */
+} CINTRUSIVE_LIST;
+
+
+/**
+ * Creates an intrusive doubly linked list protocol.
+ *
+ * @return  On success, returns the pointer to intrusive list protocol.
+ *          On failure, returns a NULL pointer.
+ */
+CINTRUSIVE_LIST*
+CIntrusiveListCreate();
+
+
+/**
+ * Releases the list created by CIntrusiveListCreate. Links still in the
+ * list are unlinked, the objects that embed them are untouched.
+ *
+ * @param[in]  This  Pointer to CIntrusiveList protocol. NULL is ignored.
+ */
+void
+CIntrusiveListDelete(
+   IN OPTIONAL CINTRUSIVE_LIST* This);
+
+#endif  // __CINTRUSIVE_LIST_H__
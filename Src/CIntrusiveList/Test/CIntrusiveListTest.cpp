@@ -0,0 +1,203 @@
+/**
+ * @file  CIntrusiveListTest.cpp
+ * @brief Unit Tests for CINTRUSIVE_LIST
+ */
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CIntrusiveList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                CIntrusiveList Fixtures                //
+///////////////////////////////////////////////////////////
+
+/** Object owned by the test that embeds a link. */
+struct Record
+{
+   size_t          Key;
+   CINTRUSIVE_LINK Link;
+   double          Value;
+};
+
+
+struct CIntrusiveListTen : public testing::Test
+{
+   CINTRUSIVE_LIST* list = NULL;
+   Record records[10];
+
+   // Per-test set-up
+   void SetUp() override
+   {
+      list = CIntrusiveListCreate();
+      ASSERT_FALSE(list == NULL);
+
+      for (size_t i = 0; i < 10; ++i)
+      {
+         records[i].Key = i;
+         records[i].Link = CINTRUSIVE_LINK_INIT;
+         records[i].Value = i * 0.5;
+         ASSERT_FALSE(SC_ERROR(list->PushBack(list, &records[i].Link)));
+      }
+   }
+
+   // Per-test tear-down
+   void TearDown() override
+   {
+      CIntrusiveListDelete(list);
+   }
+
+   /** Returns keys of the list in order. */
+   std::vector<size_t> Keys()
+   {
+      std::vector<size_t> keys;
+      for (CINTRUSIVE_LINK* link = list->Front(list);
+           link != NULL;
+           link = list->Next(list, link))
+      {
+         keys.push_back(CINTRUSIVE_LIST_GET_ENTRY(link, Record, Link)->Key);
+      }
+      return keys;
+   }
+};
+
+
+///////////////////////////////////////////////////////////
+//                        Tests                          //
+///////////////////////////////////////////////////////////
+
+TEST(CIntrusiveListCreate, Empty)
+{
+   /*** Arrange ***/
+   CINTRUSIVE_LIST* list = CIntrusiveListCreate();
+   ASSERT_FALSE(NULL == list);
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == list->Front(list));
+   EXPECT_TRUE(NULL == list->Back(list));
+   EXPECT_TRUE(NULL == list->PopFront(list));
+   EXPECT_TRUE(NULL == list->PopBack(list));
+   EXPECT_TRUE(0 == list->Size(list));
+   EXPECT_TRUE(NULL == CINTRUSIVE_LIST_GET_ENTRY(list->Front(list), Record, Link));
+
+   CIntrusiveListDelete(list);
+   CIntrusiveListDelete(NULL);
+}
+
+
+TEST_F(CIntrusiveListTen, InvPrms)
+{
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->PushBack(NULL, NULL)));
+   EXPECT_TRUE(SC_ERROR(list->PushBack(list, NULL)));
+
+   // Already linked
+   EXPECT_TRUE(SC_ERROR(list->PushFront(list, &records[3].Link)));
+   EXPECT_TRUE(SC_ERROR(list->InsertAfter(list, &records[0].Link, &records[3].Link)));
+
+   // Not linked
+   CINTRUSIVE_LINK link = CINTRUSIVE_LINK_INIT;
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, &link)));
+   EXPECT_TRUE(SC_ERROR(list->InsertBefore(list, &link, &link)));
+   EXPECT_TRUE(NULL == list->Next(list, &link));
+
+   EXPECT_TRUE(10 == list->Size(list));
+}
+
+
+TEST_F(CIntrusiveListTen, RejectsLinksOfOtherList)
+{
+   /*** Arrange ***/
+   CINTRUSIVE_LIST* other = CIntrusiveListCreate();
+   ASSERT_FALSE(NULL == other);
+   Record record = { 10, CINTRUSIVE_LINK_INIT, 5.0 };
+   ASSERT_FALSE(SC_ERROR(other->PushBack(other, &record.Link)));
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, &record.Link)));
+   EXPECT_TRUE(SC_ERROR(other->Remove(other, &records[0].Link)));
+   EXPECT_TRUE(SC_ERROR(other->InsertAfter(other, &records[0].Link, &records[0].Link)));
+   EXPECT_TRUE(NULL == list->Next(list, &record.Link));
+   EXPECT_TRUE(NULL == list->Prev(list, &record.Link));
+
+   CINTRUSIVE_LINK link = CINTRUSIVE_LINK_INIT;
+   EXPECT_TRUE(SC_ERROR(list->InsertBefore(list, &record.Link, &link)));
+   EXPECT_TRUE(NULL == link.Owner);
+
+   EXPECT_TRUE(10 == list->Size(list));
+   EXPECT_TRUE(1 == other->Size(other));
+
+   // Deleting the list leaves its links unlinked
+   CIntrusiveListDelete(other);
+   EXPECT_TRUE(NULL == record.Link.Next && NULL == record.Link.Owner);
+   EXPECT_FALSE(SC_ERROR(list->PushBack(list, &record.Link)));
+   EXPECT_FALSE(SC_ERROR(list->Remove(list, &record.Link)));
+}
+
+
+TEST_F(CIntrusiveListTen, ContainerOf)
+{
+   /*** Act && Assert ***/
+   size_t key = 0;
+   for (CINTRUSIVE_LINK* link = list->Front(list);
+        link != NULL;
+        link = list->Next(list, link))
+   {
+      Record* record = CINTRUSIVE_LIST_GET_ENTRY(link, Record, Link);
+      EXPECT_TRUE(&records[key] == record);
+      EXPECT_TRUE(key * 0.5 == record->Value);
+      ++key;
+   }
+   EXPECT_TRUE(10 == key);
+}
+
+
+TEST_F(CIntrusiveListTen, RemoveAndRelink)
+{
+   /*** Act ***/
+   EXPECT_FALSE(SC_ERROR(list->Remove(list, &records[5].Link)));
+   EXPECT_FALSE(SC_ERROR(list->Remove(list, &records[0].Link)));
+   EXPECT_FALSE(SC_ERROR(list->Remove(list, &records[9].Link)));
+
+   EXPECT_FALSE(SC_ERROR(list->InsertAfter(list, &records[1].Link, &records[5].Link)));
+   EXPECT_FALSE(SC_ERROR(list->InsertBefore(list, &records[1].Link, &records[9].Link)));
+   EXPECT_FALSE(SC_ERROR(list->PushFront(list, &records[0].Link)));
+
+   /*** Assert ***/
+   std::vector<size_t> expected = { 0, 9, 1, 5, 2, 3, 4, 6, 7, 8 };
+   EXPECT_TRUE(expected == Keys());
+   EXPECT_TRUE(10 == list->Size(list));
+}
+
+
+TEST_F(CIntrusiveListTen, Pop)
+{
+   /*** Act && Assert ***/
+   CINTRUSIVE_LINK* link = list->PopFront(list);
+   EXPECT_TRUE(&records[0].Link == link);
+   EXPECT_TRUE(NULL == link->Next && NULL == link->Prev);
+
+   link = list->PopBack(list);
+   EXPECT_TRUE(&records[9].Link == link);
+   EXPECT_TRUE(&records[8].Link == list->Back(list));
+   EXPECT_TRUE(NULL == list->Next(list, list->Back(list)));
+   EXPECT_TRUE(NULL == list->Prev(list, list->Front(list)));
+   EXPECT_TRUE(8 == list->Size(list));
+
+   // Unlinked links can be reused
+   EXPECT_FALSE(SC_ERROR(list->PushBack(list, &records[0].Link)));
+   EXPECT_TRUE(&records[0].Link == list->Back(list));
+}
+
+
+int main(int argc, char** argv)
+{
+   ::testing::InitGoogleTest(&argc, argv);
+
+   return RUN_ALL_TESTS();
+}
@@ -0,0 +1,729 @@
+/**
+ * @file  CListBench.cpp
+ * @brief Throughput benchmarks for CLIST against the standard containers
+ *
+ * Usage: CListBench [MaxSize [Filter]]
+ *    MaxSize - the largest number of elements, 10^6 by default, up to 10^8;
+ *    Filter  - runs only the cases whose name contains Filter.
+ *
+ * Every case empties its container and is repeated until at least
+ * BENCH_MIN_OPERATIONS operations are timed. Allocations are counted
+ * through operator new for the standard containers and through a counting
+ * ALLOCATOR for CLIST. Peak RSS is the process peak after the case.
+ * ScatterScan traverses a list whose order was shuffled relative to the
+ * memory order of its nodes, so large lists miss the cache on every node.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <new>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/Allocator.h"
+   #include "Include/CList.h"
+   #include "Include/CListDefine.h"
+   #include "Include/CListFast.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                  Allocation counting                  //
+///////////////////////////////////////////////////////////
+
+/** Number of allocations made since the start of the current case. */
+static size_t g_Allocations = 0;
+
+
+void* operator new(size_t Size)
+{
+   ++g_Allocations;
+   void* memory = malloc(Size != 0 ? Size : 1);
+   if (NULL == memory) { throw std::bad_alloc(); }
+   return memory;
+}
+
+
+void operator delete(void* Memory) noexcept
+{
+   free(Memory);
+}
+
+
+void operator delete(void* Memory, size_t) noexcept
+{
+   free(Memory);
+}
+
+
+/** ALLOCATOR that counts allocations in g_Allocations. */
+static ALLOCATOR g_CountingAllocator =
+{
+   [](ALLOCATOR*, size_t Size) -> void*
+   {
+      ++g_Allocations;
+      return malloc(Size);
+   },
+   [](ALLOCATOR*, void* Memory, size_t)
+   {
+      free(Memory);
+   }
+};
+
+
+/** Returns the peak resident set size of the process in MiB. */
+static double InGetPeakRssMiB()
+{
+#ifdef _WIN32
+   PROCESS_MEMORY_COUNTERS counters = {};
+   K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+   return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+   struct rusage usage = {};
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////
+//                  Container adapters                   //
+///////////////////////////////////////////////////////////
+
+/** Key of the Value in the scattered order, a bijective multiplicative hash. */
+static size_t InScatterKey(size_t Value)
+{
+   return Value * 0x9E3779B97F4A7C15ULL;
+}
+
+
+static bool InIsScatteredBefore(size_t Left, size_t Right)
+{
+   return InScatterKey(Left) < InScatterKey(Right);
+}
+
+
+static int InCompareScattered(void* Left, size_t LeftSize, void* Right, size_t RightSize,
+                              void* Context)
+{
+   (void)LeftSize;
+   (void)RightSize;
+   (void)Context;
+   size_t left = InScatterKey(*(size_t*)Left);
+   size_t right = InScatterKey(*(size_t*)Right);
+   return (left < right) ? -1 : (left > right) ? 1 : 0;
+}
+
+
+/**
+ * Adapter of a standard sequence container.
+ * Position is the element that MidInsert inserts after.
+ */
+template <typename Container>
+struct StdAdapter
+{
+   Container                      Items;
+   typename Container::iterator   Position;
+
+   void Clear()                 { Container().swap(Items); }
+   void PushBack(size_t Value)  { Items.push_back(Value); }
+   void PushFront(size_t Value) { Items.insert(Items.begin(), Value); }
+   void PopFront()              { Items.erase(Items.begin()); }
+   void PopBack()               { Items.pop_back(); }
+   size_t Size() const          { return Items.size(); }
+
+   void MidStart()
+   {
+      Position = std::next(Items.begin(), Items.size() / 2);
+   }
+
+   void MidInsert(size_t Value)
+   {
+      // Vector and deque iterators don't survive insertion
+      size_t index = std::distance(Items.begin(), Position);
+      Items.insert(std::next(Position), Value);
+      Position = std::next(Items.begin(), index);
+   }
+
+   void Scatter()
+   {
+      std::sort(Items.begin(), Items.end(), InIsScatteredBefore);
+   }
+
+   size_t Traverse()
+   {
+      size_t sum = 0;
+      for (size_t value : Items) { sum += value; }
+      return sum;
+   }
+
+   size_t CopyOut()
+   {
+      size_t sum = 0;
+      for (const size_t& value : Items)
+      {
+         size_t copy = 0;
+         memcpy(&copy, &value, sizeof(copy));
+         sum += copy;
+      }
+      return sum;
+   }
+};
+
+
+/** std::list keeps iterators on insertion. */
+template <>
+void StdAdapter<std::list<size_t>>::MidInsert(size_t Value)
+{
+   Items.insert(std::next(Position), Value);
+}
+
+
+/** std::list sorts by relinking, its nodes stay in place. */
+template <>
+void StdAdapter<std::list<size_t>>::Scatter()
+{
+   Items.sort(InIsScatteredBefore);
+}
+
+
+/** Adapter of the CLIST protocol. */
+struct CListAdapter
+{
+   CLIST*      List = NULL;
+   CLIST_NODE* Position = NULL;
+
+   void Clear()                 { while (Size() > 0) { PopFront(); } }
+   void PushBack(size_t Value)  { List->PushBack(List, &Value, sizeof(Value)); }
+   void PushFront(size_t Value) { List->PushFront(List, &Value, sizeof(Value)); }
+   void PopFront()              { List->PopFront(List); }
+   size_t Size() const          { return List->Size(List); }
+
+   void PopBack()
+   {
+      void* data = NULL;
+      size_t dataSize = 0;
+      if (!SC_ERROR(List->PopBackTake(List, &data, &dataSize)))
+      {
+         g_CountingAllocator.Free(&g_CountingAllocator, data, dataSize);
+      }
+   }
+
+   void MidStart()
+   {
+      Position = List->Front(List);
+      for (size_t i = Size() / 2; i > 0; --i) { Position = List->Next(List, Position); }
+   }
+
+   void MidInsert(size_t Value)
+   {
+      List->InsertAfter(List, Position, &Value, sizeof(Value));
+   }
+
+   void Scatter()
+   {
+      List->Sort(List, InCompareScattered, NULL);
+   }
+
+   size_t Traverse()
+   {
+      size_t sum = 0;
+      for (CLIST_NODE* position = List->Front(List);
+           position != NULL;
+           position = List->Next(List, position))
+      {
+         void** data = NULL;
+         size_t* dataSize = NULL;
+         List->GetRefToData(List, position, &data, &dataSize);
+         sum += **((size_t**)data);
+      }
+      return sum;
+   }
+
+   size_t CopyOut()
+   {
+      size_t sum = 0;
+      for (CLIST_NODE* position = List->Front(List);
+           position != NULL;
+           position = List->Next(List, position))
+      {
+         size_t copy = 0;
+         size_t dataSize = 0;
+         List->GetCopyDataInto(List, position, &copy, sizeof(copy), &dataSize);
+         sum += copy;
+      }
+      return sum;
+   }
+};
+
+
+/** Adapter of the CLIST protocol that traverses with CListFast.h. */
+struct CListFastAdapter : public CListAdapter
+{
+   void MidStart()
+   {
+      Position = CListFastFront(List);
+      for (size_t i = Size() / 2; i > 0; --i) { Position = CListFastNext(Position); }
+   }
+
+   size_t Traverse()
+   {
+      size_t sum = 0;
+      for (CLIST_NODE* position = CListFastFront(List);
+           position != NULL;
+           position = CListFastNext(position))
+      {
+         sum += *(size_t*)CListFastData(position);
+      }
+      return sum;
+   }
+
+   size_t CopyOut()
+   {
+      size_t sum = 0;
+      for (CLIST_NODE* position = CListFastFront(List);
+           position != NULL;
+           position = CListFastNext(position))
+      {
+         size_t copy = 0;
+         memcpy(&copy, CListFastData(position), sizeof(copy));
+         sum += copy;
+      }
+      return sum;
+   }
+};
+
+
+/** Adapter of the CLIST protocol that traverses with ForEach. */
+struct CListForEachAdapter : public CListAdapter
+{
+   size_t Traverse()
+   {
+      size_t sum = 0;
+      List->ForEach(List, [](void* Data, size_t, void* Context)
+      {
+         *(size_t*)Context += *(size_t*)Data;
+      }, &sum);
+      return sum;
+   }
+
+   size_t CopyOut()
+   {
+      size_t sum = 0;
+      List->ForEach(List, [](void* Data, size_t, void* Context)
+      {
+         size_t copy = 0;
+         memcpy(&copy, Data, sizeof(copy));
+         *(size_t*)Context += copy;
+      }, &sum);
+      return sum;
+   }
+};
+
+
+/** Adapter of the CLIST protocol that traverses with NextBatch. */
+struct CListBatchAdapter : public CListAdapter
+{
+   /** Number of items read by one call of NextBatch. */
+   static const size_t BatchSize = 64;
+
+   size_t Traverse()
+   {
+      size_t sum = 0;
+      CLIST_ITEM items[BatchSize];
+      CLIST_NODE* position = List->Front(List);
+      size_t count = 0;
+      while (!SC_ERROR(List->NextBatch(List, &position, items, BatchSize, &count)) && (count > 0))
+      {
+         for (size_t i = 0; i < count; ++i) { sum += *(size_t*)items[i].Data; }
+      }
+      return sum;
+   }
+
+   size_t CopyOut()
+   {
+      size_t sum = 0;
+      CLIST_ITEM items[BatchSize];
+      CLIST_NODE* position = List->Front(List);
+      size_t count = 0;
+      while (!SC_ERROR(List->NextBatch(List, &position, items, BatchSize, &count)) && (count > 0))
+      {
+         for (size_t i = 0; i < count; ++i)
+         {
+            size_t copy = 0;
+            memcpy(&copy, items[i].Data, sizeof(copy));
+            sum += copy;
+         }
+      }
+      return sum;
+   }
+};
+
+
+CLIST_DEFINE(SizeList, size_t)
+
+
+/** Adapter of the list generated by CLIST_DEFINE. */
+struct CListTypedAdapter
+{
+   SizeList       List;
+   SizeList_NODE* Position = NULL;
+
+   CListTypedAdapter()          { SizeListInit(&List, &g_CountingAllocator); }
+
+   void Clear()                 { SizeListClear(&List); }
+   void PushBack(size_t Value)  { SizeListPushBack(&List, Value); }
+   void PushFront(size_t Value) { SizeListPushFront(&List, Value); }
+   void PopFront()              { SizeListPopFront(&List, NULL); }
+   void PopBack()               { SizeListPopBack(&List, NULL); }
+   size_t Size() const          { return SizeListSize(&List); }
+
+   void MidStart()
+   {
+      Position = SizeListFront(&List);
+      for (size_t i = Size() / 2; i > 0; --i) { Position = SizeListNext(Position); }
+   }
+
+   void MidInsert(size_t Value)
+   {
+      SizeListInsertAfter(&List, Position, Value);
+   }
+
+   /** The generated list has no sort, its nodes are relinked here. */
+   void Scatter()
+   {
+      std::vector<SizeList_NODE*> nodes;
+      for (SizeList_NODE* position = SizeListFront(&List);
+           position != NULL;
+           position = SizeListNext(position))
+      {
+         nodes.push_back(position);
+      }
+
+      std::sort(nodes.begin(), nodes.end(), [](SizeList_NODE* Left, SizeList_NODE* Right)
+      {
+         return InIsScatteredBefore(Left->Data, Right->Data);
+      });
+
+      SizeList_NODE* prev = NULL;
+      for (SizeList_NODE* node : nodes)
+      {
+         node->Prev = prev;
+         node->Next = NULL;
+         if (prev != NULL) { prev->Next = node; }
+         else              { List.Head = node; }
+         prev = node;
+      }
+      List.Tail = prev;
+   }
+
+   size_t Traverse()
+   {
+      size_t sum = 0;
+      for (SizeList_NODE* position = SizeListFront(&List);
+           position != NULL;
+           position = SizeListNext(position))
+      {
+         sum += *SizeListData(position);
+      }
+      return sum;
+   }
+
+   size_t CopyOut()
+   {
+      size_t sum = 0;
+      for (SizeList_NODE* position = SizeListFront(&List);
+           position != NULL;
+           position = SizeListNext(position))
+      {
+         size_t copy = *SizeListData(position);
+         sum += copy;
+      }
+      return sum;
+   }
+};
+
+
+static CListAdapter InCreateCList(uint32_t Flags)
+{
+   CListAdapter adapter;
+   adapter.List = CListCreateEx(Flags, &g_CountingAllocator);
+   if (NULL == adapter.List) { abort(); }
+   return adapter;
+}
+
+
+static CListAdapter InCreateFixedCList()
+{
+   CListAdapter adapter;
+   adapter.List = CListCreateFixed(sizeof(size_t));
+   if (NULL == adapter.List) { abort(); }
+   return adapter;
+}
+
+
+///////////////////////////////////////////////////////////
+//                        Cases                          //
+///////////////////////////////////////////////////////////
+
+/** Minimum number of timed operations of a case. */
+#define BENCH_MIN_OPERATIONS 1000000U
+
+/** Largest size for the cases that are quadratic for vector and deque. */
+#define BENCH_MAX_QUADRATIC_SIZE 100000U
+
+
+/** Result of one case. */
+struct Result
+{
+   double NsPerOp;
+   double AllocationsPerOp;
+};
+
+
+/**
+ * Runs Prepare + Body on the emptied Container until enough operations are
+ * timed. Body returns the number of operations it made.
+ */
+template <typename Adapter, typename Setup, typename Body>
+static Result InMeasure(Adapter& Container, size_t Size, Setup Prepare, Body Run)
+{
+   size_t operations = 0;
+   size_t allocations = 0;
+   std::chrono::nanoseconds elapsed(0);
+   volatile size_t sink = 0;
+
+   do
+   {
+      Container.Clear();
+      Prepare(Container, Size);
+
+      g_Allocations = 0;
+      auto start = std::chrono::steady_clock::now();
+      size_t done = Run(Container, Size, sink);
+      elapsed += std::chrono::steady_clock::now() - start;
+
+      allocations += g_Allocations;
+      operations += done;
+   } while (operations < BENCH_MIN_OPERATIONS);
+
+   return Result{ (double)elapsed.count() / operations,
+                  (double)allocations / operations };
+}
+
+
+/** Prints one row of the report. */
+static void InReport(const char* Case, const char* Container, size_t Size,
+                   const Result* Value, bool IsCounted)
+{
+   if (NULL == Value)
+   {
+      printf("%-14s %-14s %10zu %12s %12s %10.1f\n",
+             Case, Container, Size, "-", "-", InGetPeakRssMiB());
+      return;
+   }
+
+   char allocations[32] = "-";
+   if (IsCounted) { snprintf(allocations, sizeof(allocations), "%.3f", Value->AllocationsPerOp); }
+
+   printf("%-14s %-14s %10zu %12.2f %12s %10.1f\n",
+          Case, Container, Size, Value->NsPerOp, allocations, InGetPeakRssMiB());
+}
+
+
+template <typename Adapter>
+static void InFill(Adapter& Container, size_t Size)
+{
+   for (size_t i = 0; i < Size; ++i) { Container.PushBack(i); }
+}
+
+
+template <typename Adapter>
+static void InFillScattered(Adapter& Container, size_t Size)
+{
+   InFill(Container, Size);
+   Container.Scatter();
+}
+
+
+/**
+ * Runs every case on one container type. Cases that are quadratic for the
+ * container are skipped above BENCH_MAX_QUADRATIC_SIZE.
+ */
+template <typename Adapter, typename Factory>
+static void InRunCases(const char* Name, Factory Make, size_t Size,
+                     bool IsQuadraticFront, bool IsQuadraticMiddle, bool IsCounted,
+                     const std::string& Filter)
+{
+   auto NoSetup = [](Adapter&, size_t) {};
+   Adapter container = Make();
+
+   auto run = [&](const char* Case, bool IsQuadratic, auto Prepare, auto Body)
+   {
+      if (!Filter.empty() && (std::string(Case).find(Filter) == std::string::npos))
+      {
+         return;
+      }
+
+      if (IsQuadratic && (Size > BENCH_MAX_QUADRATIC_SIZE))
+      {
+         InReport(Case, Name, Size, NULL, IsCounted);
+         return;
+      }
+
+      Result result = InMeasure(container, Size, Prepare, Body);
+      InReport(Case, Name, Size, &result, IsCounted);
+   };
+
+   run("PushBack", false, NoSetup, [](Adapter& C, size_t N, volatile size_t&)
+   {
+      for (size_t i = 0; i < N; ++i) { C.PushBack(i); }
+      return N;
+   });
+
+   run("PushFront", IsQuadraticFront, NoSetup, [](Adapter& C, size_t N, volatile size_t&)
+   {
+      for (size_t i = 0; i < N; ++i) { C.PushFront(i); }
+      return N;
+   });
+
+   run("PopFront", IsQuadraticFront, InFill<Adapter>, [](Adapter& C, size_t N, volatile size_t&)
+   {
+      for (size_t i = 0; i < N; ++i) { C.PopFront(); }
+      return N;
+   });
+
+   run("PopBack", false, InFill<Adapter>, [](Adapter& C, size_t N, volatile size_t&)
+   {
+      for (size_t i = 0; i < N; ++i) { C.PopBack(); }
+      return N;
+   });
+
+   run("MidInsert", IsQuadraticMiddle, [](Adapter& C, size_t)
+   {
+      C.PushBack(0);
+      C.PushBack(1);
+      C.MidStart();
+   }, [](Adapter& C, size_t N, volatile size_t&)
+   {
+      for (size_t i = 0; i < N; ++i) { C.MidInsert(i); }
+      return N;
+   });
+
+   run("Traverse", false, InFill<Adapter>, [](Adapter& C, size_t N, volatile size_t& Sink)
+   {
+      Sink += C.Traverse();
+      return N;
+   });
+
+   run("ScatterScan", false, InFillScattered<Adapter>,
+       [](Adapter& C, size_t N, volatile size_t& Sink)
+   {
+      Sink += C.Traverse();
+      return N;
+   });
+
+   run("CopyOut", false, InFill<Adapter>, [](Adapter& C, size_t N, volatile size_t& Sink)
+   {
+      Sink += C.CopyOut();
+      return N;
+   });
+
+   // A queue-like mix: 2 pushes for every pop, both ends
+   run("Mixed", IsQuadraticFront, NoSetup, [](Adapter& C, size_t N, volatile size_t&)
+   {
+      // Linear congruential generator, cheap enough to run in the timed loop
+      uint32_t random = 25;
+      for (size_t i = 0; i < N; ++i)
+      {
+         random = random * 1664525U + 1013904223U;
+         switch ((random >> 16) % 6)
+         {
+         case 0:
+         case 1:
+         {
+            C.PushBack(i);
+            break;
+         }
+         case 2:
+         case 3:
+         {
+            C.PushFront(i);
+            break;
+         }
+         case 4:
+         {
+            if (C.Size() > 0) { C.PopFront(); }
+            break;
+         }
+
+         default:
+            if (C.Size() > 0) { C.PopBack(); }
+            break;
+         }
+      }
+      return N;
+   });
+}
+
+
+int main(int argc, char** argv)
+{
+   size_t maxSize = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000U;
+   std::string filter = (argc > 2) ? argv[2] : "";
+
+   if ((maxSize < 10) || (maxSize > 100000000U))
+   {
+      fprintf(stderr, "MaxSize must be in [10, 10^8]\n");
+      return EXIT_FAILURE;
+   }
+
+   printf("%-14s %-14s %10s %12s %12s %10s\n",
+          "Case", "Container", "Size", "ns/op", "allocs/op", "PeakRSS,MiB");
+
+   for (size_t size = 10; size <= maxSize; size *= 10)
+   {
+      InRunCases<CListAdapter>("CList", [] { return InCreateCList(0); },
+                             size, false, false, true, filter);
+      InRunCases<CListAdapter>("CList inline", [] { return InCreateCList(CLIST_FLAG_INLINE_DATA); },
+                             size, false, false, true, filter);
+      InRunCases<CListAdapter>("CList fixed", InCreateFixedCList,
+                             size, false, false, false, filter);
+      InRunCases<CListFastAdapter>("CList fast", [] { return CListFastAdapter{ InCreateCList(0) }; },
+                                 size, false, false, true, filter);
+      InRunCases<CListForEachAdapter>("CList foreach",
+                                    [] { return CListForEachAdapter{ InCreateCList(0) }; },
+                                    size, false, false, true, filter);
+      InRunCases<CListBatchAdapter>("CList batch",
+                                  [] { return CListBatchAdapter{ InCreateCList(0) }; },
+                                  size, false, false, true, filter);
+      InRunCases<CListTypedAdapter>("CList typed", [] { return CListTypedAdapter(); },
+                                  size, false, false, true, filter);
+      InRunCases<StdAdapter<std::list<size_t>>>("std::list",
+                                              [] { return StdAdapter<std::list<size_t>>(); },
+                                              size, false, false, true, filter);
+      InRunCases<StdAdapter<std::deque<size_t>>>("std::deque",
+                                               [] { return StdAdapter<std::deque<size_t>>(); },
+                                               size, false, true, true, filter);
+      InRunCases<StdAdapter<std::vector<size_t>>>("std::vector",
+                                                [] { return StdAdapter<std::vector<size_t>>(); },
+                                                size, true, true, true, filter);
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file  CListParallelBench.cpp
+ * @brief Scaling benchmark for the parallel traversals of CLIST
+ *
+ * Usage: CListParallelBench [MaxThreads [Size [Work]]]
+ *    MaxThreads - the largest number of threads, the number of hardware
+ *                 threads by default;
+ *    Size       - number of elements of the list, 10^6 by default;
+ *    Work       - rounds of the transform applied to every element, 100
+ *                 by default.
+ *
+ * ParallelForEach replaces every element by a hash mixed Work times,
+ * ParallelReduce sums the hashes of the elements mixed Work times. The
+ * number of threads doubles from 1 to MaxThreads, the speedup is relative
+ * to one thread.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                      Transforms                       //
+///////////////////////////////////////////////////////////
+
+/** Mixes the Value Rounds times, a CPU-bound stand-in for real transforms. */
+static uint64_t InMix(uint64_t Value, size_t Rounds)
+{
+   for (size_t i = 0; i < Rounds; ++i)
+   {
+      Value ^= Value >> 33;
+      Value *= 0xFF51AFD7ED558CCDULL;
+      Value ^= Value >> 29;
+   }
+
+   return Value;
+}
+
+
+static void InTransform(void* Data, size_t DataSize, void* Context)
+{
+   (void)DataSize;
+   *(uint64_t*)Data = InMix(*(uint64_t*)Data, *(size_t*)Context);
+}
+
+
+static void InSum(void* Accumulator, void* Data, size_t DataSize, void* Context)
+{
+   (void)DataSize;
+   *(uint64_t*)Accumulator += InMix(*(uint64_t*)Data, *(size_t*)Context);
+}
+
+
+static void InCombine(void* Accumulator, void* Other, void* Context)
+{
+   (void)Context;
+   *(uint64_t*)Accumulator += *(uint64_t*)Other;
+}
+
+
+///////////////////////////////////////////////////////////
+//                         Cases                         //
+///////////////////////////////////////////////////////////
+
+/** Times one call of Run in milliseconds. */
+template <typename Body>
+static double InMeasure(Body Run)
+{
+   auto start = std::chrono::steady_clock::now();
+   Run();
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+int main(int argc, char** argv)
+{
+   size_t maxThreads = (argc > 1) ? strtoull(argv[1], NULL, 10) :
+                                    std::max(1U, std::thread::hardware_concurrency());
+   size_t size = (argc > 2) ? strtoull(argv[2], NULL, 10) : 1000000U;
+   size_t work = (argc > 3) ? strtoull(argv[3], NULL, 10) : 100U;
+
+   if ((0 == maxThreads) || (maxThreads > 1024) || (0 == size) || (size > 100000000U))
+   {
+      fprintf(stderr, "MaxThreads must be in [1, 1024], Size must be in [1, 10^8]\n");
+      return EXIT_FAILURE;
+   }
+
+   CLIST* list = CListCreate();
+   if (NULL == list)
+   {
+      fprintf(stderr, "CList can't be created\n");
+      return EXIT_FAILURE;
+   }
+
+   for (uint64_t i = 0; i < size; ++i)
+   {
+      if (SC_ERROR(list->PushBack(list, &i, sizeof(uint64_t))))
+      {
+         fprintf(stderr, "PushBack failed\n");
+         return EXIT_FAILURE;
+      }
+   }
+
+   printf("%-16s %-8s %12s %10s\n", "Case", "Threads", "ms", "Speedup");
+
+   std::vector<size_t> threadCounts;
+   for (size_t threads = 1; threads < maxThreads; threads *= 2) { threadCounts.push_back(threads); }
+   threadCounts.push_back(maxThreads);
+
+   double forEachBase = 0;
+   double reduceBase = 0;
+
+   for (size_t threads : threadCounts)
+   {
+      double ms = InMeasure([&] { list->ParallelForEach(list, InTransform, &work, threads); });
+      if (1 == threads) { forEachBase = ms; }
+      printf("%-16s %-8zu %12.2f %10.2f\n", "ParallelForEach", threads, ms, forEachBase / ms);
+
+      uint64_t sum = 0;
+      ms = InMeasure([&]
+      {
+         list->ParallelReduce(list, InSum, InCombine, &work, &sum, sizeof(uint64_t), threads);
+      });
+      if (1 == threads) { reduceBase = ms; }
+      printf("%-16s %-8zu %12.2f %10.2f\n", "ParallelReduce", threads, ms, reduceBase / ms);
+   }
+
+   CListDelete(list);
+
+   return EXIT_SUCCESS;
+}
@@ -7,10 +7,20 @@
  * @ingroup  DATA_STRUCTURES
  */
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#include <inttypes.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
+#include <threads.h>
+
+#include "Include/Allocator.h"
 
 #include "Include/CList.h"
+#include "Include/CListFast.h"
 
 
 ///////////////////////////////////////////////////////////
@@ -18,30 +28,126 @@
 ///////////////////////////////////////////////////////////
 
 
-/** Doubly linked list node. */
-typedef struct CLIST_NODE
+/** Unique identificator for CLIST_IMPL_IMPL */
+#define CLIST_IMPL_STRUCT_ID STRUCT_ID_64('C', 'L', 'I', 'S', 'T', '.', '.', '.')
+
+
+/** Size of the node header of fixed-size lists. */
+#define CLIST_FIXED_NODE_HEADER_SIZE offsetof(CLIST_NODE, DataSize)
+
+
+/** Preferred size of one slab of equally sized nodes. */
+#define CLIST_SLAB_SIZE 65536U
+
+
+/** Largest node carved from the node heap, bigger ones come from malloc. */
+#define CLIST_NODE_CLASS_MAX 1024U
+
+
+/** Number of size classes of the node heap, one per ALLOCATOR_ALIGNMENT bytes. */
+#define CLIST_NODE_CLASS_COUNT (CLIST_NODE_CLASS_MAX / ALLOCATOR_ALIGNMENT)
+
+
+/** Nodes of one size class of the node heap. */
+typedef struct CLIST_NODE_CLASS
 {
-   struct CLIST_NODE* Prev;     /** Pointer to previous node */
-   struct CLIST_NODE* Next;     /** Pointer to next node     */
-   void*              Data;     /** Data stored in the node  */
-   size_t             DataSize; /** Size of data stored in the node */
-} CLIST_NODE;
+   mtx_t      Lock; /** Guards the Pool                       */
+   ALLOCATOR* Pool; /** Pool of the class, NULL until first use */
+} CLIST_NODE_CLASS;
 
 
-/** CList protocol implementation. */
-typedef struct CLIST_IMPL
+/** Nodes shared by all lists of the system allocator. */
+typedef struct CLIST_NODE_HEAP
 {
-   STRUCT_ID StructureId; /** Structure unique id */
-   CLIST     VTable;      /** API                 */
+   STRUCT_ID        StructureId;                     /** Structure unique id */
+   ALLOCATOR        VTable;                          /** API                 */
+   CLIST_NODE_CLASS Classes[CLIST_NODE_CLASS_COUNT]; /** Pools by node size  */
+} CLIST_NODE_HEAP;
 
-   CLIST_NODE* Head; /** Pointer to the first node in the list */
-   CLIST_NODE* Tail; /** Pointer to the last node in the list  */
-   size_t      Size; /** Number of nodes */
-} CLIST_IMPL;
 
+/** Unique identificator for CLIST_NODE_HEAP */
+#define CLIST_NODE_HEAP_STRUCT_ID STRUCT_ID_64('C', 'L', 'I', 'S', 'T', 'H', 'E', 'A')
 
-/** Unique identificator for CLIST_IMPL_IMPL */
-#define CLIST_IMPL_STRUCT_ID STRUCT_ID_64('C', 'L', 'I', 'S', 'T', '.', '.', '.')
+
+/** Node heap of the process. */
+static CLIST_NODE_HEAP g_NodeHeap;
+
+/** Guards the initialization of g_NodeHeap. */
+static once_flag g_NodeHeapOnce = ONCE_FLAG_INIT;
+
+
+#ifdef CLIST_ENABLE_STATS
+
+/** Adds Value to the Counter of the List statistics. */
+#define CLIST_STAT_ADD(List, Counter, Value) ((List)->StatsEntry->Stats.Counter += (Value))
+
+/** Accounts Bytes of nodes and data taken by the List. */
+#define CLIST_STAT_HOLD(List, Bytes) InStatHold(List, Bytes)
+
+/** Accounts Bytes of nodes and data given away by the List. */
+#define CLIST_STAT_RELEASE(List, Bytes) ((List)->StatsEntry->Stats.LiveBytes -= (Bytes))
+
+
+/** Registry of all live lists. */
+static CLIST_STATS_ENTRY* g_Registry = NULL;
+
+/** Lock of g_Registry. */
+static mtx_t g_RegistryLock;
+
+/** Initialization flag of g_RegistryLock. */
+static once_flag g_RegistryLockOnce = ONCE_FLAG_INIT;
+
+#else
+
+#define CLIST_STAT_ADD(List, Counter, Value) ((void)0)
+#define CLIST_STAT_HOLD(List, Bytes)         ((void)0)
+#define CLIST_STAT_RELEASE(List, Bytes)      ((void)0)
+
+#endif
+
+
+/** Number of nodes ForEach prefetches ahead of the visited one. */
+#define CLIST_PREFETCH_DISTANCE 8U
+
+/** Starts loading the cache line at Address, never faults. */
+#if defined(__GNUC__) || defined(__clang__)
+#define CLIST_PREFETCH(Address) __builtin_prefetch(Address)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CLIST_PREFETCH(Address) _mm_prefetch((const char*)(Address), _MM_HINT_T0)
+#else
+#define CLIST_PREFETCH(Address) ((void)(Address))
+#endif
+
+
+/** Number of bins of the merge sort, bin i holds a sorted run of 2^i nodes. */
+#define CLIST_SORT_BINS 64U
+
+
+/** Run of nodes sorted by one thread of CListSortParallel. */
+typedef struct CLIST_SORT_RUN
+{
+   CLIST_IMPL*      List;       /** List the nodes belong to             */
+   CLIST_COMPARATOR Comparator; /** Comparator of the node data          */
+   void*            Context;    /** Context for the Comparator           */
+   CLIST_NODE*      First;      /** Chain of nodes linked through Next   */
+   thrd_t           Thread;     /** Thread that sorts the run            */
+   bool             IsStarted;  /** true if the run is sorted by Thread  */
+} CLIST_SORT_RUN;
+
+
+/** Chunk of nodes visited by one thread of the parallel traversals. */
+typedef struct CLIST_PARALLEL_RUN
+{
+   CLIST_IMPL*   List;        /** List the nodes belong to                   */
+   CLIST_VISITOR Visitor;     /** Visitor of ParallelForEach or NULL         */
+   CLIST_REDUCER Reducer;     /** Reducer of ParallelReduce or NULL          */
+   void*         Context;     /** Context for the Visitor or the Reducer     */
+   void*         Accumulator; /** Result of the chunk for the Reducer        */
+   CLIST_NODE*   First;       /** First node of the chunk                    */
+   size_t        Count;       /** Number of nodes in the chunk               */
+   thrd_t        Thread;      /** Thread that visits the chunk               */
+   bool          IsStarted;   /** true if the chunk is visited by Thread     */
+} CLIST_PARALLEL_RUN;
 
 
 ///////////////////////////////////////////////////////////
@@ -50,311 +156,424 @@ typedef struct CLIST_IMPL
 
 
 /**
- * Creates CLIST_NODE.
+ * Returns the number of bytes allocated for a node with DataSize bytes of data.
  *
- * @param[in]  Data      Data that will be stored in the node
+ * @param[in]  List      List the node belongs to
  * @param[in]  DataSize  Data size
- * @param[in]  Prev      Pointer to previous node
- * @param[in]  Next      Pointer to next node
  *
- * @retval  CLIST_NODE*  If the node is successfully created
- * @retval  NULL         On failure
+ * @return  Size of the node allocation
  */
 static
-CLIST_NODE*
-InCreateNode(
-   IN void*       Data,
-   IN size_t      DataSize,
-   IN CLIST_NODE* Prev,
-   IN CLIST_NODE* Next)
+size_t
+InGetNodeSize(
+   IN CLIST_IMPL* List,
+   IN size_t      DataSize)
 {
-   CLIST_NODE* node = malloc(sizeof(CLIST_NODE));
-   if (NULL == node) { return NULL; }
-
-   node->Data = malloc(DataSize);
-   if (NULL == node->Data)
+   if (List->ElementSize != 0)
    {
-      free(node);
-      return NULL;
+      return CLIST_FIXED_NODE_HEADER_SIZE + List->ElementSize;
    }
 
-   memcpy(node->Data, Data, DataSize);
-   node->Prev = Prev;
-   node->Next = Next;
-   node->DataSize = DataSize;
+   if (List->Flags & CLIST_FLAG_INLINE_DATA)
+   {
+      return sizeof(CLIST_NODE) + DataSize;
+   }
 
-   return node;
+   // Every node has room for small data, so the size doesn't depend on
+   // where the data ended up
+   return sizeof(CLIST_NODE) + CLIST_SMALL_DATA_SIZE;
 }
 
 
-///////////////////////////////////////////////////////////
-///              CList API implementation               ///
-///////////////////////////////////////////////////////////
-
 /**
- * Creates a node with a copy of the Data at the head of the list.
+ * Returns the size of data stored in the Node.
  *
- * @param[in]  This      Pointer to CList protocol
- * @param[in]  Data      Data
- * @param[in]  DataSize  Data size
+ * @param[in]  List  List the node belongs to
+ * @param[in]  Node  Node
  *
- * @retval  SC_INVALID_PARAMETER  Invalid input parameter
- * @retval  SC_SUCCESS            On success
- * @retval  SC_UNSUCCESSFUL       On failure
+ * @return  Data size
  */
 static
-STATUS_CODE
-CListPushFront(
-   IN CLIST* This,
-   IN void*  Data,
-   IN size_t DataSize)
+size_t
+InGetDataSize(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* Node)
 {
-   STATUS_CODE status = SC_SUCCESS;
-   CLIST_NODE* node = NULL;
-
-   do
-   {
-      GET_THIS(This, CLIST_IMPL);
-      if ((NULL == Data) || (0 == DataSize))
-      {
-         SET_SC(SC_INVALID_PARAMETER);
-         break;
-      }
+   return (List->ElementSize != 0) ? List->ElementSize : Node->DataSize;
+}
 
-      node = InCreateNode(Data, DataSize, NULL, this->Head);
-      if (NULL == node) { SET_SC(SC_UNSUCCESSFUL); break; }
 
-      if (0 == this->Size)
-      {
-         this->Head = this->Tail = node;
-      }
-      else
-      {
-         this->Head->Prev = node;
-         this->Head = node;
-      }
+/**
+ * Checks whether the data of the Node is stored in the node itself.
+ *
+ * @param[in]  List  List the node belongs to
+ * @param[in]  Node  Node
+ *
+ * @return  true if the data has no buffer of its own
+ */
+static
+bool
+InIsDataInNode(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* Node)
+{
+   return (List->Flags & CLIST_FLAG_INLINE_DATA) || (Node->Data == (void*)Node->Payload);
+}
 
-      ++this->Size;
 
-   } while (false);
+/**
+ * Checks that DataSize can be stored in the List.
+ *
+ * @param[in]  List      List
+ * @param[in]  DataSize  Data size
+ *
+ * @return  true if DataSize is valid for the List
+ */
+static
+bool
+InIsValidDataSize(
+   IN CLIST_IMPL* List,
+   IN size_t      DataSize)
+{
+   if (0 == DataSize) { return false; }
 
-   return status;
+   return (0 == List->ElementSize) || (DataSize == List->ElementSize);
 }
 
 
+#ifdef CLIST_ENABLE_STATS
+
 /**
- * Returns the first node in the list.
+ * Returns the number of bytes the Node holds, including its data buffer.
  *
- * @param[in]  This  Pointer to CList protocol
+ * @param[in]  List  List the node belongs to
+ * @param[in]  Node  Node
  *
- * @retval  NULL         If This is invalid or the list is empty
- * @retval  CLIST_NODE*  List head
+ * @return  Size of the node and its data
  */
 static
-CLIST_NODE*
-CListFront(
-   IN CLIST* This)
+size_t
+InGetNodeBytes(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* Node)
 {
-   STATUS_CODE status = SC_SUCCESS;
-
-   do
-   {
-      GET_THIS(This, CLIST_IMPL);
-      return this->Head;
-   } while (false);
+   size_t dataSize = InGetDataSize(List, Node);
+   size_t nodeSize = InGetNodeSize(List, dataSize);
 
-   return NULL;
+   return InIsDataInNode(List, Node) ? nodeSize : nodeSize + dataSize;
 }
 
 
 /**
- * Gets a link to the data stored in the Position node.
- *
- * @param[in]  This      Pointer to CList protocol
- * @param[in]  Position  Position in the list
- * @param[in]  Data      Triple pointer to data
- * @param[in]  DataSize  Pointer to pointer to data size
+ * Accounts Bytes of nodes and data taken by the List.
  *
- * @retval  SC_INVALID_PARAMETER  Invalid input parameter
- * @retval  SC_SUCCESS            On success
+ * @param[in]  List   List
+ * @param[in]  Bytes  Number of bytes
  */
 static
-STATUS_CODE
-CListGetRefToData(
-   IN CLIST*      This,
-   IN CLIST_NODE* Position,
-   IN void***     Data,
-   IN size_t**    DataSize)
+void
+InStatHold(
+   IN CLIST_IMPL* List,
+   IN size_t      Bytes)
 {
-   STATUS_CODE status = SC_SUCCESS;
+   CLIST_STATS* stats = &List->StatsEntry->Stats;
 
-   do
+   stats->LiveBytes += Bytes;
+   if (stats->LiveBytes > stats->PeakBytes)
    {
-      GET_THIS(This, CLIST_IMPL);
-      if ((NULL == Position) || (NULL == Data) || (NULL == DataSize))
-      {
-         SET_SC(SC_INVALID_PARAMETER);
-         break;
-      }
-
-      *Data = &Position->Data;
-      *DataSize = &Position->DataSize;
+      stats->PeakBytes = stats->LiveBytes;
+   }
+}
 
-   } while (false);
 
-   return status;
+/**
+ * Initializes g_RegistryLock.
+ */
+static
+void
+InInitRegistryLock()
+{
+   mtx_init(&g_RegistryLock, mtx_plain);
 }
 
 
 /**
- * Gets a copy of the data stored in the Position node.
+ * Adds the List to the registry of live lists.
  *
- * @param[in]   This      Pointer to CList protocol
- * @param[in]   Position  Position in the list
- * @param[out]  Data      Data
- * @param[out]  DataSize  Data size
+ * @param[in]  List  List
  *
- * @retval  SC_INVALID_PARAMETER  Invalid input parameter
- * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
- * @retval  SC_SUCCESS            On success
+ * @return  false if there is no memory for the registry entry
  */
 static
-STATUS_CODE
-CListGetCopyData(
-   IN CLIST*      This,
-   IN CLIST_NODE* Position,
-   OUT void**     Data,
-   OUT size_t*    DataSize)
+bool
+InRegisterList(
+   IN CLIST_IMPL* List)
 {
-   STATUS_CODE status = SC_SUCCESS;
-
-   do
-   {
-      GET_THIS(This, CLIST_IMPL);
+   ALLOCATOR* allocator = GetSystemAllocator();
+   CLIST_STATS_ENTRY* entry = allocator->Alloc(allocator, sizeof(CLIST_STATS_ENTRY));
+   if (NULL == entry) { return false; }
 
-      if ((NULL == Position) || (NULL == Data) || (NULL == DataSize))
-      {
-         SET_SC(SC_INVALID_PARAMETER);
-         break;
-      }
+   memset(&entry->Stats, 0, sizeof(entry->Stats));
+   entry->List = &List->VTable;
+   entry->Prev = NULL;
+   List->StatsEntry = entry;
 
-      *Data = malloc(Position->DataSize);
-      if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+   call_once(&g_RegistryLockOnce, InInitRegistryLock);
+   mtx_lock(&g_RegistryLock);
 
-      memcpy(*Data, Position->Data, Position->DataSize);
-      *DataSize = Position->DataSize;
+   entry->Next = g_Registry;
+   if (g_Registry != NULL) { g_Registry->Prev = entry; }
+   g_Registry = entry;
 
-   } while (false);
+   mtx_unlock(&g_RegistryLock);
 
-   return status;
+   return true;
 }
 
 
 /**
- * Returns the previous node in the list.
+ * Removes the List from the registry of live lists.
  *
- * @param[in]  This      Pointer to CList protocol
- * @param[in]  Position  Position in the list
- *
- * @retval  CLIST_NODE*  Next node
- * @retval  NULL         If Invalid input parameter or there is no previous node
+ * @param[in]  List  Registered list
  */
 static
-CLIST_NODE*
-CListPrev(
-   IN CLIST*      This,
-   IN CLIST_NODE* Position)
+void
+InUnregisterList(
+   IN CLIST_IMPL* List)
 {
-   STATUS_CODE status = SC_SUCCESS;
+   CLIST_STATS_ENTRY* entry = List->StatsEntry;
 
-   do
-   {
-      GET_THIS(This, CLIST_IMPL);
-      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+   mtx_lock(&g_RegistryLock);
 
-      return Position->Prev;
+   if (entry->Prev != NULL) { entry->Prev->Next = entry->Next; }
+   else                     { g_Registry = entry->Next; }
 
-   } while (false);
+   if (entry->Next != NULL) { entry->Next->Prev = entry->Prev; }
 
-   return NULL;
+   mtx_unlock(&g_RegistryLock);
+
+   ALLOCATOR* allocator = GetSystemAllocator();
+   allocator->Free(allocator, entry, sizeof(CLIST_STATS_ENTRY));
 }
 
+#endif
+
 
 /**
- * Returns the next node in the list.
+ * Allocates memory for a node of NodeSize bytes.
  *
- * @param[in]  This      Pointer to CList protocol
- * @param[in]  Position  Position in the list
+ * @param[in]  List      List the node is allocated for
+ * @param[in]  NodeSize  Size of the node allocation
  *
- * @retval  CLIST_NODE*  Next node
- * @retval  NULL         If Invalid input parameter or there is no next node
+ * @retval  CLIST_NODE*  On success
+ * @retval  NULL         On failure
  */
 static
 CLIST_NODE*
-CListNext(
-   IN CLIST*      This,
-   IN CLIST_NODE* Position)
+InAllocNode(
+   IN CLIST_IMPL* List,
+   IN size_t      NodeSize)
 {
-   STATUS_CODE status = SC_SUCCESS;
-
-   do
-   {
-      GET_THIS(This, CLIST_IMPL);
-      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+   ALLOCATOR* nodeAllocator = List->NodeAllocator;
+   CLIST_NODE* node = nodeAllocator->Alloc(nodeAllocator, NodeSize);
+   if (node != NULL) { CLIST_STAT_ADD(List, NodeAllocations, 1); }
 
-      return Position->Next;
+   return node;
+}
 
-   } while (false);
 
-   return NULL;
+/**
+ * Releases the memory of a node of NodeSize bytes.
+ *
+ * @param[in]  List      List the node was allocated for
+ * @param[in]  Node      Node without data of its own
+ * @param[in]  NodeSize  Size of the node allocation
+ */
+static
+void
+InFreeNode(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* Node,
+   IN size_t      NodeSize)
+{
+   ALLOCATOR* nodeAllocator = List->NodeAllocator;
+   nodeAllocator->Free(nodeAllocator, Node, NodeSize);
 }
 
 
 /**
- * Creates a node with a copy of the Data before Position node.
+ * Creates CLIST_NODE.
  *
- * @param[in]  This      Pointer to CList protocol
- * @param[in]  Position  Position in the list
- * @param[in]  Data      Data
+ * If TakeData is true, the node adopts the Data buffer allocated from the
+ * list allocator. Nodes with inline data copy it and release the buffer.
+ * On failure the buffer stays with the caller. Otherwise data up to
+ * CLIST_SMALL_DATA_SIZE bytes is copied into the node itself. Without Data
+ * the storage of the node is left uninitialized.
+ *
+ * @param[in]  List      List the node is created for
+ * @param[in]  Data      Data that will be stored in the node, may be NULL
  * @param[in]  DataSize  Data size
+ * @param[in]  TakeData  Adopt the Data buffer instead of copying it
+ * @param[in]  Prev      Pointer to previous node
+ * @param[in]  Next      Pointer to next node
  *
- * @retval  SC_INVALID_PARAMETER  Invalid input parameter
- * @retval  SC_SUCCESS            On success
- * @retval  SC_UNSUCCESSFUL       Otherwise
+ * @retval  CLIST_NODE*  If the node is successfully created
+ * @retval  NULL         On failure
  */
 static
-STATUS_CODE
-CListInsertBefore(
-   IN CLIST* This,
-   IN CLIST_NODE* Position,
-   IN void* Data,
-   IN size_t DataSize)
+CLIST_NODE*
+InCreateNode(
+   IN CLIST_IMPL* List,
+   IN void*       Data,
+   IN size_t      DataSize,
+   IN bool        TakeData,
+   IN CLIST_NODE* Prev,
+   IN CLIST_NODE* Next)
 {
-   STATUS_CODE status = SC_SUCCESS;
+   ALLOCATOR* allocator = List->Allocator;
 
-   do
+   CLIST_NODE* node = InAllocNode(List, InGetNodeSize(List, DataSize));
+   if (NULL == node) { return NULL; }
+
+   if (List->ElementSize != 0)
    {
-      GET_THIS(This, CLIST_IMPL);
-      if ((NULL == Position) || (NULL == Data) || (0 == DataSize))
+      node->Data = (char*)node + CLIST_FIXED_NODE_HEADER_SIZE;
+   }
+   else if (List->Flags & CLIST_FLAG_INLINE_DATA)
+   {
+      node->Data = node->Payload;
+   }
+   else if (TakeData)
+   {
+      node->Data = Data;
+   }
+   else if (DataSize <= CLIST_SMALL_DATA_SIZE)
+   {
+      node->Data = node->Payload;
+   }
+   else
+   {
+      node->Data = allocator->Alloc(allocator, DataSize);
+      if (NULL == node->Data)
       {
-         SET_SC(SC_INVALID_PARAMETER);
-         break;
+         InFreeNode(List, node, InGetNodeSize(List, DataSize));
+         return NULL;
       }
 
-      CLIST_NODE* node = InCreateNode(Data, DataSize, Position->Prev, Position);
+      CLIST_STAT_ADD(List, PayloadAllocations, 1);
+   }
+
+   if ((Data != NULL) && (node->Data != Data))
+   {
+      memcpy(node->Data, Data, DataSize);
+      if (TakeData) { allocator->Free(allocator, Data, DataSize); }
+   }
+
+   node->Prev = Prev;
+   node->Next = Next;
+
+   if (0 == List->ElementSize)
+   {
+      node->DataSize = DataSize;
+   }
+
+   CLIST_STAT_HOLD(List, InGetNodeBytes(List, node));
+
+   // The node is complete before it is linked: readers of lists with an
+   // epoch allocator follow the links without a lock
+   atomic_thread_fence(memory_order_release);
+
+   return node;
+}
+
+
+/**
+ * Releases CLIST_NODE and its data.
+ *
+ * @param[in]  List  List the node belongs to
+ * @param[in]  Node  Node to release
+ */
+static
+void
+InDeleteNode(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* Node)
+{
+   ALLOCATOR* allocator = List->Allocator;
+   size_t dataSize = InGetDataSize(List, Node);
+
+   CLIST_STAT_RELEASE(List, InGetNodeBytes(List, Node));
+
+   if (!InIsDataInNode(List, Node))
+   {
+      allocator->Free(allocator, Node->Data, dataSize);
+   }
+
+   InFreeNode(List, Node, InGetNodeSize(List, dataSize));
+}
+
+
+/**
+ * Releases all nodes of the List and their data, the List becomes empty.
+ *
+ * @param[in]  List  List
+ */
+static
+void
+InDeleteNodes(
+   IN CLIST_IMPL* List)
+{
+   CLIST_NODE* node = List->Head;
+   while (node != NULL)
+   {
+      CLIST_NODE* next = node->Next;
+      InDeleteNode(List, node);
+      node = next;
+   }
+
+   List->Head = List->Tail = NULL;
+   List->Size = 0;
+}
+
+
+/**
+ * Creates a node at the head of the list.
+ *
+ * @param[in]  List      List
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ * @param[in]  TakeData  Adopt the Data buffer instead of copying it
+ *
+ * @retval  SC_SUCCESS       On success
+ * @retval  SC_UNSUCCESSFUL  On failure
+ */
+static
+STATUS_CODE
+InPushFront(
+   IN CLIST_IMPL* List,
+   IN void*       Data,
+   IN size_t      DataSize,
+   IN bool        TakeData)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      CLIST_NODE* node = InCreateNode(List, Data, DataSize, TakeData, NULL, List->Head);
       if (NULL == node) { SET_SC(SC_UNSUCCESSFUL); break; }
 
-      if(Position->Prev != NULL)
+      if (0 == List->Size)
       {
-         Position->Prev->Next = node;
+         List->Head = List->Tail = node;
       }
       else
       {
-         this->Head = node;
-         Position->Prev = node;
+         List->Head->Prev = node;
+         List->Head = node;
       }
 
-      ++this->Size;
+      ++List->Size;
+      CLIST_STAT_ADD(List, Pushes, 1);
 
    } while (false);
 
@@ -363,49 +582,43 @@ CListInsertBefore(
 
 
 /**
- * Creates a node with a copy of the Data after Position node.
+ * Creates a node at the end of the list.
  *
- * @param[in]  This      Pointer to CList protocol
- * @param[in]  Position  Position in the list
+ * @param[in]  List      List
  * @param[in]  Data      Data
  * @param[in]  DataSize  Data size
+ * @param[in]  TakeData  Adopt the Data buffer instead of copying it
  *
- * @retval  SC_INVALID_PARAMETER  Invalid input parameter
- * @retval  SC_SUCCESS            On success
- * @retval  SC_UNSUCCESSFUL       Otherwise
+ * @retval  SC_SUCCESS       On success
+ * @retval  SC_UNSUCCESSFUL  On failure
  */
 static
 STATUS_CODE
-CListInsertAfter(
-   IN CLIST* This,
-   IN CLIST_NODE* Position,
-   IN void* Data,
-   IN size_t DataSize)
+InPushBack(
+   IN CLIST_IMPL* List,
+   IN void*       Data,
+   IN size_t      DataSize,
+   IN bool        TakeData)
 {
    STATUS_CODE status = SC_SUCCESS;
 
    do
    {
-      GET_THIS(This, CLIST_IMPL);
-      if ((NULL == Position) || (NULL == Data) || (0 == DataSize))
-      {
-         SET_SC(SC_INVALID_PARAMETER);
-         break;
-      }
-
-      CLIST_NODE* node = InCreateNode(Data, DataSize, Position, Position->Next);
+      CLIST_NODE* node = InCreateNode(List, Data, DataSize, TakeData, List->Tail, NULL);
       if (NULL == node) { SET_SC(SC_UNSUCCESSFUL); break; }
-      Position->Next = node;
-      if (node->Next != NULL)
+
+      if (0 == List->Size)
       {
-         node->Next->Prev = node;
+         List->Head = List->Tail = node;
       }
       else
       {
-         this->Tail = node;
+         List->Tail->Next = node;
+         List->Tail = node;
       }
 
-      ++this->Size;
+      ++List->Size;
+      CLIST_STAT_ADD(List, Pushes, 1);
 
    } while (false);
 
@@ -414,139 +627,340 @@ CListInsertAfter(
 
 
 /**
- * Removes the first node in the list.
+ * Creates a chain of nodes with copies of Count records.
  *
- * @param[in]  This  Pointer to CList protocol
+ * @param[in]   List      List
+ * @param[in]   Records   Array of records
+ * @param[in]   DataSize  Size of one record
+ * @param[in]   Stride    Distance between records
+ * @param[in]   Count     Number of records, greater than 0
+ * @param[out]  First     First node of the chain
+ * @param[out]  Last      Last node of the chain
  *
- * @retval  SC_INVALID_PARAMETER  Invalid input parameter
- * @retval  SC_SUCCESS            On success
+ * @retval  SC_SUCCESS       On success
+ * @retval  SC_UNSUCCESSFUL  On failure, no nodes are left allocated
  */
-void
-CListPopFront(
-   IN CLIST* This)
+static
+STATUS_CODE
+InCreateChain(
+   IN  CLIST_IMPL*  List,
+   IN  void*        Records,
+   IN  size_t       DataSize,
+   IN  size_t       Stride,
+   IN  size_t       Count,
+   OUT CLIST_NODE** First,
+   OUT CLIST_NODE** Last)
 {
    STATUS_CODE status = SC_SUCCESS;
+   CLIST_NODE* first = NULL;
+   CLIST_NODE* last = NULL;
+   char* record = Records;
 
-   do
+   for (size_t i = 0; i < Count; ++i, record += Stride)
    {
-      GET_THIS(This, CLIST_IMPL);
-
-      if (0 == this->Size)
+      CLIST_NODE* node = InCreateNode(List, record, DataSize, false, last, NULL);
+      if (NULL == node)
       {
-         return;
+         while (first != NULL)
+         {
+            CLIST_NODE* next = first->Next;
+            InDeleteNode(List, first);
+            first = next;
+         }
+
+         SET_SC(SC_UNSUCCESSFUL);
+         return status;
       }
-      else if (1 == this->Size)
-      {
-         free(this->Head->Data);
-         free(this->Head);
-         this->Head = this->Tail = NULL;
 
-         --this->Size;
-      }
-      else
-      {
-         CLIST_NODE* tmp = this->Head;
-         this->Head = tmp->Next;
-         this->Head->Prev = tmp->Prev;
-         free(tmp->Data);
-         free(tmp);
-         --this->Size;
-      }
+      if (last != NULL) { last->Next = node; }
+      else              { first = node; }
+      last = node;
+   }
 
-   } while (false);
+   *First = first;
+   *Last = last;
 
+   return status;
 }
 
 
 /**
- * Returns the number of nodes.
+ * Links the chain [First, Last] of Count nodes between Prev and Next.
  *
- * @param[in]  This  Pointer to CList protocol
+ * @param[in]  List   List
+ * @param[in]  Prev   Node before the chain, NULL to link at the head
+ * @param[in]  Next   Node after the chain, NULL to link at the end
+ * @param[in]  First  First node of the chain
+ * @param[in]  Last   Last node of the chain
+ * @param[in]  Count  Number of nodes in the chain
+ */
+static
+void
+InLinkChain(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* Prev,
+   IN CLIST_NODE* Next,
+   IN CLIST_NODE* First,
+   IN CLIST_NODE* Last,
+   IN size_t      Count)
+{
+   First->Prev = Prev;
+   Last->Next = Next;
+
+   if (Prev != NULL) { Prev->Next = First; }
+   else              { List->Head = First; }
+
+   if (Next != NULL) { Next->Prev = Last; }
+   else              { List->Tail = Last; }
+
+   List->Size += Count;
+}
+
+
+/**
+ * Returns CLIST_IMPL that implements the List protocol.
  *
- * @return  Number of nodes. If This is invalid then returns 0.
+ * @param[in]  List  Pointer to CList protocol
+ *
+ * @retval  CLIST_IMPL*  If List is a valid CList
+ * @retval  NULL         Otherwise
  */
-size_t
-CListSize(
-   IN CLIST* This)
+static
+CLIST_IMPL*
+InGetImpl(
+   IN CLIST* List)
 {
-   STATUS_CODE status = SC_SUCCESS;
+   CLIST_IMPL* impl = GET_STRUCT_FIELD(List, CLIST_IMPL, VTable);
+   if ((NULL == impl) || (impl->StructureId != CLIST_IMPL_STRUCT_ID)) { return NULL; }
 
-   do
-   {
-      GET_THIS(This, CLIST_IMPL);
-      return this->Size;
-   } while (false);
+   return impl;
+}
 
-   return 0;
+
+/**
+ * Checks that nodes of the Other list can be moved into the List.
+ *
+ * @param[in]  List   List
+ * @param[in]  Other  Other list
+ *
+ * @return  true if both lists store data the same way
+ */
+static
+bool
+InIsCompatible(
+   IN CLIST_IMPL* List,
+   IN CLIST_IMPL* Other)
+{
+   return (List->Allocator == Other->Allocator) &&
+          (List->Flags == Other->Flags) &&
+          (List->ElementSize == Other->ElementSize);
 }
 
 
 /**
- * Returns the node with the last elemet in the list.
+ * Checks whether the nodes of the List come from a pool of its own, which
+ * is released together with the list.
  *
- * @param[in]  This  Pointer to CList protocol
+ * @param[in]  List  List
  *
- * @retval  NULL         If This is invalid or the list is empty
- * @retval  CLIST_NODE*  List tail
+ * @return  true if the node allocator belongs to the List
  */
-CLIST_NODE*
-CListBack(
-   IN CLIST* This)
+static
+bool
+InOwnsNodePool(
+   IN CLIST_IMPL* List)
+{
+   return (List->NodeAllocator != List->Allocator) &&
+          (List->NodeAllocator != &g_NodeHeap.VTable);
+}
+
+
+/**
+ * Releases an empty list.
+ *
+ * @param[in]  List  Empty list
+ */
+static
+void
+InDeleteEmptyList(
+   IN CLIST_IMPL* List)
+{
+   ALLOCATOR* allocator = List->Allocator;
+
+   if (InOwnsNodePool(List)) { PoolAllocatorDelete(List->NodeAllocator); }
+
+#ifdef CLIST_ENABLE_STATS
+   InUnregisterList(List);
+#endif
+
+   List->StructureId = 0;
+   allocator->Free(allocator, List, sizeof(CLIST_IMPL));
+}
+
+
+/**
+ * Excludes the nodes [First, Last] from the list without releasing them.
+ *
+ * @param[in]  List   List
+ * @param[in]  First  First node of the range
+ * @param[in]  Last   Last node of the range
+ * @param[in]  Count  Number of nodes in the range
+ */
+static
+void
+InUnlinkRange(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* First,
+   IN CLIST_NODE* Last,
+   IN size_t      Count)
+{
+   if (First->Prev != NULL) { First->Prev->Next = Last->Next; }
+   else                     { List->Head = Last->Next; }
+
+   if (Last->Next != NULL) { Last->Next->Prev = First->Prev; }
+   else                    { List->Tail = First->Prev; }
+
+   List->Size -= Count;
+}
+
+
+/**
+ * Copies Count nodes starting from First into nodes allocated for the List.
+ *
+ * @param[in]   List   List the copies are allocated for
+ * @param[in]   Other  Compatible list that owns the original nodes
+ * @param[in]   First  First node to copy
+ * @param[in]   Count  Number of nodes to copy
+ * @param[out]  Copy   First node of the copied chain
+ * @param[out]  Last   Last node of the copied chain
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, no copies are left
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InCopyRange(
+   IN  CLIST_IMPL*  List,
+   IN  CLIST_IMPL*  Other,
+   IN  CLIST_NODE*  First,
+   IN  size_t       Count,
+   OUT CLIST_NODE** Copy,
+   OUT CLIST_NODE** Last)
 {
    STATUS_CODE status = SC_SUCCESS;
+   CLIST_NODE* first = NULL;
+   CLIST_NODE* last = NULL;
+   CLIST_NODE* node = First;
 
-   do
+   for (size_t i = 0; i < Count; ++i, node = node->Next)
    {
-      GET_THIS(This, CLIST_IMPL);
-      return this->Tail;
-   } while (false);
+      size_t nodeSize = InGetNodeSize(Other, InGetDataSize(Other, node));
 
-   return NULL;
+      CLIST_NODE* copy = InAllocNode(List, nodeSize);
+      if (NULL == copy)
+      {
+         while (first != NULL)
+         {
+            CLIST_NODE* next = first->Next;
+            InFreeNode(List, first, InGetNodeSize(List, InGetDataSize(List, first)));
+            first = next;
+         }
+
+         SET_SC(SC_NOT_ENOUGH_MEMORY);
+         return status;
+      }
+
+      memcpy(copy, node, nodeSize);
+
+      // Data stored inside the node moves with it
+      char* data = node->Data;
+      if ((data >= (char*)node) && (data < (char*)node + nodeSize))
+      {
+         copy->Data = (char*)copy + (data - (char*)node);
+      }
+
+      copy->Prev = last;
+      copy->Next = NULL;
+      if (last != NULL) { last->Next = copy; }
+      else              { first = copy; }
+      last = copy;
+   }
+
+   *Copy = first;
+   *Last = last;
+
+   return status;
 }
 
 
 /**
- * Creates a node with a copy of the Data at the end of the list.
+ * Moves Count nodes [First, Last] of the Other list before Position.
  *
- * @param[in]  This      Pointer to CList protocol
- * @param[in]  Data      Data
- * @param[in]  DataSize  Data size
+ * @param[in]  List      List
+ * @param[in]  Position  Position in the List, NULL to move to the end
+ * @param[in]  Other     Compatible list that contains the range
+ * @param[in]  First     First node of the range
+ * @param[in]  Last      Last node of the range
+ * @param[in]  Count     Number of nodes in the range
  *
- * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, lists are unchanged
  * @retval  SC_SUCCESS            On success
- * @retval  SC_UNSUCCESSFUL       On failure
  */
 static
 STATUS_CODE
-CListPushBack(
-   IN CLIST* This,
-   IN void*  Data,
-   IN size_t DataSize)
+InMoveRange(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* Position,
+   IN CLIST_IMPL* Other,
+   IN CLIST_NODE* First,
+   IN CLIST_NODE* Last,
+   IN size_t      Count)
 {
    STATUS_CODE status = SC_SUCCESS;
 
    do
    {
-      GET_THIS(This, CLIST_IMPL);
-      if (NULL == Data || 0 == DataSize)
+      CLIST_NODE* first = First;
+      CLIST_NODE* last = Last;
+
+      // Nodes from another pool are copied, so a pool owned by a compacted
+      // list can be released independently
+      if (List->NodeAllocator != Other->NodeAllocator)
       {
-         SET_SC(SC_INVALID_PARAMETER);
-         break;
+         status = InCopyRange(List, Other, First, Count, &first, &last);
+         if (SC_ERROR(status)) { break; }
       }
 
-      CLIST_NODE* node = InCreateNode(Data, DataSize, this->Tail, NULL);
+      InUnlinkRange(Other, First, Last, Count);
 
-      if (0 == this->Size)
+      if (first != First)
       {
-         this->Head = this->Tail = node;
+         CLIST_NODE* node = First;
+         for (size_t i = 0; i < Count; ++i)
+         {
+            CLIST_NODE* next = node->Next;
+            InFreeNode(Other, node, InGetNodeSize(Other, InGetDataSize(Other, node)));
+            node = next;
+         }
       }
-      else
+
+#ifdef CLIST_ENABLE_STATS
+      if (List != Other)
       {
-         this->Tail->Next = node;
-         this->Tail = node;
+         size_t bytes = 0;
+         CLIST_NODE* node = first;
+         for (size_t i = 0; i < Count; ++i, node = node->Next)
+         {
+            bytes += InGetNodeBytes(List, node);
+         }
+
+         CLIST_STAT_RELEASE(Other, bytes);
+         CLIST_STAT_HOLD(List, bytes);
       }
+#endif
 
-      ++this->Size;
+      CLIST_NODE* prev = (Position != NULL) ? Position->Prev : List->Tail;
+      InLinkChain(List, prev, Position, first, last, Count);
 
    } while (false);
 
@@ -554,13 +968,2108 @@ CListPushBack(
 }
 
 
-CLIST*
-CListCreate()
-{
-   CLIST_IMPL* this = malloc(sizeof(CLIST_IMPL));
-   if (NULL == this) { return NULL; }
-
+/**
+ * Merges two sorted chains linked through Next. Nodes of Left go first
+ * among equivalent nodes.
+ *
+ * @param[in]  List        List the nodes belong to
+ * @param[in]  Left        Sorted chain of earlier nodes
+ * @param[in]  Right       Sorted chain of later nodes
+ * @param[in]  Comparator  Comparator of the node data
+ * @param[in]  Context     Context for the Comparator
+ *
+ * @return  Head of the merged chain
+ */
+static
+CLIST_NODE*
+InMergeChains(
+   IN CLIST_IMPL*      List,
+   IN CLIST_NODE*      Left,
+   IN CLIST_NODE*      Right,
+   IN CLIST_COMPARATOR Comparator,
+   IN void*            Context)
+{
+   CLIST_NODE* head = NULL;
+   CLIST_NODE** tail = &head;
+
+   while ((Left != NULL) && (Right != NULL))
+   {
+      int order = Comparator(Right->Data, InGetDataSize(List, Right),
+                             Left->Data, InGetDataSize(List, Left),
+                             Context);
+      if (order < 0)
+      {
+         *tail = Right;
+         Right = Right->Next;
+      }
+      else
+      {
+         *tail = Left;
+         Left = Left->Next;
+      }
+
+      tail = &(*tail)->Next;
+   }
+
+   *tail = (Left != NULL) ? Left : Right;
+
+   return head;
+}
+
+
+/**
+ * Sorts a chain of nodes linked through Next with a bottom-up merge sort.
+ * Prev pointers are left stale.
+ *
+ * @param[in]  List        List the nodes belong to
+ * @param[in]  First       Head of the chain
+ * @param[in]  Comparator  Comparator of the node data
+ * @param[in]  Context     Context for the Comparator
+ *
+ * @return  Head of the sorted chain
+ */
+static
+CLIST_NODE*
+InSortChain(
+   IN CLIST_IMPL*      List,
+   IN CLIST_NODE*      First,
+   IN CLIST_COMPARATOR Comparator,
+   IN void*            Context)
+{
+   // Bins with greater indices hold earlier nodes
+   CLIST_NODE* bins[CLIST_SORT_BINS] = { NULL };
+   size_t used = 0;
+
+   while (First != NULL)
+   {
+      CLIST_NODE* carry = First;
+      First = First->Next;
+      carry->Next = NULL;
+
+      size_t i = 0;
+      for (; (i < used) && (bins[i] != NULL); ++i)
+      {
+         carry = InMergeChains(List, bins[i], carry, Comparator, Context);
+         bins[i] = NULL;
+      }
+
+      bins[i] = carry;
+      if (i == used) { ++used; }
+   }
+
+   CLIST_NODE* result = NULL;
+   for (size_t i = 0; i < used; ++i)
+   {
+      if (bins[i] != NULL)
+      {
+         result = InMergeChains(List, bins[i], result, Comparator, Context);
+      }
+   }
+
+   return result;
+}
+
+
+/**
+ * Thread routine of CListSortParallel.
+ *
+ * @param[in]  Run  CLIST_SORT_RUN to sort
+ *
+ * @return  0
+ */
+static
+int
+InSortRunThread(
+   IN void* Run)
+{
+   CLIST_SORT_RUN* run = Run;
+
+   run->First = InSortChain(run->List, run->First, run->Comparator, run->Context);
+
+   return 0;
+}
+
+
+/**
+ * Prefetches the data of the Node and the node after it.
+ *
+ * @param[in]  Node  Node of the list
+ *
+ * @return  The node after the Node
+ */
+static
+CLIST_NODE*
+InPrefetchNode(
+   IN CLIST_NODE* Node)
+{
+   CLIST_NODE* next = Node->Next;
+
+   CLIST_PREFETCH(Node->Data);
+   CLIST_PREFETCH(next);
+
+   return next;
+}
+
+
+/**
+ * Thread routine of the parallel traversals, visits the nodes of a chunk.
+ *
+ * @param[in]  Run  CLIST_PARALLEL_RUN to visit
+ *
+ * @return  0
+ */
+static
+int
+InParallelRunThread(
+   IN void* Run)
+{
+   CLIST_PARALLEL_RUN* run = Run;
+   CLIST_IMPL* list = run->List;
+   CLIST_NODE* node = run->First;
+
+   for (size_t i = 0; i < run->Count; ++i, node = node->Next)
+   {
+      if (run->Reducer != NULL)
+      {
+         run->Reducer(run->Accumulator, node->Data, InGetDataSize(list, node), run->Context);
+      }
+      else
+      {
+         run->Visitor(node->Data, InGetDataSize(list, node), run->Context);
+      }
+   }
+
+   return 0;
+}
+
+
+/**
+ * Visits all nodes of the List in chunks with up to ThreadCount threads.
+ *
+ * With a Reducer every chunk but the first folds its nodes into a copy of
+ * the initial Accumulator, the first one folds them into the Accumulator
+ * itself. The chunk results are then combined in list order.
+ *
+ * @param[in]  List             List
+ * @param[in]  Template         Run with the Visitor or the Reducer and the Context
+ * @param[in]  Combiner         Combiner of the chunk results, NULL without Reducer
+ * @param[in]  AccumulatorSize  Size of the Accumulator of the Template
+ * @param[in]  ThreadCount      Maximum number of threads, including the caller
+ */
+static
+void
+InParallelVisit(
+   IN CLIST_IMPL*               List,
+   IN const CLIST_PARALLEL_RUN* Template,
+   IN CLIST_COMBINER            Combiner,
+   IN size_t                    AccumulatorSize,
+   IN size_t                    ThreadCount)
+{
+   size_t runCount = List->Size / CLIST_PARALLEL_MIN_CHUNK;
+   if (runCount > ThreadCount) { runCount = ThreadCount; }
+
+   // Runs are followed by the accumulators of all chunks but the first
+   ALLOCATOR* allocator = List->Allocator;
+   size_t runsSize = ALLOCATOR_ALIGN_UP(runCount * sizeof(CLIST_PARALLEL_RUN));
+   size_t accumulatorStride = ALLOCATOR_ALIGN_UP(AccumulatorSize);
+   size_t blockSize = runsSize + ((runCount > 1) ? (runCount - 1) * accumulatorStride : 0);
+   CLIST_PARALLEL_RUN* runs = (runCount > 1) ? allocator->Alloc(allocator, blockSize) : NULL;
+
+   // Not worth it or no memory for the runs, visit in this thread
+   if (NULL == runs)
+   {
+      CLIST_PARALLEL_RUN run = *Template;
+      run.First = List->Head;
+      run.Count = List->Size;
+      InParallelRunThread(&run);
+      return;
+   }
+
+   size_t chunk = List->Size / runCount;
+   for (size_t i = 0; i < runCount; ++i)
+   {
+      runs[i] = *Template;
+      runs[i].Count = (i + 1 < runCount) ? chunk : List->Size - chunk * (runCount - 1);
+      runs[i].IsStarted = false;
+
+      if ((i > 0) && (Template->Reducer != NULL))
+      {
+         runs[i].Accumulator = (char*)runs + runsSize + (i - 1) * accumulatorStride;
+         memcpy(runs[i].Accumulator, Template->Accumulator, AccumulatorSize);
+      }
+   }
+
+   // Every chunk starts as soon as its first node is found, the calling
+   // thread visits the last chunk and the chunks without threads
+   CLIST_NODE* node = List->Head;
+   for (size_t i = 0; i < runCount; ++i)
+   {
+      runs[i].First = node;
+      if (i + 1 == runCount) { break; }
+
+      runs[i].IsStarted =
+         (thrd_success == thrd_create(&runs[i].Thread, InParallelRunThread, &runs[i]));
+
+      for (size_t j = 0; j < runs[i].Count; ++j) { node = node->Next; }
+   }
+
+   InParallelRunThread(&runs[runCount - 1]);
+
+   for (size_t i = 0; i + 1 < runCount; ++i)
+   {
+      if (runs[i].IsStarted) { thrd_join(runs[i].Thread, NULL); }
+      else                   { InParallelRunThread(&runs[i]); }
+   }
+
+   if (Template->Reducer != NULL)
+   {
+      for (size_t i = 1; i < runCount; ++i)
+      {
+         Combiner(Template->Accumulator, runs[i].Accumulator, Template->Context);
+      }
+   }
+
+   allocator->Free(allocator, runs, blockSize);
+}
+
+
+/**
+ * Makes the chain linked through Next the content of the List and
+ * restores Prev pointers.
+ *
+ * @param[in]  List   List
+ * @param[in]  First  Head of the chain with all nodes of the List
+ */
+static
+void
+InRelinkChain(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* First)
+{
+   CLIST_NODE* prev = NULL;
+
+   for (CLIST_NODE* node = First; node != NULL; node = node->Next)
+   {
+      node->Prev = prev;
+      prev = node;
+   }
+
+   List->Head = First;
+   List->Tail = prev;
+}
+
+
+/**
+ * Excludes the Node from the list without releasing it.
+ *
+ * @param[in]  List  List
+ * @param[in]  Node  Node in the list
+ */
+static
+void
+InUnlinkNode(
+   IN CLIST_IMPL* List,
+   IN CLIST_NODE* Node)
+{
+   if (Node->Prev != NULL) { Node->Prev->Next = Node->Next; }
+   else                    { List->Head = Node->Next; }
+
+   if (Node->Next != NULL) { Node->Next->Prev = Node->Prev; }
+   else                    { List->Tail = Node->Prev; }
+
+   --List->Size;
+}
+
+
+/**
+ * Hands the data of the Node to the caller, unlinks and releases the node.
+ *
+ * Data stored in the node is copied into a buffer allocated from the list
+ * allocator.
+ *
+ * @param[in]   List      List
+ * @param[in]   Node      Node in the list
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the node is intact
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InTakeNodeData(
+   IN  CLIST_IMPL* List,
+   IN  CLIST_NODE* Node,
+   OUT void**      Data,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   ALLOCATOR* allocator = List->Allocator;
+   size_t dataSize = InGetDataSize(List, Node);
+
+   do
+   {
+      if (InIsDataInNode(List, Node))
+      {
+         *Data = allocator->Alloc(allocator, dataSize);
+         if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+         memcpy(*Data, Node->Data, dataSize);
+      }
+      else
+      {
+         *Data = Node->Data;
+      }
+
+      *DataSize = dataSize;
+      CLIST_STAT_RELEASE(List, InGetNodeBytes(List, Node));
+      InUnlinkNode(List, Node);
+      InFreeNode(List, Node, InGetNodeSize(List, dataSize));
+
+   } while (false);
+
+   return status;
+}
+
+
+///////////////////////////////////////////////////////////
+///              CList API implementation               ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Creates a node with a copy of the Data at the head of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CListPushFront(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Data) || !InIsValidDataSize(this, DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InPushFront(this, Data, DataSize, false);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the first node in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  NULL         If This is invalid or the list is empty
+ * @retval  CLIST_NODE*  List head
+ */
+static
+CLIST_NODE*
+CListFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      return this->Head;
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Gets a link to the data stored in the Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Triple pointer to data
+ * @param[in]  DataSize  Pointer to pointer to data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  No memory for the buffer of small data
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListGetRefToData(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void***     Data,
+   IN size_t**    DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // Small data gets a buffer of its own, which the caller may replace
+      if (!(this->Flags & CLIST_FLAG_INLINE_DATA) && InIsDataInNode(this, Position))
+      {
+         ALLOCATOR* allocator = this->Allocator;
+         void* buffer = allocator->Alloc(allocator, Position->DataSize);
+         if (NULL == buffer) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+         memcpy(buffer, Position->Data, Position->DataSize);
+         Position->Data = buffer;
+
+         CLIST_STAT_ADD(this, PayloadAllocations, 1);
+         CLIST_STAT_HOLD(this, Position->DataSize);
+      }
+
+      *Data = &Position->Data;
+      *DataSize = (this->ElementSize != 0) ? &this->ElementSize :
+                                             &Position->DataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Gets a copy of the data stored in the Position node.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[in]   Position  Position in the list
+ * @param[out]  Data      Data
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListGetCopyData(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   OUT void**     Data,
+   OUT size_t*    DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+
+      if ((NULL == Position) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      size_t dataSize = InGetDataSize(this, Position);
+
+      *Data = malloc(dataSize);
+      if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(*Data, Position->Data, dataSize);
+      *DataSize = dataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the previous node in the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  CLIST_NODE*  Next node
+ * @retval  NULL         If Invalid input parameter or there is no previous node
+ */
+static
+CLIST_NODE*
+CListPrev(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CLIST_STAT_ADD(this, TraversalSteps, 1);
+      return Position->Prev;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the next node in the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  CLIST_NODE*  Next node
+ * @retval  NULL         If Invalid input parameter or there is no next node
+ */
+static
+CLIST_NODE*
+CListNext(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CLIST_STAT_ADD(this, TraversalSteps, 1);
+      return Position->Next;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Creates a node with a copy of the Data before Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       Otherwise
+ */
+static
+STATUS_CODE
+CListInsertBefore(
+   IN CLIST* This,
+   IN CLIST_NODE* Position,
+   IN void* Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) ||
+          !InIsValidDataSize(this, DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CLIST_NODE* node = InCreateNode(this, Data, DataSize, false, Position->Prev, Position);
+      if (NULL == node) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      if(Position->Prev != NULL)
+      {
+         Position->Prev->Next = node;
+      }
+      else
+      {
+         this->Head = node;
+      }
+      Position->Prev = node;
+
+      ++this->Size;
+      CLIST_STAT_ADD(this, Inserts, 1);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node with a copy of the Data after Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       Otherwise
+ */
+static
+STATUS_CODE
+CListInsertAfter(
+   IN CLIST* This,
+   IN CLIST_NODE* Position,
+   IN void* Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) ||
+          !InIsValidDataSize(this, DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CLIST_NODE* node = InCreateNode(this, Data, DataSize, false, Position, Position->Next);
+      if (NULL == node) { SET_SC(SC_UNSUCCESSFUL); break; }
+      Position->Next = node;
+      if (node->Next != NULL)
+      {
+         node->Next->Prev = node;
+      }
+      else
+      {
+         this->Tail = node;
+      }
+
+      ++this->Size;
+      CLIST_STAT_ADD(this, Inserts, 1);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the first node in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+void
+CListPopFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+
+      if (0 == this->Size)
+      {
+         return;
+      }
+      else if (1 == this->Size)
+      {
+         InDeleteNode(this, this->Head);
+         this->Head = this->Tail = NULL;
+
+         --this->Size;
+      }
+      else
+      {
+         CLIST_NODE* tmp = this->Head;
+         this->Head = tmp->Next;
+         this->Head->Prev = tmp->Prev;
+         InDeleteNode(this, tmp);
+         --this->Size;
+      }
+
+      CLIST_STAT_ADD(this, Pops, 1);
+
+   } while (false);
+
+}
+
+
+/**
+ * Removes the last node in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CListPopBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+
+      CLIST_NODE* node = this->Tail;
+      if (NULL == node) { break; }
+
+      InUnlinkNode(this, node);
+      InDeleteNode(this, node);
+
+      CLIST_STAT_ADD(this, Pops, 1);
+
+   } while (false);
+}
+
+
+/**
+ * Removes the Position node from the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Node of the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListRemove(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      InUnlinkNode(this, Position);
+      InDeleteNode(this, Position);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes all nodes from the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListClear(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      InDeleteNodes(this);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the number of nodes.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  Number of nodes. If This is invalid then returns 0.
+ */
+size_t
+CListSize(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      return this->Size;
+   } while (false);
+
+   return 0;
+}
+
+
+/**
+ * Returns the node with the last elemet in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  NULL         If This is invalid or the list is empty
+ * @retval  CLIST_NODE*  List tail
+ */
+CLIST_NODE*
+CListBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      return this->Tail;
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Creates a node with a copy of the Data at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CListPushBack(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Data) || !InIsValidDataSize(this, DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InPushBack(this, Data, DataSize, false);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node that adopts the Data buffer at the head of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data buffer allocated from the list allocator
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CListPushFrontTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Data) || !InIsValidDataSize(this, DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InPushFront(this, Data, DataSize, true);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node that adopts the Data buffer at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data buffer allocated from the list allocator
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CListPushBackTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Data) || !InIsValidDataSize(this, DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InPushBack(this, Data, DataSize, true);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the first node and hands its data buffer to the caller.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer to be released with the list allocator
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListPopFrontTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CLIST_NODE* node = this->Head;
+      if (NULL == node) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      status = InTakeNodeData(this, node, Data, DataSize);
+      if (SC_ERROR(status)) { break; }
+
+      CLIST_STAT_ADD(this, Pops, 1);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the last node and hands its data buffer to the caller.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer to be released with the list allocator
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListPopBackTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CLIST_NODE* node = this->Tail;
+      if (NULL == node) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      status = InTakeNodeData(this, node, Data, DataSize);
+      if (SC_ERROR(status)) { break; }
+
+      CLIST_STAT_ADD(this, Pops, 1);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Copies the data stored in the Position node into the caller's Buffer.
+ *
+ * @param[in]   This        Pointer to CList protocol
+ * @param[in]   Position    Position in the list
+ * @param[out]  Buffer      Buffer for the data
+ * @param[in]   BufferSize  Buffer size
+ * @param[out]  DataSize    Data size, also set if the buffer is too small
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_BUFFER_TOO_SMALL   BufferSize is less than the data size
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListGetCopyDataInto(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void*       Buffer,
+   IN  size_t      BufferSize,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Position) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      size_t dataSize = InGetDataSize(this, Position);
+
+      *DataSize = dataSize;
+      if ((NULL == Buffer) || (BufferSize < dataSize))
+      {
+         SET_SC(SC_BUFFER_TOO_SMALL);
+         break;
+      }
+
+      memcpy(Buffer, Position->Data, dataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes with copies of Count records at the head of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CListPushFrontBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Records) || !InIsValidDataSize(this, DataSize) ||
+          (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (0 == Count) { break; }
+
+      CLIST_NODE* first = NULL;
+      CLIST_NODE* last = NULL;
+      status = InCreateChain(this, Records, DataSize, Stride, Count, &first, &last);
+      if (SC_ERROR(status)) { break; }
+
+      InLinkChain(this, NULL, this->Head, first, last, Count);
+      CLIST_STAT_ADD(this, Pushes, Count);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes with copies of Count records at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CListPushBackBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Records) || !InIsValidDataSize(this, DataSize) ||
+          (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (0 == Count) { break; }
+
+      CLIST_NODE* first = NULL;
+      CLIST_NODE* last = NULL;
+      status = InCreateChain(this, Records, DataSize, Stride, Count, &first, &last);
+      if (SC_ERROR(status)) { break; }
+
+      InLinkChain(this, this->Tail, NULL, first, last, Count);
+      CLIST_STAT_ADD(this, Pushes, Count);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes with copies of Count records after Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CListInsertAfterBatch(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Records,
+   IN size_t      DataSize,
+   IN size_t      Stride,
+   IN size_t      Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Position) || (NULL == Records) ||
+          !InIsValidDataSize(this, DataSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (0 == Count) { break; }
+
+      CLIST_NODE* first = NULL;
+      CLIST_NODE* last = NULL;
+      status = InCreateChain(this, Records, DataSize, Stride, Count, &first, &last);
+      if (SC_ERROR(status)) { break; }
+
+      InLinkChain(this, Position, Position->Next, first, last, Count);
+      CLIST_STAT_ADD(this, Inserts, Count);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Moves the nodes [First, Last] of the Other list before Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in This list, NULL to move to the end
+ * @param[in]  Other     List that contains the range, may be This
+ * @param[in]  First     First node of the range
+ * @param[in]  Last      Last node of the range
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListSplice(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN CLIST*      Other,
+   IN CLIST_NODE* First,
+   IN CLIST_NODE* Last)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      CLIST_IMPL* other = InGetImpl(Other);
+      if ((NULL == other) || (NULL == First) || (NULL == Last) ||
+          !InIsCompatible(this, other))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // Count the range and make sure Position isn't inside it
+      CLIST_NODE* node = First;
+      bool hasPosition = false;
+      size_t count = 0;
+      while (node != NULL)
+      {
+         ++count;
+         hasPosition = hasPosition || (node == Position);
+         if (node == Last) { break; }
+         node = node->Next;
+      }
+
+      if ((NULL == node) || hasPosition)
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if ((this == other) && (Last->Next == Position)) { break; }
+
+      status = InMoveRange(this, Position, other, First, Last, count);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Moves the nodes after Position node into a new list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  CLIST*  New list with the nodes after Position
+ * @retval  NULL    If Invalid input parameter or on failure
+ */
+static
+CLIST*
+CListSplitAfter(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CLIST* list = (this->ElementSize != 0) ?
+                    CListCreateFixed(this->ElementSize) :
+                    CListCreateEx(this->Flags, this->Allocator);
+      if (NULL == list) { break; }
+
+      if (NULL == Position->Next) { return list; }
+
+      size_t count = 0;
+      for (CLIST_NODE* node = Position->Next; node != NULL; node = node->Next)
+      {
+         ++count;
+      }
+
+      CLIST_IMPL* other = InGetImpl(list);
+      status = InMoveRange(other, NULL, this, Position->Next, this->Tail, count);
+      if (SC_ERROR(status))
+      {
+         InDeleteEmptyList(other);
+         break;
+      }
+
+      return list;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Moves all nodes of the Other list to the end of This list.
+ *
+ * @param[in]  This   Pointer to CList protocol
+ * @param[in]  Other  List to empty into This
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListAppend(
+   IN CLIST* This,
+   IN CLIST* Other)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      CLIST_IMPL* other = InGetImpl(Other);
+      if ((NULL == other) || (other == this) || !InIsCompatible(this, other))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (0 == other->Size) { break; }
+
+      status = InMoveRange(this, NULL, other, other->Head, other->Tail, other->Size);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Sorts the list in ascending order defined by the Comparator.
+ *
+ * @param[in]  This        Pointer to CList protocol
+ * @param[in]  Comparator  Comparator of the node data
+ * @param[in]  Context     Context for the Comparator, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListSort(
+   IN          CLIST*           This,
+   IN          CLIST_COMPARATOR Comparator,
+   IN OPTIONAL void*            Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if (NULL == Comparator) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      if (this->Size < 2) { break; }
+
+      InRelinkChain(this, InSortChain(this, this->Head, Comparator, Context));
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Sorts the list like CListSort using up to ThreadCount threads.
+ *
+ * @param[in]  This         Pointer to CList protocol
+ * @param[in]  Comparator   Comparator of the node data
+ * @param[in]  Context      Context for the Comparator, may be NULL
+ * @param[in]  ThreadCount  Maximum number of threads, including the caller
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListSortParallel(
+   IN          CLIST*           This,
+   IN          CLIST_COMPARATOR Comparator,
+   IN OPTIONAL void*            Context,
+   IN          size_t           ThreadCount)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Comparator) || (0 == ThreadCount))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      size_t runCount = this->Size / CLIST_PARALLEL_SORT_MIN_RUN;
+      if (runCount > ThreadCount) { runCount = ThreadCount; }
+
+      ALLOCATOR* allocator = this->Allocator;
+      CLIST_SORT_RUN* runs = (runCount > 1) ?
+                             allocator->Alloc(allocator, runCount * sizeof(CLIST_SORT_RUN)) :
+                             NULL;
+
+      // Not worth it or no memory for the runs, sort in this thread
+      if (NULL == runs)
+      {
+         status = CListSort(This, Comparator, Context);
+         break;
+      }
+
+      // Cut the list into runs of equal length, the last takes the rest
+      size_t runLength = this->Size / runCount;
+      CLIST_NODE* node = this->Head;
+      for (size_t i = 0; i < runCount; ++i)
+      {
+         runs[i].List = this;
+         runs[i].Comparator = Comparator;
+         runs[i].Context = Context;
+         runs[i].First = node;
+         runs[i].IsStarted = false;
+
+         if (i + 1 < runCount)
+         {
+            for (size_t j = 1; j < runLength; ++j) { node = node->Next; }
+
+            CLIST_NODE* next = node->Next;
+            node->Next = NULL;
+            node = next;
+         }
+      }
+
+      // The calling thread sorts the first run and the runs without threads
+      for (size_t i = 1; i < runCount; ++i)
+      {
+         runs[i].IsStarted =
+            (thrd_success == thrd_create(&runs[i].Thread, InSortRunThread, &runs[i]));
+      }
+
+      for (size_t i = 0; i < runCount; ++i)
+      {
+         if (runs[i].IsStarted) { thrd_join(runs[i].Thread, NULL); }
+         else                   { InSortRunThread(&runs[i]); }
+      }
+
+      // Merge neighbouring runs to keep the sort stable
+      for (size_t width = 1; width < runCount; width *= 2)
+      {
+         for (size_t i = 0; i + width < runCount; i += 2 * width)
+         {
+            runs[i].First = InMergeChains(this, runs[i].First, runs[i + width].First,
+                                          Comparator, Context);
+         }
+      }
+
+      InRelinkChain(this, runs[0].First);
+      allocator->Free(allocator, runs, runCount * sizeof(CLIST_SORT_RUN));
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Calls the Visitor for the data of every node in list order.
+ *
+ * @param[in]  This     Pointer to CList protocol
+ * @param[in]  Visitor  Function called for every node
+ * @param[in]  Context  Context for the Visitor, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListForEach(
+   IN          CLIST*        This,
+   IN          CLIST_VISITOR Visitor,
+   IN OPTIONAL void*         Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if (NULL == Visitor) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      // The lookahead runs CLIST_PREFETCH_DISTANCE nodes ahead, so its
+      // nodes and their data are loading while the Visitor runs
+      CLIST_NODE* ahead = this->Head;
+      for (size_t i = 0; (i < CLIST_PREFETCH_DISTANCE) && (ahead != NULL); ++i)
+      {
+         ahead = InPrefetchNode(ahead);
+      }
+
+      for (CLIST_NODE* node = this->Head; node != NULL; node = node->Next)
+      {
+         if (ahead != NULL) { ahead = InPrefetchNode(ahead); }
+
+         Visitor(node->Data, InGetDataSize(this, node), Context);
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Reads the data of up to Capacity nodes starting from *Position.
+ *
+ * @param[in]      This      Pointer to CList protocol
+ * @param[in,out]  Position  First node to read, the node after the last
+ *                           read one on output
+ * @param[out]     Items     Array of Capacity items
+ * @param[in]      Capacity  Maximum number of nodes to read
+ * @param[out]     Count     Number of read nodes
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListNextBatch(
+   IN     CLIST*       This,
+   IN OUT CLIST_NODE** Position,
+   OUT    CLIST_ITEM*  Items,
+   IN     size_t       Capacity,
+   OUT    size_t*      Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Position) || (NULL == Items) || (0 == Capacity) || (NULL == Count))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // Only the walk waits for memory, the data of the items is loading
+      // while the rest of the batch is collected and processed
+      CLIST_NODE* node = *Position;
+      size_t count = 0;
+      for (; (node != NULL) && (count < Capacity); ++count)
+      {
+         Items[count].Data = node->Data;
+         Items[count].DataSize = InGetDataSize(this, node);
+         node = InPrefetchNode(node);
+      }
+
+      *Position = node;
+      *Count = count;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Calls the Visitor for the data of every node using up to ThreadCount threads.
+ *
+ * @param[in]  This         Pointer to CList protocol
+ * @param[in]  Visitor      Function called for every node
+ * @param[in]  Context      Context for the Visitor, may be NULL
+ * @param[in]  ThreadCount  Maximum number of threads, including the caller
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListParallelForEach(
+   IN          CLIST*        This,
+   IN          CLIST_VISITOR Visitor,
+   IN OPTIONAL void*         Context,
+   IN          size_t        ThreadCount)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Visitor) || (0 == ThreadCount))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CLIST_PARALLEL_RUN run = { 0 };
+      run.List = this;
+      run.Visitor = Visitor;
+      run.Context = Context;
+
+      InParallelVisit(this, &run, NULL, 0, ThreadCount);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Folds the data of all nodes into the Accumulator using up to ThreadCount
+ * threads.
+ *
+ * @param[in]  This             Pointer to CList protocol
+ * @param[in]  Reducer          Function that folds a node into a chunk result
+ * @param[in]  Combiner         Function that folds chunk results together
+ * @param[in]  Context          Context for the Reducer and the Combiner, may be NULL
+ * @param[in]  Accumulator      Identity value on input, the result on output
+ * @param[in]  AccumulatorSize  Size of the Accumulator
+ * @param[in]  ThreadCount      Maximum number of threads, including the caller
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListParallelReduce(
+   IN          CLIST*         This,
+   IN          CLIST_REDUCER  Reducer,
+   IN          CLIST_COMBINER Combiner,
+   IN OPTIONAL void*          Context,
+   IN OUT      void*          Accumulator,
+   IN          size_t         AccumulatorSize,
+   IN          size_t         ThreadCount)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if ((NULL == Reducer) || (NULL == Combiner) || (NULL == Accumulator) ||
+          (0 == AccumulatorSize) || (0 == ThreadCount))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CLIST_PARALLEL_RUN run = { 0 };
+      run.List = this;
+      run.Reducer = Reducer;
+      run.Context = Context;
+      run.Accumulator = Accumulator;
+
+      InParallelVisit(this, &run, Combiner, AccumulatorSize, ThreadCount);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Copies the counters of the list.
+ *
+ * @param[in]   This   Pointer to CList protocol
+ * @param[out]  Stats  Counters of the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       Built without CLIST_ENABLE_STATS
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListGetStats(
+   IN  CLIST*       This,
+   OUT CLIST_STATS* Stats)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if (NULL == Stats) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+#ifdef CLIST_ENABLE_STATS
+      *Stats = this->StatsEntry->Stats;
+#else
+      SET_SC(SC_UNSUCCESSFUL);
+#endif
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Moves all nodes into one contiguous block in list order.
+ *
+ * @param[in]  This       Pointer to CList protocol
+ * @param[in]  Flags      0 or CLIST_COMPACT_PAYLOADS
+ * @param[in]  Relocator  Receiver of moved handles, may be NULL
+ * @param[in]  Context    Context for the Relocator, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       Nodes of the list differ in size
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CListCompact(
+   IN          CLIST*          This,
+   IN          uint32_t        Flags,
+   IN OPTIONAL CLIST_RELOCATOR Relocator,
+   IN OPTIONAL void*           Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_IMPL);
+      if (Flags & ~CLIST_COMPACT_PAYLOADS) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      if ((0 == this->ElementSize) && (this->Flags & CLIST_FLAG_INLINE_DATA))
+      {
+         SET_SC(SC_UNSUCCESSFUL);
+         break;
+      }
+
+      if (0 == this->Size) { break; }
+
+      // Every node has the same size, the first block holds all of them
+      ALLOCATOR* allocator = this->Allocator;
+      size_t nodeSize = InGetNodeSize(this, 0);
+      size_t nodesPerSlab = CLIST_SLAB_SIZE / ALLOCATOR_ALIGN_UP(nodeSize);
+      size_t nodesPerBlock = (this->Size > nodesPerSlab) ? this->Size : nodesPerSlab;
+      ALLOCATOR* pool = PoolAllocatorCreate(nodeSize, nodesPerBlock, allocator);
+      if (NULL == pool) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CLIST_NODE* head = NULL;
+      CLIST_NODE* tail = NULL;
+      for (CLIST_NODE* node = this->Head; node != NULL; node = node->Next)
+      {
+         CLIST_NODE* copy = pool->Alloc(pool, nodeSize);
+         if (NULL == copy) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+         memcpy(copy, node, nodeSize);
+
+         // Data stored inside the node moves with it
+         char* data = node->Data;
+         if ((data >= (char*)node) && (data < (char*)node + nodeSize))
+         {
+            copy->Data = (char*)copy + (data - (char*)node);
+         }
+
+         copy->Prev = tail;
+         copy->Next = NULL;
+         if (tail != NULL) { tail->Next = copy; }
+         else              { head = copy; }
+         tail = copy;
+      }
+
+      // Buffers are reallocated in list order as well, the old ones are
+      // released only when nothing can fail anymore
+      size_t payloads = 0;
+      if (!SC_ERROR(status) && (Flags & CLIST_COMPACT_PAYLOADS))
+      {
+         CLIST_NODE* copy = head;
+         for (; copy != NULL; copy = copy->Next)
+         {
+            if (InIsDataInNode(this, copy)) { continue; }
+
+            size_t dataSize = InGetDataSize(this, copy);
+            void* data = allocator->Alloc(allocator, dataSize);
+            if (NULL == data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+            memcpy(data, copy->Data, dataSize);
+            copy->Data = data;
+            ++payloads;
+         }
+
+         for (CLIST_NODE* node = head; SC_ERROR(status) && (node != copy); node = node->Next)
+         {
+            if (InIsDataInNode(this, node)) { continue; }
+
+            allocator->Free(allocator, node->Data, InGetDataSize(this, node));
+         }
+      }
+
+      if (SC_ERROR(status))
+      {
+         PoolAllocatorDelete(pool);
+         break;
+      }
+
+      // The nodes of an owned pool are released together with it
+      ALLOCATOR* nodeAllocator = this->NodeAllocator;
+      bool isOwnedPool = InOwnsNodePool(this);
+
+      CLIST_NODE* copy = head;
+      CLIST_NODE* node = this->Head;
+      while (node != NULL)
+      {
+         CLIST_NODE* next = node->Next;
+         size_t dataSize = InGetDataSize(this, node);
+
+         if (Relocator != NULL) { Relocator(node, copy, Context); }
+
+         if ((copy->Data != node->Data) && !InIsDataInNode(this, node))
+         {
+            allocator->Free(allocator, node->Data, dataSize);
+         }
+
+         if (!isOwnedPool) { nodeAllocator->Free(nodeAllocator, node, nodeSize); }
+
+         node = next;
+         copy = copy->Next;
+      }
+
+      if (isOwnedPool) { PoolAllocatorDelete(nodeAllocator); }
+
+      this->NodeAllocator = pool;
+      this->Head = head;
+      this->Tail = tail;
+
+      CLIST_STAT_ADD(this, NodeAllocations, this->Size);
+      CLIST_STAT_ADD(this, PayloadAllocations, payloads);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a pool of nodes of NodeSize bytes carved from CLIST_SLAB_SIZE slabs.
+ *
+ * @param[in]  NodeSize  Size of one node
+ * @param[in]  Backing   Allocator for the slabs
+ *
+ * @retval  ALLOCATOR*  If the pool is successfully created
+ * @retval  NULL        On failure
+ */
+static
+ALLOCATOR*
+InCreateNodePool(
+   IN size_t     NodeSize,
+   IN ALLOCATOR* Backing)
+{
+   size_t nodesPerSlab = CLIST_SLAB_SIZE / ALLOCATOR_ALIGN_UP(NodeSize);
+
+   return PoolAllocatorCreate(NodeSize,
+                              (nodesPerSlab > 0) ? nodesPerSlab : 1,
+                              Backing);
+}
+
+
+/**
+ * Takes a node of Size bytes from the pool of its size class.
+ *
+ * @param[in]  This  Pointer to Allocator protocol of the node heap
+ * @param[in]  Size  Size of the node
+ *
+ * @retval  void*  Pointer to the node memory
+ * @retval  NULL   If This is invalid, Size is 0 or memory can't be allocated
+ */
+static
+void*
+InNodeHeapAlloc(
+   IN ALLOCATOR* This,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_NODE_HEAP);
+      if (0 == Size) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      ALLOCATOR* allocator = GetSystemAllocator();
+      if (Size > CLIST_NODE_CLASS_MAX) { return allocator->Alloc(allocator, Size); }
+
+      CLIST_NODE_CLASS* nodeClass = &this->Classes[(Size - 1) / ALLOCATOR_ALIGNMENT];
+      void* node = NULL;
+
+      mtx_lock(&nodeClass->Lock);
+
+      // Slabs of a class are requested only when a list needs its nodes
+      if (NULL == nodeClass->Pool)
+      {
+         nodeClass->Pool = InCreateNodePool(ALLOCATOR_ALIGN_UP(Size), allocator);
+      }
+
+      if (nodeClass->Pool != NULL)
+      {
+         node = nodeClass->Pool->Alloc(nodeClass->Pool, Size);
+      }
+
+      mtx_unlock(&nodeClass->Lock);
+
+      return node;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns a node of Size bytes to the pool of its size class.
+ *
+ * @param[in]  This    Pointer to Allocator protocol of the node heap
+ * @param[in]  Memory  Node memory
+ * @param[in]  Size    Size the node was allocated with
+ */
+static
+void
+InNodeHeapFree(
+   IN ALLOCATOR* This,
+   IN void*      Memory,
+   IN size_t     Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLIST_NODE_HEAP);
+      if ((NULL == Memory) || (0 == Size)) { break; }
+
+      if (Size > CLIST_NODE_CLASS_MAX)
+      {
+         ALLOCATOR* allocator = GetSystemAllocator();
+         allocator->Free(allocator, Memory, Size);
+         break;
+      }
+
+      CLIST_NODE_CLASS* nodeClass = &this->Classes[(Size - 1) / ALLOCATOR_ALIGNMENT];
+
+      mtx_lock(&nodeClass->Lock);
+      nodeClass->Pool->Free(nodeClass->Pool, Memory, Size);
+      mtx_unlock(&nodeClass->Lock);
+
+   } while (false);
+}
+
+
+/**
+ * Initializes g_NodeHeap.
+ */
+static
+void
+InInitNodeHeap()
+{
+   for (size_t i = 0; i < CLIST_NODE_CLASS_COUNT; ++i)
+   {
+      mtx_init(&g_NodeHeap.Classes[i].Lock, mtx_plain);
+      g_NodeHeap.Classes[i].Pool = NULL;
+   }
+
+   g_NodeHeap.VTable.Alloc = InNodeHeapAlloc;
+   g_NodeHeap.VTable.Free  = InNodeHeapFree;
+   g_NodeHeap.StructureId = CLIST_NODE_HEAP_STRUCT_ID;
+}
+
+
+/**
+ * Returns the node heap shared by the lists of the system allocator.
+ *
+ * Nodes of equal size come from one pool of CLIST_SLAB_SIZE slabs, so
+ * lists don't reserve slabs of their own and nodes can be relinked from
+ * one list into another. The slabs stay with the process for reuse.
+ *
+ * @return  Pointer to Allocator protocol of the node heap
+ */
+static
+ALLOCATOR*
+InGetNodeHeap()
+{
+   call_once(&g_NodeHeapOnce, InInitNodeHeap);
+
+   return &g_NodeHeap.VTable;
+}
+
+
+/**
+ * Allocates and initializes CLIST_IMPL with default storage settings.
+ *
+ * @param[in]  Allocator  Allocator for the list, its nodes and data
+ *
+ * @retval  CLIST_IMPL*  If the list is successfully created
+ * @retval  NULL         On failure
+ */
+static
+CLIST_IMPL*
+InCreateList(
+   IN ALLOCATOR* Allocator)
+{
+   CLIST_IMPL* this = Allocator->Alloc(Allocator, sizeof(CLIST_IMPL));
+   if (NULL == this) { return NULL; }
+
    this->StructureId = CLIST_IMPL_STRUCT_ID;
+   this->Allocator = Allocator;
+
+   // Caller allocators such as EpochAllocator get every node themselves
+   this->NodeAllocator = (GetSystemAllocator() == Allocator) ? InGetNodeHeap() : Allocator;
+   this->Flags = 0;
+   this->ElementSize = 0;
    this->Head = this->Tail = NULL;
    this->Size = 0;
 
@@ -576,7 +3085,207 @@ CListCreate()
    this->VTable.Size         = CListSize;
    this->VTable.Back         = CListBack;
    this->VTable.PushBack     = CListPushBack;
-   this->VTable.PopBack      = NULL;
+   this->VTable.PopBack      = CListPopBack;
+   this->VTable.Remove       = CListRemove;
+   this->VTable.Clear        = CListClear;
+
+   this->VTable.PushFrontTake   = CListPushFrontTake;
+   this->VTable.PushBackTake    = CListPushBackTake;
+   this->VTable.PopFrontTake    = CListPopFrontTake;
+   this->VTable.PopBackTake     = CListPopBackTake;
+   this->VTable.GetCopyDataInto = CListGetCopyDataInto;
+
+   this->VTable.PushFrontBatch   = CListPushFrontBatch;
+   this->VTable.PushBackBatch    = CListPushBackBatch;
+   this->VTable.InsertAfterBatch = CListInsertAfterBatch;
+
+   this->VTable.Splice     = CListSplice;
+   this->VTable.SplitAfter = CListSplitAfter;
+   this->VTable.Append     = CListAppend;
+
+   this->VTable.Sort         = CListSort;
+   this->VTable.SortParallel = CListSortParallel;
+
+   this->VTable.ForEach   = CListForEach;
+   this->VTable.NextBatch = CListNextBatch;
+
+   this->VTable.ParallelForEach = CListParallelForEach;
+   this->VTable.ParallelReduce  = CListParallelReduce;
+
+   this->VTable.GetStats = CListGetStats;
+
+   this->VTable.Compact = CListCompact;
+
+#ifdef CLIST_ENABLE_STATS
+   if (!InRegisterList(this))
+   {
+      Allocator->Free(Allocator, this, sizeof(CLIST_IMPL));
+      return NULL;
+   }
+#endif
+
+   return this;
+}
+
+
+CLIST*
+CListCreate()
+{
+   return CListCreateWithAllocator(GetSystemAllocator());
+}
+
+
+CLIST*
+CListCreateWithAllocator(
+   IN ALLOCATOR* Allocator)
+{
+   if (NULL == Allocator) { return NULL; }
+
+   return CListCreateEx(0, Allocator);
+}
+
+
+CLIST*
+CListCreateEx(
+   IN          uint32_t   Flags,
+   IN OPTIONAL ALLOCATOR* Allocator)
+{
+   if (Flags & ~CLIST_FLAGS_ALL) { return NULL; }
+   if (NULL == Allocator) { Allocator = GetSystemAllocator(); }
+
+   CLIST_IMPL* this = InCreateList(Allocator);
+   if (NULL == this) { return NULL; }
+
+   this->Flags = Flags;
+
+   return &this->VTable;
+}
+
+
+CLIST*
+CListCreateFixed(
+   IN size_t ElementSize)
+{
+   if (0 == ElementSize) { return NULL; }
+
+   CLIST_IMPL* this = InCreateList(GetSystemAllocator());
+   if (NULL == this) { return NULL; }
+
+   this->Flags = CLIST_FLAG_INLINE_DATA;
+   this->ElementSize = ElementSize;
 
    return &this->VTable;
+}
+
+
+void
+CListDelete(
+   IN OPTIONAL CLIST* This)
+{
+   CLIST_IMPL* this = InGetImpl(This);
+   if (NULL == this) { return; }
+
+   InDeleteNodes(this);
+   InDeleteEmptyList(this);
+}
+
+
+CLIST_NODE*
+CListFastEmplace(
+   IN          CLIST*      This,
+   IN OPTIONAL CLIST_NODE* Position,
+   IN          size_t      DataSize)
+{
+   CLIST_IMPL* this = CLIST_FAST_GET_IMPL(This);
+   CLIST_NODE* prev = (Position != NULL) ? Position->Prev : this->Tail;
+
+   CLIST_NODE* node = InCreateNode(this, NULL, DataSize, false, prev, Position);
+   if (NULL == node) { return NULL; }
+
+   InLinkChain(this, prev, Position, node, node, 1);
+
+   return node;
+}
+
+
+#ifdef CLIST_ENABLE_STATS
+
+/**
+ * Prints the counters of the List as one line to the Stream(Context).
+ *
+ * @param[in]  List     List
+ * @param[in]  Stats    Counters of the List
+ * @param[in]  Context  Output stream
+ */
+static
+void
+InDumpStats(
+   IN CLIST*             List,
+   IN const CLIST_STATS* Stats,
+   IN void*              Context)
+{
+   fprintf((FILE*)Context,
+           "CList %p: pushes=%" PRIu64 " pops=%" PRIu64 " inserts=%" PRIu64
+           " steps=%" PRIu64 " nodes=%" PRIu64 " payloads=%" PRIu64
+           " live=%" PRIu64 " peak=%" PRIu64 "\n",
+           (void*)List, Stats->Pushes, Stats->Pops, Stats->Inserts,
+           Stats->TraversalSteps, Stats->NodeAllocations,
+           Stats->PayloadAllocations, Stats->LiveBytes, Stats->PeakBytes);
+}
+
+#endif
+
+
+STATUS_CODE
+CListStatsForEach(
+   IN          CLIST_STATS_CALLBACK Callback,
+   IN OPTIONAL void*                Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      if (NULL == Callback) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+#ifdef CLIST_ENABLE_STATS
+      call_once(&g_RegistryLockOnce, InInitRegistryLock);
+      mtx_lock(&g_RegistryLock);
+
+      for (CLIST_STATS_ENTRY* entry = g_Registry; entry != NULL; entry = entry->Next)
+      {
+         CLIST_STATS stats = entry->Stats;
+         Callback(entry->List, &stats, Context);
+      }
+
+      mtx_unlock(&g_RegistryLock);
+#else
+      (void)Context;
+      SET_SC(SC_UNSUCCESSFUL);
+#endif
+
+   } while (false);
+
+   return status;
+}
+
+
+STATUS_CODE
+CListStatsDump(
+   IN FILE* Stream)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      if (NULL == Stream) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+#ifdef CLIST_ENABLE_STATS
+      status = CListStatsForEach(InDumpStats, Stream);
+#else
+      SET_SC(SC_UNSUCCESSFUL);
+#endif
+
+   } while (false);
+
+   return status;
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #ifndef  __CLIST_H__
 #define  __CLIST_H__
 
+#include <stdio.h>
+
 #include "Include/Misc.h"
 
 
@@ -17,6 +19,63 @@ typedef struct CLIST CLIST;
 typedef struct CLIST_NODE CLIST_NODE;
 
 
+/**
+ * Data is stored right after the node header, so one allocation holds
+ * both. See CLIST_GET_REF_TO_DATA for the restrictions of this mode.
+ */
+#define CLIST_FLAG_INLINE_DATA 0x00000001U
+
+/**
+ * By default data up to this size is stored in the node itself instead of
+ * a buffer of its own. See CLIST_GET_REF_TO_DATA.
+ */
+#define CLIST_SMALL_DATA_SIZE 24U
+
+/** All flags accepted by CListCreateEx. */
+#define CLIST_FLAGS_ALL (CLIST_FLAG_INLINE_DATA)
+
+
+/**
+ * Operation and memory counters of a list.
+ *
+ * Counting is compiled in only with the CLIST_ENABLE_STATS CMake option,
+ * otherwise the list has no counters and GetStats fails.
+ */
+typedef struct CLIST_STATS
+{
+   uint64_t Pushes;             /** Nodes created at the head or the end  */
+   uint64_t Pops;               /** Nodes removed from the head or the end */
+   uint64_t Inserts;            /** Nodes created next to a node          */
+   uint64_t TraversalSteps;     /** Calls of Next and Prev                */
+   uint64_t NodeAllocations;    /** Nodes allocated                       */
+   uint64_t PayloadAllocations; /** Data buffers allocated for nodes      */
+   uint64_t LiveBytes;          /** Bytes of nodes and data held now      */
+   uint64_t PeakBytes;          /** High-water mark of LiveBytes          */
+} CLIST_STATS;
+
+
+/**
+ * Compares the data of two nodes.
+ *
+ * @param[in]  Left       Data of the first node
+ * @param[in]  LeftSize   Size of the data of the first node
+ * @param[in]  Right      Data of the second node
+ * @param[in]  RightSize  Size of the data of the second node
+ * @param[in]  Context    Context passed to the list method
+ *
+ * @return  A negative value if Left goes before Right, a positive value if
+ *          Left goes after Right and 0 if they are equivalent.
+ */
+typedef
+int
+(*CLIST_COMPARATOR)(
+   IN void*   Left,
+   IN size_t  LeftSize,
+   IN void*   Right,
+   IN size_t  RightSize,
+   IN void*   Context);
+
+
 /**
  * Creates a node with a copy of the Data at the head of the list.
  *
@@ -111,15 +170,59 @@ void
    IN CLIST* This);
 
 
+/**
+ * Removes the Position node from the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Node of the list, invalid after the call
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_REMOVE)(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position);
+
+
+/**
+ * Removes all nodes from the list. The list stays usable.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_CLEAR)(
+   IN CLIST* This);
+
+
 /**
  * Gets a link to the data stored in the Position node.
  *
+ * By default the data buffer may be replaced through the link: the old
+ * buffer is released by the caller and the new one must be allocated from
+ * the list allocator (malloc for CListCreate). Data up to
+ * CLIST_SMALL_DATA_SIZE bytes is stored in the node itself, so the first
+ * call for such a node moves the data into a buffer of its own. Use
+ * GetCopyDataInto or CListFast.h to read small data without it.
+ *
+ * In CLIST_FLAG_INLINE_DATA mode and in lists created by CListCreateFixed
+ * *Data points into the node itself. The data may be modified in place,
+ * but *Data and *DataSize must not be changed and *Data must not be
+ * released. For fixed-size lists *DataSize refers to the element size of
+ * the whole list.
+ *
  * @param[in]  This      Pointer to CList protocol
  * @param[in]  Position  Position in the list
  * @param[in]  Data      Triple pointer to data
  * @param[in]  DataSize  Pointer to pointer to data size
  *
  * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  No memory for the buffer of small data
  * @retval  SC_SUCCESS            On success
  */
 typedef
@@ -239,9 +342,569 @@ size_t
    IN CLIST* This);
 
 
-/// @todo Clear
-/// @todo Remove
-/// @todo CListDelete
+/**
+ * Creates a node that adopts the Data buffer at the head of the list.
+ *
+ * The buffer must be allocated from the list allocator (malloc for
+ * CListCreate). On success the list owns it; nodes with inline data copy
+ * the buffer and release it at once. On failure it stays with the caller.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data buffer
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+typedef
+STATUS_CODE
+(*CLIST_PUSH_FRONT_TAKE)(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize);
+
+
+/**
+ * Creates a node that adopts the Data buffer at the end of the list.
+ * Ownership rules are the same as for CLIST_PUSH_FRONT_TAKE.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data buffer
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+typedef
+STATUS_CODE
+(*CLIST_PUSH_BACK_TAKE)(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize);
+
+
+/**
+ * Removes the first node and hands its data buffer to the caller.
+ *
+ * The caller releases the buffer with the list allocator (free for
+ * CListCreate). Inline data is copied into a buffer from that allocator.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_POP_FRONT_TAKE)(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize);
+
+
+/**
+ * Removes the last node and hands its data buffer to the caller.
+ * Ownership rules are the same as for CLIST_POP_FRONT_TAKE.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_POP_BACK_TAKE)(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize);
+
+
+/**
+ * Copies the data stored in the Position node into the caller's Buffer.
+ *
+ * @param[in]   This        Pointer to CList protocol
+ * @param[in]   Position    Position in the list
+ * @param[out]  Buffer      Buffer for the data
+ * @param[in]   BufferSize  Buffer size
+ * @param[out]  DataSize    Data size, also set if the buffer is too small
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_BUFFER_TOO_SMALL   BufferSize is less than the data size
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_GET_COPY_DATA_INTO)(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void*       Buffer,
+   IN  size_t      BufferSize,
+   OUT size_t*     DataSize);
+
+
+/**
+ * Creates nodes with copies of Count records at the head of the list.
+ *
+ * Record i starts at Records + i * Stride and is DataSize bytes long. The
+ * records keep their order. All nodes are created before any of them is
+ * linked, so on failure the list is left unchanged.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+typedef
+STATUS_CODE
+(*CLIST_PUSH_FRONT_BATCH)(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count);
+
+
+/**
+ * Creates nodes with copies of Count records at the end of the list.
+ * Record layout and failure rules are the same as for CLIST_PUSH_FRONT_BATCH.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+typedef
+STATUS_CODE
+(*CLIST_PUSH_BACK_BATCH)(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count);
+
+
+/**
+ * Creates nodes with copies of Count records after Position node.
+ * Record layout and failure rules are the same as for CLIST_PUSH_FRONT_BATCH.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+typedef
+STATUS_CODE
+(*CLIST_INSERT_AFTER_BATCH)(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Records,
+   IN size_t      DataSize,
+   IN size_t      Stride,
+   IN size_t      Count);
+
+
+/**
+ * Moves the nodes [First, Last] of the Other list before Position node.
+ *
+ * The lists must be created the same way: with the same allocator, flags
+ * and element size. Nodes are relinked without copying the data, so their
+ * CLIST_NODE handles stay valid. A list compacted by CLIST_COMPACT owns its
+ * node pool, so nodes moved to or from it are copied into the nodes of
+ * This list instead: their handles and data stored inside the nodes change,
+ * data buffers are moved without copying. Takes time proportional to the
+ * number of moved nodes.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in This list, NULL to move to the end
+ * @param[in]  Other     List that contains the range, may be This
+ * @param[in]  First     First node of the range
+ * @param[in]  Last      Last node of the range, First or a node after it
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or the lists
+ *                                are incompatible
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, lists are unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_SPLICE)(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN CLIST*      Other,
+   IN CLIST_NODE* First,
+   IN CLIST_NODE* Last);
+
+
+/**
+ * Moves the nodes after Position node into a new list.
+ *
+ * The new list is created the same way as This list and takes the nodes
+ * under the same rules as CLIST_SPLICE.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  On success, returns the pointer to the new list, which is empty
+ *          if Position is the last node. On failure, returns a NULL pointer
+ *          and This list is unchanged.
+ */
+typedef
+CLIST*
+(*CLIST_SPLIT_AFTER)(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position);
+
+
+/**
+ * Moves all nodes of the Other list to the end of This list.
+ *
+ * Compatibility and copying rules are the same as for CLIST_SPLICE, but
+ * relinking takes constant time.
+ *
+ * @param[in]  This   Pointer to CList protocol
+ * @param[in]  Other  List to empty into This, not This itself
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter or the lists
+ *                                are incompatible
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, lists are unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_APPEND)(
+   IN CLIST* This,
+   IN CLIST* Other);
+
+
+/**
+ * Sorts the list in ascending order defined by the Comparator.
+ *
+ * The sort is a stable bottom-up merge sort that relinks the nodes, so
+ * node handles and data stay valid and equivalent nodes keep their order.
+ * It takes O(N log N) comparisons and doesn't allocate memory.
+ *
+ * @param[in]  This        Pointer to CList protocol
+ * @param[in]  Comparator  Comparator of the node data
+ * @param[in]  Context     Context for the Comparator, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_SORT)(
+   IN          CLIST*           This,
+   IN          CLIST_COMPARATOR Comparator,
+   IN OPTIONAL void*            Context);
+
+
+/**
+ * Sorts the list like CLIST_SORT using up to ThreadCount threads.
+ *
+ * The list is cut into ThreadCount runs that are sorted in parallel and
+ * then merged by the calling thread. Runs shorter than
+ * CLIST_PARALLEL_SORT_MIN_RUN nodes aren't worth a thread, so short lists
+ * use fewer threads. The Comparator must be safe to call concurrently.
+ *
+ * @param[in]  This         Pointer to CList protocol
+ * @param[in]  Comparator   Comparator of the node data
+ * @param[in]  Context      Context for the Comparator, may be NULL
+ * @param[in]  ThreadCount  Maximum number of threads, including the caller
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_SORT_PARALLEL)(
+   IN          CLIST*           This,
+   IN          CLIST_COMPARATOR Comparator,
+   IN OPTIONAL void*            Context,
+   IN          size_t           ThreadCount);
+
+
+/** Minimum number of nodes sorted by one thread of CLIST_SORT_PARALLEL. */
+#define CLIST_PARALLEL_SORT_MIN_RUN 16384U
+
+
+/**
+ * Visits the data of one node of CLIST_FOR_EACH and CLIST_PARALLEL_FOR_EACH.
+ *
+ * @param[in]  Data      Data of the node, may be modified in place
+ * @param[in]  DataSize  Size of the data
+ * @param[in]  Context   Context passed to the list method
+ */
+typedef
+void
+(*CLIST_VISITOR)(
+   IN void*  Data,
+   IN size_t DataSize,
+   IN void*  Context);
+
+
+/**
+ * Folds the data of one node into the Accumulator of CLIST_PARALLEL_REDUCE.
+ *
+ * @param[in]  Accumulator  Result of the chunk the node belongs to
+ * @param[in]  Data         Data of the node
+ * @param[in]  DataSize     Size of the data
+ * @param[in]  Context      Context passed to the list method
+ */
+typedef
+void
+(*CLIST_REDUCER)(
+   IN void*  Accumulator,
+   IN void*  Data,
+   IN size_t DataSize,
+   IN void*  Context);
+
+
+/**
+ * Folds the result of a later chunk (Other) into the Accumulator of
+ * CLIST_PARALLEL_REDUCE.
+ *
+ * @param[in]  Accumulator  Result of the earlier chunks
+ * @param[in]  Other        Result of the next chunk
+ * @param[in]  Context      Context passed to the list method
+ */
+typedef
+void
+(*CLIST_COMBINER)(
+   IN void* Accumulator,
+   IN void* Other,
+   IN void* Context);
+
+
+/**
+ * Calls the Visitor for the data of every node using up to ThreadCount
+ * threads.
+ *
+ * The list is cut into ThreadCount chunks of consecutive nodes, every
+ * chunk is visited in list order by one thread. A thread starts as soon
+ * as the calling thread finds its first node, the calling thread visits
+ * the last chunk. Chunks shorter than CLIST_PARALLEL_MIN_CHUNK nodes
+ * aren't worth a thread, so short lists use fewer threads. The Visitor
+ * must be safe to call concurrently and must not change the list.
+ *
+ * @param[in]  This         Pointer to CList protocol
+ * @param[in]  Visitor      Function called for every node
+ * @param[in]  Context      Context for the Visitor, may be NULL
+ * @param[in]  ThreadCount  Maximum number of threads, including the caller
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_PARALLEL_FOR_EACH)(
+   IN          CLIST*        This,
+   IN          CLIST_VISITOR Visitor,
+   IN OPTIONAL void*         Context,
+   IN          size_t        ThreadCount);
+
+
+/**
+ * Folds the data of all nodes into the Accumulator using up to ThreadCount
+ * threads.
+ *
+ * The list is cut into chunks as by CLIST_PARALLEL_FOR_EACH. Every chunk
+ * starts from a copy of the initial Accumulator, so it must hold the
+ * identity value of the Combiner, and folds its nodes in list order with
+ * the Reducer. The calling thread then combines the chunk results in list
+ * order into the Accumulator. The Reducer and the Combiner must be safe to
+ * call concurrently; the result doesn't depend on the number of threads
+ * if the Combiner is associative.
+ *
+ * @param[in]  This             Pointer to CList protocol
+ * @param[in]  Reducer          Function that folds a node into a chunk result
+ * @param[in]  Combiner         Function that folds chunk results together
+ * @param[in]  Context          Context for the Reducer and the Combiner, may be NULL
+ * @param[in]  Accumulator      Identity value on input, the result on output
+ * @param[in]  AccumulatorSize  Size of the Accumulator
+ * @param[in]  ThreadCount      Maximum number of threads, including the caller
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_PARALLEL_REDUCE)(
+   IN          CLIST*         This,
+   IN          CLIST_REDUCER  Reducer,
+   IN          CLIST_COMBINER Combiner,
+   IN OPTIONAL void*          Context,
+   IN OUT      void*          Accumulator,
+   IN          size_t         AccumulatorSize,
+   IN          size_t         ThreadCount);
+
+
+/** Minimum number of nodes visited by one thread of the parallel traversals. */
+#define CLIST_PARALLEL_MIN_CHUNK 4096U
+
+
+/**
+ * Calls the Visitor for the data of every node in list order.
+ *
+ * The list walks its nodes itself and prefetches the nodes and the data
+ * buffers of the next few nodes while the Visitor runs, which hides much
+ * of the latency of cache misses on lists scattered over memory. It is
+ * faster than a loop over Next for the same reason. The Visitor must not
+ * change the list.
+ *
+ * @param[in]  This     Pointer to CList protocol
+ * @param[in]  Visitor  Function called for every node
+ * @param[in]  Context  Context for the Visitor, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_FOR_EACH)(
+   IN          CLIST*        This,
+   IN          CLIST_VISITOR Visitor,
+   IN OPTIONAL void*         Context);
+
+
+/** Data of one node read by CLIST_NEXT_BATCH. */
+typedef struct CLIST_ITEM
+{
+   void*  Data;     /** Data of the node */
+   size_t DataSize; /** Size of the data */
+} CLIST_ITEM;
+
+
+/**
+ * Reads the data of up to Capacity nodes starting from *Position.
+ *
+ * A cursor over the list: start with *Position set to the first node and
+ * call until *Count is 0. The data of the read nodes is prefetched, so it
+ * is loading while the caller processes the items. The data may be
+ * modified in place but not released; it stays valid until its node is
+ * removed, moved by Compact or given a new buffer through GetRefToData.
+ *
+ * @param[in]      This      Pointer to CList protocol
+ * @param[in,out]  Position  First node to read, NULL at the end of the list.
+ *                           On output, the node after the last read one.
+ * @param[out]     Items     Array of Capacity items
+ * @param[in]      Capacity  Maximum number of nodes to read
+ * @param[out]     Count     Number of read nodes, 0 at the end of the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_NEXT_BATCH)(
+   IN     CLIST*       This,
+   IN OUT CLIST_NODE** Position,
+   OUT    CLIST_ITEM*  Items,
+   IN     size_t       Capacity,
+   OUT    size_t*      Count);
+
+
+/**
+ * Returns the counters of the list.
+ *
+ * @param[in]   This   Pointer to CList protocol
+ * @param[out]  Stats  Counters
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       Built without CLIST_ENABLE_STATS
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_GET_STATS)(
+   IN  CLIST*       This,
+   OUT CLIST_STATS* Stats);
+
+
+/** CLIST_COMPACT also moves the data buffers of the nodes. */
+#define CLIST_COMPACT_PAYLOADS 0x00000001U
+
+
+/**
+ * Receives the handles of a node moved by CLIST_COMPACT.
+ *
+ * @param[in]  OldPosition  Handle before the move, identifies the node only
+ *                          and must not be dereferenced
+ * @param[in]  NewPosition  Handle after the move
+ * @param[in]  Context      Context passed to the list method
+ */
+typedef
+void
+(*CLIST_RELOCATOR)(
+   IN CLIST_NODE* OldPosition,
+   IN CLIST_NODE* NewPosition,
+   IN void*       Context);
+
+
+/**
+ * Moves all nodes into one contiguous block in list order, so traversal
+ * walks memory sequentially again after long insert and remove churn.
+ *
+ * Every CLIST_NODE handle of the list is invalidated; the Relocator gets
+ * the old and the new handle of each node in list order. Data stored in
+ * the node moves with it, and so links to it from GetRefToData are
+ * invalidated too. This is all data of fixed-size lists and data up to
+ * CLIST_SMALL_DATA_SIZE bytes otherwise. Data buffers of bigger data stay
+ * in place unless Flags has CLIST_COMPACT_PAYLOADS. Then they are
+ * reallocated from the list allocator in list order and their links are
+ * invalidated as well.
+ *
+ * The block becomes the node pool of the list: new nodes are carved from
+ * blocks of the same size and released nodes are reused. The memory
+ * returns to the allocator on the next Compact or when the list is
+ * deleted. Unlike other lists, a compacted list copies nodes moved to or
+ * from other lists by Splice, SplitAfter and Append.
+ *
+ * @param[in]  This       Pointer to CList protocol
+ * @param[in]  Flags      0 or CLIST_COMPACT_PAYLOADS
+ * @param[in]  Relocator  Receiver of moved handles, may be NULL
+ * @param[in]  Context    Context for the Relocator, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The list has CLIST_FLAG_INLINE_DATA, its
+ *                                nodes differ in size and can't be pooled
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+typedef
+STATUS_CODE
+(*CLIST_COMPACT)(
+   IN          CLIST*          This,
+   IN          uint32_t        Flags,
+   IN OPTIONAL CLIST_RELOCATOR Relocator,
+   IN OPTIONAL void*           Context);
+
+
 /** Doubly Linked List protocol. */
 typedef struct CLIST
 {
@@ -258,16 +921,171 @@ typedef struct CLIST
    CLIST_INSERT_BEFORE   InsertBefore; /** Creates a node before the specified node */
    CLIST_INSERT_AFTER    InsertAfter;  /** Creates a node after the specified node */
    CLIST_SIZE            Size;         /** Returns the number of nodes */
+   CLIST_REMOVE          Remove;       /** Removes the specified node */
+   CLIST_CLEAR           Clear;        /** Removes all nodes */
+
+   CLIST_PUSH_FRONT_TAKE    PushFrontTake;   /** Adopts a buffer at the beginning */
+   CLIST_PUSH_BACK_TAKE     PushBackTake;    /** Adopts a buffer at the end */
+   CLIST_POP_FRONT_TAKE     PopFrontTake;    /** Removes the first node, returns its buffer */
+   CLIST_POP_BACK_TAKE      PopBackTake;     /** Removes the last node, returns its buffer */
+   CLIST_GET_COPY_DATA_INTO GetCopyDataInto; /** Copies the data into a caller buffer */
+
+   CLIST_PUSH_FRONT_BATCH   PushFrontBatch;   /** Creates nodes for an array at the beginning */
+   CLIST_PUSH_BACK_BATCH    PushBackBatch;    /** Creates nodes for an array at the end */
+   CLIST_INSERT_AFTER_BATCH InsertAfterBatch; /** Creates nodes for an array after a node */
+
+   CLIST_SPLICE             Splice;     /** Moves a range of nodes from another list */
+   CLIST_SPLIT_AFTER        SplitAfter; /** Moves the tail of the list into a new list */
+   CLIST_APPEND             Append;     /** Moves all nodes of another list to the end */
+
+   CLIST_SORT               Sort;         /** Sorts the list */
+   CLIST_SORT_PARALLEL      SortParallel; /** Sorts the list with several threads */
+
+   CLIST_FOR_EACH           ForEach;   /** Visits every node in list order */
+   CLIST_NEXT_BATCH         NextBatch; /** Reads the data of several nodes from a position */
+
+   CLIST_PARALLEL_FOR_EACH  ParallelForEach; /** Visits every node with several threads */
+   CLIST_PARALLEL_REDUCE    ParallelReduce;  /** Folds the data of all nodes with several threads */
+
+   CLIST_GET_STATS          GetStats; /** Returns the counters of the list */
+
+   CLIST_COMPACT            Compact; /** Moves the nodes into one block in list order */
 } CLIST;
 
 
 /**
  * Creates a doubly linked list protocol.
  *
+ * Nodes, with room for CLIST_SMALL_DATA_SIZE bytes of data, are carved
+ * from slabs shared by all lists of the process, so a list reserves no
+ * node memory of its own and a batch of pushes calls malloc only when the
+ * slabs run out. Data bigger than CLIST_SMALL_DATA_SIZE bytes still gets a
+ * buffer of its own. Removed nodes go back to the slabs and are reused by
+ * later insertions into any list, so steady push and remove cycles don't
+ * call malloc for nodes.
+ *
  * @return  On success, returns the pointer to doubly linked list protocol.
  *          On failure, returns a NULL pointer.
  */
 CLIST*
 CListCreate();
 
+
+/**
+ * Creates a doubly linked list protocol whose list, nodes and data are
+ * allocated from Allocator.
+ *
+ * Buffers stored into the list through GetRefToData must be allocated
+ * from the same Allocator. The Allocator must outlive the list. With an
+ * allocator from EpochAllocatorCreate readers may walk the list while
+ * nodes are removed. Nodes come from the shared slabs as in CListCreate
+ * only if Allocator is the system allocator, any other one allocates and
+ * gets back every node itself.
+ *
+ * @param[in]  Allocator  Allocator for the list, its nodes and data
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, returns a NULL pointer.
+ */
+CLIST*
+CListCreateWithAllocator(
+   IN ALLOCATOR* Allocator);
+
+
+/**
+ * Creates a doubly linked list protocol with the given storage flags.
+ * Nodes of CLIST_FLAG_INLINE_DATA lists differ in size, with the system
+ * allocator they come from the shared slabs of their size class.
+ *
+ * @param[in]  Flags      Combination of CLIST_FLAG_* values
+ * @param[in]  Allocator  Allocator for the list, its nodes and data.
+ *                        If NULL then the system allocator is used.
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, returns a NULL pointer.
+ */
+CLIST*
+CListCreateEx(
+   IN          uint32_t   Flags,
+   IN OPTIONAL ALLOCATOR* Allocator);
+
+
+/**
+ * Creates a doubly linked list protocol for elements of ElementSize bytes.
+ *
+ * Nodes don't store the data size and are carved together with their data
+ * from slabs of equally sized nodes shared by all lists, nodes bigger than
+ * 1 KB are allocated one by one. DataSize passed to the list methods
+ * must be equal to ElementSize. The data is aligned to sizeof(void*).
+ *
+ * @param[in]  ElementSize  Size of every element of the list
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, returns a NULL pointer.
+ */
+CLIST*
+CListCreateFixed(
+   IN size_t ElementSize);
+
+
+/**
+ * Releases the list created by CListCreate*, its nodes and their data.
+ *
+ * @param[in]  This  Pointer to CList protocol. NULL is ignored.
+ */
+void
+CListDelete(
+   IN OPTIONAL CLIST* This);
+
+
+/**
+ * Receives the counters of one live list from CListStatsForEach.
+ *
+ * @param[in]  List     Pointer to CList protocol
+ * @param[in]  Stats    Counters of the List
+ * @param[in]  Context  Context passed to CListStatsForEach
+ */
+typedef
+void
+(*CLIST_STATS_CALLBACK)(
+   IN CLIST*             List,
+   IN const CLIST_STATS* Stats,
+   IN void*              Context);
+
+
+/**
+ * Calls the Callback for every live list of the process.
+ *
+ * Lists are registered on creation. The registry lock is held during the
+ * walk, so the Callback must not create lists. Counters of lists used by
+ * other threads at the same time are approximate. A list released together
+ * with its allocator stays in the registry with its last counters, its
+ * List pointer must not be dereferenced then.
+ *
+ * @param[in]  Callback  Receiver of the counters
+ * @param[in]  Context   Context for the Callback, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       Built without CLIST_ENABLE_STATS
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+CListStatsForEach(
+   IN          CLIST_STATS_CALLBACK Callback,
+   IN OPTIONAL void*                Context);
+
+
+/**
+ * Prints the counters of every live list of the process, one line per list.
+ *
+ * @param[in]  Stream  Output stream
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       Built without CLIST_ENABLE_STATS
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+CListStatsDump(
+   IN FILE* Stream);
+
 #endif  // __CLIST_H__
\ No newline at end of file
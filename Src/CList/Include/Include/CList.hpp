@@ -0,0 +1,304 @@
+/**
+ * @file     CList.hpp
+ * @brief    C++17 wrapper over the CList protocol.
+ * @ingroup  DATA_STRUCTURES
+ *
+ * @details  Draft::List<T> owns a CList created in CLIST_FLAG_INLINE_DATA
+ *           mode. Every element is constructed in the storage of its node
+ *           and is never copied or moved by the list afterwards, so
+ *           move-only and self-referencing types are supported. Elements
+ *           are read through CListFast.h, without GetCopyData and without
+ *           the protocol validation.
+ *
+ *           Iterators are bidirectional and stay valid until their element
+ *           is erased, like std::list iterators. Allocation failures throw
+ *           std::bad_alloc.
+ */
+
+#ifndef  __CLIST_HPP__
+#define  __CLIST_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+extern "C"
+{
+   #include "Include/Allocator.h"
+   #include "Include/CList.h"
+   #include "Include/CListFast.h"
+}
+
+
+namespace Draft
+{
+
+/** Doubly linked list of T over the CList protocol. */
+template <typename T>
+class List
+{
+   static_assert(alignof(T) <= ALLOCATOR_ALIGNMENT,
+                 "Node storage is aligned to ALLOCATOR_ALIGNMENT only");
+
+public:
+   /** Bidirectional iterator, IsConst selects const access. */
+   template <bool IsConst>
+   class Iterator
+   {
+   public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type        = T;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = std::conditional_t<IsConst, const T*, T*>;
+      using reference         = std::conditional_t<IsConst, const T&, T&>;
+
+      Iterator() = default;
+
+      /** Converts iterator to const_iterator. */
+      operator Iterator<true>() const { return Iterator<true>(Owner, Node); }
+
+      reference operator*() const  { return *static_cast<pointer>(CListFastData(Node)); }
+      pointer   operator->() const { return static_cast<pointer>(CListFastData(Node)); }
+
+      Iterator& operator++()
+      {
+         Node = CListFastNext(Node);
+         return *this;
+      }
+
+      Iterator operator++(int)
+      {
+         Iterator previous = *this;
+         ++*this;
+         return previous;
+      }
+
+      Iterator& operator--()
+      {
+         // Stepping back from end() gives the last node
+         Node = (Node != nullptr) ? CListFastPrev(Node) : CListFastBack(Owner);
+         return *this;
+      }
+
+      Iterator operator--(int)
+      {
+         Iterator previous = *this;
+         --*this;
+         return previous;
+      }
+
+      bool operator==(const Iterator& Other) const { return Node == Other.Node; }
+      bool operator!=(const Iterator& Other) const { return Node != Other.Node; }
+
+      /** Returns the node for the CList protocol, NULL for end(). */
+      CLIST_NODE* GetNode() const { return Node; }
+
+   private:
+      friend class List;
+      friend class Iterator<!IsConst>;
+
+      Iterator(CLIST* Handle, CLIST_NODE* Position) : Owner(Handle), Node(Position) {}
+
+      CLIST*      Owner = nullptr; /** List of the node */
+      CLIST_NODE* Node = nullptr;  /** NULL for end()   */
+   };
+
+   using value_type             = T;
+   using size_type              = std::size_t;
+   using difference_type        = std::ptrdiff_t;
+   using reference              = T&;
+   using const_reference        = const T&;
+   using iterator               = Iterator<false>;
+   using const_iterator         = Iterator<true>;
+   using reverse_iterator       = std::reverse_iterator<iterator>;
+   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+   /** Creates an empty list. The CList is created on the first insertion. */
+   List() = default;
+
+   List(const List&) = delete;
+   List& operator=(const List&) = delete;
+
+   List(List&& Other) noexcept : Handle(std::exchange(Other.Handle, nullptr)) {}
+
+   List& operator=(List&& Other) noexcept
+   {
+      if (this != &Other)
+      {
+         Destroy();
+         Handle = std::exchange(Other.Handle, nullptr);
+      }
+      return *this;
+   }
+
+   ~List() { Destroy(); }
+
+   size_type size() const { return (Handle != nullptr) ? CListFastSize(Handle) : 0; }
+   bool      empty() const { return 0 == size(); }
+
+   iterator       begin()        { return iterator(Handle, GetFront()); }
+   const_iterator begin() const  { return const_iterator(Handle, GetFront()); }
+   const_iterator cbegin() const { return begin(); }
+   iterator       end()          { return iterator(Handle, nullptr); }
+   const_iterator end() const    { return const_iterator(Handle, nullptr); }
+   const_iterator cend() const   { return end(); }
+
+   reverse_iterator       rbegin()       { return reverse_iterator(end()); }
+   const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+   reverse_iterator       rend()         { return reverse_iterator(begin()); }
+   const_reverse_iterator rend() const   { return const_reverse_iterator(begin()); }
+
+   reference       front()       { return *begin(); }
+   const_reference front() const { return *begin(); }
+   reference       back()        { return *iterator(Handle, CListFastBack(Handle)); }
+   const_reference back() const  { return *const_iterator(Handle, CListFastBack(Handle)); }
+
+   /** Constructs an element at the end from Args. */
+   template <typename... Args>
+   reference emplace_back(Args&&... Arguments)
+   {
+      return *Construct(CreateNode(nullptr), std::forward<Args>(Arguments)...);
+   }
+
+   /** Constructs an element at the beginning from Args. */
+   template <typename... Args>
+   reference emplace_front(Args&&... Arguments)
+   {
+      return *Construct(CreateNode(GetFront()), std::forward<Args>(Arguments)...);
+   }
+
+   /** Constructs an element before Position from Args. */
+   template <typename... Args>
+   iterator emplace(const_iterator Position, Args&&... Arguments)
+   {
+      CLIST_NODE* node = CreateNode(Position.Node);
+      Construct(node, std::forward<Args>(Arguments)...);
+
+      return iterator(Handle, node);
+   }
+
+   void push_back(const T& Value)  { emplace_back(Value); }
+   void push_back(T&& Value)       { emplace_back(std::move(Value)); }
+   void push_front(const T& Value) { emplace_front(Value); }
+   void push_front(T&& Value)      { emplace_front(std::move(Value)); }
+
+   iterator insert(const_iterator Position, const T& Value) { return emplace(Position, Value); }
+   iterator insert(const_iterator Position, T&& Value)      { return emplace(Position, std::move(Value)); }
+
+   /** Destroys the element at Position and returns the iterator after it. */
+   iterator erase(const_iterator Position)
+   {
+      CLIST_NODE* next = CListFastNext(Position.Node);
+      static_cast<T*>(CListFastData(Position.Node))->~T();
+      Discard(Position.Node);
+      return iterator(Handle, next);
+   }
+
+   void pop_front() { erase(cbegin()); }
+   void pop_back()  { erase(const_iterator(Handle, CListFastBack(Handle))); }
+
+   /** Destroys all elements. */
+   void clear()
+   {
+      if (empty()) { return; }
+
+      if (!std::is_trivially_destructible<T>::value)
+      {
+         for (T& value : *this) { value.~T(); }
+      }
+
+      Handle->Clear(Handle);
+   }
+
+   /** Stable sort of the elements by Less, elements are relinked only. */
+   template <typename Compare = std::less<T>>
+   void sort(Compare Less = Compare())
+   {
+      if (size() < 2) { return; }
+
+      STATUS_CODE status = Handle->Sort(Handle, InCompare<Compare>, &Less);
+      if (SC_ERROR(status)) { throw std::bad_alloc(); }
+   }
+
+   /** Returns the underlying CList, NULL if nothing was ever inserted. */
+   CLIST* native_handle() const { return Handle; }
+
+private:
+   /** CLIST_COMPARATOR over a C++ Less predicate. */
+   template <typename Compare>
+   static int InCompare(void* Left, size_t LeftSize, void* Right, size_t RightSize, void* Context)
+   {
+      (void)LeftSize;
+      (void)RightSize;
+
+      Compare& less = *static_cast<Compare*>(Context);
+      const T& left = *static_cast<const T*>(Left);
+      const T& right = *static_cast<const T*>(Right);
+
+      if (less(left, right)) { return -1; }
+      return less(right, left) ? 1 : 0;
+   }
+
+   CLIST_NODE* GetFront() const { return (Handle != nullptr) ? CListFastFront(Handle) : nullptr; }
+
+   /**
+    * Links a node with uninitialized storage for an element before
+    * Position, nullptr for the end.
+    */
+   CLIST_NODE* CreateNode(CLIST_NODE* Position)
+   {
+      if (nullptr == Handle)
+      {
+         Handle = CListCreateEx(CLIST_FLAG_INLINE_DATA, nullptr);
+         if (nullptr == Handle) { throw std::bad_alloc(); }
+      }
+
+      CLIST_NODE* node = CListFastEmplace(Handle, Position, sizeof(T));
+      if (nullptr == node) { throw std::bad_alloc(); }
+
+      return node;
+   }
+
+   /** Constructs an element in the Node, releases the Node on failure. */
+   template <typename... Args>
+   T* Construct(CLIST_NODE* Node, Args&&... Arguments)
+   {
+      try
+      {
+         return new (CListFastData(Node)) T(std::forward<Args>(Arguments)...);
+      }
+      catch (...)
+      {
+         Discard(Node);
+         throw;
+      }
+   }
+
+   /** Releases the Node whose element is destroyed or not constructed. */
+   void Discard(CLIST_NODE* Node)
+   {
+      Handle->Remove(Handle, Node);
+   }
+
+   void Destroy()
+   {
+      if (nullptr == Handle) { return; }
+
+      if (!std::is_trivially_destructible<T>::value)
+      {
+         for (T& value : *this) { value.~T(); }
+      }
+
+      CListDelete(Handle);
+      Handle = nullptr;
+   }
+
+   CLIST* Handle = nullptr; /** Owned CList, NULL until the first insertion */
+};
+
+} // namespace Draft
+
+#endif  // __CLIST_HPP__
@@ -0,0 +1,260 @@
+/**
+ * @file     CListDefine.h
+ * @brief    Generator of type-specialized doubly linked lists.
+ * @ingroup  DATA_STRUCTURES
+ *
+ * @details  CLIST_DEFINE(Name, T) emits a doubly linked list of T that stores
+ *           the elements inline in the nodes. Elements are passed by value,
+ *           so the copies have a size known to the compiler, and all the
+ *           functions are static inline. The generated list is a plain
+ *           structure and has no protocol, its functions are called directly:
+ *
+ *           @code
+ *           CLIST_DEFINE(U64List, uint64_t)
+ *
+ *           U64List list;
+ *           U64ListInit(&list, NULL);
+ *           U64ListPushBack(&list, 42);
+ *           for (U64List_NODE* node = U64ListFront(&list);
+ *                node != NULL;
+ *                node = U64ListNext(node))
+ *           {
+ *              *U64ListData(node) += 1;
+ *           }
+ *           U64ListClear(&list);
+ *           @endcode
+ *
+ *           Generated types:
+ *             - Name_NODE  Node with Prev, Next and the element Data;
+ *             - Name       List with Head, Tail, Size and Allocator.
+ *
+ *           Generated functions, the same as in the CLIST protocol:
+ *             - NameInit(List, Allocator)  Allocator may be NULL for the
+ *               system allocator;
+ *             - NamePushFront, NamePushBack(List, Value);
+ *             - NameInsertAfter, NameInsertBefore(List, Position, Value);
+ *             - NamePopFront, NamePopBack(List, Value)  Value may be NULL;
+ *             - NameFront, NameBack(List);
+ *             - NameNext, NamePrev(Position);
+ *             - NameData(Position)  Pointer to the element;
+ *             - NameSize(List);
+ *             - NameClear(List)  Releases all nodes.
+ *
+ *           NameCreateNode and NameDeleteNode are generated as well and are
+ *           internal.
+ *
+ *           Like CListFast.h the functions don't validate their arguments
+ *           beyond what is needed to keep the list consistent.
+ */
+
+#ifndef  __CLIST_DEFINE_H__
+#define  __CLIST_DEFINE_H__
+
+#include "Include/Allocator.h"
+
+
+/**
+ * Defines the list type Name, its node type Name_NODE and the functions
+ * Name<Operation> for elements of type T.
+ */
+#define CLIST_DEFINE(Name, T)                                                \
+                                                                             \
+typedef struct Name ## _NODE                                                 \
+{                                                                            \
+   struct Name ## _NODE* Prev;                                               \
+   struct Name ## _NODE* Next;                                               \
+   T                     Data;                                               \
+} Name ## _NODE;                                                             \
+                                                                             \
+typedef struct Name                                                          \
+{                                                                            \
+   Name ## _NODE* Head;                                                      \
+   Name ## _NODE* Tail;                                                      \
+   size_t         Size;                                                      \
+   ALLOCATOR*     Allocator;                                                 \
+} Name;                                                                      \
+                                                                             \
+static inline                                                                \
+void                                                                         \
+Name ## Init(                                                                \
+   OUT         Name*      This,                                              \
+   IN OPTIONAL ALLOCATOR* Allocator)                                         \
+{                                                                            \
+   This->Head = This->Tail = NULL;                                           \
+   This->Size = 0;                                                           \
+   This->Allocator = (Allocator != NULL) ? Allocator : GetSystemAllocator(); \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+Name ## _NODE*                                                               \
+Name ## CreateNode(                                                          \
+   IN Name*          This,                                                   \
+   IN T              Value,                                                  \
+   IN Name ## _NODE* Prev,                                                   \
+   IN Name ## _NODE* Next)                                                   \
+{                                                                            \
+   Name ## _NODE* node = (Name ## _NODE*)This->Allocator->Alloc(             \
+      This->Allocator, sizeof(Name ## _NODE));                               \
+   if (NULL == node) { return NULL; }                                        \
+                                                                             \
+   node->Prev = Prev;                                                        \
+   node->Next = Next;                                                        \
+   node->Data = Value;                                                       \
+                                                                             \
+   if (Prev != NULL) { Prev->Next = node; } else { This->Head = node; }      \
+   if (Next != NULL) { Next->Prev = node; } else { This->Tail = node; }      \
+   ++This->Size;                                                             \
+                                                                             \
+   return node;                                                              \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+void                                                                         \
+Name ## DeleteNode(                                                          \
+   IN           Name*          This,                                         \
+   IN           Name ## _NODE* Node,                                         \
+   OUT OPTIONAL T*             Value)                                        \
+{                                                                            \
+   if (Value != NULL) { *Value = Node->Data; }                               \
+                                                                             \
+   if (Node->Prev != NULL) { Node->Prev->Next = Node->Next; }                \
+   else                    { This->Head = Node->Next; }                      \
+   if (Node->Next != NULL) { Node->Next->Prev = Node->Prev; }                \
+   else                    { This->Tail = Node->Prev; }                      \
+   --This->Size;                                                             \
+                                                                             \
+   This->Allocator->Free(This->Allocator, Node, sizeof(Name ## _NODE));      \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+STATUS_CODE                                                                  \
+Name ## PushFront(                                                           \
+   IN Name* This,                                                            \
+   IN T     Value)                                                           \
+{                                                                            \
+   return (NULL == Name ## CreateNode(This, Value, NULL, This->Head)) ?      \
+          SC_NOT_ENOUGH_MEMORY : SC_SUCCESS;                                 \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+STATUS_CODE                                                                  \
+Name ## PushBack(                                                            \
+   IN Name* This,                                                            \
+   IN T     Value)                                                           \
+{                                                                            \
+   return (NULL == Name ## CreateNode(This, Value, This->Tail, NULL)) ?      \
+          SC_NOT_ENOUGH_MEMORY : SC_SUCCESS;                                 \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+STATUS_CODE                                                                  \
+Name ## InsertAfter(                                                         \
+   IN Name*          This,                                                   \
+   IN Name ## _NODE* Position,                                               \
+   IN T              Value)                                                  \
+{                                                                            \
+   if (NULL == Position) { return SC_INVALID_PARAMETER; }                    \
+                                                                             \
+   return (NULL == Name ## CreateNode(This, Value, Position,                 \
+                                      Position->Next)) ?                     \
+          SC_NOT_ENOUGH_MEMORY : SC_SUCCESS;                                 \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+STATUS_CODE                                                                  \
+Name ## InsertBefore(                                                        \
+   IN Name*          This,                                                   \
+   IN Name ## _NODE* Position,                                               \
+   IN T              Value)                                                  \
+{                                                                            \
+   if (NULL == Position) { return SC_INVALID_PARAMETER; }                    \
+                                                                             \
+   return (NULL == Name ## CreateNode(This, Value, Position->Prev,           \
+                                      Position)) ?                           \
+          SC_NOT_ENOUGH_MEMORY : SC_SUCCESS;                                 \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+STATUS_CODE                                                                  \
+Name ## PopFront(                                                            \
+   IN           Name* This,                                                  \
+   OUT OPTIONAL T*    Value)                                                 \
+{                                                                            \
+   if (NULL == This->Head) { return SC_UNSUCCESSFUL; }                       \
+                                                                             \
+   Name ## DeleteNode(This, This->Head, Value);                              \
+   return SC_SUCCESS;                                                        \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+STATUS_CODE                                                                  \
+Name ## PopBack(                                                             \
+   IN           Name* This,                                                  \
+   OUT OPTIONAL T*    Value)                                                 \
+{                                                                            \
+   if (NULL == This->Tail) { return SC_UNSUCCESSFUL; }                       \
+                                                                             \
+   Name ## DeleteNode(This, This->Tail, Value);                              \
+   return SC_SUCCESS;                                                        \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+Name ## _NODE*                                                               \
+Name ## Front(                                                               \
+   IN const Name* This)                                                      \
+{                                                                            \
+   return This->Head;                                                        \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+Name ## _NODE*                                                               \
+Name ## Back(                                                                \
+   IN const Name* This)                                                      \
+{                                                                            \
+   return This->Tail;                                                        \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+Name ## _NODE*                                                               \
+Name ## Next(                                                                \
+   IN const Name ## _NODE* Position)                                         \
+{                                                                            \
+   return Position->Next;                                                    \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+Name ## _NODE*                                                               \
+Name ## Prev(                                                                \
+   IN const Name ## _NODE* Position)                                         \
+{                                                                            \
+   return Position->Prev;                                                    \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+T*                                                                           \
+Name ## Data(                                                                \
+   IN Name ## _NODE* Position)                                               \
+{                                                                            \
+   return &Position->Data;                                                   \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+size_t                                                                       \
+Name ## Size(                                                                \
+   IN const Name* This)                                                      \
+{                                                                            \
+   return This->Size;                                                        \
+}                                                                            \
+                                                                             \
+static inline                                                                \
+void                                                                         \
+Name ## Clear(                                                               \
+   IN Name* This)                                                            \
+{                                                                            \
+   while (This->Head != NULL)                                                \
+   {                                                                         \
+      Name ## DeleteNode(This, This->Head, NULL);                            \
+   }                                                                         \
+}
+
+#endif  // __CLIST_DEFINE_H__
@@ -0,0 +1,223 @@
+/**
+ * @file     CListFast.h
+ * @brief    Unchecked inline access to the nodes of a CList.
+ * @ingroup  DATA_STRUCTURES
+ *
+ * @details  The functions of this header skip the validation done by the
+ *           CList protocol: This and Position are neither checked for NULL
+ *           nor for the structure ID, and the calls are not counted by
+ *           CLIST_STATS. The accessors can be inlined into traversal
+ *           loops, CListFastEmplace gives wrappers node storage to construct
+ *           data in. The caller must pass lists created by CListCreate* and
+ *           nodes that belong to them; the checked protocol remains the
+ *           default API.
+ */
+
+#ifndef  __CLIST_FAST_H__
+#define  __CLIST_FAST_H__
+
+#include "Include/CList.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+/** Doubly linked list node. Not to be modified outside of CList. */
+typedef struct CLIST_NODE
+{
+   struct CLIST_NODE* Prev;      /** Pointer to previous node */
+   struct CLIST_NODE* Next;      /** Pointer to next node     */
+   void*              Data;      /** Data stored in the node  */
+
+   // Nodes of fixed-size lists end here, their data starts at DataSize
+
+   size_t             DataSize;  /** Size of data stored in the node */
+   unsigned char      Payload[]; /** Data storage in CLIST_FLAG_INLINE_DATA mode */
+} CLIST_NODE;
+
+
+#ifdef CLIST_ENABLE_STATS
+
+/**
+ * Counters of a list and its entry in the registry. Allocated from the
+ * system allocator, so the registry stays valid when a list is released
+ * together with its allocator.
+ */
+typedef struct CLIST_STATS_ENTRY
+{
+   CLIST_STATS               Stats; /** Operation and memory counters */
+   CLIST*                    List;  /** List protocol                 */
+   struct CLIST_STATS_ENTRY* Prev;  /** Previous entry                */
+   struct CLIST_STATS_ENTRY* Next;  /** Next entry                    */
+} CLIST_STATS_ENTRY;
+
+#endif
+
+
+/** CList protocol implementation. Not to be modified outside of CList. */
+typedef struct CLIST_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   CLIST     VTable;      /** API                 */
+
+   ALLOCATOR*  Allocator;     /** Source of the list and data buffers     */
+   ALLOCATOR*  NodeAllocator; /** Source of nodes                         */
+   uint32_t    Flags;         /** CLIST_FLAG_* storage flags              */
+   size_t      ElementSize;   /** Size of every element, 0 if variable    */
+   CLIST_NODE* Head;          /** Pointer to the first node in the list */
+   CLIST_NODE* Tail;          /** Pointer to the last node in the list  */
+   size_t      Size;          /** Number of nodes */
+
+#ifdef CLIST_ENABLE_STATS
+   CLIST_STATS_ENTRY* StatsEntry; /** Counters and registry entry */
+#endif
+} CLIST_IMPL;
+
+
+///////////////////////////////////////////////////////////
+///                  Unchecked access                   ///
+///////////////////////////////////////////////////////////
+
+/**
+ * By pointer to CList protocol(This), get the pointer to CLIST_IMPL
+ * without any validation.
+ */
+#define CLIST_FAST_GET_IMPL(This) \
+   ((CLIST_IMPL*)((char*)(This) - offsetof(CLIST_IMPL, VTable)))
+
+
+/**
+ * Returns the number of nodes in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  Number of nodes
+ */
+static inline
+size_t
+CListFastSize(
+   IN CLIST* This)
+{
+   return CLIST_FAST_GET_IMPL(This)->Size;
+}
+
+
+/**
+ * Returns the first node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  The first node or NULL if the list is empty
+ */
+static inline
+CLIST_NODE*
+CListFastFront(
+   IN CLIST* This)
+{
+   return CLIST_FAST_GET_IMPL(This)->Head;
+}
+
+
+/**
+ * Returns the last node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  The last node or NULL if the list is empty
+ */
+static inline
+CLIST_NODE*
+CListFastBack(
+   IN CLIST* This)
+{
+   return CLIST_FAST_GET_IMPL(This)->Tail;
+}
+
+
+/**
+ * Returns the node following the Position.
+ *
+ * @param[in]  Position  Node of the list
+ *
+ * @return  The next node or NULL if Position is the last node
+ */
+static inline
+CLIST_NODE*
+CListFastNext(
+   IN CLIST_NODE* Position)
+{
+   return Position->Next;
+}
+
+
+/**
+ * Returns the node preceding the Position.
+ *
+ * @param[in]  Position  Node of the list
+ *
+ * @return  The previous node or NULL if Position is the first node
+ */
+static inline
+CLIST_NODE*
+CListFastPrev(
+   IN CLIST_NODE* Position)
+{
+   return Position->Prev;
+}
+
+
+/**
+ * Returns the data stored in the Position, in every storage mode.
+ *
+ * @param[in]  Position  Node of the list
+ *
+ * @return  Pointer to the data
+ */
+static inline
+void*
+CListFastData(
+   IN CLIST_NODE* Position)
+{
+   return Position->Data;
+}
+
+
+/**
+ * Returns the size of the data stored in the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Node of the list
+ *
+ * @return  Data size
+ */
+static inline
+size_t
+CListFastDataSize(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   CLIST_IMPL* list = CLIST_FAST_GET_IMPL(This);
+
+   return (list->ElementSize != 0) ? list->ElementSize : Position->DataSize;
+}
+
+
+/**
+ * Creates a node for DataSize bytes of data and links it before Position.
+ * The data storage is left uninitialized, the caller constructs the data
+ * in place through CListFastData. DataSize must be valid for the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Node of the list, NULL to link the node at the end
+ * @param[in]  DataSize  Data size
+ *
+ * @return  The new node or NULL if memory can't be allocated
+ */
+CLIST_NODE*
+CListFastEmplace(
+   IN          CLIST*      This,
+   IN OPTIONAL CLIST_NODE* Position,
+   IN          size_t      DataSize);
+
+#endif  // __CLIST_FAST_H__
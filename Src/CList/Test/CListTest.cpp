@@ -5,13 +5,71 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 extern "C"
 {
+   #include "Include/Allocator.h"
    #include "Include/CList.h"
+   #include "Include/CListDefine.h"
+   #include "Include/CListFast.h"
 }
 
+#include "Include/CList.hpp"
+
+
+///////////////////////////////////////////////////////////
+//                   Test allocators                     //
+///////////////////////////////////////////////////////////
+
+/** Allocator that counts calls and live bytes. */
+struct CountingAllocator
+{
+   ALLOCATOR VTable;
+   size_t    Allocs = 0;
+   size_t    Frees = 0;
+   size_t    LiveBytes = 0;
+   size_t    FailAfter = SIZE_MAX; // Number of allocations before failures
+
+   CountingAllocator()
+   {
+      VTable.Alloc = Alloc;
+      VTable.Free = Free;
+   }
+
+   static void* Alloc(ALLOCATOR* This, size_t Size)
+   {
+      CountingAllocator* self = reinterpret_cast<CountingAllocator*>(This);
+      if (self->Allocs >= self->FailAfter) { return NULL; }
+
+      ++self->Allocs;
+      self->LiveBytes += Size;
+      return malloc(Size);
+   }
+
+   static void Free(ALLOCATOR* This, void* Memory, size_t Size)
+   {
+      if (NULL == Memory) { return; }
+
+      CountingAllocator* self = reinterpret_cast<CountingAllocator*>(This);
+      ++self->Frees;
+      self->LiveBytes -= Size;
+      free(Memory);
+   }
+};
+
 
 ///////////////////////////////////////////////////////////
 //                    CList Fixtures                     //
@@ -31,7 +89,7 @@ struct CListEmpty : public testing::Test
    // You can define per-test tear-down logic as usual
    void TearDown() override
    {
-      // Nothing to do for now
+      CListDelete(list);
    }
 
 };
@@ -58,7 +116,7 @@ struct CListTwentyFiveElement : public testing::Test
    // You can define per-test tear-down logic as usual
    void TearDown() override
    {
-      // Nothing to do for now
+      CListDelete(list);
    }
 
 };
@@ -79,8 +137,237 @@ TEST(CListCreate, CorrectCreation)
 
    /*** Assert ***/
    EXPECT_FALSE(NULL == list);
+
+   CListDelete(list);
+}
+
+
+TEST(CListCreate, WithAllocatorInvPrms)
+{
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == CListCreateWithAllocator(NULL));
+}
+
+
+TEST(CListCreate, WithArenaAllocator)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   ALLOCATOR* arena = ArenaAllocatorCreate(4096, NULL);
+   ASSERT_FALSE(NULL == arena);
+
+   /*** Act ***/
+   CLIST* list = CListCreateWithAllocator(arena);
+   ASSERT_FALSE(NULL == list);
+
+   for (size_t i = 0; i < 100; ++i)
+   {
+      status = list->PushBack(list, &i, sizeof(size_t));
+      ASSERT_FALSE(SC_ERROR(status));
+   }
+   list->PopFront(list);
+
+   /*** Assert ***/
+   EXPECT_TRUE(99 == list->Size(list));
+
+   size_t expected = 1;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      status = list->GetRefToData(list, position, &data, &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      EXPECT_TRUE(expected++ == **((size_t**)data));
+   }
+
+   EXPECT_FALSE(SC_ERROR(ArenaAllocatorDelete(arena)));
+}
+
+
+TEST(CListCreate, WithPoolAllocator)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   ALLOCATOR* pool = PoolAllocatorCreate(1024, 64, NULL);
+   ASSERT_FALSE(NULL == pool);
+
+   /*** Act && Assert ***/
+   CLIST* list = CListCreateWithAllocator(pool);
+   ASSERT_FALSE(NULL == list);
+
+   // Pop/push churn is served by the pool free list
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      status = list->PushBack(list, &i, sizeof(size_t));
+      ASSERT_FALSE(SC_ERROR(status));
+
+      if (list->Size(list) > 10) { list->PopFront(list); }
+   }
+   EXPECT_TRUE(10 == list->Size(list));
+
+   // Data larger than a pool object can't be stored
+   char large[2048] = {};
+   status = list->PushBack(list, large, sizeof(large));
+   EXPECT_TRUE(SC_ERROR(status));
+   EXPECT_TRUE(10 == list->Size(list));
+
+   EXPECT_FALSE(SC_ERROR(PoolAllocatorDelete(pool)));
+}
+
+
+TEST(CListCreate, ExInvPrms)
+{
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == CListCreateEx(0x80000000U, NULL));
+
+   CLIST* list = CListCreateEx(0, NULL);
+   EXPECT_FALSE(NULL == list);
+   CListDelete(list);
+}
+
+
+TEST(CListCreate, InlineData)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   CountingAllocator allocator;
+   CLIST* list = CListCreateEx(CLIST_FLAG_INLINE_DATA, &allocator.VTable);
+   ASSERT_FALSE(NULL == list);
+   size_t listAllocs = allocator.Allocs;
+
+   /*** Act ***/
+   for (size_t i = 0; i < 25; ++i)
+   {
+      status = list->PushBack(list, &i, sizeof(size_t));
+      ASSERT_FALSE(SC_ERROR(status));
+   }
+
+   /*** Assert ***/
+   // One allocation per node
+   EXPECT_TRUE(25 == allocator.Allocs - listAllocs);
+
+   size_t expected = 0;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      status = list->GetRefToData(list, position, &data, &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      EXPECT_TRUE(sizeof(size_t) == *dataSize);
+      EXPECT_TRUE(expected == **((size_t**)data));
+
+      // In place modification is allowed
+      **((size_t**)data) += 100;
+
+      size_t* copy = NULL;
+      size_t copySize = 0;
+      status = list->GetCopyData(list, position, (void**)&copy, &copySize);
+      ASSERT_FALSE(SC_ERROR(status));
+      EXPECT_TRUE(expected + 100 == *copy);
+      free(copy);
+
+      ++expected;
+   }
+
+   size_t liveBytes = allocator.LiveBytes;
+   list->PopFront(list);
+   EXPECT_TRUE(1 == allocator.Frees);
+   EXPECT_TRUE(liveBytes > allocator.LiveBytes);
+
+   CListDelete(list);
+   EXPECT_TRUE(0 == allocator.LiveBytes);
+}
+
+///////////////////////////////////////////////////////////
+//                   CListCreateFixed                    //
+///////////////////////////////////////////////////////////
+
+TEST(CListCreateFixed, InvPrms)
+{
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == CListCreateFixed(0));
+}
+
+
+TEST(CListCreateFixed, DataSizeIsValidated)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   CLIST* list = CListCreateFixed(sizeof(size_t));
+   ASSERT_FALSE(NULL == list);
+   size_t data = 25;
+
+   /*** Act && Assert ***/
+   status = list->PushFront(list, &data, sizeof(uint32_t));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->PushBack(list, &data, sizeof(size_t) + 1);
+   EXPECT_TRUE(SC_ERROR(status));
+
+   status = list->PushBack(list, &data, sizeof(size_t));
+   ASSERT_FALSE(SC_ERROR(status));
+   status = list->InsertAfter(list, list->Front(list), &data, 1);
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->InsertBefore(list, list->Front(list), &data, 1);
+   EXPECT_TRUE(SC_ERROR(status));
+
+   EXPECT_TRUE(1 == list->Size(list));
+
+   CListDelete(list);
+}
+
+
+TEST(CListCreateFixed, StoresElements)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   CLIST* list = CListCreateFixed(sizeof(size_t));
+   ASSERT_FALSE(NULL == list);
+
+   /*** Act ***/
+   for (size_t i = 0; i < 10000; ++i)
+   {
+      status = list->PushBack(list, &i, sizeof(size_t));
+      ASSERT_FALSE(SC_ERROR(status));
+   }
+   for (size_t i = 0; i < 5000; ++i)
+   {
+      list->PopFront(list);
+   }
+
+   /*** Assert ***/
+   EXPECT_TRUE(5000 == list->Size(list));
+
+   size_t expected = 5000;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      status = list->GetRefToData(list, position, &data, &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      ASSERT_TRUE(sizeof(size_t) == *dataSize);
+      ASSERT_TRUE(expected == **((size_t**)data));
+
+      size_t* copy = NULL;
+      size_t copySize = 0;
+      status = list->GetCopyData(list, position, (void**)&copy, &copySize);
+      ASSERT_FALSE(SC_ERROR(status));
+      ASSERT_TRUE(expected == *copy);
+      ASSERT_TRUE(sizeof(size_t) == copySize);
+      free(copy);
+
+      ++expected;
+   }
+
+   CListDelete(list);
 }
 
+
 ///////////////////////////////////////////////////////////
 //                       PushFront                       //
 ///////////////////////////////////////////////////////////
@@ -295,6 +582,7 @@ TEST_F(CListEmpty, InsertAfter)
    {
       status = list->GetCopyData(list, position, (void**)&receivedData, &dataSize);
       ASSERT_FALSE(SC_ERROR(status));
+      free(receivedData);
 
       position = list->Next(list, position);
    }
@@ -330,6 +618,14 @@ TEST_F(CListEmpty, InsertBefore)
       ASSERT_FALSE(NULL == position);
    }
 
+   // Insert in the middle keeps both directions consistent
+   position = list->Next(list, list->Front(list));
+   ASSERT_FALSE(NULL == position);
+   status = list->InsertBefore(list, position, &data, sizeof(size_t));
+   ASSERT_FALSE(SC_ERROR(status));
+   ASSERT_TRUE(list->Next(list, list->Prev(list, position)) == position);
+   ASSERT_TRUE(list->Prev(list, list->Next(list, list->Front(list))) == list->Front(list));
+
    position = list->Front(list);
    ASSERT_FALSE(NULL == position);
 
@@ -339,6 +635,7 @@ TEST_F(CListEmpty, InsertBefore)
    {
       status = list->GetCopyData(list, position, (void**)&receivedData, &dataSize);
       ASSERT_FALSE(SC_ERROR(status));
+      free(receivedData);
 
       position = list->Next(list, position);
    }
@@ -374,6 +671,7 @@ TEST_F(CListTwentyFiveElement, GetCopyData)
       ASSERT_FALSE(SC_ERROR(status));
       EXPECT_TRUE(expected == *data);
       EXPECT_TRUE(sizeof(size_t) == dataSize);
+      free(data);
 
       position = list->Next(list, position);
       --expected;
@@ -450,6 +748,7 @@ TEST_F(CListEmpty, PopFrontTwoElements)
    ASSERT_FALSE(SC_ERROR(status));
    ASSERT_TRUE(0 == *data);
    ASSERT_TRUE(sizeof(size_t) == dataSize);
+   free(data);
 }
 
 
@@ -484,6 +783,7 @@ TEST_F(CListEmpty, PushBack)
       ASSERT_FALSE(SC_ERROR(status));
       ASSERT_TRUE(expected == *data);
       ASSERT_TRUE(sizeof(size_t) == dataSize);
+      free(data);
 
       position = list->Next(list, position);
       ++expected;
@@ -500,6 +800,7 @@ TEST_F(CListEmpty, PushBack)
       ASSERT_FALSE(SC_ERROR(status));
       ASSERT_TRUE(expected == *data);
       ASSERT_TRUE(sizeof(size_t) == dataSize);
+      free(data);
 
       position = list->Prev(list, position);
       --expected;
@@ -508,6 +809,2087 @@ TEST_F(CListEmpty, PushBack)
 }
 
 
+///////////////////////////////////////////////////////////
+//                PopBack, Remove, Clear                 //
+///////////////////////////////////////////////////////////
+
+/** Returns the size_t values of the List from the front to the back. */
+static std::vector<size_t> InGetValues(CLIST* List)
+{
+   std::vector<size_t> values;
+   for (CLIST_NODE* node = List->Front(List); node != NULL; node = List->Next(List, node))
+   {
+      size_t value = 0;
+      size_t dataSize = 0;
+      EXPECT_FALSE(SC_ERROR(List->GetCopyDataInto(List, node, &value, sizeof(value), &dataSize)));
+      values.push_back(value);
+   }
+
+   return values;
+}
+
+
+TEST_F(CListTwentyFiveElement, PopBack)
+{
+   /*** Act ***/
+   for (size_t i = 1; i <= 5; ++i)
+   {
+      list->PopBack(list);
+      ASSERT_TRUE(25 - i == list->Size(list));
+   }
+   list->PopBack(NULL);
+
+   /*** Assert ***/
+   // Values were pushed to the front, so the back holds the smallest ones
+   std::vector<size_t> values = InGetValues(list);
+   ASSERT_EQ(20U, values.size());
+   EXPECT_EQ(24U, values.front());
+   EXPECT_EQ(5U, values.back());
+
+   while (list->Size(list) > 0) { list->PopBack(list); }
+   EXPECT_TRUE((NULL == list->Front(list)) && (NULL == list->Back(list)));
+   list->PopBack(list);
+   EXPECT_TRUE(0 == list->Size(list));
+}
+
+
+TEST_F(CListTwentyFiveElement, Remove)
+{
+   /*** Arrange ***/
+   CLIST_NODE* front = list->Front(list);
+   CLIST_NODE* middle = list->Next(list, list->Next(list, front));
+   CLIST_NODE* back = list->Back(list);
+
+   /*** Act ***/
+   EXPECT_TRUE(SC_ERROR(list->Remove(NULL, front)));
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, NULL)));
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, middle)));
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, front)));
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, back)));
+
+   /*** Assert ***/
+   std::vector<size_t> values = InGetValues(list);
+   ASSERT_EQ(22U, values.size());
+   EXPECT_EQ(23U, values[0]);
+   EXPECT_EQ(21U, values[1]);
+   EXPECT_EQ(1U, values.back());
+
+   // The same nodes read back to front
+   CLIST_NODE* node = list->Back(list);
+   for (size_t i = values.size(); i > 0; --i, node = list->Prev(list, node))
+   {
+      ASSERT_FALSE(NULL == node);
+      EXPECT_EQ(values[i - 1], *(size_t*)CListFastData(node));
+   }
+   EXPECT_TRUE(NULL == node);
+}
+
+
+TEST_F(CListTwentyFiveElement, Clear)
+{
+   /*** Arrange ***/
+   size_t data = 100;
+
+   /*** Act ***/
+   EXPECT_TRUE(SC_ERROR(list->Clear(NULL)));
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+
+   /*** Assert ***/
+   EXPECT_TRUE(0 == list->Size(list));
+   EXPECT_TRUE((NULL == list->Front(list)) && (NULL == list->Back(list)));
+
+   // The list stays usable
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &data, sizeof(size_t))));
+   EXPECT_TRUE((std::vector<size_t>{ 100 }) == InGetValues(list));
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+}
+
+
+TEST(CListRecycling, SteadyStateReusesNodes)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreate();
+   ASSERT_FALSE(NULL == list);
+   std::vector<CLIST_NODE*> nodes;
+   for (size_t i = 0; i < 64; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      nodes.push_back(list->Back(list));
+   }
+
+   /*** Act && Assert ***/
+   // Every node created after the first fill is one of the removed nodes
+   for (size_t cycle = 0; cycle < 100; ++cycle)
+   {
+      CLIST_NODE* position = list->Next(list, list->Front(list));
+      ASSERT_FALSE(SC_ERROR(list->Remove(list, position)));
+      list->PopFront(list);
+      list->PopBack(list);
+
+      for (size_t i = 0; i < 3; ++i)
+      {
+         ASSERT_FALSE(SC_ERROR(list->PushFront(list, &cycle, sizeof(size_t))));
+         EXPECT_TRUE(std::find(nodes.begin(), nodes.end(), list->Front(list)) != nodes.end());
+      }
+   }
+
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+   for (size_t i = 0; i < 64; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      EXPECT_TRUE(std::find(nodes.begin(), nodes.end(), list->Back(list)) != nodes.end());
+   }
+
+   // Nodes of a compacted list are released together with its pool
+   list->PopBack(list);
+   ASSERT_FALSE(SC_ERROR(list->Compact(list, 0, NULL, NULL)));
+   list->PopBack(list);
+   CListDelete(list);
+}
+
+
+TEST(CListRecycling, CallerAllocatorGetsEveryNode)
+{
+   /*** Arrange ***/
+   CountingAllocator allocator;
+   CLIST* list = CListCreateWithAllocator(&allocator.VTable);
+   ASSERT_FALSE(NULL == list);
+   size_t listBytes = allocator.LiveBytes;
+   size_t data = 25;
+
+   /*** Act ***/
+   for (size_t i = 0; i < 10; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &data, sizeof(size_t))));
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &data, sizeof(size_t))));
+      list->PopBack(list);
+      ASSERT_FALSE(SC_ERROR(list->Remove(list, list->Front(list))));
+   }
+
+   /*** Assert ***/
+   EXPECT_EQ(listBytes, allocator.LiveBytes);
+   EXPECT_EQ(21U, allocator.Allocs);
+   EXPECT_EQ(20U, allocator.Frees);
+
+   CListDelete(list);
+   EXPECT_EQ(0U, allocator.LiveBytes);
+}
+
+
+///////////////////////////////////////////////////////////
+//                  Take / Move semantics                //
+///////////////////////////////////////////////////////////
+
+TEST_F(CListEmpty, TakeInvPrms)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   void* data = NULL;
+   size_t dataSize = 0;
+
+   /*** Act && Assert ***/
+   status = list->PushBackTake(list, NULL, sizeof(size_t));
+   EXPECT_TRUE(SC_INVALID_PARAMETER == SC_CODE(status));
+   status = list->PushFrontTake(NULL, &dataSize, sizeof(size_t));
+   EXPECT_TRUE(SC_INVALID_PARAMETER == SC_CODE(status));
+   status = list->PopFrontTake(list, NULL, &dataSize);
+   EXPECT_TRUE(SC_INVALID_PARAMETER == SC_CODE(status));
+
+   // Empty list
+   status = list->PopFrontTake(list, &data, &dataSize);
+   EXPECT_TRUE(SC_UNSUCCESSFUL == SC_CODE(status));
+   status = list->PopBackTake(list, &data, &dataSize);
+   EXPECT_TRUE(SC_UNSUCCESSFUL == SC_CODE(status));
+}
+
+
+TEST_F(CListEmpty, TakeKeepsBuffers)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   size_t* buffers[3] = { NULL };
+   for (size_t i = 0; i < 3; ++i)
+   {
+      buffers[i] = (size_t*)malloc(sizeof(size_t));
+      ASSERT_FALSE(NULL == buffers[i]);
+      *buffers[i] = i;
+   }
+
+   /*** Act ***/
+   status = list->PushBackTake(list, buffers[1], sizeof(size_t));
+   ASSERT_FALSE(SC_ERROR(status));
+   status = list->PushFrontTake(list, buffers[0], sizeof(size_t));
+   ASSERT_FALSE(SC_ERROR(status));
+   status = list->PushBackTake(list, buffers[2], sizeof(size_t));
+   ASSERT_FALSE(SC_ERROR(status));
+
+   /*** Assert ***/
+   EXPECT_TRUE(3 == list->Size(list));
+
+   void* data = NULL;
+   size_t dataSize = 0;
+   status = list->PopBackTake(list, &data, &dataSize);
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(buffers[2] == data);
+   EXPECT_TRUE(sizeof(size_t) == dataSize);
+   free(data);
+
+   status = list->PopFrontTake(list, &data, &dataSize);
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(buffers[0] == data);
+   free(data);
+
+   status = list->PopFrontTake(list, &data, &dataSize);
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(buffers[1] == data);
+   EXPECT_TRUE(1 == *(size_t*)data);
+   free(data);
+
+   EXPECT_TRUE(0 == list->Size(list));
+   EXPECT_TRUE(NULL == list->Front(list));
+   EXPECT_TRUE(NULL == list->Back(list));
+}
+
+
+TEST(CListTake, InlineDataCopiesBuffers)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   CountingAllocator allocator;
+   CLIST* list = CListCreateEx(CLIST_FLAG_INLINE_DATA, &allocator.VTable);
+   ASSERT_FALSE(NULL == list);
+   size_t liveBytes = allocator.LiveBytes;
+
+   /*** Act ***/
+   for (size_t i = 0; i < 10; ++i)
+   {
+      size_t* buffer = (size_t*)allocator.VTable.Alloc(&allocator.VTable,
+                                                       sizeof(size_t));
+      ASSERT_FALSE(NULL == buffer);
+      *buffer = i;
+      status = list->PushBackTake(list, buffer, sizeof(size_t));
+      ASSERT_FALSE(SC_ERROR(status));
+   }
+
+   /*** Assert ***/
+   for (size_t i = 0; i < 10; ++i)
+   {
+      void* data = NULL;
+      size_t dataSize = 0;
+      status = list->PopFrontTake(list, &data, &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      EXPECT_TRUE(i == *(size_t*)data);
+      allocator.VTable.Free(&allocator.VTable, data, dataSize);
+   }
+
+   EXPECT_TRUE(liveBytes == allocator.LiveBytes);
+
+   CListDelete(list);
+   EXPECT_TRUE(0 == allocator.LiveBytes);
+}
+
+
+TEST_F(CListTwentyFiveElement, GetCopyDataInto)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   CLIST_NODE* position = list->Front(list);
+   size_t data = 0;
+   size_t dataSize = 0;
+   uint8_t small = 0;
+
+   /*** Act && Assert ***/
+   status = list->GetCopyDataInto(list, NULL, &data, sizeof(data), &dataSize);
+   EXPECT_TRUE(SC_INVALID_PARAMETER == SC_CODE(status));
+
+   status = list->GetCopyDataInto(list, position, &small, sizeof(small),
+                                  &dataSize);
+   EXPECT_TRUE(SC_BUFFER_TOO_SMALL == SC_CODE(status));
+   EXPECT_TRUE(sizeof(size_t) == dataSize);
+
+   dataSize = 0;
+   status = list->GetCopyDataInto(list, position, &data, sizeof(data),
+                                  &dataSize);
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(24 == data);
+   EXPECT_TRUE(sizeof(size_t) == dataSize);
+}
+
+
+///////////////////////////////////////////////////////////
+//                     Small data                        //
+///////////////////////////////////////////////////////////
+
+TEST(CListSmallData, OneAllocationPerNode)
+{
+   /*** Arrange ***/
+   CountingAllocator allocator;
+   CLIST* list = CListCreateWithAllocator(&allocator.VTable);
+   ASSERT_FALSE(NULL == list);
+   size_t listAllocs = allocator.Allocs;
+   unsigned char small[CLIST_SMALL_DATA_SIZE] = { 1, 2, 3 };
+   unsigned char large[CLIST_SMALL_DATA_SIZE + 1] = { 4, 5, 6 };
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, small, sizeof(small))));
+   size_t smallAllocs = allocator.Allocs - listAllocs;
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, large, sizeof(large))));
+   size_t largeAllocs = allocator.Allocs - listAllocs - smallAllocs;
+
+   /*** Assert ***/
+   EXPECT_EQ(1U, smallAllocs);
+   EXPECT_EQ(2U, largeAllocs);
+
+   unsigned char copy[CLIST_SMALL_DATA_SIZE + 1] = {};
+   size_t dataSize = 0;
+   CLIST_NODE* front = list->Front(list);
+   ASSERT_FALSE(SC_ERROR(list->GetCopyDataInto(list, front, copy, sizeof(copy), &dataSize)));
+   EXPECT_EQ(sizeof(small), dataSize);
+   EXPECT_EQ(0, memcmp(copy, small, sizeof(small)));
+
+   void* data = NULL;
+   ASSERT_FALSE(SC_ERROR(list->GetCopyData(list, list->Back(list), &data, &dataSize)));
+   EXPECT_EQ(sizeof(large), dataSize);
+   EXPECT_EQ(0, memcmp(data, large, sizeof(large)));
+   free(data);
+
+   CListDelete(list);
+   EXPECT_EQ(0U, allocator.LiveBytes);
+}
+
+
+TEST(CListSmallData, RefToDataBufferCanBeReplaced)
+{
+   /*** Arrange ***/
+   CountingAllocator allocator;
+   CLIST* list = CListCreateWithAllocator(&allocator.VTable);
+   ASSERT_FALSE(NULL == list);
+   uint32_t value = 42;
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &value, sizeof(value))));
+   CLIST_NODE* node = list->Front(list);
+
+   /*** Act ***/
+   void** data = NULL;
+   size_t* dataSize = NULL;
+   ASSERT_FALSE(SC_ERROR(list->GetRefToData(list, node, &data, &dataSize)));
+
+   /*** Assert ***/
+   EXPECT_EQ(42U, **(uint32_t**)data);
+   EXPECT_EQ(sizeof(value), *dataSize);
+
+   // The data has a buffer of its own, replace it with a larger one
+   allocator.VTable.Free(&allocator.VTable, *data, *dataSize);
+   *data = allocator.VTable.Alloc(&allocator.VTable, sizeof(uint64_t));
+   **(uint64_t**)data = 7;
+   *dataSize = sizeof(uint64_t);
+
+   uint64_t copy = 0;
+   size_t copySize = 0;
+   ASSERT_FALSE(SC_ERROR(list->GetCopyDataInto(list, node, &copy, sizeof(copy), &copySize)));
+   EXPECT_EQ(7U, copy);
+   EXPECT_EQ(sizeof(uint64_t), copySize);
+
+   // Allocation failure leaves the node as it is
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &value, sizeof(value))));
+   allocator.FailAfter = allocator.Allocs;
+   STATUS_CODE status = list->GetRefToData(list, list->Back(list), &data, &dataSize);
+   EXPECT_EQ(SC_NOT_ENOUGH_MEMORY, SC_CODE(status));
+   EXPECT_EQ(42U, *(uint32_t*)CListFastData(list->Back(list)));
+
+   CListDelete(list);
+   EXPECT_EQ(0U, allocator.LiveBytes);
+}
+
+
+///////////////////////////////////////////////////////////
+//                     Batch insertion                   //
+///////////////////////////////////////////////////////////
+
+/** Record with a key that is stored and a tag that is skipped by Stride. */
+struct Record
+{
+   size_t Key;
+   size_t Tag;
+};
+
+
+TEST_F(CListEmpty, BatchInvPrms)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   size_t records[4] = { 0 };
+
+   /*** Act && Assert ***/
+   status = list->PushBackBatch(NULL, records, sizeof(size_t), sizeof(size_t), 4);
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->PushBackBatch(list, NULL, sizeof(size_t), sizeof(size_t), 4);
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->PushFrontBatch(list, records, 0, sizeof(size_t), 4);
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->PushFrontBatch(list, records, sizeof(size_t), 1, 4);
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->InsertAfterBatch(list, NULL, records, sizeof(size_t),
+                                   sizeof(size_t), 4);
+   EXPECT_TRUE(SC_ERROR(status));
+
+   // Empty batch
+   status = list->PushBackBatch(list, records, sizeof(size_t), sizeof(size_t), 0);
+   EXPECT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(0 == list->Size(list));
+}
+
+
+TEST_F(CListEmpty, BatchKeepsOrder)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   Record records[1000];
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      records[i].Key = i;
+      records[i].Tag = 0xDEADBEEF;
+   }
+
+   /*** Act ***/
+   // 300..599, then 0..299 in front, then 600..999 after 299
+   status = list->PushBackBatch(list, &records[300], sizeof(size_t),
+                                sizeof(Record), 300);
+   ASSERT_FALSE(SC_ERROR(status));
+   status = list->PushFrontBatch(list, &records[0], sizeof(size_t),
+                                 sizeof(Record), 300);
+   ASSERT_FALSE(SC_ERROR(status));
+
+   CLIST_NODE* position = list->Back(list);
+   status = list->PushBackBatch(list, &records[900], sizeof(size_t),
+                                sizeof(Record), 100);
+   ASSERT_FALSE(SC_ERROR(status));
+   status = list->InsertAfterBatch(list, position, &records[600], sizeof(size_t),
+                                   sizeof(Record), 300);
+   ASSERT_FALSE(SC_ERROR(status));
+
+   /*** Assert ***/
+   EXPECT_TRUE(1000 == list->Size(list));
+
+   size_t expected = 0;
+   for (position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      status = list->GetRefToData(list, position, &data, &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      ASSERT_TRUE(sizeof(size_t) == *dataSize);
+      ASSERT_TRUE(expected++ == **((size_t**)data));
+   }
+   EXPECT_TRUE(1000 == expected);
+
+   expected = 1000;
+   for (position = list->Back(list);
+        position != NULL;
+        position = list->Prev(list, position))
+   {
+      --expected;
+   }
+   EXPECT_TRUE(0 == expected);
+}
+
+
+TEST(CListBatch, FailureLeavesListUnchanged)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   CountingAllocator allocator;
+   CLIST* list = CListCreateWithAllocator(&allocator.VTable);
+   ASSERT_FALSE(NULL == list);
+
+   size_t records[100];
+   for (size_t i = 0; i < 100; ++i) { records[i] = i; }
+
+   status = list->PushBackBatch(list, records, sizeof(size_t), sizeof(size_t), 10);
+   ASSERT_FALSE(SC_ERROR(status));
+   size_t liveBytes = allocator.LiveBytes;
+
+   /*** Act ***/
+   allocator.FailAfter = allocator.Allocs + 15;
+   status = list->PushFrontBatch(list, records, sizeof(size_t), sizeof(size_t), 100);
+
+   /*** Assert ***/
+   EXPECT_TRUE(SC_ERROR(status));
+   EXPECT_TRUE(10 == list->Size(list));
+   EXPECT_TRUE(liveBytes == allocator.LiveBytes);
+
+   size_t expected = 0;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      size_t data = 0;
+      size_t dataSize = 0;
+      status = list->GetCopyDataInto(list, position, &data, sizeof(data), &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      ASSERT_TRUE(expected++ == data);
+   }
+
+   CListDelete(list);
+}
+
+
+TEST_F(CListEmpty, BatchNodesShareSlabs)
+{
+   /*** Arrange ***/
+   size_t records[256];
+   for (size_t i = 0; i < 256; ++i) { records[i] = i; }
+
+   CLIST* other = CListCreate();
+   ASSERT_FALSE(NULL == other);
+   ASSERT_FALSE(SC_ERROR(other->PushBackBatch(other, records, sizeof(size_t),
+                                              sizeof(size_t), 256)));
+   std::vector<CLIST_NODE*> nodes;
+   for (CLIST_NODE* position = other->Front(other);
+        position != NULL;
+        position = other->Next(other, position))
+   {
+      nodes.push_back(position);
+   }
+   CListDelete(other);
+
+   /*** Act ***/
+   STATUS_CODE status = list->PushBackBatch(list, records, sizeof(size_t),
+                                            sizeof(size_t), 256);
+   ASSERT_FALSE(SC_ERROR(status));
+
+   /*** Assert ***/
+   // Lists take equally sized nodes from shared slabs, so the nodes
+   // released by the other list are reused
+   EXPECT_TRUE(256 == list->Size(list));
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      EXPECT_TRUE(std::find(nodes.begin(), nodes.end(), position) != nodes.end());
+   }
+}
+
+
+TEST(CListBatch, FixedList)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   CLIST* list = CListCreateFixed(sizeof(size_t));
+   ASSERT_FALSE(NULL == list);
+   size_t records[100];
+   for (size_t i = 0; i < 100; ++i) { records[i] = i; }
+
+   /*** Act && Assert ***/
+   status = list->PushBackBatch(list, records, sizeof(uint32_t), sizeof(size_t), 100);
+   EXPECT_TRUE(SC_ERROR(status));
+
+   status = list->PushBackBatch(list, records, sizeof(size_t), sizeof(size_t), 100);
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(100 == list->Size(list));
+
+   size_t expected = 0;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      size_t data = 0;
+      size_t dataSize = 0;
+      status = list->GetCopyDataInto(list, position, &data, sizeof(data), &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      ASSERT_TRUE(expected++ == data);
+   }
+
+   CListDelete(list);
+}
+
+
+///////////////////////////////////////////////////////////
+//                Splice, SplitAfter, Append             //
+///////////////////////////////////////////////////////////
+
+/** Returns the size_t values stored in the List. */
+static std::vector<size_t> InToVector(CLIST* List)
+{
+   std::vector<size_t> values;
+   for (CLIST_NODE* position = List->Front(List);
+        position != NULL;
+        position = List->Next(List, position))
+   {
+      size_t data = 0;
+      size_t dataSize = 0;
+      STATUS_CODE status = List->GetCopyDataInto(List, position, &data,
+                                                 sizeof(data), &dataSize);
+      EXPECT_FALSE(SC_ERROR(status));
+      values.push_back(data);
+   }
+
+   // Backward traversal must see the same nodes
+   size_t count = 0;
+   for (CLIST_NODE* position = List->Back(List);
+        position != NULL;
+        position = List->Prev(List, position))
+   {
+      ++count;
+   }
+   EXPECT_TRUE(values.size() == count);
+   EXPECT_TRUE(List->Size(List) == count);
+
+   return values;
+}
+
+
+/** Returns the node at the Index of the List. */
+static CLIST_NODE* InGetNodeAt(CLIST* List, size_t Index)
+{
+   CLIST_NODE* position = List->Front(List);
+   while (Index-- > 0) { position = List->Next(List, position); }
+   return position;
+}
+
+
+TEST_F(CListTwentyFiveElement, SpliceInvPrms)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   CLIST* other = CListCreateEx(CLIST_FLAG_INLINE_DATA, NULL);
+   ASSERT_FALSE(NULL == other);
+   size_t data = 0;
+   ASSERT_FALSE(SC_ERROR(other->PushBack(other, &data, sizeof(data))));
+
+   /*** Act && Assert ***/
+   status = list->Splice(list, NULL, NULL, InGetNodeAt(list, 0), InGetNodeAt(list, 1));
+   EXPECT_TRUE(SC_ERROR(status));
+
+   // Incompatible lists
+   status = list->Splice(list, NULL, other, other->Front(other), other->Front(other));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->Append(list, other);
+   EXPECT_TRUE(SC_ERROR(status));
+
+   // Last is before First
+   status = list->Splice(list, NULL, list, InGetNodeAt(list, 5), InGetNodeAt(list, 4));
+   EXPECT_TRUE(SC_ERROR(status));
+
+   // Position inside the range
+   status = list->Splice(list, InGetNodeAt(list, 5), list, InGetNodeAt(list, 4), InGetNodeAt(list, 6));
+   EXPECT_TRUE(SC_ERROR(status));
+
+   status = list->Append(list, list);
+   EXPECT_TRUE(SC_ERROR(status));
+   EXPECT_TRUE(NULL == list->SplitAfter(list, NULL));
+
+   EXPECT_TRUE(25 == InToVector(list).size());
+
+   CListDelete(other);
+}
+
+
+TEST_F(CListEmpty, SpliceMovesNodes)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   size_t records[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+   ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, records, sizeof(size_t),
+                                             sizeof(size_t), 5)));
+   CLIST* other = CListCreate();
+   ASSERT_FALSE(NULL == other);
+   ASSERT_FALSE(SC_ERROR(other->PushBackBatch(other, &records[5], sizeof(size_t),
+                                              sizeof(size_t), 5)));
+
+   CLIST_NODE* first = InGetNodeAt(other, 1);
+   void** data = NULL;
+   size_t* dataSize = NULL;
+   ASSERT_FALSE(SC_ERROR(other->GetRefToData(other, first, &data, &dataSize)));
+   void* buffer = *data;
+
+   /*** Act ***/
+   // 6, 7, 8 go between 1 and 2
+   status = list->Splice(list, InGetNodeAt(list, 2), other, first, InGetNodeAt(other, 3));
+   ASSERT_FALSE(SC_ERROR(status));
+
+   /*** Assert ***/
+   EXPECT_TRUE((std::vector<size_t>{ 0, 1, 6, 7, 8, 2, 3, 4 }) == InToVector(list));
+   EXPECT_TRUE((std::vector<size_t>{ 5, 9 }) == InToVector(other));
+
+   // The node and its data are the same
+   EXPECT_TRUE(first == InGetNodeAt(list, 2));
+   ASSERT_FALSE(SC_ERROR(list->GetRefToData(list, first, &data, &dataSize)));
+   EXPECT_TRUE(buffer == *data);
+
+   // Within the list: 0 1 6 goes to the end, then 3 to the front
+   status = list->Splice(list, NULL, list, InGetNodeAt(list, 0), InGetNodeAt(list, 2));
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE((std::vector<size_t>{ 7, 8, 2, 3, 4, 0, 1, 6 }) == InToVector(list));
+   status = list->Splice(list, InGetNodeAt(list, 0), list, InGetNodeAt(list, 3), InGetNodeAt(list, 3));
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE((std::vector<size_t>{ 3, 7, 8, 2, 4, 0, 1, 6 }) == InToVector(list));
+
+   // The whole other list to the front
+   status = list->Splice(list, list->Front(list), other, other->Front(other),
+                         other->Back(other));
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE((std::vector<size_t>{ 5, 9, 3, 7, 8, 2, 4, 0, 1, 6 }) == InToVector(list));
+   EXPECT_TRUE(InToVector(other).empty());
+   EXPECT_TRUE(NULL == other->Front(other));
+
+   CListDelete(other);
+}
+
+
+TEST_F(CListTwentyFiveElement, SplitAfterAndAppend)
+{
+   /*** Arrange ***/
+   std::vector<size_t> expected = InToVector(list);
+   CLIST_NODE* position = InGetNodeAt(list, 9);
+   CLIST_NODE* moved = InGetNodeAt(list, 10);
+
+   /*** Act ***/
+   CLIST* tail = list->SplitAfter(list, position);
+   ASSERT_FALSE(NULL == tail);
+
+   /*** Assert ***/
+   EXPECT_TRUE(std::vector<size_t>(expected.begin(), expected.begin() + 10) ==
+               InToVector(list));
+   EXPECT_TRUE(std::vector<size_t>(expected.begin() + 10, expected.end()) ==
+               InToVector(tail));
+   EXPECT_TRUE(moved == tail->Front(tail));
+
+   // Splitting after the last node gives an empty list
+   CLIST* empty = tail->SplitAfter(tail, tail->Back(tail));
+   ASSERT_FALSE(NULL == empty);
+   EXPECT_TRUE(0 == empty->Size(empty));
+
+   ASSERT_FALSE(SC_ERROR(list->Append(list, empty)));
+   ASSERT_FALSE(SC_ERROR(list->Append(list, tail)));
+   EXPECT_TRUE(expected == InToVector(list));
+   EXPECT_TRUE(0 == tail->Size(tail));
+   EXPECT_TRUE(moved == InGetNodeAt(list, 10));
+
+   CListDelete(empty);
+   CListDelete(tail);
+}
+
+
+TEST(CListSplice, CallerAllocatorListsKeepHandles)
+{
+   /*** Arrange ***/
+   CountingAllocator allocator;
+   CLIST* list = CListCreateWithAllocator(&allocator.VTable);
+   CLIST* other = CListCreateWithAllocator(&allocator.VTable);
+   ASSERT_FALSE((NULL == list) || (NULL == other));
+   size_t records[6] = { 0, 1, 2, 3, 4, 5 };
+   ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, records, sizeof(size_t),
+                                             sizeof(size_t), 3)));
+   ASSERT_FALSE(SC_ERROR(other->PushBackBatch(other, &records[3], sizeof(size_t),
+                                              sizeof(size_t), 3)));
+   CLIST_NODE* moved = other->Front(other);
+
+   /*** Act ***/
+   STATUS_CODE status = list->Splice(list, NULL, other, moved, moved);
+   ASSERT_FALSE(SC_ERROR(status));
+   size_t allocs = allocator.Allocs;
+   CLIST* tail = list->SplitAfter(list, list->Front(list));
+   ASSERT_FALSE(NULL == tail);
+   EXPECT_TRUE(moved == tail->Back(tail));
+   ASSERT_FALSE(SC_ERROR(other->Append(other, tail)));
+
+   /*** Assert ***/
+   EXPECT_TRUE((std::vector<size_t>{ 0 }) == InToVector(list));
+   EXPECT_TRUE((std::vector<size_t>{ 4, 5, 1, 2, 3 }) == InToVector(other));
+   EXPECT_TRUE(moved == other->Back(other));
+
+   // Nodes are relinked, only the new list is allocated
+   EXPECT_EQ(allocs + 1, allocator.Allocs);
+
+   CListDelete(tail);
+   CListDelete(other);
+   CListDelete(list);
+   EXPECT_EQ(0U, allocator.LiveBytes);
+}
+
+
+TEST(CListSplice, DefaultListsRelinkNodes)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreate();
+   CLIST* other = CListCreate();
+   ASSERT_FALSE((NULL == list) || (NULL == other));
+   char big[64] = { 'B' };
+   size_t small = 7;
+   ASSERT_FALSE(SC_ERROR(other->PushBack(other, big, sizeof(big))));
+   ASSERT_FALSE(SC_ERROR(other->PushBack(other, &small, sizeof(small))));
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &small, sizeof(small))));
+
+   CLIST_NODE* moved = other->Front(other);
+   void** data = NULL;
+   size_t* dataSize = NULL;
+   ASSERT_FALSE(SC_ERROR(other->GetRefToData(other, moved, &data, &dataSize)));
+   void* buffer = *data;
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(list->Append(list, other)));
+
+   /*** Assert ***/
+   // Lists of the system allocator share their node slabs, the node and
+   // its buffer are the same
+   EXPECT_TRUE(moved == list->Next(list, list->Front(list)));
+   ASSERT_FALSE(SC_ERROR(list->GetRefToData(list, moved, &data, &dataSize)));
+   EXPECT_TRUE(buffer == *data);
+   EXPECT_TRUE(sizeof(big) == *dataSize);
+   EXPECT_TRUE(0 == other->Size(other));
+
+   size_t value = 0;
+   size_t valueSize = 0;
+   ASSERT_FALSE(SC_ERROR(list->GetCopyDataInto(list, list->Back(list), &value,
+                                               sizeof(value), &valueSize)));
+   EXPECT_TRUE(small == value);
+
+   // Within the list nodes are only relinked
+   CLIST_NODE* back = list->Back(list);
+   ASSERT_FALSE(SC_ERROR(list->Splice(list, list->Front(list), list, back, back)));
+   EXPECT_TRUE(back == list->Front(list));
+
+   CListDelete(other);
+   CListDelete(list);
+}
+
+
+TEST(CListSplice, FixedListsRelinkNodes)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreateFixed(sizeof(size_t));
+   CLIST* other = CListCreateFixed(sizeof(size_t));
+   ASSERT_FALSE((NULL == list) || (NULL == other));
+   size_t records[6] = { 0, 1, 2, 3, 4, 5 };
+   ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, records, sizeof(size_t),
+                                             sizeof(size_t), 3)));
+   ASSERT_FALSE(SC_ERROR(other->PushBackBatch(other, &records[3], sizeof(size_t),
+                                              sizeof(size_t), 3)));
+   CLIST_NODE* moved = other->Front(other);
+   CLIST_NODE* split = InGetNodeAt(list, 1);
+
+   /*** Act ***/
+   STATUS_CODE status = list->Splice(list, list->Front(list), other,
+                                     other->Front(other), InGetNodeAt(other, 1));
+   ASSERT_FALSE(SC_ERROR(status));
+   CLIST* tail = list->SplitAfter(list, InGetNodeAt(list, 2));
+   ASSERT_FALSE(NULL == tail);
+
+   /*** Assert ***/
+   EXPECT_TRUE((std::vector<size_t>{ 3, 4, 0 }) == InToVector(list));
+   EXPECT_TRUE((std::vector<size_t>{ 1, 2 }) == InToVector(tail));
+   EXPECT_TRUE((std::vector<size_t>{ 5 }) == InToVector(other));
+
+   // Fixed lists of one element size share their node slabs, the nodes
+   // are relinked together with the data inside them
+   EXPECT_TRUE(moved == list->Front(list));
+   EXPECT_TRUE(split == tail->Front(tail));
+
+   void** data = NULL;
+   size_t* dataSize = NULL;
+   ASSERT_FALSE(SC_ERROR(tail->GetRefToData(tail, split, &data, &dataSize)));
+   EXPECT_TRUE(sizeof(size_t) == *dataSize);
+   EXPECT_TRUE(1 == **((size_t**)data));
+
+   CListDelete(tail);
+   CListDelete(other);
+   CListDelete(list);
+}
+
+
+///////////////////////////////////////////////////////////
+//                         Sort                          //
+///////////////////////////////////////////////////////////
+
+/** Orders Record values by Key only. */
+static int InCompareKeys(void* Left, size_t LeftSize, void* Right, size_t RightSize,
+                       void* Context)
+{
+   (void)LeftSize;
+   (void)RightSize;
+   if (Context != NULL) { ++*(size_t*)Context; }
+
+   size_t left = ((Record*)Left)->Key;
+   size_t right = ((Record*)Right)->Key;
+   return (left < right) ? -1 : (left > right) ? 1 : 0;
+}
+
+
+/** Fills the List with Count records with repeating keys, Tag is the index. */
+static std::vector<Record> InFillRecords(CLIST* List, size_t Count)
+{
+   std::vector<Record> records(Count);
+   std::mt19937 random(25);
+   for (size_t i = 0; i < Count; ++i)
+   {
+      records[i].Key = random() % (Count / 4 + 1);
+      records[i].Tag = i;
+   }
+
+   STATUS_CODE status = List->PushBackBatch(List, records.data(), sizeof(Record),
+                                            sizeof(Record), Count);
+   EXPECT_FALSE(SC_ERROR(status));
+
+   std::stable_sort(records.begin(), records.end(),
+                    [](const Record& Left, const Record& Right)
+                    { return Left.Key < Right.Key; });
+   return records;
+}
+
+
+/** Expects the List to hold the Records in the same order. */
+static void InExpectRecords(CLIST* List, const std::vector<Record>& Records)
+{
+   ASSERT_TRUE(Records.size() == List->Size(List));
+
+   size_t i = 0;
+   CLIST_NODE* prev = NULL;
+   for (CLIST_NODE* position = List->Front(List);
+        position != NULL;
+        position = List->Next(List, position), ++i)
+   {
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      ASSERT_FALSE(SC_ERROR(List->GetRefToData(List, position, &data, &dataSize)));
+      ASSERT_TRUE(Records[i].Key == ((Record*)*data)->Key);
+      ASSERT_TRUE(Records[i].Tag == ((Record*)*data)->Tag);
+      ASSERT_TRUE(prev == List->Prev(List, position));
+      prev = position;
+   }
+
+   EXPECT_TRUE(prev == List->Back(List));
+}
+
+
+TEST_F(CListEmpty, SortInvPrms)
+{
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->Sort(list, NULL, NULL)));
+   EXPECT_TRUE(SC_ERROR(list->Sort(NULL, InCompareKeys, NULL)));
+   EXPECT_TRUE(SC_ERROR(list->SortParallel(list, InCompareKeys, NULL, 0)));
+
+   // Nothing to sort
+   EXPECT_FALSE(SC_ERROR(list->Sort(list, InCompareKeys, NULL)));
+   EXPECT_TRUE(NULL == list->Front(list));
+}
+
+
+TEST_F(CListEmpty, SortIsStable)
+{
+   /*** Arrange ***/
+   std::vector<Record> expected = InFillRecords(list, 1000);
+   CLIST_NODE* front = list->Front(list);
+   size_t comparisons = 0;
+
+   /*** Act ***/
+   STATUS_CODE status = list->Sort(list, InCompareKeys, &comparisons);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   InExpectRecords(list, expected);
+
+   // N log N comparisons at most
+   EXPECT_TRUE(comparisons <= 1000 * 10);
+
+   // Nodes are relinked, not copied
+   bool isFound = false;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      isFound = isFound || (position == front);
+   }
+   EXPECT_TRUE(isFound);
+}
+
+
+TEST(CListSort, InlineAndFixedLists)
+{
+   /*** Arrange ***/
+   CLIST* lists[2] = { CListCreateEx(CLIST_FLAG_INLINE_DATA, NULL),
+                       CListCreateFixed(sizeof(Record)) };
+
+   for (CLIST* list : lists)
+   {
+      ASSERT_FALSE(NULL == list);
+      std::vector<Record> expected = InFillRecords(list, 777);
+
+      /*** Act ***/
+      STATUS_CODE status = list->Sort(list, InCompareKeys, NULL);
+
+      /*** Assert ***/
+      ASSERT_FALSE(SC_ERROR(status));
+      InExpectRecords(list, expected);
+   }
+
+   for (CLIST* list : lists) { CListDelete(list); }
+}
+
+
+TEST_F(CListEmpty, SortParallel)
+{
+   /*** Arrange ***/
+   std::vector<Record> expected = InFillRecords(list, 5 * CLIST_PARALLEL_SORT_MIN_RUN + 7);
+
+   /*** Act ***/
+   STATUS_CODE status = list->SortParallel(list, InCompareKeys, NULL, 4);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   InExpectRecords(list, expected);
+
+   // Sorted input stays the same, one thread falls back to Sort
+   status = list->SortParallel(list, InCompareKeys, NULL, 3);
+   ASSERT_FALSE(SC_ERROR(status));
+   InExpectRecords(list, expected);
+   status = list->SortParallel(list, InCompareKeys, NULL, 1);
+   ASSERT_FALSE(SC_ERROR(status));
+   InExpectRecords(list, expected);
+}
+
+
+///////////////////////////////////////////////////////////
+//                  Callback traversal                   //
+///////////////////////////////////////////////////////////
+
+/** Value stored in a buffer of its own, it is larger than CLIST_SMALL_DATA_SIZE. */
+struct WideValue
+{
+   size_t Value;
+   char   Filler[40];
+};
+
+
+/** Value and data size of a visited node. */
+typedef std::pair<size_t, size_t> Visit;
+
+
+/** Records the first size_t of the Data in the std::vector<Visit> Context. */
+static void InRecordVisit(void* Data, size_t DataSize, void* Context)
+{
+   size_t value = 0;
+   memcpy(&value, Data, sizeof(size_t));
+   static_cast<std::vector<Visit>*>(Context)->push_back(Visit(value, DataSize));
+}
+
+
+/**
+ * Fills the List with Count values, every third one is stored in a
+ * WideValue unless IsSmallOnly. Returns the expected visits.
+ */
+static std::vector<Visit> InFillVisits(CLIST* List, size_t Count, bool IsSmallOnly)
+{
+   std::vector<Visit> visits;
+   for (size_t i = 0; i < Count; ++i)
+   {
+      WideValue wide = {};
+      wide.Value = i;
+      bool isWide = !IsSmallOnly && (0 == i % 3);
+      size_t dataSize = isWide ? sizeof(WideValue) : sizeof(size_t);
+
+      EXPECT_FALSE(SC_ERROR(List->PushBack(List, &wide, dataSize)));
+      visits.push_back(Visit(i, dataSize));
+   }
+
+   return visits;
+}
+
+
+TEST_F(CListEmpty, ForEachInvPrms)
+{
+   /*** Arrange ***/
+   std::vector<Visit> visits;
+   CLIST_ITEM items[4] = {};
+   CLIST_NODE* position = NULL;
+   size_t count = 1;
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->ForEach(NULL, InRecordVisit, &visits)));
+   EXPECT_TRUE(SC_ERROR(list->ForEach(list, NULL, &visits)));
+
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(NULL, &position, items, 4, &count)));
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(list, NULL, items, 4, &count)));
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(list, &position, NULL, 4, &count)));
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(list, &position, items, 0, &count)));
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(list, &position, items, 4, NULL)));
+
+   // An empty list is visited without calls, the cursor is at the end
+   ASSERT_FALSE(SC_ERROR(list->ForEach(list, InRecordVisit, &visits)));
+   EXPECT_TRUE(visits.empty());
+
+   position = list->Front(list);
+   ASSERT_FALSE(SC_ERROR(list->NextBatch(list, &position, items, 4, &count)));
+   EXPECT_EQ(0U, count);
+   EXPECT_TRUE(NULL == position);
+}
+
+
+TEST(CListForEach, VisitsNodesInListOrder)
+{
+   /*** Arrange ***/
+   // Shorter and longer than the prefetch distance, in every storage mode
+   struct { CLIST* List; bool IsSmallOnly; } cases[] =
+   {
+      { CListCreate(), false },
+      { CListCreateEx(CLIST_FLAG_INLINE_DATA, NULL), false },
+      { CListCreateFixed(sizeof(size_t)), true },
+   };
+
+   for (auto& test : cases)
+   {
+      ASSERT_FALSE(NULL == test.List);
+      for (size_t count : { 3, 1000 })
+      {
+         ASSERT_FALSE(SC_ERROR(test.List->Clear(test.List)));
+         std::vector<Visit> expected = InFillVisits(test.List, count, test.IsSmallOnly);
+
+         /*** Act ***/
+         std::vector<Visit> visits;
+         ASSERT_FALSE(SC_ERROR(test.List->ForEach(test.List, InRecordVisit, &visits)));
+
+         /*** Assert ***/
+         EXPECT_TRUE(expected == visits);
+      }
+
+      CListDelete(test.List);
+   }
+}
+
+
+TEST_F(CListEmpty, NextBatchReadsListInRuns)
+{
+   /*** Arrange ***/
+   std::vector<Visit> expected = InFillVisits(list, 50, false);
+   CLIST_ITEM items[7] = {};
+
+   /*** Act ***/
+   // Items are written in place through the cursor
+   std::vector<Visit> visits;
+   std::vector<size_t> counts;
+   CLIST_NODE* position = list->Front(list);
+   size_t count = 0;
+   do
+   {
+      ASSERT_FALSE(SC_ERROR(list->NextBatch(list, &position, items, 7, &count)));
+      counts.push_back(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+         InRecordVisit(items[i].Data, items[i].DataSize, &visits);
+         *(size_t*)items[i].Data += 100;
+      }
+   } while (count > 0);
+
+   /*** Assert ***/
+   EXPECT_TRUE(expected == visits);
+   EXPECT_TRUE((std::vector<size_t>{ 7, 7, 7, 7, 7, 7, 7, 1, 0 }) == counts);
+   EXPECT_TRUE(NULL == position);
+
+   visits.clear();
+   ASSERT_FALSE(SC_ERROR(list->ForEach(list, InRecordVisit, &visits)));
+   for (size_t i = 0; i < visits.size(); ++i)
+   {
+      EXPECT_EQ(expected[i].first + 100, visits[i].first);
+   }
+
+   // A cursor may start in the middle of the list
+   position = InGetNodeAt(list, 48);
+   ASSERT_FALSE(SC_ERROR(list->NextBatch(list, &position, items, 7, &count)));
+   EXPECT_EQ(2U, count);
+   EXPECT_EQ(148U, *(size_t*)items[0].Data);
+   EXPECT_TRUE(NULL == position);
+}
+
+
+///////////////////////////////////////////////////////////
+//                  Parallel traversal                   //
+///////////////////////////////////////////////////////////
+
+/** Run of consecutive values folded by ParallelReduce. */
+struct Sequence
+{
+   size_t First;
+   size_t Last;
+   size_t Count;
+   bool   IsOrdered;
+};
+
+
+/** Doubles the size_t value and counts the visit in the atomic Context. */
+static void InDoubleValue(void* Data, size_t DataSize, void* Context)
+{
+   EXPECT_TRUE(sizeof(size_t) == DataSize);
+   *(size_t*)Data *= 2;
+   static_cast<std::atomic<size_t>*>(Context)->fetch_add(1);
+}
+
+
+/** Appends the size_t value to the Sequence. */
+static void InAppendValue(void* Accumulator, void* Data, size_t DataSize, void* Context)
+{
+   (void)DataSize;
+   (void)Context;
+   Sequence* sequence = static_cast<Sequence*>(Accumulator);
+   size_t value = *(size_t*)Data;
+
+   if (0 == sequence->Count) { sequence->First = value; }
+   else if (value != sequence->Last + 1) { sequence->IsOrdered = false; }
+
+   sequence->Last = value;
+   ++sequence->Count;
+}
+
+
+/** Appends the Other sequence to the Sequence. */
+static void InAppendSequence(void* Accumulator, void* Other, void* Context)
+{
+   (void)Context;
+   Sequence* sequence = static_cast<Sequence*>(Accumulator);
+   const Sequence* other = static_cast<const Sequence*>(Other);
+   if (0 == other->Count) { return; }
+
+   if (0 == sequence->Count) { *sequence = *other; return; }
+
+   sequence->IsOrdered = sequence->IsOrdered && other->IsOrdered &&
+                         (other->First == sequence->Last + 1);
+   sequence->Last = other->Last;
+   sequence->Count += other->Count;
+}
+
+
+TEST_F(CListEmpty, ParallelInvPrms)
+{
+   /*** Arrange ***/
+   Sequence sequence = { 0, 0, 0, true };
+   std::atomic<size_t> visits(0);
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->ParallelForEach(NULL, InDoubleValue, &visits, 2)));
+   EXPECT_TRUE(SC_ERROR(list->ParallelForEach(list, NULL, &visits, 2)));
+   EXPECT_TRUE(SC_ERROR(list->ParallelForEach(list, InDoubleValue, &visits, 0)));
+
+   EXPECT_TRUE(SC_ERROR(list->ParallelReduce(NULL, InAppendValue, InAppendSequence, NULL,
+                                             &sequence, sizeof(Sequence), 2)));
+   EXPECT_TRUE(SC_ERROR(list->ParallelReduce(list, NULL, InAppendSequence, NULL,
+                                             &sequence, sizeof(Sequence), 2)));
+   EXPECT_TRUE(SC_ERROR(list->ParallelReduce(list, InAppendValue, NULL, NULL,
+                                             &sequence, sizeof(Sequence), 2)));
+   EXPECT_TRUE(SC_ERROR(list->ParallelReduce(list, InAppendValue, InAppendSequence, NULL,
+                                             NULL, sizeof(Sequence), 2)));
+   EXPECT_TRUE(SC_ERROR(list->ParallelReduce(list, InAppendValue, InAppendSequence, NULL,
+                                             &sequence, 0, 2)));
+   EXPECT_TRUE(SC_ERROR(list->ParallelReduce(list, InAppendValue, InAppendSequence, NULL,
+                                             &sequence, sizeof(Sequence), 0)));
+
+   // An empty list is visited without calls
+   ASSERT_FALSE(SC_ERROR(list->ParallelForEach(list, InDoubleValue, &visits, 4)));
+   ASSERT_FALSE(SC_ERROR(list->ParallelReduce(list, InAppendValue, InAppendSequence, NULL,
+                                              &sequence, sizeof(Sequence), 4)));
+   EXPECT_EQ(0U, visits.load());
+   EXPECT_EQ(0U, sequence.Count);
+}
+
+
+TEST(CListParallel, ForEachVisitsEveryNodeOnce)
+{
+   /*** Arrange ***/
+   CLIST* lists[2] = { CListCreate(), CListCreateFixed(sizeof(size_t)) };
+   size_t count = 5 * CLIST_PARALLEL_MIN_CHUNK + 7;
+
+   for (CLIST* list : lists)
+   {
+      ASSERT_FALSE(NULL == list);
+      for (size_t i = 0; i < count; ++i)
+      {
+         ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      }
+
+      /*** Act ***/
+      // More threads than chunks, a few chunks, one thread
+      std::atomic<size_t> visits(0);
+      ASSERT_FALSE(SC_ERROR(list->ParallelForEach(list, InDoubleValue, &visits, 64)));
+      ASSERT_FALSE(SC_ERROR(list->ParallelForEach(list, InDoubleValue, &visits, 3)));
+      ASSERT_FALSE(SC_ERROR(list->ParallelForEach(list, InDoubleValue, &visits, 1)));
+
+      /*** Assert ***/
+      EXPECT_EQ(3 * count, visits.load());
+
+      size_t i = 0;
+      for (CLIST_NODE* node = CListFastFront(list); node != NULL; node = CListFastNext(node), ++i)
+      {
+         ASSERT_EQ(8 * i, *(size_t*)CListFastData(node));
+      }
+      EXPECT_EQ(count, i);
+
+      CListDelete(list);
+   }
+}
+
+
+TEST(CListParallel, ReduceCombinesChunksInListOrder)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreate();
+   ASSERT_FALSE(NULL == list);
+   size_t count = 7 * CLIST_PARALLEL_MIN_CHUNK + 3;
+   for (size_t i = 0; i < count; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+   }
+
+   for (size_t threads : { 1, 2, 3, 7, 16 })
+   {
+      /*** Act ***/
+      Sequence sequence = { 0, 0, 0, true };
+      ASSERT_FALSE(SC_ERROR(list->ParallelReduce(list, InAppendValue, InAppendSequence, NULL,
+                                                 &sequence, sizeof(Sequence), threads)));
+
+      /*** Assert ***/
+      EXPECT_TRUE(sequence.IsOrdered);
+      EXPECT_EQ(count, sequence.Count);
+      EXPECT_EQ(0U, sequence.First);
+      EXPECT_EQ(count - 1, sequence.Last);
+   }
+
+   CListDelete(list);
+}
+
+
+///////////////////////////////////////////////////////////
+//                   Unchecked access                    //
+///////////////////////////////////////////////////////////
+
+TEST_F(CListTwentyFiveElement, FastMatchesChecked)
+{
+   /*** Arrange ***/
+   CLIST_NODE* checked = list->Front(list);
+
+   /*** Act ***/
+   CLIST_NODE* fast = CListFastFront(list);
+
+   /*** Assert ***/
+   ASSERT_EQ(list->Size(list), CListFastSize(list));
+   ASSERT_TRUE(list->Back(list) == CListFastBack(list));
+
+   for (; checked != NULL; checked = list->Next(list, checked), fast = CListFastNext(fast))
+   {
+      ASSERT_TRUE(checked == fast);
+
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      ASSERT_FALSE(SC_ERROR(list->GetRefToData(list, checked, &data, &dataSize)));
+      ASSERT_TRUE(*data == CListFastData(fast));
+      ASSERT_EQ(*dataSize, CListFastDataSize(list, fast));
+      ASSERT_TRUE(list->Prev(list, checked) == CListFastPrev(fast));
+   }
+
+   EXPECT_TRUE(NULL == fast);
+}
+
+
+TEST(CListFast, FixedList)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreateFixed(sizeof(uint64_t));
+   ASSERT_FALSE(NULL == list);
+   uint64_t values[3] = { 7, 8, 9 };
+   ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, values, sizeof(uint64_t),
+                                             sizeof(uint64_t), 3)));
+
+   /*** Act ***/
+   uint64_t sum = 0;
+   for (CLIST_NODE* node = CListFastFront(list); node != NULL; node = CListFastNext(node))
+   {
+      sum += *(uint64_t*)CListFastData(node);
+      ASSERT_EQ(sizeof(uint64_t), CListFastDataSize(list, node));
+   }
+
+   /*** Assert ***/
+   EXPECT_EQ(24U, sum);
+
+   CListDelete(list);
+}
+
+
+TEST(CListFast, EmplaceLinksNodeStorage)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreate();
+   CLIST* inlineList = CListCreateEx(CLIST_FLAG_INLINE_DATA, NULL);
+   ASSERT_FALSE((NULL == list) || (NULL == inlineList));
+   char big[CLIST_SMALL_DATA_SIZE + 8] = {};
+
+   /*** Act ***/
+   // 1 at the end, 0 before it, 2 at the end again
+   CLIST_NODE* one = CListFastEmplace(list, NULL, sizeof(size_t));
+   ASSERT_FALSE(NULL == one);
+   *(size_t*)CListFastData(one) = 1;
+   CLIST_NODE* zero = CListFastEmplace(list, one, sizeof(size_t));
+   ASSERT_FALSE(NULL == zero);
+   *(size_t*)CListFastData(zero) = 0;
+   CLIST_NODE* two = CListFastEmplace(list, NULL, sizeof(size_t));
+   ASSERT_FALSE(NULL == two);
+   *(size_t*)CListFastData(two) = 2;
+
+   CLIST_NODE* large = CListFastEmplace(inlineList, NULL, sizeof(big));
+   ASSERT_FALSE(NULL == large);
+   memset(CListFastData(large), 'L', sizeof(big));
+
+   /*** Assert ***/
+   EXPECT_TRUE((std::vector<size_t>{ 0, 1, 2 }) == InToVector(list));
+   EXPECT_TRUE(zero == list->Front(list));
+   EXPECT_TRUE(two == list->Back(list));
+   EXPECT_TRUE(zero == list->Prev(list, one));
+
+   EXPECT_EQ(sizeof(big), CListFastDataSize(inlineList, large));
+   size_t dataSize = 0;
+   ASSERT_FALSE(SC_ERROR(inlineList->GetCopyDataInto(inlineList, large, big,
+                                                     sizeof(big), &dataSize)));
+   EXPECT_EQ(sizeof(big), dataSize);
+   EXPECT_EQ('L', big[sizeof(big) - 1]);
+
+   CListDelete(inlineList);
+   CListDelete(list);
+}
+
+
+///////////////////////////////////////////////////////////
+//                     CLIST_DEFINE                      //
+///////////////////////////////////////////////////////////
+
+CLIST_DEFINE(U64List, uint64_t)
+CLIST_DEFINE(RecordList, Record)
+
+
+TEST(CListDefine, Operations)
+{
+   /*** Arrange ***/
+   CountingAllocator allocator;
+   U64List list;
+   U64ListInit(&list, &allocator.VTable);
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(U64ListPushBack(&list, 2)));
+   ASSERT_FALSE(SC_ERROR(U64ListPushFront(&list, 0)));
+   ASSERT_FALSE(SC_ERROR(U64ListInsertAfter(&list, U64ListFront(&list), 1)));
+   ASSERT_FALSE(SC_ERROR(U64ListInsertBefore(&list, U64ListFront(&list), 9)));
+   ASSERT_FALSE(SC_ERROR(U64ListPushBack(&list, 3)));
+   EXPECT_TRUE(SC_ERROR(U64ListInsertAfter(&list, NULL, 5)));
+
+   uint64_t value = 0;
+   ASSERT_FALSE(SC_ERROR(U64ListPopFront(&list, &value)));
+   EXPECT_EQ(9U, value);
+
+   /*** Assert ***/
+   ASSERT_EQ(4U, U64ListSize(&list));
+   uint64_t expected = 0;
+   for (U64List_NODE* node = U64ListFront(&list); node != NULL; node = U64ListNext(node))
+   {
+      EXPECT_EQ(expected++, *U64ListData(node));
+   }
+
+   expected = 3;
+   for (U64List_NODE* node = U64ListBack(&list); node != NULL; node = U64ListPrev(node))
+   {
+      EXPECT_EQ(expected--, *U64ListData(node));
+   }
+
+   ASSERT_FALSE(SC_ERROR(U64ListPopBack(&list, NULL)));
+   EXPECT_EQ(2U, *U64ListData(U64ListBack(&list)));
+
+   U64ListClear(&list);
+   EXPECT_EQ(0U, U64ListSize(&list));
+   EXPECT_TRUE(NULL == U64ListFront(&list));
+   EXPECT_TRUE(NULL == U64ListBack(&list));
+   EXPECT_TRUE(SC_ERROR(U64ListPopFront(&list, &value)));
+   EXPECT_EQ(0U, allocator.LiveBytes);
+}
+
+
+TEST(CListDefine, StructElementsAndNoMemory)
+{
+   /*** Arrange ***/
+   CountingAllocator allocator;
+   allocator.FailAfter = 2;
+   RecordList list;
+   RecordListInit(&list, &allocator.VTable);
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(RecordListPushBack(&list, Record{ 1, 10 })));
+   ASSERT_FALSE(SC_ERROR(RecordListPushBack(&list, Record{ 2, 20 })));
+   STATUS_CODE status = RecordListPushBack(&list, Record{ 3, 30 });
+
+   /*** Assert ***/
+   EXPECT_EQ(SC_NOT_ENOUGH_MEMORY, SC_CODE(status));
+   ASSERT_EQ(2U, RecordListSize(&list));
+   EXPECT_EQ(20U, RecordListData(RecordListBack(&list))->Tag);
+
+   Record record = {};
+   ASSERT_FALSE(SC_ERROR(RecordListPopBack(&list, &record)));
+   EXPECT_EQ(2U, record.Key);
+   RecordListClear(&list);
+   EXPECT_EQ(0U, allocator.LiveBytes);
+}
+
+
+///////////////////////////////////////////////////////////
+//                     Draft::List                       //
+///////////////////////////////////////////////////////////
+
+TEST(CListDelete, ReleasesNodes)
+{
+   /*** Arrange ***/
+   CountingAllocator allocator;
+   CLIST* list = CListCreateWithAllocator(&allocator.VTable);
+   ASSERT_FALSE(NULL == list);
+   int values[3] = { 1, 2, 3 };
+   ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, values, sizeof(int), sizeof(int), 3)));
+
+   /*** Act ***/
+   CListDelete(list);
+   CListDelete(NULL);
+
+   /*** Assert ***/
+   EXPECT_EQ(0U, allocator.LiveBytes);
+   EXPECT_EQ(allocator.Allocs, allocator.Frees);
+}
+
+
+TEST(DraftList, PushIterateErase)
+{
+   /*** Arrange ***/
+   Draft::List<int> list;
+   EXPECT_TRUE(list.empty());
+   EXPECT_TRUE(list.begin() == list.end());
+
+   /*** Act ***/
+   list.push_back(2);
+   list.push_front(1);
+   list.emplace_back(4);
+   auto three = list.insert(std::prev(list.end()), 3);
+   list.emplace(list.begin(), 0);
+
+   /*** Assert ***/
+   ASSERT_EQ(5U, list.size());
+   EXPECT_EQ(3, *three);
+   EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 4 }), std::vector<int>(list.begin(), list.end()));
+   EXPECT_EQ(std::vector<int>({ 4, 3, 2, 1, 0 }), std::vector<int>(list.rbegin(), list.rend()));
+   EXPECT_EQ(10, std::accumulate(list.cbegin(), list.cend(), 0));
+   EXPECT_TRUE(std::find(list.begin(), list.end(), 3) == three);
+
+   auto next = list.erase(three);
+   EXPECT_EQ(4, *next);
+   list.pop_front();
+   list.pop_back();
+   EXPECT_EQ(std::vector<int>({ 1, 2 }), std::vector<int>(list.begin(), list.end()));
+   EXPECT_EQ(1, list.front());
+   EXPECT_EQ(2, list.back());
+
+   std::reverse(list.begin(), list.end());
+   EXPECT_EQ(2, list.front());
+   list.clear();
+   EXPECT_TRUE(list.empty());
+}
+
+
+TEST(DraftList, MoveOnlyAndSelfReferencingElements)
+{
+   /*** Arrange ***/
+   Draft::List<std::unique_ptr<int>> pointers;
+   Draft::List<std::string> strings;
+
+   /*** Act ***/
+   pointers.push_back(std::make_unique<int>(7));
+   pointers.emplace_front(new int(6));
+   strings.emplace_back("short");
+   strings.emplace_back(100, 'x');
+   Draft::List<std::string> moved(std::move(strings));
+
+   /*** Assert ***/
+   EXPECT_EQ(6, *pointers.front());
+   EXPECT_EQ(7, *pointers.back());
+   EXPECT_TRUE(strings.empty());
+   EXPECT_TRUE(NULL == strings.native_handle());
+   ASSERT_EQ(2U, moved.size());
+   EXPECT_EQ("short", moved.front());
+   EXPECT_EQ(std::string(100, 'x'), moved.back());
+
+   strings = std::move(moved);
+   EXPECT_EQ(2U, strings.size());
+   strings.push_back("again");
+   EXPECT_EQ("again", strings.back());
+}
+
+
+/** Element whose constructor throws on demand. */
+struct Throwing
+{
+   int Value;
+
+   explicit Throwing(int NewValue) : Value(NewValue)
+   {
+      if (NewValue < 0) { throw std::runtime_error("negative"); }
+   }
+};
+
+
+TEST(DraftList, ThrowingConstructorLeavesListUnchanged)
+{
+   /*** Arrange ***/
+   Draft::List<Throwing> list;
+   list.emplace_back(1);
+   list.emplace_back(2);
+
+   /*** Act ***/
+   EXPECT_THROW(list.emplace_back(-1), std::runtime_error);
+   EXPECT_THROW(list.emplace_front(-1), std::runtime_error);
+   EXPECT_THROW(list.emplace(std::next(list.begin()), -1), std::runtime_error);
+
+   /*** Assert ***/
+   ASSERT_EQ(2U, list.size());
+   EXPECT_EQ(1, list.front().Value);
+   EXPECT_EQ(2, list.back().Value);
+   EXPECT_EQ(2, std::next(list.begin())->Value);
+}
+
+
+TEST(DraftList, SortIsStable)
+{
+   /*** Arrange ***/
+   Draft::List<Record> list;
+   for (size_t i = 0; i < 100; ++i) { list.push_back(Record{ (i * 7) % 10, i }); }
+   const Record* first = &list.front();
+
+   /*** Act ***/
+   list.sort([](const Record& Left, const Record& Right) { return Left.Key < Right.Key; });
+
+   /*** Assert ***/
+   EXPECT_TRUE(std::is_sorted(list.begin(), list.end(),
+                              [](const Record& Left, const Record& Right)
+                              {
+                                 return (Left.Key < Right.Key) ||
+                                        ((Left.Key == Right.Key) && (Left.Tag < Right.Tag));
+                              }));
+
+   // Elements are relinked, not moved
+   bool found = false;
+   for (const Record& record : list) { found = found || (&record == first); }
+   EXPECT_TRUE(found);
+}
+
+
+///////////////////////////////////////////////////////////
+//                        Stats                          //
+///////////////////////////////////////////////////////////
+
+#ifdef CLIST_ENABLE_STATS
+
+/** Search request for InFindStats. */
+struct StatsQuery
+{
+   CLIST*      List = NULL;
+   CLIST_STATS Stats = {};
+   size_t      Matches = 0;
+};
+
+
+static void InFindStats(CLIST* List, const CLIST_STATS* Stats, void* Context)
+{
+   StatsQuery* query = static_cast<StatsQuery*>(Context);
+   if (List != query->List) { return; }
+
+   query->Stats = *Stats;
+   ++query->Matches;
+}
+
+
+TEST_F(CListEmpty, StatsCountOperations)
+{
+   /*** Arrange ***/
+   int data[4] = { 1, 2, 3, 4 };
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &data[0], sizeof(int))));
+   ASSERT_FALSE(SC_ERROR(list->PushFront(list, &data[1], sizeof(int))));
+   ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, data, sizeof(int), sizeof(int), 4)));
+   ASSERT_FALSE(SC_ERROR(list->InsertAfter(list, list->Front(list), &data[2], sizeof(int))));
+   ASSERT_FALSE(SC_ERROR(list->InsertBefore(list, list->Back(list), &data[3], sizeof(int))));
+   list->Next(list, list->Front(list));
+   list->Prev(list, list->Back(list));
+   list->PopFront(list);
+
+   /*** Assert ***/
+   CLIST_STATS stats = {};
+   ASSERT_FALSE(SC_ERROR(list->GetStats(list, &stats)));
+   EXPECT_EQ(6U, stats.Pushes);
+   EXPECT_EQ(1U, stats.Pops);
+   EXPECT_EQ(2U, stats.Inserts);
+   EXPECT_EQ(2U, stats.TraversalSteps);
+   EXPECT_EQ(8U, stats.NodeAllocations);
+   EXPECT_EQ(0U, stats.PayloadAllocations); // Small data is stored in the nodes
+   EXPECT_TRUE(stats.LiveBytes > 0);
+   EXPECT_TRUE(stats.PeakBytes > stats.LiveBytes);
+}
+
+
+TEST_F(CListEmpty, StatsCountNodesTakenFromSlabs)
+{
+   /*** Arrange ***/
+   int data[4] = { 1, 2, 3, 4 };
+
+   /*** Act ***/
+   for (size_t i = 0; i < 10; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBackBatch(list, data, sizeof(int), sizeof(int), 4)));
+      ASSERT_FALSE(SC_ERROR(list->Remove(list, list->Front(list))));
+      list->PopBack(list);
+      ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+   }
+
+   /*** Assert ***/
+   CLIST_STATS stats = {};
+   ASSERT_FALSE(SC_ERROR(list->GetStats(list, &stats)));
+   // Removed nodes go back to the shared slabs, every push takes one again
+   EXPECT_EQ(40U, stats.Pushes);
+   EXPECT_EQ(40U, stats.NodeAllocations);
+   EXPECT_EQ(0U, stats.LiveBytes);
+}
+
+
+TEST(CListStats, TakeAndMoveBytes)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreate();
+   CLIST* other = CListCreate();
+   ASSERT_FALSE((NULL == list) || (NULL == other));
+   int data[3] = { 1, 2, 3 };
+   ASSERT_FALSE(SC_ERROR(other->PushBackBatch(other, data, sizeof(int), sizeof(int), 3)));
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(list->Append(list, other)));
+   void* taken = NULL;
+   size_t takenSize = 0;
+   ASSERT_FALSE(SC_ERROR(list->PopBackTake(list, &taken, &takenSize)));
+   free(taken);
+
+   /*** Assert ***/
+   // Appended nodes are relinked, not allocated again
+   CLIST_STATS stats = {};
+   ASSERT_FALSE(SC_ERROR(list->GetStats(list, &stats)));
+   EXPECT_EQ(0U, stats.Pushes);
+   EXPECT_EQ(1U, stats.Pops);
+   EXPECT_EQ(0U, stats.NodeAllocations);
+   EXPECT_TRUE(stats.LiveBytes > 0);
+
+   ASSERT_FALSE(SC_ERROR(other->GetStats(other, &stats)));
+   EXPECT_EQ(3U, stats.NodeAllocations);
+   EXPECT_EQ(0U, stats.LiveBytes);
+
+   // The taken buffer is no longer counted, the popped node neither
+   for (size_t i = 0; i < 2; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PopBackTake(list, &taken, &takenSize)));
+      free(taken);
+   }
+   ASSERT_FALSE(SC_ERROR(list->GetStats(list, &stats)));
+   EXPECT_EQ(0U, stats.LiveBytes);
+
+   CListDelete(other);
+   CListDelete(list);
+}
+
+
+TEST(CListStats, Registry)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreate();
+   CLIST* other = CListCreate();
+   ASSERT_FALSE((NULL == list) || (NULL == other));
+   int data = 5;
+   ASSERT_FALSE(SC_ERROR(list->PushBack(list, &data, sizeof(data))));
+
+   /*** Act ***/
+   StatsQuery query;
+   query.List = list;
+   STATUS_CODE status = CListStatsForEach(InFindStats, &query);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_EQ(1U, query.Matches);
+   EXPECT_EQ(1U, query.Stats.Pushes);
+
+   StatsQuery empty;
+   empty.List = other;
+   ASSERT_FALSE(SC_ERROR(CListStatsForEach(InFindStats, &empty)));
+   EXPECT_EQ(1U, empty.Matches);
+   EXPECT_EQ(0U, empty.Stats.LiveBytes);
+
+   EXPECT_TRUE(SC_ERROR(CListStatsForEach(NULL, NULL)));
+   EXPECT_TRUE(SC_ERROR(CListStatsDump(NULL)));
+   FILE* stream = tmpfile();
+   ASSERT_FALSE(NULL == stream);
+   EXPECT_FALSE(SC_ERROR(CListStatsDump(stream)));
+   EXPECT_TRUE(ftell(stream) > 0);
+   fclose(stream);
+
+   CListDelete(other);
+   CListDelete(list);
+}
+
+#else
+
+TEST_F(CListEmpty, StatsDisabled)
+{
+   /*** Arrange ***/
+   CLIST_STATS stats = {};
+
+   /*** Act ***/
+   STATUS_CODE status = list->GetStats(list, &stats);
+
+   /*** Assert ***/
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(status));
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(CListStatsDump(stdout)));
+   EXPECT_TRUE(SC_ERROR(list->GetStats(list, NULL)));
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////
+//                       Compact                         //
+///////////////////////////////////////////////////////////
+
+/** Handles reported by CLIST_COMPACT, in list order. */
+using Relocations = std::vector<std::pair<CLIST_NODE*, CLIST_NODE*>>;
+
+
+static void InRecordRelocation(CLIST_NODE* OldPosition, CLIST_NODE* NewPosition, void* Context)
+{
+   static_cast<Relocations*>(Context)->emplace_back(OldPosition, NewPosition);
+}
+
+
+TEST_F(CListEmpty, CompactRestoresListOrder)
+{
+   /*** Arrange ***/
+   std::mt19937 random(25);
+   std::vector<CLIST_NODE*> nodes;
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      CLIST_NODE* position = InGetNodeAt(list, (i > 0) ? random() % i : 0);
+      STATUS_CODE status = (NULL == position) ?
+                           list->PushBack(list, &i, sizeof(size_t)) :
+                           list->InsertAfter(list, position, &i, sizeof(size_t));
+      ASSERT_FALSE(SC_ERROR(status));
+   }
+   std::vector<size_t> values = InToVector(list);
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      nodes.push_back(position);
+   }
+   Relocations relocations;
+
+   /*** Act ***/
+   STATUS_CODE status = list->Compact(list, 0, InRecordRelocation, &relocations);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(values == InToVector(list));
+   ASSERT_TRUE(nodes.size() == relocations.size());
+
+   // Nodes follow each other in memory with the same stride
+   CLIST_NODE* position = list->Front(list);
+   ptrdiff_t stride = (char*)InGetNodeAt(list, 1) - (char*)position;
+   EXPECT_TRUE(stride > 0);
+   for (size_t i = 0; i < nodes.size(); ++i)
+   {
+      EXPECT_TRUE(nodes[i] == relocations[i].first);
+      EXPECT_TRUE(position == relocations[i].second);
+      if (i > 0)
+      {
+         EXPECT_TRUE(stride == (char*)position - (char*)relocations[i - 1].second);
+      }
+      position = list->Next(list, position);
+   }
+
+   // The list keeps working on top of its pool
+   size_t value = 1000;
+   ASSERT_FALSE(SC_ERROR(list->PushFront(list, &value, sizeof(size_t))));
+   list->PopFront(list);
+   ASSERT_FALSE(SC_ERROR(list->Compact(list, 0, NULL, NULL)));
+   EXPECT_TRUE(values == InToVector(list));
+   EXPECT_TRUE(SC_ERROR(list->Compact(list, 2, NULL, NULL)));
+}
+
+
+TEST(CListCompact, Payloads)
+{
+   /*** Arrange ***/
+   CountingAllocator allocator;
+   CLIST* list = CListCreateWithAllocator(&allocator.VTable);
+   ASSERT_FALSE(NULL == list);
+
+   // Records are too big to be stored in the nodes
+   char record[64] = {};
+   for (char i = 0; i < 10; ++i)
+   {
+      record[0] = i;
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, record, sizeof(record))));
+   }
+
+   auto firstData = [list]() -> void*
+   {
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      EXPECT_FALSE(SC_ERROR(list->GetRefToData(list, list->Front(list), &data, &dataSize)));
+      return *data;
+   };
+   void* data = firstData();
+
+   /*** Act && Assert ***/
+   // Out of memory leaves the list as it was
+   size_t liveBytes = allocator.LiveBytes;
+   allocator.FailAfter = allocator.Allocs + 4;
+   EXPECT_EQ(SC_NOT_ENOUGH_MEMORY,
+             SC_CODE(list->Compact(list, CLIST_COMPACT_PAYLOADS, NULL, NULL)));
+   EXPECT_TRUE(liveBytes == allocator.LiveBytes);
+   EXPECT_TRUE(data == firstData());
+   allocator.FailAfter = SIZE_MAX;
+
+   ASSERT_FALSE(SC_ERROR(list->Compact(list, 0, NULL, NULL)));
+   EXPECT_TRUE(data == firstData());
+
+   ASSERT_FALSE(SC_ERROR(list->Compact(list, CLIST_COMPACT_PAYLOADS, NULL, NULL)));
+   EXPECT_FALSE(data == firstData());
+
+   char expected = 0;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position), ++expected)
+   {
+      size_t dataSize = 0;
+      ASSERT_FALSE(SC_ERROR(list->GetCopyDataInto(list, position, record,
+                                                  sizeof(record), &dataSize)));
+      EXPECT_TRUE(expected == record[0]);
+   }
+   EXPECT_TRUE(10 == expected);
+
+   // Nodes of the pool are released with it
+   CListDelete(list);
+   EXPECT_TRUE(0 == allocator.LiveBytes);
+}
+
+
+TEST(CListCompact, FixedAndInlineLists)
+{
+   /*** Arrange ***/
+   CLIST* list = CListCreateFixed(sizeof(size_t));
+   CLIST* other = CListCreateFixed(sizeof(size_t));
+   CLIST* inlineList = CListCreateEx(CLIST_FLAG_INLINE_DATA, NULL);
+   ASSERT_FALSE((NULL == list) || (NULL == other) || (NULL == inlineList));
+   size_t records[6] = { 0, 1, 2, 3, 4, 5 };
+   ASSERT_FALSE(SC_ERROR(list->PushFrontBatch(list, records, sizeof(size_t),
+                                              sizeof(size_t), 3)));
+   ASSERT_FALSE(SC_ERROR(other->PushBackBatch(other, &records[3], sizeof(size_t),
+                                              sizeof(size_t), 3)));
+   ASSERT_FALSE(SC_ERROR(inlineList->PushBack(inlineList, records, sizeof(size_t))));
+
+   /*** Act ***/
+   STATUS_CODE status = list->Compact(list, 0, NULL, NULL);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE((std::vector<size_t>{ 0, 1, 2 }) == InToVector(list));
+
+   // Nodes moved between pools are copied
+   ASSERT_FALSE(SC_ERROR(list->Append(list, other)));
+   EXPECT_TRUE((std::vector<size_t>{ 0, 1, 2, 3, 4, 5 }) == InToVector(list));
+
+   // Nodes of an inline list differ in size
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(inlineList->Compact(inlineList, 0, NULL, NULL)));
+
+   CListDelete(list);
+   CListDelete(other);
+   CListDelete(inlineList);
+}
+
+
+///////////////////////////////////////////////////////////
+//                 Epoch reclamation                     //
+///////////////////////////////////////////////////////////
+
+TEST(CListEpoch, ReadersWalkWhileWriterPops)
+{
+   /*** Arrange ***/
+   // Records are larger than CLIST_SMALL_DATA_SIZE, so data is freed apart
+   struct Record
+   {
+      size_t Value;
+      char   Filler[32];
+   };
+
+   ALLOCATOR* epoch = EpochAllocatorCreate(NULL);
+   ASSERT_FALSE(NULL == epoch);
+   CLIST* list = CListCreateWithAllocator(epoch);
+   ASSERT_FALSE(NULL == list);
+
+   Record record = {};
+   for (record.Value = 0; record.Value < 64; ++record.Value)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &record, sizeof(Record))));
+   }
+
+   std::atomic<bool> isDone(false);
+   std::vector<std::thread> readers;
+   for (size_t r = 0; r < 3; ++r)
+   {
+      readers.emplace_back([epoch, list, &isDone]()
+      {
+         // Values are pushed in order, so every walk sees them increasing
+         while (!isDone.load())
+         {
+            ASSERT_FALSE(SC_ERROR(EpochAllocatorEnter(epoch)));
+            size_t previous = 0;
+            for (CLIST_NODE* position = list->Front(list);
+                 position != NULL;
+                 position = list->Next(list, position))
+            {
+               Record data = {};
+               size_t dataSize = 0;
+               EXPECT_FALSE(SC_ERROR(list->GetCopyDataInto(list, position, &data,
+                                                           sizeof(Record), &dataSize)));
+               EXPECT_TRUE((0 == previous) || (previous < data.Value));
+               previous = data.Value;
+            }
+            ASSERT_FALSE(SC_ERROR(EpochAllocatorLeave(epoch)));
+         }
+      });
+   }
+
+   /*** Act ***/
+   // Popped nodes stay readable until the readers that saw them leave
+   for (; record.Value < 20000; ++record.Value)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &record, sizeof(Record))));
+      list->PopFront(list);
+   }
+
+   isDone.store(true);
+   for (std::thread& reader : readers) { reader.join(); }
+
+   /*** Assert ***/
+   EXPECT_TRUE(64 == list->Size(list));
+
+   CListDelete(list);
+   EXPECT_FALSE(SC_ERROR(EpochAllocatorSynchronize(epoch)));
+   EXPECT_FALSE(SC_ERROR(EpochAllocatorDelete(epoch)));
+}
+
+
 int main(int argc, char** argv)
 {
    ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,173 @@
+/**
+ * @file  CLockFreeQueueBench.cpp
+ * @brief Scaling benchmark for the lock-free queue against the locking CLIST queues
+ *
+ * Usage: CLockFreeQueueBench [MaxThreads [Operations]]
+ *    MaxThreads - the largest number of threads, the number of hardware
+ *                 threads by default;
+ *    Operations - push and pop pairs done by every thread, 10^5 by default.
+ *
+ * Every thread pushes a value to the end of the shared queue and pops one
+ * from the beginning, the queue starts with one value per thread so pops
+ * rarely find it empty. The number of threads doubles from 1 to MaxThreads.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CConcurrentList.h"
+   #include "Include/CLockFreeQueue.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                      Containers                       //
+///////////////////////////////////////////////////////////
+
+/** CLIST queue guarded by one mutex, the setup the concurrent queues replace. */
+struct LockedList
+{
+   CLIST      VTable;
+   CLIST*     List;
+   std::mutex Lock;
+};
+
+
+/** Creates the LockedList around a new CList. */
+static LockedList* InCreateLockedList()
+{
+   LockedList* locked = new LockedList();
+   locked->List = CListCreate();
+   locked->VTable.PushBack = [](CLIST* This, void* Data, size_t DataSize) -> STATUS_CODE
+   {
+      LockedList* self = reinterpret_cast<LockedList*>(This);
+      std::lock_guard<std::mutex> guard(self->Lock);
+      return self->List->PushBack(self->List, Data, DataSize);
+   };
+   locked->VTable.PopFrontTake = [](CLIST* This, void** Data, size_t* DataSize) -> STATUS_CODE
+   {
+      LockedList* self = reinterpret_cast<LockedList*>(This);
+      std::lock_guard<std::mutex> guard(self->Lock);
+      return self->List->PopFrontTake(self->List, Data, DataSize);
+   };
+
+   return locked;
+}
+
+
+/** Queue under test with the function that releases it. */
+struct BenchQueue
+{
+   const char*                Name;
+   std::function<CLIST*()>    Create;
+   std::function<void(CLIST*)> Delete;
+};
+
+
+///////////////////////////////////////////////////////////
+//                         Cases                         //
+///////////////////////////////////////////////////////////
+
+/**
+ * Runs Threads threads that do Operations push and pop pairs each on the Queue.
+ *
+ * @return  Millions of operations, pushes and pops, per second
+ */
+static double InRunCase(CLIST* Queue, size_t Threads, size_t Operations)
+{
+   for (size_t i = 0; i < Threads; ++i)
+   {
+      if (SC_ERROR(Queue->PushBack(Queue, &i, sizeof(size_t))))
+      {
+         fprintf(stderr, "PushBack failed\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   std::vector<std::thread> threads;
+   auto start = std::chrono::steady_clock::now();
+
+   for (size_t t = 0; t < Threads; ++t)
+   {
+      threads.emplace_back([Queue, Operations]()
+      {
+         for (size_t i = 0; i < Operations; ++i)
+         {
+            while (SC_ERROR(Queue->PushBack(Queue, &i, sizeof(size_t)))) {}
+
+            void* data = NULL;
+            size_t dataSize = 0;
+            while (SC_ERROR(Queue->PopFrontTake(Queue, &data, &dataSize))) {}
+            free(data);
+         }
+      });
+   }
+
+   for (std::thread& thread : threads) { thread.join(); }
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+   return 2.0 * Threads * Operations / seconds / 1e6;
+}
+
+
+int main(int argc, char** argv)
+{
+   size_t maxThreads = (argc > 1) ? strtoull(argv[1], NULL, 10) :
+                                    std::max(1U, std::thread::hardware_concurrency());
+   size_t operations = (argc > 2) ? strtoull(argv[2], NULL, 10) : 100000U;
+
+   if ((0 == maxThreads) || (maxThreads > 1024) || (0 == operations))
+   {
+      fprintf(stderr, "MaxThreads must be in [1, 1024], Operations must be positive\n");
+      return EXIT_FAILURE;
+   }
+
+   std::vector<BenchQueue> queues =
+   {
+      { "mutex CList",
+        [] { return &InCreateLockedList()->VTable; },
+        [](CLIST* Queue)
+        {
+           LockedList* locked = reinterpret_cast<LockedList*>(Queue);
+           CListDelete(locked->List);
+           delete locked;
+        } },
+      { "CConcurrentList", [] { return CConcurrentListCreate(); }, CConcurrentListDelete },
+      { "CLockFreeQueue", [] { return CLockFreeQueueCreate(); }, CLockFreeQueueDelete },
+   };
+
+   printf("%-8s %-16s %10s\n", "Threads", "Queue", "Mops/s");
+
+   std::vector<size_t> threadCounts;
+   for (size_t threads = 1; threads < maxThreads; threads *= 2) { threadCounts.push_back(threads); }
+   threadCounts.push_back(maxThreads);
+
+   for (size_t threads : threadCounts)
+   {
+      for (const BenchQueue& queue : queues)
+      {
+         CLIST* instance = queue.Create();
+         if (NULL == instance)
+         {
+            fprintf(stderr, "%s can't be created\n", queue.Name);
+            return EXIT_FAILURE;
+         }
+
+         double mops = InRunCase(instance, threads, operations);
+         printf("%-8zu %-16s %10.2f\n", threads, queue.Name, mops);
+
+         queue.Delete(instance);
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,941 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     CLockFreeQueue.c
+ * @brief    Lock-free multi-producer multi-consumer queue implementation.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#include "Include/CLockFreeQueue.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Node of a lock-free queue. */
+typedef struct CLOCKFREE_NODE
+{
+   _Atomic(struct CLOCKFREE_NODE*) Next;     /** Pointer to next node                */
+   struct CLOCKFREE_NODE*          Retired;  /** Next node in the retired list       */
+   void*                           Data;     /** Data stored in the node             */
+   size_t                          DataSize; /** Size of data stored in the node     */
+   char                            Payload[CLIST_SMALL_DATA_SIZE]; /** Small data    */
+} CLOCKFREE_NODE;
+
+
+/** Size of the padding that keeps the head and tail fields apart. */
+#define CLOCKFREE_CACHE_LINE 64U
+
+
+/** Number of hazard pointers one operation needs. */
+#define CLOCKFREE_HAZARDS 2U
+
+
+/** Retired nodes a thread keeps on top of twice the number of hazard pointers. */
+#define CLOCKFREE_RETIRED_MIN 64U
+
+
+/** Hazard pointers the scan snapshots without allocating memory. */
+#define CLOCKFREE_SCAN_BUFFER 256U
+
+
+/**
+ * Hazard record of a thread.
+ *
+ * A thread publishes in Hazards the nodes it reads, removed nodes wait in
+ * the Retired list until no record points to them. Records are never
+ * released: a record of a finished thread is reused by a new one together
+ * with its retired nodes.
+ */
+typedef struct CLOCKFREE_RECORD
+{
+   _Atomic(CLOCKFREE_NODE*) Hazards[CLOCKFREE_HAZARDS]; /** Nodes the thread reads     */
+   atomic_bool              Active;                     /** The record has an owner     */
+   struct CLOCKFREE_RECORD* Next;                       /** Next record, never changes  */
+   CLOCKFREE_NODE*          Retired;                    /** Nodes waiting to be freed   */
+   size_t                   RetiredCount;               /** Number of retired nodes     */
+   char                     Padding[CLOCKFREE_CACHE_LINE];
+} CLOCKFREE_RECORD;
+
+
+/**
+ * Lock-free queue implementation of the CList protocol.
+ *
+ * Head is a dummy node that precedes the first node. Pushing links nodes
+ * after the last node with a CAS and then swings Tail, popping swings Head
+ * to the first node, which becomes the new dummy node. Threads that find
+ * Tail behind the last node move it forward. Fields of the head and the
+ * tail end are kept in separate cache lines.
+ */
+typedef struct CLOCKFREE_QUEUE_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   CLIST     VTable;      /** API                 */
+
+   char                     HeadPadding[CLOCKFREE_CACHE_LINE];
+   _Atomic(CLOCKFREE_NODE*) Head;   /** Dummy node before the first node */
+   atomic_size_t            Popped; /** Number of nodes ever removed     */
+
+   char                     TailPadding[CLOCKFREE_CACHE_LINE];
+   _Atomic(CLOCKFREE_NODE*) Tail;   /** Last node or a node before it    */
+   atomic_size_t            Pushed; /** Number of nodes ever added       */
+   char                     EndPadding[CLOCKFREE_CACHE_LINE];
+} CLOCKFREE_QUEUE_IMPL;
+
+
+/** Unique identificator for CLOCKFREE_QUEUE_IMPL */
+#define CLOCKFREE_QUEUE_IMPL_STRUCT_ID \
+   STRUCT_ID_64('C', 'L', 'F', 'Q', 'U', 'E', 'U', 'E')
+
+
+/** Hazard records of all threads. */
+static _Atomic(CLOCKFREE_RECORD*) g_Records = NULL;
+
+/** Number of hazard records, sets how many nodes a thread retires before a scan. */
+static atomic_size_t g_RecordCount = 0;
+
+/** Hazard record of the current thread. */
+static _Thread_local CLOCKFREE_RECORD* g_Record = NULL;
+
+/** Key that releases the hazard record when its thread exits. */
+static tss_t g_RecordKey;
+
+/** The key is created. */
+static bool g_IsRecordKeyCreated = false;
+
+/** Creates the key once. */
+static once_flag g_RecordKeyOnce = ONCE_FLAG_INIT;
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Creates an unlinked node, copies the data the same way CListCreate lists do.
+ *
+ * @param[in]  Data      Data that will be stored in the node
+ * @param[in]  DataSize  Data size
+ * @param[in]  TakeData  Adopt the malloc Data buffer instead of copying it
+ *
+ * @retval  CLOCKFREE_NODE*  If the node is successfully created
+ * @retval  NULL             On failure, the Data buffer stays with the caller
+ */
+static
+CLOCKFREE_NODE*
+InCreateNode(
+   IN void*  Data,
+   IN size_t DataSize,
+   IN bool   TakeData)
+{
+   CLOCKFREE_NODE* node = malloc(sizeof(CLOCKFREE_NODE));
+   if (NULL == node) { return NULL; }
+
+   if (TakeData)
+   {
+      node->Data = Data;
+   }
+   else if (DataSize <= CLIST_SMALL_DATA_SIZE)
+   {
+      node->Data = node->Payload;
+   }
+   else
+   {
+      node->Data = malloc(DataSize);
+      if (NULL == node->Data)
+      {
+         free(node);
+         return NULL;
+      }
+   }
+
+   if (node->Data != Data) { memcpy(node->Data, Data, DataSize); }
+
+   atomic_init(&node->Next, NULL);
+   node->Retired = NULL;
+   node->DataSize = DataSize;
+
+   return node;
+}
+
+
+/**
+ * Releases the Node and its data.
+ *
+ * @param[in]  Node  Unlinked node
+ */
+static
+void
+InDeleteNode(
+   IN CLOCKFREE_NODE* Node)
+{
+   if (Node->Data != Node->Payload) { free(Node->Data); }
+   free(Node);
+}
+
+
+/**
+ * Compares two node addresses for qsort and bsearch.
+ *
+ * @param[in]  Left   Pointer to the first address
+ * @param[in]  Right  Pointer to the second address
+ *
+ * @return  Negative, zero or positive as for qsort
+ */
+static
+int
+InCompareNodes(
+   IN const void* Left,
+   IN const void* Right)
+{
+   uintptr_t left = (uintptr_t)*(CLOCKFREE_NODE* const*)Left;
+   uintptr_t right = (uintptr_t)*(CLOCKFREE_NODE* const*)Right;
+
+   return (left > right) - (left < right);
+}
+
+
+/**
+ * Frees the retired nodes of the Record that no hazard pointer points to.
+ *
+ * The hazard pointers are copied and sorted first, so every retired node
+ * is checked with a binary search. If the copy can't be allocated, the
+ * nodes wait for the next scan.
+ *
+ * @param[in]  Record  Hazard record of the current thread
+ */
+static
+void
+InScan(
+   IN CLOCKFREE_RECORD* Record)
+{
+   CLOCKFREE_NODE* buffer[CLOCKFREE_SCAN_BUFFER];
+   CLOCKFREE_NODE** hazards = buffer;
+
+   // Records are added at the beginning, records added after the snapshot
+   // can't hold hazards to nodes that were retired before it
+   CLOCKFREE_RECORD* records = atomic_load(&g_Records);
+
+   size_t capacity = 0;
+   for (CLOCKFREE_RECORD* record = records; record != NULL; record = record->Next)
+   {
+      capacity += CLOCKFREE_HAZARDS;
+   }
+
+   if (capacity > CLOCKFREE_SCAN_BUFFER)
+   {
+      hazards = malloc(capacity * sizeof(CLOCKFREE_NODE*));
+      if (NULL == hazards) { return; }
+   }
+
+   size_t count = 0;
+   for (CLOCKFREE_RECORD* record = records; record != NULL; record = record->Next)
+   {
+      for (size_t i = 0; i < CLOCKFREE_HAZARDS; ++i)
+      {
+         CLOCKFREE_NODE* hazard = atomic_load(&record->Hazards[i]);
+         if (hazard != NULL) { hazards[count++] = hazard; }
+      }
+   }
+
+   qsort(hazards, count, sizeof(CLOCKFREE_NODE*), InCompareNodes);
+
+   CLOCKFREE_NODE* node = Record->Retired;
+   Record->Retired = NULL;
+   Record->RetiredCount = 0;
+
+   while (node != NULL)
+   {
+      CLOCKFREE_NODE* next = node->Retired;
+      if (NULL == bsearch(&node, hazards, count, sizeof(CLOCKFREE_NODE*), InCompareNodes))
+      {
+         // Data of a retired node was taken by the thread that removed it
+         free(node);
+      }
+      else
+      {
+         node->Retired = Record->Retired;
+         Record->Retired = node;
+         ++Record->RetiredCount;
+      }
+
+      node = next;
+   }
+
+   if (hazards != buffer) { free(hazards); }
+}
+
+
+/**
+ * Adds the removed Node to the retired list of the Record. Scans the list
+ * when it is long enough for the scan to free most of it.
+ *
+ * @param[in]  Record  Hazard record of the current thread
+ * @param[in]  Node    Node removed from a queue
+ */
+static
+void
+InRetire(
+   IN CLOCKFREE_RECORD* Record,
+   IN CLOCKFREE_NODE*   Node)
+{
+   Node->Retired = Record->Retired;
+   Record->Retired = Node;
+   ++Record->RetiredCount;
+
+   size_t threshold = 2 * CLOCKFREE_HAZARDS * atomic_load(&g_RecordCount) + CLOCKFREE_RETIRED_MIN;
+   if (Record->RetiredCount >= threshold) { InScan(Record); }
+}
+
+
+/**
+ * Releases the hazard record of a finishing thread, called through g_RecordKey.
+ *
+ * @param[in]  Record  Hazard record
+ */
+static
+void
+InReleaseRecord(
+   IN void* Record)
+{
+   CLOCKFREE_RECORD* record = Record;
+
+   for (size_t i = 0; i < CLOCKFREE_HAZARDS; ++i) { atomic_store(&record->Hazards[i], NULL); }
+   InScan(record);
+
+   g_Record = NULL;
+   atomic_store(&record->Active, false);
+}
+
+
+/**
+ * Creates g_RecordKey, called once.
+ */
+static
+void
+InCreateRecordKey()
+{
+   g_IsRecordKeyCreated = (thrd_success == tss_create(&g_RecordKey, InReleaseRecord));
+}
+
+
+/**
+ * Returns the hazard record of the current thread. The first call of the
+ * thread takes a free record or adds a new one.
+ *
+ * @return  Hazard record or NULL if memory allocation failed
+ */
+static
+CLOCKFREE_RECORD*
+InGetRecord()
+{
+   if (g_Record != NULL) { return g_Record; }
+
+   call_once(&g_RecordKeyOnce, InCreateRecordKey);
+
+   CLOCKFREE_RECORD* record = atomic_load(&g_Records);
+   for (; record != NULL; record = record->Next)
+   {
+      bool isActive = false;
+      if (!atomic_load(&record->Active) &&
+          atomic_compare_exchange_strong(&record->Active, &isActive, true))
+      {
+         break;
+      }
+   }
+
+   if (NULL == record)
+   {
+      record = malloc(sizeof(CLOCKFREE_RECORD));
+      if (NULL == record) { return NULL; }
+
+      for (size_t i = 0; i < CLOCKFREE_HAZARDS; ++i) { atomic_init(&record->Hazards[i], NULL); }
+      atomic_init(&record->Active, true);
+      record->Retired = NULL;
+      record->RetiredCount = 0;
+
+      atomic_fetch_add(&g_RecordCount, 1);
+
+      CLOCKFREE_RECORD* first = atomic_load(&g_Records);
+      do
+      {
+         record->Next = first;
+      } while (!atomic_compare_exchange_weak(&g_Records, &first, record));
+   }
+
+   // Without the key the record stays with the finished thread
+   if (g_IsRecordKeyCreated) { tss_set(g_RecordKey, record); }
+
+   g_Record = record;
+   return record;
+}
+
+
+/**
+ * Reads the node pointer from the Source and protects the node with a
+ * hazard pointer, so it isn't freed while the thread reads it.
+ *
+ * @param[in]  Record  Hazard record of the current thread
+ * @param[in]  Index   Index of the hazard pointer
+ * @param[in]  Source  Pointer to the node pointer
+ *
+ * @return  Node that stays valid until the hazard pointer changes
+ */
+static
+CLOCKFREE_NODE*
+InProtect(
+   IN CLOCKFREE_RECORD*         Record,
+   IN size_t                    Index,
+   IN _Atomic(CLOCKFREE_NODE*)* Source)
+{
+   CLOCKFREE_NODE* node = atomic_load(Source);
+   for (;;)
+   {
+      // The node stays valid if it is still there after the hazard is seen
+      atomic_store(&Record->Hazards[Index], node);
+
+      CLOCKFREE_NODE* check = atomic_load(Source);
+      if (check == node) { return node; }
+      node = check;
+   }
+}
+
+
+/**
+ * Clears the hazard pointers of the Record.
+ *
+ * @param[in]  Record  Hazard record of the current thread
+ */
+static
+void
+InClearHazards(
+   IN CLOCKFREE_RECORD* Record)
+{
+   for (size_t i = 0; i < CLOCKFREE_HAZARDS; ++i)
+   {
+      atomic_store_explicit(&Record->Hazards[i], NULL, memory_order_release);
+   }
+}
+
+
+/**
+ * Links the chain [First, Last] of Count nodes after the last node of
+ * the Queue.
+ *
+ * @param[in]  Queue  Queue
+ * @param[in]  First  First node of the chain
+ * @param[in]  Last   Last node of the chain
+ * @param[in]  Count  Number of nodes in the chain
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the chain isn't linked
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InPushChain(
+   IN CLOCKFREE_QUEUE_IMPL* Queue,
+   IN CLOCKFREE_NODE*       First,
+   IN CLOCKFREE_NODE*       Last,
+   IN size_t                Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      CLOCKFREE_RECORD* record = InGetRecord();
+      if (NULL == record) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      for (;;)
+      {
+         CLOCKFREE_NODE* tail = InProtect(record, 0, &Queue->Tail);
+         CLOCKFREE_NODE* next = atomic_load(&tail->Next);
+         if (tail != atomic_load(&Queue->Tail)) { continue; }
+
+         // Help the thread that linked the next node
+         if (next != NULL)
+         {
+            atomic_compare_exchange_strong(&Queue->Tail, &tail, next);
+            continue;
+         }
+
+         if (atomic_compare_exchange_weak(&tail->Next, &next, First))
+         {
+            atomic_compare_exchange_strong(&Queue->Tail, &tail, Last);
+            break;
+         }
+      }
+
+      InClearHazards(record);
+      atomic_fetch_add_explicit(&Queue->Pushed, Count, memory_order_relaxed);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the first node of the Queue and returns its data.
+ *
+ * The data of the first node moves to the caller and the node becomes the
+ * new dummy node, whose data is never read again. The old dummy node is
+ * retired. Data stored in the node
+ * is copied to a malloc buffer when TakeData is true; the buffer is
+ * allocated before the node is removed, so the queue is unchanged if the
+ * allocation fails.
+ *
+ * @param[in]   Queue     Queue
+ * @param[in]   TakeData  Return a malloc buffer, otherwise release the data
+ * @param[out]  Data      Data buffer if TakeData is true
+ * @param[out]  DataSize  Data size if TakeData is true
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the queue is unchanged
+ * @retval  SC_UNSUCCESSFUL       The queue is empty
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InPopFront(
+   IN  CLOCKFREE_QUEUE_IMPL* Queue,
+   IN  bool                  TakeData,
+   OUT void**                Data,
+   OUT size_t*               DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   void* buffer = NULL;
+
+   do
+   {
+      CLOCKFREE_RECORD* record = InGetRecord();
+      if (NULL == record) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CLOCKFREE_NODE* head = NULL;
+      CLOCKFREE_NODE* next = NULL;
+      bool isRemoved = false;
+      for (;;)
+      {
+         head = InProtect(record, 0, &Queue->Head);
+         CLOCKFREE_NODE* tail = atomic_load(&Queue->Tail);
+         next = atomic_load(&head->Next);
+         atomic_store(&record->Hazards[1], next);
+
+         // While the head is in place its next node can't be retired
+         if (head != atomic_load(&Queue->Head)) { continue; }
+         if (NULL == next) { break; }
+
+         if (head == tail)
+         {
+            atomic_compare_exchange_strong(&Queue->Tail, &tail, next);
+            continue;
+         }
+
+         if (TakeData && (NULL == buffer) && (next->Data == next->Payload))
+         {
+            InClearHazards(record);
+            buffer = malloc(CLIST_SMALL_DATA_SIZE);
+            if (NULL == buffer) { break; }
+            continue;
+         }
+
+         if (atomic_compare_exchange_weak(&Queue->Head, &head, next))
+         {
+            isRemoved = true;
+            break;
+         }
+      }
+
+      if (!isRemoved)
+      {
+         InClearHazards(record);
+         if (NULL == next) { SET_SC(SC_UNSUCCESSFUL); }
+         else              { SET_SC(SC_NOT_ENOUGH_MEMORY); }
+         break;
+      }
+
+      // The data moves to the caller, the node stays as the dummy node
+      if (next->Data != next->Payload)
+      {
+         if (TakeData) { *Data = next->Data; }
+         else          { free(next->Data); }
+      }
+      else if (TakeData)
+      {
+         memcpy(buffer, next->Data, next->DataSize);
+         *Data = buffer;
+         buffer = NULL;
+      }
+
+      if (TakeData) { *DataSize = next->DataSize; }
+
+      InClearHazards(record);
+      atomic_fetch_add_explicit(&Queue->Popped, 1, memory_order_relaxed);
+      InRetire(record, head);
+
+   } while (false);
+
+   free(buffer);
+
+   return status;
+}
+
+
+/**
+ * Creates the queue implementation with the dummy node and sets its methods.
+ *
+ * @return  Queue or NULL on failure
+ */
+static
+CLOCKFREE_QUEUE_IMPL*
+InCreateQueue();
+
+
+///////////////////////////////////////////////////////////
+///           CLockFreeQueue API implementation         ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Creates a node at the end of the queue.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CLockFreeQueuePushBack(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLOCKFREE_QUEUE_IMPL);
+      if ((NULL == Data) || (0 == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CLOCKFREE_NODE* node = InCreateNode(Data, DataSize, false);
+      if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      status = InPushChain(this, node, node, 1);
+      if (SC_ERROR(status)) { InDeleteNode(node); }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the first node of the queue.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CLockFreeQueuePopFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLOCKFREE_QUEUE_IMPL);
+
+      InPopFront(this, false, NULL, NULL);
+
+   } while (false);
+}
+
+
+/**
+ * Removes nodes from the beginning of the queue until it is found empty.
+ * Nodes pushed by other threads during the call may stay in the queue.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  No memory for the hazard pointers of the thread
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CLockFreeQueueClear(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLOCKFREE_QUEUE_IMPL);
+
+      do
+      {
+         status = InPopFront(this, false, NULL, NULL);
+      } while (!SC_ERROR(status));
+
+      if (SC_UNSUCCESSFUL == SC_CODE(status)) { status = SC_SUCCESS; }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the number of nodes in the queue.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  Number of nodes, 0 if This is invalid
+ */
+static
+size_t
+CLockFreeQueueSize(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLOCKFREE_QUEUE_IMPL);
+
+      // A node may be counted as removed before it is counted as added
+      size_t popped = atomic_load(&this->Popped);
+      size_t pushed = atomic_load(&this->Pushed);
+
+      return (pushed > popped) ? pushed - popped : 0;
+
+   } while (false);
+
+   return 0;
+}
+
+
+/**
+ * Adopts the malloc Data buffer in a node at the end of the queue.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Buffer allocated with malloc
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, Data stays with the caller
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CLockFreeQueuePushBackTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLOCKFREE_QUEUE_IMPL);
+      if ((NULL == Data) || (0 == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CLOCKFREE_NODE* node = InCreateNode(Data, DataSize, true);
+      if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      status = InPushChain(this, node, node, 1);
+      if (SC_ERROR(status)) { free(node); }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the first node and returns its malloc data buffer.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the queue is unchanged
+ * @retval  SC_UNSUCCESSFUL       The queue is empty
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CLockFreeQueuePopFrontTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CLOCKFREE_QUEUE_IMPL);
+      if ((NULL == Data) || (NULL == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      status = InPopFront(this, true, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates nodes for Count records at the end of the queue. The nodes are
+ * linked with one CAS, so they are popped one after another.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the queue is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CLockFreeQueuePushBackBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   CLOCKFREE_NODE* first = NULL;
+
+   do
+   {
+      GET_THIS(This, CLOCKFREE_QUEUE_IMPL);
+      if ((NULL == Records) || (0 == DataSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (0 == Count) { break; }
+
+      CLOCKFREE_NODE* last = NULL;
+      char* record = Records;
+      for (size_t i = 0; i < Count; ++i, record += Stride)
+      {
+         CLOCKFREE_NODE* node = InCreateNode(record, DataSize, false);
+         if (NULL == node) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+         if (last != NULL) { atomic_init(&last->Next, node); }
+         else              { first = node; }
+         last = node;
+      }
+
+      if (SC_ERROR(status)) { break; }
+
+      status = InPushChain(this, first, last, Count);
+      if (!SC_ERROR(status)) { first = NULL; }
+
+   } while (false);
+
+   while (first != NULL)
+   {
+      CLOCKFREE_NODE* next = atomic_load(&first->Next);
+      InDeleteNode(first);
+      first = next;
+   }
+
+   return status;
+}
+
+
+static
+CLOCKFREE_QUEUE_IMPL*
+InCreateQueue()
+{
+   CLOCKFREE_QUEUE_IMPL* this = malloc(sizeof(CLOCKFREE_QUEUE_IMPL));
+   if (NULL == this) { return NULL; }
+
+   memset(this, 0, sizeof(CLOCKFREE_QUEUE_IMPL));
+
+   CLOCKFREE_NODE* dummy = InCreateNode(NULL, 0, true);
+   if (NULL == dummy)
+   {
+      free(this);
+      return NULL;
+   }
+
+   this->StructureId = CLOCKFREE_QUEUE_IMPL_STRUCT_ID;
+   atomic_init(&this->Head, dummy);
+   atomic_init(&this->Tail, dummy);
+   atomic_init(&this->Popped, 0);
+   atomic_init(&this->Pushed, 0);
+
+   this->VTable.PushBack = CLockFreeQueuePushBack;
+   this->VTable.PopFront = CLockFreeQueuePopFront;
+   this->VTable.Size     = CLockFreeQueueSize;
+   this->VTable.Clear    = CLockFreeQueueClear;
+
+   this->VTable.PushBackTake = CLockFreeQueuePushBackTake;
+   this->VTable.PopFrontTake = CLockFreeQueuePopFrontTake;
+
+   this->VTable.PushBackBatch = CLockFreeQueuePushBackBatch;
+
+   // PushFront, Front, Back, PopBack, Next, Prev, Remove, GetRefToData,
+   // GetCopyData, InsertBefore, InsertAfter, PushFrontTake, PopBackTake,
+   // GetCopyDataInto, PushFrontBatch, InsertAfterBatch, Splice,
+   // SplitAfter, Append, Sort, SortParallel, ForEach, NextBatch,
+   // ParallelForEach, ParallelReduce, GetStats and Compact stay NULL
+
+   return this;
+}
+
+
+CLIST*
+CLockFreeQueueCreate()
+{
+   CLOCKFREE_QUEUE_IMPL* this = InCreateQueue();
+   if (NULL == this) { return NULL; }
+
+   return &this->VTable;
+}
+
+
+void
+CLockFreeQueueDelete(
+   IN OPTIONAL CLIST* This)
+{
+   CLOCKFREE_QUEUE_IMPL* this = GET_STRUCT_FIELD(This, CLOCKFREE_QUEUE_IMPL, VTable);
+   if ((NULL == this) || (this->StructureId != CLOCKFREE_QUEUE_IMPL_STRUCT_ID)) { return; }
+
+   // Retired nodes of the queue are freed by the threads that retired them,
+   // data of the dummy node belongs to the thread that removed it
+   CLOCKFREE_NODE* node = atomic_load(&this->Head);
+   CLOCKFREE_NODE* first = atomic_load(&node->Next);
+   free(node);
+
+   node = first;
+   while (node != NULL)
+   {
+      CLOCKFREE_NODE* next = atomic_load(&node->Next);
+      InDeleteNode(node);
+      node = next;
+   }
+
+   this->StructureId = 0;
+   free(this);
+}
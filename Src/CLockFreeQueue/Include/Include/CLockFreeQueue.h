@@ -0,0 +1,52 @@
+/**
+ * @file     CLockFreeQueue.h
+ * @brief    Lock-free multi-producer multi-consumer queue implementation of the CList protocol.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#ifndef  __CLOCKFREE_QUEUE_H__
+#define  __CLOCKFREE_QUEUE_H__
+
+#include "Include/CList.h"
+
+
+/**
+ * Creates a Michael-Scott queue that any number of threads may push to and
+ * pop from at once without locks.
+ *
+ * The queue implements the queue subset of the CList protocol:
+ *    - PushBack, PushBackTake and PushBackBatch add nodes at the end, the
+ *      nodes of one batch are popped one after another;
+ *    - PopFront and PopFrontTake remove the first node, PopFrontTake
+ *      returns SC_UNSUCCESSFUL if the queue is empty;
+ *    - Clear removes nodes until it finds the queue empty;
+ *    - Size returns the number of nodes at some moment during the call;
+ *    - Other methods would need a stable position in the queue and are
+ *      set to NULL.
+ *
+ * Data is copied the same way CListCreate lists do: up to
+ * CLIST_SMALL_DATA_SIZE bytes into the node, larger data into a malloc
+ * buffer. Buffers passed to PushBackTake must be allocated with malloc,
+ * buffers returned by PopFrontTake are released with free.
+ *
+ * Removed nodes are released once no thread can read them, the hazard
+ * pointers that track it are kept per thread and shared by all queues.
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, returns a NULL pointer.
+ */
+CLIST*
+CLockFreeQueueCreate();
+
+
+/**
+ * Releases the queue created by CLockFreeQueueCreate, its nodes and data.
+ * No other thread may use the queue.
+ *
+ * @param[in]  This  Pointer to CList protocol. NULL is ignored.
+ */
+void
+CLockFreeQueueDelete(
+   IN OPTIONAL CLIST* This);
+
+#endif  // __CLOCKFREE_QUEUE_H__
@@ -0,0 +1,338 @@
+/**
+ * @file  CLockFreeQueueTest.cpp
+ * @brief Unit and stress Tests for the lock-free queue implementation of CLIST
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CLockFreeQueue.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                       Helpers                         //
+///////////////////////////////////////////////////////////
+
+/** Record larger than CLIST_SMALL_DATA_SIZE, so it is stored out of the node. */
+struct LargeRecord
+{
+   size_t Value;
+   char   Filler[40];
+};
+
+
+/** Value pushed by a producer: the producer index and a sequence number. */
+static size_t InMakeValue(size_t Producer, size_t Sequence)
+{
+   return (Producer << 32) | Sequence;
+}
+
+
+/** Pops all values from the Queue in order. */
+static std::vector<size_t> InPopAll(CLIST* Queue)
+{
+   std::vector<size_t> values;
+   void* data = NULL;
+   size_t dataSize = 0;
+   while (!SC_ERROR(Queue->PopFrontTake(Queue, &data, &dataSize)))
+   {
+      values.push_back(*(size_t*)data);
+      free(data);
+   }
+
+   return values;
+}
+
+
+/**
+ * Runs Producers threads that push Count values each to the Queue, in
+ * batches of Batch records, and Consumers threads that pop them. Records
+ * are LargeRecord if IsLarge is true. Checks that every value is popped
+ * once and values of one producer are popped by one consumer in the order
+ * they were pushed.
+ */
+static void InRunQueue(CLIST* Queue, size_t Producers, size_t Consumers, size_t Count,
+                       size_t Batch, bool IsLarge)
+{
+   std::atomic<size_t> popped(0);
+   std::vector<std::vector<size_t>> seen(Consumers);
+   std::vector<std::thread> threads;
+
+   for (size_t p = 0; p < Producers; ++p)
+   {
+      threads.emplace_back([Queue, p, Count, Batch, IsLarge]()
+      {
+         std::vector<LargeRecord> records(Batch);
+         for (size_t i = 0; i < Count; i += Batch)
+         {
+            size_t batch = std::min(Batch, Count - i);
+            for (size_t j = 0; j < batch; ++j) { records[j].Value = InMakeValue(p, i + j); }
+
+            size_t dataSize = IsLarge ? sizeof(LargeRecord) : sizeof(size_t);
+            while (SC_ERROR(Queue->PushBackBatch(Queue, records.data(), dataSize,
+                                                 sizeof(LargeRecord), batch))) {}
+         }
+      });
+   }
+
+   for (size_t c = 0; c < Consumers; ++c)
+   {
+      threads.emplace_back([Queue, c, Producers, Count, IsLarge, &popped, &seen]()
+      {
+         std::vector<size_t> last(Producers, SIZE_MAX);
+         while (popped.load() < Producers * Count)
+         {
+            void* data = NULL;
+            size_t dataSize = 0;
+            if (SC_ERROR(Queue->PopFrontTake(Queue, &data, &dataSize))) { continue; }
+
+            EXPECT_TRUE((IsLarge ? sizeof(LargeRecord) : sizeof(size_t)) == dataSize);
+            size_t value = *(size_t*)data;
+            free(data);
+            popped.fetch_add(1);
+
+            size_t producer = value >> 32;
+            size_t sequence = value & 0xFFFFFFFFU;
+            EXPECT_TRUE((SIZE_MAX == last[producer]) || (last[producer] < sequence));
+            last[producer] = sequence;
+            seen[c].push_back(value);
+         }
+      });
+   }
+
+   for (std::thread& thread : threads) { thread.join(); }
+
+   std::vector<char> isSeen(Producers * Count, 0);
+   for (const std::vector<size_t>& values : seen)
+   {
+      for (size_t value : values)
+      {
+         size_t index = (value >> 32) * Count + (value & 0xFFFFFFFFU);
+         EXPECT_TRUE(0 == isSeen[index]);
+         isSeen[index] = 1;
+      }
+   }
+   EXPECT_TRUE(0 == Queue->Size(Queue));
+}
+
+
+///////////////////////////////////////////////////////////
+//                CLockFreeQueue Fixtures                //
+///////////////////////////////////////////////////////////
+
+struct CLockFreeQueueEmpty : public testing::Test
+{
+   CLIST* queue = NULL;
+
+   // Per-test set-up
+   void SetUp() override
+   {
+      queue = CLockFreeQueueCreate();
+      ASSERT_FALSE(queue == NULL);
+   }
+
+   // Per-test tear-down
+   void TearDown() override
+   {
+      CLockFreeQueueDelete(queue);
+   }
+};
+
+
+///////////////////////////////////////////////////////////
+//                       Tests                           //
+///////////////////////////////////////////////////////////
+
+TEST_F(CLockFreeQueueEmpty, InvPrms)
+{
+   /*** Arrange ***/
+   size_t data = 25;
+   void* buffer = NULL;
+   size_t bufferSize = 0;
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(queue->PushBack(NULL, &data, sizeof(size_t))));
+   EXPECT_TRUE(SC_ERROR(queue->PushBack(queue, NULL, sizeof(size_t))));
+   EXPECT_TRUE(SC_ERROR(queue->PushBack(queue, &data, 0)));
+   EXPECT_TRUE(SC_ERROR(queue->PushBackTake(queue, NULL, sizeof(size_t))));
+   EXPECT_TRUE(SC_ERROR(queue->PushBackBatch(queue, &data, sizeof(size_t), 1, 1)));
+   EXPECT_TRUE(SC_ERROR(queue->PopFrontTake(queue, NULL, &bufferSize)));
+
+   CLIST* list = CListCreate();
+   ASSERT_FALSE(NULL == list);
+   EXPECT_TRUE(SC_ERROR(queue->PopFrontTake(list, &buffer, &bufferSize)));
+   CListDelete(list);
+
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(queue->PopFrontTake(queue, &buffer, &bufferSize)));
+   queue->PopFront(queue);
+   queue->PopFront(NULL);
+   EXPECT_TRUE(0 == queue->Size(queue));
+   EXPECT_TRUE(0 == queue->Size(NULL));
+
+   // Methods that need a position in the queue are not supported
+   EXPECT_TRUE(NULL == queue->Front);
+   EXPECT_TRUE(NULL == queue->PopBack);
+   EXPECT_TRUE(NULL == queue->Remove);
+   EXPECT_TRUE(NULL == queue->Next);
+   EXPECT_TRUE(NULL == queue->PushFront);
+   EXPECT_TRUE(NULL == queue->Splice);
+   EXPECT_TRUE(NULL == queue->Compact);
+   CLockFreeQueueDelete(NULL);
+}
+
+
+TEST_F(CLockFreeQueueEmpty, Operations)
+{
+   /*** Arrange ***/
+   size_t records[3] = { 2, 3, 4 };
+   LargeRecord large = {};
+   large.Value = 1;
+   std::memset(large.Filler, 'x', sizeof(large.Filler));
+   size_t zero = 0;
+
+   size_t* taken = (size_t*)malloc(sizeof(size_t));
+   ASSERT_FALSE(NULL == taken);
+   *taken = 5;
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(queue->PushBack(queue, &zero, sizeof(size_t))));
+   ASSERT_FALSE(SC_ERROR(queue->PushBack(queue, &large, sizeof(LargeRecord))));
+   ASSERT_FALSE(SC_ERROR(queue->PushBackBatch(queue, records, sizeof(size_t),
+                                              sizeof(size_t), 3)));
+   ASSERT_FALSE(SC_ERROR(queue->PushBackTake(queue, taken, sizeof(size_t))));
+   ASSERT_FALSE(SC_ERROR(queue->PushBackBatch(queue, records, sizeof(size_t),
+                                              sizeof(size_t), 0)));
+
+   /*** Assert ***/
+   EXPECT_TRUE(6 == queue->Size(queue));
+
+   // Data is copied, changing the source changes nothing
+   zero = 100;
+   void* data = NULL;
+   size_t dataSize = 0;
+   ASSERT_FALSE(SC_ERROR(queue->PopFrontTake(queue, &data, &dataSize)));
+   EXPECT_TRUE((sizeof(size_t) == dataSize) && (0 == *(size_t*)data));
+   free(data);
+
+   ASSERT_FALSE(SC_ERROR(queue->PopFrontTake(queue, &data, &dataSize)));
+   EXPECT_TRUE(sizeof(LargeRecord) == dataSize);
+   EXPECT_TRUE(0 == std::memcmp(&large, data, sizeof(LargeRecord)));
+   free(data);
+
+   queue->PopFront(queue);
+   EXPECT_TRUE(3 == queue->Size(queue));
+   EXPECT_TRUE((std::vector<size_t>{ 3, 4, 5 }) == InPopAll(queue));
+   EXPECT_TRUE(0 == queue->Size(queue));
+
+   // The queue works after it was emptied
+   ASSERT_FALSE(SC_ERROR(queue->PushBack(queue, &zero, sizeof(size_t))));
+   EXPECT_TRUE((std::vector<size_t>{ 100 }) == InPopAll(queue));
+
+   ASSERT_FALSE(SC_ERROR(queue->PushBack(queue, &large, sizeof(LargeRecord))));
+   ASSERT_FALSE(SC_ERROR(queue->PushBackBatch(queue, records, sizeof(size_t),
+                                              sizeof(size_t), 3)));
+   EXPECT_TRUE(SC_ERROR(queue->Clear(NULL)));
+   ASSERT_FALSE(SC_ERROR(queue->Clear(queue)));
+   ASSERT_FALSE(SC_ERROR(queue->Clear(queue)));
+   EXPECT_TRUE(0 == queue->Size(queue));
+}
+
+
+TEST_F(CLockFreeQueueEmpty, DeleteReleasesNodes)
+{
+   /*** Arrange ***/
+   LargeRecord large = {};
+
+   /*** Act ***/
+   for (size_t i = 0; i < 100; ++i)
+   {
+      large.Value = i;
+      ASSERT_FALSE(SC_ERROR(queue->PushBack(queue, &large.Value, sizeof(size_t))));
+      ASSERT_FALSE(SC_ERROR(queue->PushBack(queue, &large, sizeof(LargeRecord))));
+   }
+   queue->PopFront(queue);
+
+   /*** Assert ***/
+   // Leak checkers see the nodes and data left in the queue released
+   EXPECT_TRUE(199 == queue->Size(queue));
+}
+
+
+TEST_F(CLockFreeQueueEmpty, StressQueue)
+{
+   InRunQueue(queue, 4, 4, 20000, 1, false);
+}
+
+
+TEST_F(CLockFreeQueueEmpty, StressBatchesOfLargeRecords)
+{
+   InRunQueue(queue, 3, 3, 20000, 7, true);
+}
+
+
+TEST_F(CLockFreeQueueEmpty, StressShortLivedThreads)
+{
+   /*** Act ***/
+   // Every wave of threads reuses the hazard records of the previous one
+   for (size_t wave = 0; wave < 20; ++wave)
+   {
+      InRunQueue(queue, 2, 2, 500, 1 + wave % 3, 0 == wave % 2);
+   }
+
+   /*** Assert ***/
+   EXPECT_TRUE(0 == queue->Size(queue));
+}
+
+
+TEST(CLockFreeQueue, QueuesShareThreads)
+{
+   /*** Arrange ***/
+   CLIST* first = CLockFreeQueueCreate();
+   CLIST* second = CLockFreeQueueCreate();
+   ASSERT_FALSE((NULL == first) || (NULL == second));
+
+   /*** Act ***/
+   // Values move from one queue to the other while both are in use
+   std::thread mover([first, second]()
+   {
+      for (size_t moved = 0; moved < 10000;)
+      {
+         void* data = NULL;
+         size_t dataSize = 0;
+         if (SC_ERROR(first->PopFrontTake(first, &data, &dataSize))) { continue; }
+         EXPECT_FALSE(SC_ERROR(second->PushBackTake(second, data, dataSize)));
+         ++moved;
+      }
+   });
+
+   for (size_t i = 0; i < 10000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(first->PushBack(first, &i, sizeof(size_t))));
+   }
+   mover.join();
+
+   /*** Assert ***/
+   std::vector<size_t> values = InPopAll(second);
+   ASSERT_TRUE(10000 == values.size());
+   for (size_t i = 0; i < values.size(); ++i) { EXPECT_TRUE(i == values[i]); }
+
+   CLockFreeQueueDelete(first);
+   CLockFreeQueueDelete(second);
+}
+
+
+int main(int argc, char** argv)
+{
+   ::testing::InitGoogleTest(&argc, argv);
+
+   return RUN_ALL_TESTS();
+}
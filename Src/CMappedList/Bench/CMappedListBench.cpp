@@ -0,0 +1,139 @@
+/**
+ * @file  CMappedListBench.cpp
+ * @brief Startup benchmark for list images: reloading by PushBack against the mapped view
+ *
+ * Usage: CMappedListBench [Size [DataSize [Path]]]
+ *    Size     - number of elements of the list, 10^6 by default;
+ *    DataSize - size of every element, 32 by default;
+ *    Path     - path of the image, CMappedListBench.img by default.
+ *
+ * The list is written once with CMappedListSerialize. Reload copies every
+ * element of the image into a new CList with PushBack, Open maps the image
+ * and reads nothing, Open+Walk maps it and reads every element once.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CMappedList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                       Helpers                         //
+///////////////////////////////////////////////////////////
+
+/** Times one call of Run in milliseconds. */
+template <typename Body>
+static double InMeasure(Body Run)
+{
+   auto start = std::chrono::steady_clock::now();
+   Run();
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/** Adds the first byte of the Data to the size_t Context. */
+static void InSumFirstBytes(void* Data, size_t DataSize, void* Context)
+{
+   (void)DataSize;
+   *(size_t*)Context += *(unsigned char*)Data;
+}
+
+
+/** Pushes a copy of the Data to the end of the CLIST Context. */
+static void InPushBack(void* Data, size_t DataSize, void* Context)
+{
+   CLIST* list = (CLIST*)Context;
+   if (SC_ERROR(list->PushBack(list, Data, DataSize))) { abort(); }
+}
+
+
+///////////////////////////////////////////////////////////
+//                         Cases                         //
+///////////////////////////////////////////////////////////
+
+int main(int argc, char** argv)
+{
+   size_t size = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000U;
+   size_t dataSize = (argc > 2) ? strtoull(argv[2], NULL, 10) : 32U;
+   const char* path = (argc > 3) ? argv[3] : "CMappedListBench.img";
+
+   if ((0 == size) || (size > 100000000U) || (0 == dataSize) || (dataSize > 4096))
+   {
+      fprintf(stderr, "Size must be in [1, 10^8], DataSize must be in [1, 4096]\n");
+      return EXIT_FAILURE;
+   }
+
+   CLIST* list = CListCreate();
+   if (NULL == list)
+   {
+      fprintf(stderr, "CList can't be created\n");
+      return EXIT_FAILURE;
+   }
+
+   std::vector<unsigned char> data(dataSize);
+   for (size_t i = 0; i < size; ++i)
+   {
+      memset(data.data(), (int)i, dataSize);
+      if (SC_ERROR(list->PushBack(list, data.data(), dataSize)))
+      {
+         fprintf(stderr, "PushBack failed\n");
+         return EXIT_FAILURE;
+      }
+   }
+
+   STATUS_CODE status = SC_SUCCESS;
+   double ms = InMeasure([&] { status = CMappedListSerialize(list, path); });
+   CListDelete(list);
+   if (SC_ERROR(status))
+   {
+      fprintf(stderr, "%s can't be written\n", path);
+      return EXIT_FAILURE;
+   }
+
+   printf("%-12s %12s\n", "Case", "ms");
+   printf("%-12s %12.2f\n", "Serialize", ms);
+
+   CLIST* copy = NULL;
+   ms = InMeasure([&]
+   {
+      CLIST* mapped = CMappedListOpen(path);
+      copy = CListCreate();
+      if ((NULL == mapped) || (NULL == copy)) { abort(); }
+
+      mapped->ForEach(mapped, InPushBack, copy);
+      CMappedListClose(mapped);
+   });
+   CListDelete(copy);
+   printf("%-12s %12.2f\n", "Reload", ms);
+
+   ms = InMeasure([&]
+   {
+      CLIST* mapped = CMappedListOpen(path);
+      if (NULL == mapped) { abort(); }
+      CMappedListClose(mapped);
+   });
+   printf("%-12s %12.2f\n", "Open", ms);
+
+   size_t sum = 0;
+   ms = InMeasure([&]
+   {
+      CLIST* mapped = CMappedListOpen(path);
+      if (NULL == mapped) { abort(); }
+
+      mapped->ForEach(mapped, InSumFirstBytes, &sum);
+      CMappedListClose(mapped);
+   });
+   printf("%-12s %12.2f\n", "Open+Walk", ms);
+   if (0 == sum) { fprintf(stderr, "Walk read nothing\n"); }
+
+   remove(path);
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,995 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     CMappedList.c
+ * @brief    Binary images of lists and their read-only memory-mapped view.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Include/CMappedList.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Header of an image, followed by the records of the nodes in list order. */
+typedef struct CMAPPED_HEADER
+{
+   uint64_t Magic;      /** CMAPPED_MAGIC, 0 until the image is complete */
+   uint32_t Version;    /** CMAPPED_LIST_VERSION                         */
+   uint32_t HeaderSize; /** Size of CMAPPED_HEADER                       */
+   uint64_t Count;      /** Number of records                            */
+   uint64_t ImageSize;  /** Size of the whole image                      */
+   uint64_t LastOffset; /** Offset of the last record, 0 if there is none */
+} CMAPPED_HEADER;
+
+
+/** Record of one node, followed by its data padded to CMAPPED_ALIGNMENT. */
+typedef struct CMAPPED_RECORD
+{
+   uint64_t DataSize; /** Size of the data                                  */
+   uint64_t PrevSize; /** Size of the previous record, 0 for the first one  */
+} CMAPPED_RECORD;
+
+
+/** Identifies images, also tells the byte order they were written in. */
+#define CMAPPED_MAGIC STRUCT_ID_64('C', 'L', 'I', 'S', 'T', 'I', 'M', 'G')
+
+/** Alignment of records and of the data in them. */
+#define CMAPPED_ALIGNMENT 8U
+
+/** Rounds Size up to CMAPPED_ALIGNMENT. */
+#define CMAPPED_ALIGN_UP(Size) \
+   (((Size) + CMAPPED_ALIGNMENT - 1) & ~(uint64_t)(CMAPPED_ALIGNMENT - 1))
+
+/** Suffix of the file the image is written to before it replaces the target. */
+#define CMAPPED_TEMP_SUFFIX ".tmp"
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/** Number of records written by one writev, every record takes up to 3 vectors. */
+#define CMAPPED_WRITE_BATCH ((IOV_MAX - 1) / 3)
+
+
+/** Buffers of CMappedListSerialize, allocated in one block. */
+typedef struct CMAPPED_WRITER
+{
+   CLIST_ITEM     Items[CMAPPED_WRITE_BATCH];   /** Data of the nodes of a batch */
+   CMAPPED_RECORD Records[CMAPPED_WRITE_BATCH]; /** Records of the batch         */
+   struct iovec   Vectors[IOV_MAX];             /** Vectors of one writev        */
+} CMAPPED_WRITER;
+
+
+/** Read-only view of an image, implementation of the CList protocol. */
+typedef struct CMAPPED_LIST_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   CLIST     VTable;      /** API                 */
+
+   unsigned char* Image;       /** Mapping of the image                 */
+   size_t         ImageSize;   /** Size of the mapping                  */
+   size_t         Size;        /** Number of records                    */
+   size_t         LastOffset;  /** Offset of the last record            */
+   void*          RefData;     /** Target of the link of GetRefToData   */
+   size_t         RefDataSize; /** Data size linked by GetRefToData     */
+} CMAPPED_LIST_IMPL;
+
+
+/** Unique identificator for CMAPPED_LIST_IMPL */
+#define CMAPPED_LIST_IMPL_STRUCT_ID \
+   STRUCT_ID_64('C', 'M', 'A', 'P', 'P', 'E', 'D', '.')
+
+
+/** Source of the padding after the data. */
+static const unsigned char g_Padding[CMAPPED_ALIGNMENT] = { 0 };
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Writes all Vectors to the file, continuing after partial writes.
+ *
+ * @param[in]  File     File descriptor
+ * @param[in]  Vectors  Vectors to write, changed by the call
+ * @param[in]  Count    Number of vectors
+ *
+ * @retval  SC_UNSUCCESSFUL  The file can't be written
+ * @retval  SC_SUCCESS       On success
+ */
+static
+STATUS_CODE
+InWriteVectors(
+   IN int           File,
+   IN struct iovec* Vectors,
+   IN size_t        Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   while (Count > 0)
+   {
+      ssize_t written = writev(File, Vectors, (int)Count);
+      if (written < 0)
+      {
+         if (EINTR == errno) { continue; }
+
+         SET_SC(SC_UNSUCCESSFUL);
+         break;
+      }
+
+      // Skips the vectors written completely and cuts the one written partly
+      size_t left = (size_t)written;
+      while ((Count > 0) && (left >= Vectors->iov_len))
+      {
+         left -= Vectors->iov_len;
+         ++Vectors;
+         --Count;
+      }
+
+      if (Count > 0)
+      {
+         Vectors->iov_base = (char*)Vectors->iov_base + left;
+         Vectors->iov_len -= left;
+      }
+   }
+
+   return status;
+}
+
+
+/**
+ * Reads the data of up to Capacity nodes of the List from the *Position,
+ * with NextBatch if the list has it and with Next and GetRefToData otherwise.
+ *
+ * @param[in]      List      Pointer to CList protocol
+ * @param[in,out]  Position  First node to read, the node after the last
+ *                           read one on output
+ * @param[out]     Items     Array of Capacity items
+ * @param[in]      Capacity  Maximum number of nodes to read
+ * @param[out]     Count     Number of read nodes
+ *
+ * @retval  SC_INVALID_PARAMETER  The list rejected the position
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InReadItems(
+   IN     CLIST*       List,
+   IN OUT CLIST_NODE** Position,
+   OUT    CLIST_ITEM*  Items,
+   IN     size_t       Capacity,
+   OUT    size_t*      Count)
+{
+   if (List->NextBatch != NULL)
+   {
+      return List->NextBatch(List, Position, Items, Capacity, Count);
+   }
+
+   STATUS_CODE status = SC_SUCCESS;
+   size_t count = 0;
+
+   for (; (*Position != NULL) && (count < Capacity); ++count)
+   {
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      status = List->GetRefToData(List, *Position, &data, &dataSize);
+      if (SC_ERROR(status)) { break; }
+
+      Items[count].Data = *data;
+      Items[count].DataSize = *dataSize;
+      *Position = List->Next(List, *Position);
+   }
+
+   *Count = count;
+
+   return status;
+}
+
+
+/**
+ * Writes the image of the List to the File.
+ *
+ * @param[in]  List    Pointer to CList protocol
+ * @param[in]  File    File descriptor of an empty file
+ * @param[in]  Writer  Buffers for the batches
+ *
+ * @retval  SC_INVALID_PARAMETER  The list rejected a position
+ * @retval  SC_UNSUCCESSFUL       The file can't be written
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InWriteImage(
+   IN CLIST*          List,
+   IN int             File,
+   IN CMAPPED_WRITER* Writer)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   // The header is written last, until then the image has no magic
+   CMAPPED_HEADER header = { 0 };
+   Writer->Vectors[0].iov_base = &header;
+   Writer->Vectors[0].iov_len = sizeof(CMAPPED_HEADER);
+   size_t vectorCount = 1;
+
+   uint64_t offset = sizeof(CMAPPED_HEADER);
+   uint64_t prevSize = 0;
+   CLIST_NODE* position = List->Front(List);
+
+   while (position != NULL)
+   {
+      size_t itemCount = 0;
+      status = InReadItems(List, &position, Writer->Items, CMAPPED_WRITE_BATCH, &itemCount);
+      if (SC_ERROR(status) || (0 == itemCount)) { break; }
+
+      for (size_t i = 0; i < itemCount; ++i)
+      {
+         CMAPPED_RECORD* record = &Writer->Records[i];
+         uint64_t dataSize = Writer->Items[i].DataSize;
+         uint64_t paddedSize = CMAPPED_ALIGN_UP(dataSize);
+
+         record->DataSize = dataSize;
+         record->PrevSize = prevSize;
+
+         Writer->Vectors[vectorCount].iov_base = record;
+         Writer->Vectors[vectorCount++].iov_len = sizeof(CMAPPED_RECORD);
+         Writer->Vectors[vectorCount].iov_base = Writer->Items[i].Data;
+         Writer->Vectors[vectorCount++].iov_len = (size_t)dataSize;
+         if (paddedSize != dataSize)
+         {
+            Writer->Vectors[vectorCount].iov_base = (void*)g_Padding;
+            Writer->Vectors[vectorCount++].iov_len = (size_t)(paddedSize - dataSize);
+         }
+
+         prevSize = sizeof(CMAPPED_RECORD) + paddedSize;
+         header.LastOffset = offset;
+         offset += prevSize;
+      }
+
+      header.Count += itemCount;
+      status = InWriteVectors(File, Writer->Vectors, vectorCount);
+      if (SC_ERROR(status)) { break; }
+
+      vectorCount = 0;
+   }
+
+   if (!SC_ERROR(status) && (vectorCount > 0))
+   {
+      status = InWriteVectors(File, Writer->Vectors, vectorCount);
+   }
+
+   if (SC_ERROR(status)) { return status; }
+
+   header.Magic = CMAPPED_MAGIC;
+   header.Version = CMAPPED_LIST_VERSION;
+   header.HeaderSize = sizeof(CMAPPED_HEADER);
+   header.ImageSize = offset;
+
+   if (pwrite(File, &header, sizeof(CMAPPED_HEADER), 0) != (ssize_t)sizeof(CMAPPED_HEADER))
+   {
+      SET_SC(SC_UNSUCCESSFUL);
+   }
+
+   return status;
+}
+
+
+/**
+ * Converts the CLIST_NODE handle into the record it points to.
+ *
+ * @param[in]  List      List
+ * @param[in]  Position  Handle
+ *
+ * @return  Record, NULL if Position isn't a record that fits the image
+ */
+static
+CMAPPED_RECORD*
+InToRecord(
+   IN CMAPPED_LIST_IMPL* List,
+   IN CLIST_NODE*        Position)
+{
+   uintptr_t address = (uintptr_t)Position;
+   uintptr_t image = (uintptr_t)List->Image;
+
+   if ((address < image + sizeof(CMAPPED_HEADER)) ||
+       (address - image > List->ImageSize - sizeof(CMAPPED_RECORD)) ||
+       ((address - image) % CMAPPED_ALIGNMENT != 0))
+   {
+      return NULL;
+   }
+
+   CMAPPED_RECORD* record = (CMAPPED_RECORD*)Position;
+   size_t offset = address - image;
+   if (record->DataSize > List->ImageSize - offset - sizeof(CMAPPED_RECORD)) { return NULL; }
+
+   return record;
+}
+
+
+/**
+ * Returns the data of the Record.
+ *
+ * @param[in]  Record  Record
+ *
+ * @return  Pointer to the data
+ */
+static
+void*
+InGetData(
+   IN CMAPPED_RECORD* Record)
+{
+   return (unsigned char*)Record + sizeof(CMAPPED_RECORD);
+}
+
+
+/**
+ * Returns the handle of the record after the Record.
+ *
+ * @param[in]  List    List
+ * @param[in]  Record  Record of the List
+ *
+ * @return  Handle, NULL if the Record is the last one
+ */
+static
+CLIST_NODE*
+InGetNext(
+   IN CMAPPED_LIST_IMPL* List,
+   IN CMAPPED_RECORD*    Record)
+{
+   size_t offset = (unsigned char*)Record - List->Image;
+   size_t left = List->ImageSize - offset - sizeof(CMAPPED_RECORD);
+
+   // A damaged size that runs past the image ends the list as well
+   if (CMAPPED_ALIGN_UP(Record->DataSize) >= left) { return NULL; }
+
+   return (CLIST_NODE*)((unsigned char*)InGetData(Record) + CMAPPED_ALIGN_UP(Record->DataSize));
+}
+
+
+/**
+ * Returns the handle of the record before the Record.
+ *
+ * @param[in]  List    List
+ * @param[in]  Record  Record of the List
+ *
+ * @return  Handle, NULL if the Record is the first one
+ */
+static
+CLIST_NODE*
+InGetPrev(
+   IN CMAPPED_LIST_IMPL* List,
+   IN CMAPPED_RECORD*    Record)
+{
+   size_t offset = (unsigned char*)Record - List->Image;
+
+   if ((0 == Record->PrevSize) || (Record->PrevSize > offset - sizeof(CMAPPED_HEADER)))
+   {
+      return NULL;
+   }
+
+   return (CLIST_NODE*)((unsigned char*)Record - Record->PrevSize);
+}
+
+
+///////////////////////////////////////////////////////////
+///                     Public API                      ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Returns the first node in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  NULL         If This is invalid or the list is empty
+ * @retval  CLIST_NODE*  List head
+ */
+static
+CLIST_NODE*
+CMappedListFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      if (0 == this->Size) { break; }
+
+      return (CLIST_NODE*)(this->Image + sizeof(CMAPPED_HEADER));
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the last node in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  NULL         If This is invalid or the list is empty
+ * @retval  CLIST_NODE*  List tail
+ */
+static
+CLIST_NODE*
+CMappedListBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      if (0 == this->Size) { break; }
+
+      return (CLIST_NODE*)(this->Image + this->LastOffset);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the next node in the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  CLIST_NODE*  Next node
+ * @retval  NULL         If Invalid input parameter or there is no next node
+ */
+static
+CLIST_NODE*
+CMappedListNext(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      CMAPPED_RECORD* record = InToRecord(this, Position);
+      if (NULL == record) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      return InGetNext(this, record);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the previous node in the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  CLIST_NODE*  Previous node
+ * @retval  NULL         If Invalid input parameter or there is no previous node
+ */
+static
+CLIST_NODE*
+CMappedListPrev(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      CMAPPED_RECORD* record = InToRecord(this, Position);
+      if (NULL == record) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      return InGetPrev(this, record);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Gets a link to the data stored in the Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Triple pointer to data
+ * @param[in]  DataSize  Pointer to pointer to data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CMappedListGetRefToData(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void***     Data,
+   IN size_t**    DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      CMAPPED_RECORD* record = InToRecord(this, Position);
+      if ((NULL == record) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      this->RefData = InGetData(record);
+      this->RefDataSize = (size_t)record->DataSize;
+      *Data = &this->RefData;
+      *DataSize = &this->RefDataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Gets a copy of the data stored in the Position node.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[in]   Position  Position in the list
+ * @param[out]  Data      Data
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CMappedListGetCopyData(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void**      Data,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      CMAPPED_RECORD* record = InToRecord(this, Position);
+      if ((NULL == record) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      *Data = malloc((size_t)record->DataSize);
+      if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(*Data, InGetData(record), (size_t)record->DataSize);
+      *DataSize = (size_t)record->DataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the number of nodes.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  Number of nodes. If This is invalid then returns 0.
+ */
+static
+size_t
+CMappedListSize(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      return this->Size;
+   } while (false);
+
+   return 0;
+}
+
+
+/**
+ * Copies the data stored in the Position node into the caller's Buffer.
+ *
+ * @param[in]   This        Pointer to CList protocol
+ * @param[in]   Position    Position in the list
+ * @param[out]  Buffer      Buffer for the data
+ * @param[in]   BufferSize  Buffer size
+ * @param[out]  DataSize    Data size, also set if the buffer is too small
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_BUFFER_TOO_SMALL   BufferSize is less than the data size
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CMappedListGetCopyDataInto(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void*       Buffer,
+   IN  size_t      BufferSize,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      CMAPPED_RECORD* record = InToRecord(this, Position);
+      if ((NULL == record) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      *DataSize = (size_t)record->DataSize;
+      if ((NULL == Buffer) || (BufferSize < *DataSize))
+      {
+         SET_SC(SC_BUFFER_TOO_SMALL);
+         break;
+      }
+
+      memcpy(Buffer, InGetData(record), *DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Calls the Visitor for the data of every node in list order.
+ *
+ * @param[in]  This     Pointer to CList protocol
+ * @param[in]  Visitor  Function called for every node
+ * @param[in]  Context  Context for the Visitor, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The walk reached a damaged node
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CMappedListForEach(
+   IN          CLIST*        This,
+   IN          CLIST_VISITOR Visitor,
+   IN OPTIONAL void*         Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      if (NULL == Visitor) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CLIST_NODE* position = CMappedListFront(This);
+      while (position != NULL)
+      {
+         CMAPPED_RECORD* record = InToRecord(this, position);
+         if (NULL == record) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+         Visitor(InGetData(record), (size_t)record->DataSize, Context);
+         position = InGetNext(this, record);
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Reads the data of up to Capacity nodes starting from *Position.
+ *
+ * @param[in]      This      Pointer to CList protocol
+ * @param[in,out]  Position  First node to read, the node after the last
+ *                           read one on output
+ * @param[out]     Items     Array of Capacity items
+ * @param[in]      Capacity  Maximum number of nodes to read
+ * @param[out]     Count     Number of read nodes
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CMappedListNextBatch(
+   IN     CLIST*       This,
+   IN OUT CLIST_NODE** Position,
+   OUT    CLIST_ITEM*  Items,
+   IN     size_t       Capacity,
+   OUT    size_t*      Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CMAPPED_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Items) || (0 == Capacity) || (NULL == Count))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // A damaged node ends the batch, the next call rejects its position
+      size_t count = 0;
+      for (; (*Position != NULL) && (count < Capacity); ++count)
+      {
+         CMAPPED_RECORD* record = InToRecord(this, *Position);
+         if (NULL == record) { break; }
+
+         Items[count].Data = InGetData(record);
+         Items[count].DataSize = (size_t)record->DataSize;
+         *Position = InGetNext(this, record);
+      }
+
+      if ((0 == count) && (*Position != NULL)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      *Count = count;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Checks the header and the ends of the Image.
+ *
+ * @param[in]  Image      Mapping of the image
+ * @param[in]  ImageSize  Size of the mapping
+ *
+ * @return  true if the Image is a valid image of CMAPPED_LIST_VERSION
+ */
+static
+bool
+InIsValidImage(
+   IN const unsigned char* Image,
+   IN size_t               ImageSize)
+{
+   const CMAPPED_HEADER* header = (const CMAPPED_HEADER*)Image;
+
+   if ((header->Magic != CMAPPED_MAGIC) ||
+       (header->Version != CMAPPED_LIST_VERSION) ||
+       (header->HeaderSize != sizeof(CMAPPED_HEADER)) ||
+       (header->ImageSize != ImageSize) ||
+       (header->Count > ImageSize / sizeof(CMAPPED_RECORD)))
+   {
+      return false;
+   }
+
+   if (0 == header->Count)
+   {
+      return (0 == header->LastOffset) && (sizeof(CMAPPED_HEADER) == ImageSize);
+   }
+
+   // The first record starts the list and the last one ends the image
+   const CMAPPED_RECORD* first = (const CMAPPED_RECORD*)(Image + sizeof(CMAPPED_HEADER));
+   if ((ImageSize < sizeof(CMAPPED_HEADER) + sizeof(CMAPPED_RECORD)) || (first->PrevSize != 0))
+   {
+      return false;
+   }
+
+   if ((header->LastOffset < sizeof(CMAPPED_HEADER)) ||
+       (header->LastOffset > ImageSize - sizeof(CMAPPED_RECORD)) ||
+       (header->LastOffset % CMAPPED_ALIGNMENT != 0))
+   {
+      return false;
+   }
+
+   const CMAPPED_RECORD* last = (const CMAPPED_RECORD*)(Image + header->LastOffset);
+   size_t left = ImageSize - (size_t)header->LastOffset - sizeof(CMAPPED_RECORD);
+
+   return (last->DataSize <= left) && (CMAPPED_ALIGN_UP(last->DataSize) == left);
+}
+
+
+/**
+ * Allocates and initializes CMAPPED_LIST_IMPL for the valid Image.
+ *
+ * @param[in]  Image      Mapping of the image
+ * @param[in]  ImageSize  Size of the mapping
+ *
+ * @retval  CMAPPED_LIST_IMPL*  If the list is successfully created
+ * @retval  NULL                On failure
+ */
+static
+CMAPPED_LIST_IMPL*
+InCreateList(
+   IN unsigned char* Image,
+   IN size_t         ImageSize)
+{
+   CMAPPED_LIST_IMPL* this = malloc(sizeof(CMAPPED_LIST_IMPL));
+   if (NULL == this) { return NULL; }
+
+   const CMAPPED_HEADER* header = (const CMAPPED_HEADER*)Image;
+
+   this->StructureId = CMAPPED_LIST_IMPL_STRUCT_ID;
+   this->Image = Image;
+   this->ImageSize = ImageSize;
+   this->Size = (size_t)header->Count;
+   this->LastOffset = (size_t)header->LastOffset;
+   this->RefData = NULL;
+   this->RefDataSize = 0;
+
+   this->VTable.PushFront    = NULL;
+   this->VTable.PushBack     = NULL;
+   this->VTable.Front        = CMappedListFront;
+   this->VTable.Back         = CMappedListBack;
+   this->VTable.PopFront     = NULL;
+   this->VTable.PopBack      = NULL;
+   this->VTable.Next         = CMappedListNext;
+   this->VTable.Prev         = CMappedListPrev;
+   this->VTable.GetRefToData = CMappedListGetRefToData;
+   this->VTable.GetCopyData  = CMappedListGetCopyData;
+   this->VTable.InsertBefore = NULL;
+   this->VTable.InsertAfter  = NULL;
+   this->VTable.Size         = CMappedListSize;
+   this->VTable.Remove       = NULL;
+   this->VTable.Clear        = NULL;
+
+   this->VTable.PushFrontTake   = NULL;
+   this->VTable.PushBackTake    = NULL;
+   this->VTable.PopFrontTake    = NULL;
+   this->VTable.PopBackTake     = NULL;
+   this->VTable.GetCopyDataInto = CMappedListGetCopyDataInto;
+
+   this->VTable.PushFrontBatch   = NULL;
+   this->VTable.PushBackBatch    = NULL;
+   this->VTable.InsertAfterBatch = NULL;
+
+   this->VTable.Splice     = NULL;
+   this->VTable.SplitAfter = NULL;
+   this->VTable.Append     = NULL;
+
+   this->VTable.Sort         = NULL;
+   this->VTable.SortParallel = NULL;
+
+   this->VTable.ForEach   = CMappedListForEach;
+   this->VTable.NextBatch = CMappedListNextBatch;
+
+   this->VTable.ParallelForEach = NULL;
+   this->VTable.ParallelReduce  = NULL;
+
+   this->VTable.GetStats = NULL;
+
+   this->VTable.Compact = NULL;
+
+   return this;
+}
+
+
+STATUS_CODE
+CMappedListSerialize(
+   IN CLIST*      List,
+   IN const char* Path)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   CMAPPED_WRITER* writer = NULL;
+   char* tempPath = NULL;
+   int file = -1;
+
+   do
+   {
+      if ((NULL == List) || (NULL == Path) ||
+          (NULL == List->Front) || (NULL == List->Next) || (NULL == List->Size) ||
+          ((NULL == List->NextBatch) && (NULL == List->GetRefToData)))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      size_t pathLength = strlen(Path);
+      tempPath = malloc(pathLength + sizeof(CMAPPED_TEMP_SUFFIX));
+      writer = malloc(sizeof(CMAPPED_WRITER));
+      if ((NULL == tempPath) || (NULL == writer)) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(tempPath, Path, pathLength);
+      memcpy(tempPath + pathLength, CMAPPED_TEMP_SUFFIX, sizeof(CMAPPED_TEMP_SUFFIX));
+
+      file = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (file < 0) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      status = InWriteImage(List, file, writer);
+      if (SC_ERROR(status)) { break; }
+
+      int result = close(file);
+      file = -1;
+      if (result != 0) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      // Views of the replaced image keep the old file
+      if (rename(tempPath, Path) != 0) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+   } while (false);
+
+   if (file >= 0) { close(file); }
+   if (SC_ERROR(status) && (tempPath != NULL)) { unlink(tempPath); }
+
+   free(writer);
+   free(tempPath);
+
+   return status;
+}
+
+
+CLIST*
+CMappedListOpen(
+   IN const char* Path)
+{
+   if (NULL == Path) { return NULL; }
+
+   int file = open(Path, O_RDONLY | O_CLOEXEC);
+   if (file < 0) { return NULL; }
+
+   // The mapping stays valid after the file is closed
+   struct stat info;
+   size_t imageSize = 0;
+   void* image = MAP_FAILED;
+   if ((0 == fstat(file, &info)) &&
+       (info.st_size >= (off_t)sizeof(CMAPPED_HEADER)) &&
+       ((uint64_t)info.st_size <= SIZE_MAX))
+   {
+      imageSize = (size_t)info.st_size;
+      image = mmap(NULL, imageSize, PROT_READ, MAP_PRIVATE, file, 0);
+   }
+   close(file);
+
+   if (MAP_FAILED == image) { return NULL; }
+
+   CMAPPED_LIST_IMPL* this = InIsValidImage(image, imageSize) ? InCreateList(image, imageSize) : NULL;
+   if (NULL == this)
+   {
+      munmap(image, imageSize);
+      return NULL;
+   }
+
+   return &this->VTable;
+}
+
+
+void
+CMappedListClose(
+   IN OPTIONAL CLIST* This)
+{
+   CMAPPED_LIST_IMPL* this = GET_STRUCT_FIELD(This, CMAPPED_LIST_IMPL, VTable);
+   if ((NULL == this) || (this->StructureId != CMAPPED_LIST_IMPL_STRUCT_ID)) { return; }
+
+   this->StructureId = 0;
+   munmap(this->Image, this->ImageSize);
+   free(this);
+}
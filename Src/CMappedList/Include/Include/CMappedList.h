@@ -0,0 +1,93 @@
+/**
+ * @file     CMappedList.h
+ * @brief    Binary images of lists and their read-only memory-mapped view.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#ifndef  __CMAPPED_LIST_H__
+#define  __CMAPPED_LIST_H__
+
+#include "Include/CList.h"
+
+
+/** Version of the image written by CMappedListSerialize. */
+#define CMAPPED_LIST_VERSION 1U
+
+
+/**
+ * Writes the data of all nodes of the List into a binary image at Path.
+ *
+ * The image is a versioned header followed by the nodes in list order,
+ * each as its length, a link to the previous node and the data padded to
+ * 8 bytes. Integers are in the byte order of the host, images of the other
+ * byte order are rejected by CMappedListOpen.
+ *
+ * The data is written straight from the nodes with writev, so the image
+ * is never assembled in memory. It goes into Path.tmp first and replaces
+ * Path by rename only when it is complete: on failure an existing image
+ * stays intact, and views of it opened by CMappedListOpen keep reading
+ * the old image after the replacement. The image is not flushed to disk.
+ *
+ * Lists of every CLIST implementation with Front, Next, Size and either
+ * NextBatch or GetRefToData can be written. The List must not be changed
+ * during the call.
+ *
+ * @param[in]  List  Pointer to CList protocol
+ * @param[in]  Path  Path of the image
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_UNSUCCESSFUL       The image can't be written
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+CMappedListSerialize(
+   IN CLIST*      List,
+   IN const char* Path);
+
+
+/**
+ * Maps the image written by CMappedListSerialize and exposes it as a
+ * read-only CLIST.
+ *
+ * Opening reads the header only, nodes are read from the mapping when the
+ * list is walked, so the cost of startup is the page faults of the walked
+ * part instead of an allocation per node. CLIST_NODE handles point into
+ * the mapping and stay valid until CMappedListClose:
+ *    - Front, Back, Next, Prev, Size, GetCopyData and GetCopyDataInto
+ *      work as for CListCreate lists, GetCopyData allocates with malloc;
+ *    - GetRefToData links to a field of the list that points to the data
+ *      in the mapping, the link is valid until the next call of
+ *      GetRefToData. The data and *Data and *DataSize must not be changed;
+ *    - ForEach and NextBatch pass the data in the mapping, the Visitor and
+ *      the caller must not change it. ForEach returns SC_UNSUCCESSFUL if
+ *      it reaches a damaged node;
+ *    - The data is aligned to 8 bytes;
+ *    - Other methods change the list and are set to NULL.
+ *
+ * Handles are checked against the bounds of the image and every node is
+ * checked when it is reached, so a damaged image can't make the list read
+ * outside of the mapping. The file must not be changed or truncated while
+ * it is mapped; CMappedListSerialize replaces it without touching it.
+ *
+ * @param[in]  Path  Path of the image
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, or if the file is not a valid image of
+ *          CMAPPED_LIST_VERSION, returns a NULL pointer.
+ */
+CLIST*
+CMappedListOpen(
+   IN const char* Path);
+
+
+/**
+ * Unmaps the image opened by CMappedListOpen and releases the list.
+ *
+ * @param[in]  This  Pointer to CList protocol. NULL is ignored.
+ */
+void
+CMappedListClose(
+   IN OPTIONAL CLIST* This);
+
+#endif  // __CMAPPED_LIST_H__
@@ -0,0 +1,379 @@
+/**
+ * @file  CMappedListTest.cpp
+ * @brief Unit Tests for the list images and their memory-mapped view
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CIndexList.h"
+   #include "Include/CMappedList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                       Helpers                         //
+///////////////////////////////////////////////////////////
+
+/** Data of one node: the first byte and the size. */
+typedef std::pair<unsigned char, size_t> Element;
+
+
+/** Pushes Count elements of 1..40 bytes filled with their index to the List. */
+static std::vector<Element> InFill(CLIST* List, size_t Count)
+{
+   std::vector<Element> elements;
+   for (size_t i = 0; i < Count; ++i)
+   {
+      unsigned char data[40];
+      size_t dataSize = 1 + (i * 7) % sizeof(data);
+      memset(data, (int)i, dataSize);
+
+      EXPECT_FALSE(SC_ERROR(List->PushBack(List, data, dataSize)));
+      elements.push_back(Element((unsigned char)i, dataSize));
+   }
+
+   return elements;
+}
+
+
+/** Reads the elements of the List forward and checks that backward gives the same. */
+static std::vector<Element> InRead(CLIST* List)
+{
+   std::vector<Element> elements;
+   for (CLIST_NODE* position = List->Front(List);
+        position != NULL;
+        position = List->Next(List, position))
+   {
+      unsigned char data[64] = {};
+      size_t dataSize = 0;
+      EXPECT_FALSE(SC_ERROR(List->GetCopyDataInto(List, position, data, sizeof(data),
+                                                  &dataSize)));
+      for (size_t i = 1; i < dataSize; ++i) { EXPECT_EQ(data[0], data[i]); }
+      elements.push_back(Element(data[0], dataSize));
+   }
+
+   std::vector<Element> backward;
+   for (CLIST_NODE* position = List->Back(List);
+        position != NULL;
+        position = List->Prev(List, position))
+   {
+      unsigned char data[64] = {};
+      size_t dataSize = 0;
+      EXPECT_FALSE(SC_ERROR(List->GetCopyDataInto(List, position, data, sizeof(data),
+                                                  &dataSize)));
+      backward.insert(backward.begin(), Element(data[0], dataSize));
+   }
+   EXPECT_TRUE(elements == backward);
+
+   return elements;
+}
+
+
+/** Records the element in the std::vector<Element> Context. */
+static void InRecordElement(void* Data, size_t DataSize, void* Context)
+{
+   static_cast<std::vector<Element>*>(Context)->push_back(
+      Element(*(unsigned char*)Data, DataSize));
+}
+
+
+/** Overwrites Size bytes at the Offset of the file at Path. */
+static void InPatchFile(const std::string& Path, long Offset, const void* Data, size_t Size)
+{
+   FILE* file = fopen(Path.c_str(), "r+b");
+   ASSERT_FALSE(NULL == file);
+   ASSERT_EQ(0, fseek(file, Offset, SEEK_SET));
+   ASSERT_EQ(Size, fwrite(Data, 1, Size, file));
+   fclose(file);
+}
+
+
+///////////////////////////////////////////////////////////
+//                 CMappedList Fixtures                  //
+///////////////////////////////////////////////////////////
+
+struct CMappedListImage : public testing::Test
+{
+   std::string path;
+   CLIST* list = NULL;
+
+   // Per-test set-up
+   void SetUp() override
+   {
+      path = testing::TempDir() + "CMappedListTest." +
+             testing::UnitTest::GetInstance()->current_test_info()->name();
+      list = CListCreate();
+      ASSERT_FALSE(list == NULL);
+   }
+
+   // Per-test tear-down
+   void TearDown() override
+   {
+      CListDelete(list);
+      remove(path.c_str());
+   }
+};
+
+
+///////////////////////////////////////////////////////////
+//                       Tests                           //
+///////////////////////////////////////////////////////////
+
+TEST_F(CMappedListImage, InvPrms)
+{
+   /*** Arrange ***/
+   // A protocol without methods can't be walked
+   CLIST empty = {};
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(CMappedListSerialize(NULL, path.c_str())));
+   EXPECT_TRUE(SC_ERROR(CMappedListSerialize(list, NULL)));
+   EXPECT_TRUE(SC_ERROR(CMappedListSerialize(&empty, path.c_str())));
+   EXPECT_TRUE(SC_ERROR(CMappedListSerialize(list, (path + ".missing/image").c_str())));
+
+   EXPECT_TRUE(NULL == CMappedListOpen(NULL));
+   EXPECT_TRUE(NULL == CMappedListOpen(path.c_str()));
+   CMappedListClose(NULL);
+   CMappedListClose(list);
+}
+
+
+TEST_F(CMappedListImage, RoundTrip)
+{
+   /*** Arrange ***/
+   std::vector<Element> expected = InFill(list, 1000);
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   CLIST* mapped = CMappedListOpen(path.c_str());
+   ASSERT_FALSE(NULL == mapped);
+
+   /*** Assert ***/
+   EXPECT_EQ(expected.size(), mapped->Size(mapped));
+   EXPECT_TRUE(expected == InRead(mapped));
+
+   std::vector<Element> visited;
+   ASSERT_FALSE(SC_ERROR(mapped->ForEach(mapped, InRecordElement, &visited)));
+   EXPECT_TRUE(expected == visited);
+
+   // Data is read in place, aligned to 8 bytes
+   CLIST_NODE* position = mapped->Front(mapped);
+   CLIST_ITEM items[64] = {};
+   size_t count = 0;
+   visited.clear();
+   do
+   {
+      ASSERT_FALSE(SC_ERROR(mapped->NextBatch(mapped, &position, items, 64, &count)));
+      for (size_t i = 0; i < count; ++i)
+      {
+         EXPECT_EQ(0U, (uintptr_t)items[i].Data % 8);
+         InRecordElement(items[i].Data, items[i].DataSize, &visited);
+      }
+   } while (count > 0);
+   EXPECT_TRUE(expected == visited);
+
+   position = mapped->Back(mapped);
+   void** data = NULL;
+   size_t* dataSize = NULL;
+   ASSERT_FALSE(SC_ERROR(mapped->GetRefToData(mapped, position, &data, &dataSize)));
+   EXPECT_EQ(expected.back().first, *(unsigned char*)*data);
+   EXPECT_EQ(expected.back().second, *dataSize);
+
+   void* copy = NULL;
+   size_t copySize = 0;
+   ASSERT_FALSE(SC_ERROR(mapped->GetCopyData(mapped, position, &copy, &copySize)));
+   EXPECT_EQ(0, memcmp(copy, *data, copySize));
+   free(copy);
+
+   CMappedListClose(mapped);
+}
+
+
+TEST_F(CMappedListImage, ViewIsReadOnly)
+{
+   /*** Arrange ***/
+   InFill(list, 3);
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   CLIST* mapped = CMappedListOpen(path.c_str());
+   ASSERT_FALSE(NULL == mapped);
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == mapped->PushBack);
+   EXPECT_TRUE(NULL == mapped->PopFront);
+   EXPECT_TRUE(NULL == mapped->InsertAfter);
+   EXPECT_TRUE(NULL == mapped->Remove);
+   EXPECT_TRUE(NULL == mapped->Clear);
+   EXPECT_TRUE(NULL == mapped->Sort);
+
+   // Handles of other lists and positions inside a record are rejected
+   unsigned char buffer[8] = {};
+   size_t dataSize = 0;
+   CLIST_NODE* front = mapped->Front(mapped);
+   EXPECT_TRUE(NULL == mapped->Next(mapped, list->Front(list)));
+   EXPECT_TRUE(SC_ERROR(mapped->GetCopyDataInto(mapped, (CLIST_NODE*)((char*)front + 4),
+                                                buffer, sizeof(buffer), &dataSize)));
+   EXPECT_TRUE(NULL == mapped->Prev(mapped, front));
+   EXPECT_EQ(SC_BUFFER_TOO_SMALL, SC_CODE(mapped->GetCopyDataInto(mapped, mapped->Back(mapped),
+                                                                  buffer, 1, &dataSize)));
+   EXPECT_TRUE(NULL == mapped->Front(NULL));
+   EXPECT_EQ(0U, mapped->Size(list));
+
+   CMappedListClose(mapped);
+}
+
+
+TEST_F(CMappedListImage, EmptyList)
+{
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   CLIST* mapped = CMappedListOpen(path.c_str());
+   ASSERT_FALSE(NULL == mapped);
+
+   /*** Assert ***/
+   EXPECT_EQ(0U, mapped->Size(mapped));
+   EXPECT_TRUE(NULL == mapped->Front(mapped));
+   EXPECT_TRUE(NULL == mapped->Back(mapped));
+
+   std::vector<Element> visited;
+   ASSERT_FALSE(SC_ERROR(mapped->ForEach(mapped, InRecordElement, &visited)));
+   EXPECT_TRUE(visited.empty());
+
+   CMappedListClose(mapped);
+}
+
+
+TEST_F(CMappedListImage, ListsWithoutNextBatch)
+{
+   /*** Arrange ***/
+   // CIndexList is read through GetRefToData
+   CLIST* indexList = CIndexListCreate(sizeof(uint64_t));
+   ASSERT_FALSE(NULL == indexList);
+   for (uint64_t i = 0; i < 500; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(indexList->PushBack(indexList, &i, sizeof(uint64_t))));
+   }
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(indexList, path.c_str())));
+   CLIST* mapped = CMappedListOpen(path.c_str());
+   ASSERT_FALSE(NULL == mapped);
+
+   /*** Assert ***/
+   ASSERT_EQ(500U, mapped->Size(mapped));
+   uint64_t i = 0;
+   for (CLIST_NODE* position = mapped->Front(mapped);
+        position != NULL;
+        position = mapped->Next(mapped, position), ++i)
+   {
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      ASSERT_FALSE(SC_ERROR(mapped->GetRefToData(mapped, position, &data, &dataSize)));
+      EXPECT_EQ(sizeof(uint64_t), *dataSize);
+      EXPECT_EQ(i, *(uint64_t*)*data);
+   }
+   EXPECT_EQ(500U, i);
+
+   CMappedListClose(mapped);
+   CIndexListDelete(indexList);
+}
+
+
+TEST_F(CMappedListImage, ReplacingKeepsOpenViews)
+{
+   /*** Arrange ***/
+   std::vector<Element> first = InFill(list, 10);
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   CLIST* oldView = CMappedListOpen(path.c_str());
+   ASSERT_FALSE(NULL == oldView);
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+   std::vector<Element> second = InFill(list, 25);
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   CLIST* newView = CMappedListOpen(path.c_str());
+   ASSERT_FALSE(NULL == newView);
+
+   /*** Assert ***/
+   EXPECT_TRUE(first == InRead(oldView));
+   EXPECT_TRUE(second == InRead(newView));
+
+   // A failed write leaves the image in place
+   EXPECT_TRUE(SC_ERROR(CMappedListSerialize(list, (path + ".missing/image").c_str())));
+   CMappedListClose(oldView);
+   CMappedListClose(newView);
+
+   newView = CMappedListOpen(path.c_str());
+   ASSERT_FALSE(NULL == newView);
+   EXPECT_TRUE(second == InRead(newView));
+   CMappedListClose(newView);
+}
+
+
+TEST_F(CMappedListImage, DamagedImagesAreRejected)
+{
+   /*** Arrange ***/
+   InFill(list, 20);
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   uint64_t zero = 0;
+   uint32_t version = CMAPPED_LIST_VERSION + 1;
+   uint64_t huge = UINT64_MAX;
+
+   // Offsets of Magic, Version, the size of the first record and its
+   // previous record link
+   const long magicOffset = 0;
+   const long versionOffset = 8;
+   const long firstSizeOffset = 40;
+   const long firstPrevOffset = 48;
+
+   /*** Act && Assert ***/
+   InPatchFile(path, magicOffset, &zero, sizeof(zero));
+   EXPECT_TRUE(NULL == CMappedListOpen(path.c_str()));
+
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   InPatchFile(path, versionOffset, &version, sizeof(version));
+   EXPECT_TRUE(NULL == CMappedListOpen(path.c_str()));
+
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   InPatchFile(path, firstPrevOffset, &huge, sizeof(huge));
+   EXPECT_TRUE(NULL == CMappedListOpen(path.c_str()));
+
+   // A cut image doesn't match its size
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   FILE* file = fopen(path.c_str(), "ab");
+   ASSERT_FALSE(NULL == file);
+   fputc(0, file);
+   fclose(file);
+   EXPECT_TRUE(NULL == CMappedListOpen(path.c_str()));
+
+   // A damaged node in the middle is found when it is reached
+   ASSERT_FALSE(SC_ERROR(CMappedListSerialize(list, path.c_str())));
+   InPatchFile(path, firstSizeOffset, &huge, sizeof(huge));
+   CLIST* mapped = CMappedListOpen(path.c_str());
+   ASSERT_FALSE(NULL == mapped);
+
+   std::vector<Element> visited;
+   EXPECT_EQ(SC_UNSUCCESSFUL, SC_CODE(mapped->ForEach(mapped, InRecordElement, &visited)));
+   EXPECT_TRUE(visited.empty());
+   EXPECT_TRUE(NULL == mapped->Next(mapped, mapped->Front(mapped)));
+   EXPECT_TRUE(NULL != mapped->Back(mapped));
+
+   CMappedListClose(mapped);
+}
+
+
+int main(int argc, char** argv)
+{
+   ::testing::InitGoogleTest(&argc, argv);
+
+   return RUN_ALL_TESTS();
+}
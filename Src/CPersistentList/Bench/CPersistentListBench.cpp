@@ -0,0 +1,187 @@
+/**
+ * @file  CPersistentListBench.cpp
+ * @brief Startup and update benchmark for the list kept in a memory-mapped file
+ *
+ * Usage: CPersistentListBench [Size [DataSize [SyncInterval [Path]]]]
+ *    Size         - number of elements of the list, 10^6 by default;
+ *    DataSize     - size of every element, 32 by default;
+ *    SyncInterval - changes between flushes of the batched case, 10^4 by default;
+ *    Path         - path of the file, CPersistentListBench.lst by default.
+ *
+ * Build fills the file with PushBack, flushing only at the end or every
+ * SyncInterval changes. Reload copies every element into a new CList,
+ * which is the startup the file replaces. Open maps the file, Open+Walk
+ * also reads every element once, Open unsynced is the check of a file
+ * left by a crash. Churn removes the first element and appends a new one,
+ * the blocks come from the free lists.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CPersistentList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                       Helpers                         //
+///////////////////////////////////////////////////////////
+
+/** Times one call of Run in milliseconds. */
+template <typename Body>
+static double InMeasure(Body Run)
+{
+   auto start = std::chrono::steady_clock::now();
+   Run();
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/** Adds the first byte of the Data to the size_t Context. */
+static void InSumFirstBytes(void* Data, size_t DataSize, void* Context)
+{
+   (void)DataSize;
+   *(size_t*)Context += *(unsigned char*)Data;
+}
+
+
+/** Pushes a copy of the Data to the end of the CLIST Context. */
+static void InPushBack(void* Data, size_t DataSize, void* Context)
+{
+   CLIST* list = (CLIST*)Context;
+   if (SC_ERROR(list->PushBack(list, Data, DataSize))) { abort(); }
+}
+
+
+/** Opens the file at Path, aborts on failure. */
+static CLIST* InOpen(const char* Path, size_t SyncInterval)
+{
+   CLIST* list = CPersistentListOpen(Path, SyncInterval);
+   if (NULL == list) { abort(); }
+
+   return list;
+}
+
+
+/** Creates the file at Path with Size elements and closes it. */
+static void InBuild(const char* Path, size_t Size, size_t DataSize, size_t SyncInterval)
+{
+   remove(Path);
+   CLIST* list = InOpen(Path, SyncInterval);
+
+   std::vector<unsigned char> data(DataSize);
+   for (size_t i = 0; i < Size; ++i)
+   {
+      memset(data.data(), (int)i, DataSize);
+      if (SC_ERROR(list->PushBack(list, data.data(), DataSize))) { abort(); }
+   }
+
+   CPersistentListClose(list);
+}
+
+
+/** Copies the file at Source to Target, aborts on failure. */
+static void InCopyFile(const char* Source, const char* Target)
+{
+   FILE* source = fopen(Source, "rb");
+   FILE* target = fopen(Target, "wb");
+   if ((NULL == source) || (NULL == target)) { abort(); }
+
+   std::vector<char> buffer(1 << 20);
+   size_t read = 0;
+   while ((read = fread(buffer.data(), 1, buffer.size(), source)) > 0)
+   {
+      if (fwrite(buffer.data(), 1, read, target) != read) { abort(); }
+   }
+
+   fclose(source);
+   fclose(target);
+}
+
+
+///////////////////////////////////////////////////////////
+//                         Cases                         //
+///////////////////////////////////////////////////////////
+
+int main(int argc, char** argv)
+{
+   size_t size = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000U;
+   size_t dataSize = (argc > 2) ? strtoull(argv[2], NULL, 10) : 32U;
+   size_t syncInterval = (argc > 3) ? strtoull(argv[3], NULL, 10) : 10000U;
+   const char* path = (argc > 4) ? argv[4] : "CPersistentListBench.lst";
+
+   if ((0 == size) || (size > 100000000U) || (0 == dataSize) || (dataSize > 4096) ||
+       (0 == syncInterval))
+   {
+      fprintf(stderr, "Size must be in [1, 10^8], DataSize must be in [1, 4096], "
+                      "SyncInterval must not be 0\n");
+      return EXIT_FAILURE;
+   }
+
+   printf("%-14s %12s\n", "Case", "ms");
+
+   double ms = InMeasure([&] { InBuild(path, size, dataSize, 0); });
+   printf("%-14s %12.2f\n", "Build", ms);
+
+   ms = InMeasure([&] { InBuild(path, size, dataSize, syncInterval); });
+   printf("%-14s %12.2f\n", ("Build/" + std::to_string(syncInterval)).c_str(), ms);
+
+   CLIST* copy = NULL;
+   ms = InMeasure([&]
+   {
+      CLIST* list = InOpen(path, 0);
+      copy = CListCreate();
+      if (NULL == copy) { abort(); }
+
+      list->ForEach(list, InPushBack, copy);
+      CPersistentListClose(list);
+   });
+   CListDelete(copy);
+   printf("%-14s %12.2f\n", "Reload", ms);
+
+   ms = InMeasure([&] { CPersistentListClose(InOpen(path, 0)); });
+   printf("%-14s %12.2f\n", "Open", ms);
+
+   size_t sum = 0;
+   ms = InMeasure([&]
+   {
+      CLIST* list = InOpen(path, 0);
+      list->ForEach(list, InSumFirstBytes, &sum);
+      CPersistentListClose(list);
+   });
+   printf("%-14s %12.2f\n", "Open+Walk", ms);
+   if (0 == sum) { fprintf(stderr, "Walk read nothing\n"); }
+
+   // One change leaves the file unsynced until the copy is taken
+   std::string copyPath = std::string(path) + ".copy";
+   CLIST* list = InOpen(path, 0);
+   list->PopFront(list);
+   InCopyFile(path, copyPath.c_str());
+
+   ms = InMeasure([&] { CPersistentListClose(InOpen(copyPath.c_str(), 0)); });
+   printf("%-14s %12.2f\n", "Open unsynced", ms);
+   remove(copyPath.c_str());
+
+   std::vector<unsigned char> data(dataSize, 0x5A);
+   ms = InMeasure([&]
+   {
+      for (size_t i = 0; i < size; ++i)
+      {
+         list->PopFront(list);
+         if (SC_ERROR(list->PushBack(list, data.data(), dataSize))) { abort(); }
+      }
+      CPersistentListSync(list);
+   });
+   printf("%-14s %12.2f\n", "Churn", ms);
+
+   CPersistentListClose(list);
+   remove(path);
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,1730 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     CPersistentList.c
+ * @brief    Doubly linked list kept in a memory-mapped file.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Include/CPersistentList.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Number of free lists, one for every power of 2 of the block capacity. */
+#define CPERSISTENT_CLASS_COUNT 64U
+
+
+/** Header at the start of the file, followed by the blocks. */
+typedef struct CPERSISTENT_HEADER
+{
+   uint64_t Magic;      /** CPERSISTENT_MAGIC                                */
+   uint32_t Version;    /** CPERSISTENT_LIST_VERSION                         */
+   uint32_t HeaderSize; /** Size of CPERSISTENT_HEADER                       */
+   uint64_t End;        /** Offset of the first byte never given to a block  */
+   uint64_t Count;      /** Number of nodes                                  */
+   uint64_t Head;       /** Offset of the first node                         */
+   uint64_t Tail;       /** Offset of the last node                          */
+   uint64_t Unsynced;   /** Not 0 from the first change after a flush to the next flush */
+   uint64_t FreeHeads[CPERSISTENT_CLASS_COUNT]; /** First free block of every class */
+} CPERSISTENT_HEADER;
+
+
+/** Block of a node or a free block, followed by the space for the data. */
+typedef struct CPERSISTENT_BLOCK
+{
+   uint64_t Next;     /** Offset of the next node or of the next free block */
+   uint64_t Prev;     /** Offset of the previous node, CPERSISTENT_FREE if free */
+   uint64_t DataSize; /** Size of the data                                  */
+   uint64_t Capacity; /** Space for the data, multiple of CPERSISTENT_ALIGNMENT */
+} CPERSISTENT_BLOCK;
+
+
+/** Offset that links to nothing. The header is at it. */
+#define CPERSISTENT_NONE 0U
+
+/** Prev of free blocks. */
+#define CPERSISTENT_FREE UINT64_MAX
+
+/** Identifies the files, also tells the byte order they were written in. */
+#define CPERSISTENT_MAGIC STRUCT_ID_64('C', 'L', 'I', 'S', 'T', 'A', 'R', 'N')
+
+/** Alignment of blocks and of the data in them. */
+#define CPERSISTENT_ALIGNMENT 8U
+
+/** Rounds Size up to CPERSISTENT_ALIGNMENT. */
+#define CPERSISTENT_ALIGN_UP(Size) \
+   (((Size) + CPERSISTENT_ALIGNMENT - 1) & ~(uint64_t)(CPERSISTENT_ALIGNMENT - 1))
+
+/** Size of a new file. */
+#define CPERSISTENT_INITIAL_SIZE (64U * 1024U)
+
+/** Number of blocks of the own class checked before a larger class is used. */
+#define CPERSISTENT_FIT_SCAN 8U
+
+/** Largest data of a node, keeps the sizes of blocks far from overflows. */
+#define CPERSISTENT_MAX_DATA_SIZE ((uint64_t)SIZE_MAX / 4)
+
+
+/** List in a mapped file, implementation of the CList protocol. */
+typedef struct CPERSISTENT_LIST_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   CLIST     VTable;      /** API                 */
+
+   int            File;         /** Descriptor of the locked file         */
+   unsigned char* Base;         /** Mapping of the whole file             */
+   size_t         MapSize;      /** Size of the mapping and of the file   */
+   size_t         SyncInterval; /** Changes between flushes, 0 for none   */
+   size_t         Changes;      /** Changes since the last flush          */
+   void*          RefData;      /** Target of the link of GetRefToData    */
+   size_t         RefDataSize;  /** Data size linked by GetRefToData      */
+} CPERSISTENT_LIST_IMPL;
+
+
+/** Unique identificator for CPERSISTENT_LIST_IMPL */
+#define CPERSISTENT_LIST_IMPL_STRUCT_ID \
+   STRUCT_ID_64('C', 'P', 'E', 'R', 'S', 'I', 'S', 'T')
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Returns the header of the file.
+ *
+ * @param[in]  List  List
+ *
+ * @return  Header
+ */
+static
+CPERSISTENT_HEADER*
+InGetHeader(
+   IN CPERSISTENT_LIST_IMPL* List)
+{
+   return (CPERSISTENT_HEADER*)List->Base;
+}
+
+
+/**
+ * Returns the block at the Offset.
+ *
+ * @param[in]  List    List
+ * @param[in]  Offset  Offset of a block
+ *
+ * @return  Block
+ */
+static
+CPERSISTENT_BLOCK*
+InGetBlock(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN uint64_t               Offset)
+{
+   return (CPERSISTENT_BLOCK*)(List->Base + Offset);
+}
+
+
+/**
+ * Returns the data of the Block.
+ *
+ * @param[in]  Block  Block
+ *
+ * @return  Pointer to the data
+ */
+static
+void*
+InGetData(
+   IN CPERSISTENT_BLOCK* Block)
+{
+   return (unsigned char*)Block + sizeof(CPERSISTENT_BLOCK);
+}
+
+
+/**
+ * Converts the Offset of a node into a CLIST_NODE handle.
+ *
+ * @param[in]  Offset  Offset of a node
+ *
+ * @return  Handle, NULL for CPERSISTENT_NONE
+ */
+static
+CLIST_NODE*
+InToHandle(
+   IN uint64_t Offset)
+{
+   return (CLIST_NODE*)(uintptr_t)Offset;
+}
+
+
+/**
+ * Checks that a block at the Offset fits the used part of the file.
+ *
+ * @param[in]  List    List
+ * @param[in]  Offset  Offset
+ *
+ * @return  true if the block and its capacity are inside the used part
+ */
+static
+bool
+InIsBlock(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN uint64_t               Offset)
+{
+   uint64_t end = InGetHeader(List)->End;
+
+   if ((Offset < sizeof(CPERSISTENT_HEADER)) || (end < sizeof(CPERSISTENT_BLOCK)) ||
+       (Offset > end - sizeof(CPERSISTENT_BLOCK)) || (Offset % CPERSISTENT_ALIGNMENT != 0))
+   {
+      return false;
+   }
+
+   CPERSISTENT_BLOCK* block = InGetBlock(List, Offset);
+
+   return (block->Capacity <= end - Offset - sizeof(CPERSISTENT_BLOCK)) &&
+          (block->DataSize <= block->Capacity);
+}
+
+
+/**
+ * Converts the CLIST_NODE handle into the offset of a node in the list.
+ *
+ * @param[in]  List      List
+ * @param[in]  Position  Handle
+ *
+ * @return  Offset, CPERSISTENT_NONE if Position isn't a node of the List
+ */
+static
+uint64_t
+InToOffset(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN CLIST_NODE*            Position)
+{
+   uint64_t offset = (uintptr_t)Position;
+
+   if (!InIsBlock(List, offset) || (CPERSISTENT_FREE == InGetBlock(List, offset)->Prev))
+   {
+      return CPERSISTENT_NONE;
+   }
+
+   return offset;
+}
+
+
+/**
+ * Checks that the Offset is a free block.
+ *
+ * @param[in]  List    List
+ * @param[in]  Offset  Offset
+ *
+ * @return  true if there is a free block at the Offset
+ */
+static
+bool
+InIsFreeBlock(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN uint64_t               Offset)
+{
+   return InIsBlock(List, Offset) && (CPERSISTENT_FREE == InGetBlock(List, Offset)->Prev);
+}
+
+
+/**
+ * Returns the free list of blocks with the Capacity.
+ *
+ * @param[in]  Capacity  Capacity of a block, not 0
+ *
+ * @return  Index of the free list, the highest bit set in the Capacity
+ */
+static
+unsigned
+InGetClass(
+   IN uint64_t Capacity)
+{
+   unsigned sizeClass = 0;
+   while (Capacity >>= 1) { ++sizeClass; }
+
+   return sizeClass;
+}
+
+
+/**
+ * Flushes the used part of the file, then clears the unsynced mark and
+ * flushes the header.
+ *
+ * @param[in]  List  List
+ *
+ * @retval  SC_UNSUCCESSFUL  The file can't be flushed, it stays unsynced
+ * @retval  SC_SUCCESS       On success
+ */
+static
+STATUS_CODE
+InFlush(
+   IN CPERSISTENT_LIST_IMPL* List)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   CPERSISTENT_HEADER* header = InGetHeader(List);
+
+   do
+   {
+      // Every change marks the file first, a synced file has nothing to flush
+      if (0 == header->Unsynced) { List->Changes = 0; break; }
+
+      if (msync(List->Base, (size_t)header->End, MS_SYNC) != 0) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      header->Unsynced = 0;
+      if (msync(List->Base, sizeof(CPERSISTENT_HEADER), MS_SYNC) != 0)
+      {
+         SET_SC(SC_UNSUCCESSFUL);
+         break;
+      }
+
+      List->Changes = 0;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Marks the file unsynced before the first change after a flush. The mark
+ * reaches the disk before the change can.
+ *
+ * @param[in]  List  List
+ *
+ * @retval  SC_UNSUCCESSFUL  The mark can't be flushed, the change must not be done
+ * @retval  SC_SUCCESS       On success
+ */
+static
+STATUS_CODE
+InBeginChange(
+   IN CPERSISTENT_LIST_IMPL* List)
+{
+   CPERSISTENT_HEADER* header = InGetHeader(List);
+   if (header->Unsynced != 0) { return SC_SUCCESS; }
+
+   header->Unsynced = 1;
+
+   return (0 == msync(List->Base, sizeof(CPERSISTENT_HEADER), MS_SYNC)) ? SC_SUCCESS :
+                                                                           SC_UNSUCCESSFUL;
+}
+
+
+/**
+ * Counts the change and flushes the file every SyncInterval changes. A
+ * failed flush is retried by the next one.
+ *
+ * @param[in]  List  List
+ */
+static
+void
+InEndChange(
+   IN CPERSISTENT_LIST_IMPL* List)
+{
+   ++List->Changes;
+
+   if ((List->SyncInterval != 0) && (List->Changes >= List->SyncInterval))
+   {
+      (void)InFlush(List);
+   }
+}
+
+
+/**
+ * Grows the file by doubling until it has Size bytes and maps it again.
+ * Offsets stay valid, pointers into the old mapping don't.
+ *
+ * @param[in]  List  List
+ * @param[in]  Size  Size the file needs
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  The file can't grow or be mapped, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InGrow(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN uint64_t               Size)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      uint64_t mapSize = List->MapSize;
+      while ((mapSize < Size) && (mapSize <= (uint64_t)SIZE_MAX / 2)) { mapSize *= 2; }
+      if (mapSize < Size) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      // Reserved space can't fail a write through the mapping with SIGBUS
+      if (posix_fallocate(List->File, (off_t)List->MapSize, (off_t)(mapSize - List->MapSize)) != 0)
+      {
+         SET_SC(SC_NOT_ENOUGH_MEMORY);
+         break;
+      }
+
+      // The new mapping is made first, so a failure keeps the old one
+      void* base = mmap(NULL, (size_t)mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, List->File, 0);
+      if (MAP_FAILED == base) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      munmap(List->Base, List->MapSize);
+      List->Base = base;
+      List->MapSize = (size_t)mapSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Takes a block for DataSize bytes, from the free lists if there is a fit
+ * and from the end of the used part otherwise.
+ *
+ * A block of the own class is taken if it fits among the first
+ * CPERSISTENT_FIT_SCAN ones, then the first block of any larger class,
+ * which always fits.
+ *
+ * @param[in]   List      List
+ * @param[in]   DataSize  Data size, not 0
+ * @param[out]  Offset    Offset of the block
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  No block can be taken, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InAllocate(
+   IN  CPERSISTENT_LIST_IMPL* List,
+   IN  size_t                 DataSize,
+   OUT uint64_t*              Offset)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      if ((uint64_t)DataSize > CPERSISTENT_MAX_DATA_SIZE) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      CPERSISTENT_HEADER* header = InGetHeader(List);
+      uint64_t capacity = CPERSISTENT_ALIGN_UP((uint64_t)DataSize);
+      unsigned sizeClass = InGetClass(capacity);
+      uint64_t offset = CPERSISTENT_NONE;
+
+      // The link to the checked block, to unlink the block in place
+      uint64_t* link = &header->FreeHeads[sizeClass];
+      for (unsigned i = 0; (i < CPERSISTENT_FIT_SCAN) && InIsFreeBlock(List, *link); ++i)
+      {
+         CPERSISTENT_BLOCK* block = InGetBlock(List, *link);
+         if (block->Capacity >= capacity)
+         {
+            offset = *link;
+            *link = block->Next;
+            break;
+         }
+
+         link = &block->Next;
+      }
+
+      for (++sizeClass;
+           (CPERSISTENT_NONE == offset) && (sizeClass < CPERSISTENT_CLASS_COUNT);
+           ++sizeClass)
+      {
+         if (InIsFreeBlock(List, header->FreeHeads[sizeClass]))
+         {
+            offset = header->FreeHeads[sizeClass];
+            header->FreeHeads[sizeClass] = InGetBlock(List, offset)->Next;
+         }
+      }
+
+      if (CPERSISTENT_NONE == offset)
+      {
+         uint64_t end = header->End + sizeof(CPERSISTENT_BLOCK) + capacity;
+         if (end > List->MapSize)
+         {
+            status = InGrow(List, end);
+            if (SC_ERROR(status)) { break; }
+
+            header = InGetHeader(List);
+         }
+
+         offset = header->End;
+         InGetBlock(List, offset)->Capacity = capacity;
+         header->End = end;
+      }
+
+      *Offset = offset;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Links the node at the Offset between Prev and Next nodes.
+ *
+ * @param[in]  List    List
+ * @param[in]  Offset  Offset of the node
+ * @param[in]  Prev    Offset of previous node or CPERSISTENT_NONE
+ * @param[in]  Next    Offset of next node or CPERSISTENT_NONE
+ */
+static
+void
+InLink(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN uint64_t               Offset,
+   IN uint64_t               Prev,
+   IN uint64_t               Next)
+{
+   CPERSISTENT_HEADER* header = InGetHeader(List);
+   CPERSISTENT_BLOCK* block = InGetBlock(List, Offset);
+   block->Prev = Prev;
+   block->Next = Next;
+
+   if (Prev != CPERSISTENT_NONE) { InGetBlock(List, Prev)->Next = Offset; }
+   else                          { header->Head = Offset; }
+
+   if (Next != CPERSISTENT_NONE) { InGetBlock(List, Next)->Prev = Offset; }
+   else                          { header->Tail = Offset; }
+
+   ++header->Count;
+}
+
+
+/**
+ * Unlinks the node at the Offset and puts its block on the free list of
+ * its class.
+ *
+ * @param[in]  List    List
+ * @param[in]  Offset  Offset of a node in the list
+ */
+static
+void
+InUnlink(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN uint64_t               Offset)
+{
+   CPERSISTENT_HEADER* header = InGetHeader(List);
+   CPERSISTENT_BLOCK* block = InGetBlock(List, Offset);
+
+   if (block->Prev != CPERSISTENT_NONE) { InGetBlock(List, block->Prev)->Next = block->Next; }
+   else                                 { header->Head = block->Next; }
+
+   if (block->Next != CPERSISTENT_NONE) { InGetBlock(List, block->Next)->Prev = block->Prev; }
+   else                                 { header->Tail = block->Prev; }
+
+   --header->Count;
+
+   uint64_t* freeHead = &header->FreeHeads[InGetClass(block->Capacity)];
+   block->Prev = CPERSISTENT_FREE;
+   block->Next = *freeHead;
+   *freeHead = Offset;
+}
+
+
+/**
+ * Creates a node with a copy of the Data between Prev and Next nodes.
+ *
+ * @param[in]  List      List
+ * @param[in]  Prev      Offset of previous node or CPERSISTENT_NONE
+ * @param[in]  Next      Offset of next node or CPERSISTENT_NONE
+ * @param[in]  Data      Data, not inside the file
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  The file can't grow, the list is unchanged
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InInsert(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN uint64_t               Prev,
+   IN uint64_t               Next,
+   IN void*                  Data,
+   IN size_t                 DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      status = InBeginChange(List);
+      if (SC_ERROR(status)) { break; }
+
+      uint64_t offset = CPERSISTENT_NONE;
+      status = InAllocate(List, DataSize, &offset);
+      if (SC_ERROR(status)) { break; }
+
+      CPERSISTENT_BLOCK* block = InGetBlock(List, offset);
+      block->DataSize = DataSize;
+      memcpy(InGetData(block), Data, DataSize);
+      InLink(List, offset, Prev, Next);
+
+      InEndChange(List);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the node at the Offset.
+ *
+ * @param[in]  List    List
+ * @param[in]  Offset  Offset of a node in the list
+ *
+ * @retval  SC_UNSUCCESSFUL  The file can't be marked unsynced, the list is unchanged
+ * @retval  SC_SUCCESS       On success
+ */
+static
+STATUS_CODE
+InRemove(
+   IN CPERSISTENT_LIST_IMPL* List,
+   IN uint64_t               Offset)
+{
+   STATUS_CODE status = InBeginChange(List);
+   if (SC_ERROR(status)) { return status; }
+
+   InUnlink(List, Offset);
+   InEndChange(List);
+
+   return status;
+}
+
+
+/**
+ * Copies the data of the node at the Offset into a new malloc buffer and
+ * removes the node.
+ *
+ * @param[in]   List      List
+ * @param[in]   Offset    Offset of a node in the list
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InTake(
+   IN  CPERSISTENT_LIST_IMPL* List,
+   IN  uint64_t               Offset,
+   OUT void**                 Data,
+   OUT size_t*                DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      CPERSISTENT_BLOCK* block = InGetBlock(List, Offset);
+      size_t dataSize = (size_t)block->DataSize;
+
+      void* data = malloc(dataSize);
+      if (NULL == data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(data, InGetData(block), dataSize);
+
+      status = InRemove(List, Offset);
+      if (SC_ERROR(status)) { free(data); break; }
+
+      *Data = data;
+      *DataSize = dataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+///////////////////////////////////////////////////////////
+///          CPersistentList API implementation         ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Creates a node at the beginning of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  The file can't grow
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListPushFront(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      status = InInsert(this, CPERSISTENT_NONE, InGetHeader(this)->Head, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  The file can't grow
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListPushBack(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      status = InInsert(this, InGetHeader(this)->Tail, CPERSISTENT_NONE, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the first node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  The first node or NULL if the list is empty or This is invalid
+ */
+static
+CLIST_NODE*
+CPersistentListFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      return InToHandle(InGetHeader(this)->Head);
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the last node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  The last node or NULL if the list is empty or This is invalid
+ */
+static
+CLIST_NODE*
+CPersistentListBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      return InToHandle(InGetHeader(this)->Tail);
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Removes the first node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CPersistentListPopFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t head = InGetHeader(this)->Head;
+      if (head != CPERSISTENT_NONE) { (void)InRemove(this, head); }
+   } while (false);
+}
+
+
+/**
+ * Removes the last node of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CPersistentListPopBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t tail = InGetHeader(this)->Tail;
+      if (tail != CPERSISTENT_NONE) { (void)InRemove(this, tail); }
+   } while (false);
+}
+
+
+/**
+ * Returns the node following the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  The next node or NULL
+ */
+static
+CLIST_NODE*
+CPersistentListNext(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t offset = InToOffset(this, Position);
+      if (CPERSISTENT_NONE == offset) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      return InToHandle(InGetBlock(this, offset)->Next);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the node preceding the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @return  The previous node or NULL
+ */
+static
+CLIST_NODE*
+CPersistentListPrev(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t offset = InToOffset(this, Position);
+      if (CPERSISTENT_NONE == offset) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      return InToHandle(InGetBlock(this, offset)->Prev);
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Gets a link to the data stored in the Position node.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Triple pointer to data
+ * @param[in]  DataSize  Pointer to pointer to data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListGetRefToData(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void***     Data,
+   IN size_t**    DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t offset = InToOffset(this, Position);
+      if ((CPERSISTENT_NONE == offset) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CPERSISTENT_BLOCK* block = InGetBlock(this, offset);
+      this->RefData = InGetData(block);
+      this->RefDataSize = (size_t)block->DataSize;
+      *Data = &this->RefData;
+      *DataSize = &this->RefDataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Gets a copy of the data stored in the Position node. The copy is
+ * allocated with malloc and released by the caller.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[in]   Position  Position in the list
+ * @param[out]  Data      Copy of the data
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListGetCopyData(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void**      Data,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t offset = InToOffset(this, Position);
+      if ((CPERSISTENT_NONE == offset) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CPERSISTENT_BLOCK* block = InGetBlock(this, offset);
+      *Data = malloc((size_t)block->DataSize);
+      if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(*Data, InGetData(block), (size_t)block->DataSize);
+      *DataSize = (size_t)block->DataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node before the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  The file can't grow
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListInsertBefore(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Data,
+   IN size_t      DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t offset = InToOffset(this, Position);
+      if ((CPERSISTENT_NONE == offset) || (NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, InGetBlock(this, offset)->Prev, offset, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates a node after the Position.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  The file can't grow
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListInsertAfter(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Data,
+   IN size_t      DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t offset = InToOffset(this, Position);
+      if ((CPERSISTENT_NONE == offset) || (NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, offset, InGetBlock(this, offset)->Next, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the number of nodes in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  Number of nodes, 0 if This is invalid
+ */
+static
+size_t
+CPersistentListSize(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      return (size_t)InGetHeader(this)->Count;
+   } while (false);
+
+   return 0;
+}
+
+
+/**
+ * Removes the Position node from the list, its block is recycled.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListRemove(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t offset = InToOffset(this, Position);
+      if (CPERSISTENT_NONE == offset) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      status = InRemove(this, offset);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes all nodes from the list. The whole file becomes free, its size
+ * is kept for new nodes.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListClear(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      status = InBeginChange(this);
+      if (SC_ERROR(status)) { break; }
+
+      CPERSISTENT_HEADER* header = InGetHeader(this);
+      header->End = sizeof(CPERSISTENT_HEADER);
+      header->Count = 0;
+      header->Head = header->Tail = CPERSISTENT_NONE;
+      memset(header->FreeHeads, 0, sizeof(header->FreeHeads));
+
+      InEndChange(this);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Copies the Data buffer to the beginning of the list and releases it
+ * with free.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Buffer allocated with malloc
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  The file can't grow, Data stays with the caller
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced, Data stays with the caller
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListPushFrontTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = CPersistentListPushFront(This, Data, DataSize);
+   if (!SC_ERROR(status)) { free(Data); }
+
+   return status;
+}
+
+
+/**
+ * Copies the Data buffer to the end of the list and releases it with free.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Buffer allocated with malloc
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  The file can't grow, Data stays with the caller
+ * @retval  SC_UNSUCCESSFUL       The file can't be marked unsynced, Data stays with the caller
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListPushBackTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = CPersistentListPushBack(This, Data, DataSize);
+   if (!SC_ERROR(status)) { free(Data); }
+
+   return status;
+}
+
+
+/**
+ * Removes the first node and returns its data in a malloc buffer.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The list is empty or the file can't be marked unsynced
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListPopFrontTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      uint64_t head = InGetHeader(this)->Head;
+      if (CPERSISTENT_NONE == head) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      status = InTake(this, head, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the last node and returns its data in a malloc buffer.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The list is empty or the file can't be marked unsynced
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListPopBackTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      uint64_t tail = InGetHeader(this)->Tail;
+      if (CPERSISTENT_NONE == tail) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      status = InTake(this, tail, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Copies the data stored in the Position node into the caller's Buffer.
+ *
+ * @param[in]   This        Pointer to CList protocol
+ * @param[in]   Position    Position in the list
+ * @param[out]  Buffer      Buffer for the data
+ * @param[in]   BufferSize  Buffer size
+ * @param[out]  DataSize    Data size, also set if the buffer is too small
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_BUFFER_TOO_SMALL   BufferSize is less than the data size
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListGetCopyDataInto(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void*       Buffer,
+   IN  size_t      BufferSize,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      uint64_t offset = InToOffset(this, Position);
+      if ((CPERSISTENT_NONE == offset) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CPERSISTENT_BLOCK* block = InGetBlock(this, offset);
+      *DataSize = (size_t)block->DataSize;
+      if ((NULL == Buffer) || (BufferSize < *DataSize))
+      {
+         SET_SC(SC_BUFFER_TOO_SMALL);
+         break;
+      }
+
+      memcpy(Buffer, InGetData(block), *DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Calls the Visitor for the data of every node in list order.
+ *
+ * @param[in]  This     Pointer to CList protocol
+ * @param[in]  Visitor  Function called for every node
+ * @param[in]  Context  Context for the Visitor, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The walk reached a damaged link
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListForEach(
+   IN          CLIST*        This,
+   IN          CLIST_VISITOR Visitor,
+   IN OPTIONAL void*         Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      if (NULL == Visitor) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      uint64_t offset = InGetHeader(this)->Head;
+      while (offset != CPERSISTENT_NONE)
+      {
+         if (CPERSISTENT_NONE == InToOffset(this, InToHandle(offset)))
+         {
+            SET_SC(SC_UNSUCCESSFUL);
+            break;
+         }
+
+         CPERSISTENT_BLOCK* block = InGetBlock(this, offset);
+         Visitor(InGetData(block), (size_t)block->DataSize, Context);
+         offset = block->Next;
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Reads the data of up to Capacity nodes starting from *Position. The
+ * pointers are valid until the next insertion.
+ *
+ * @param[in]      This      Pointer to CList protocol
+ * @param[in,out]  Position  First node to read, the node after the last
+ *                           read one on output
+ * @param[out]     Items     Array of Capacity items
+ * @param[in]      Capacity  Maximum number of nodes to read
+ * @param[out]     Count     Number of read nodes
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CPersistentListNextBatch(
+   IN     CLIST*       This,
+   IN OUT CLIST_NODE** Position,
+   OUT    CLIST_ITEM*  Items,
+   IN     size_t       Capacity,
+   OUT    size_t*      Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Items) || (0 == Capacity) || (NULL == Count))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // A damaged link ends the batch, the next call rejects its position
+      size_t count = 0;
+      for (; (*Position != NULL) && (count < Capacity); ++count)
+      {
+         uint64_t offset = InToOffset(this, *Position);
+         if (CPERSISTENT_NONE == offset) { break; }
+
+         CPERSISTENT_BLOCK* block = InGetBlock(this, offset);
+         Items[count].Data = InGetData(block);
+         Items[count].DataSize = (size_t)block->DataSize;
+         *Position = InToHandle(block->Next);
+      }
+
+      if ((0 == count) && (*Position != NULL)) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      *Count = count;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Checks the header of the mapped file and the ends of its lists.
+ *
+ * @param[in]  List  List with the mapping
+ *
+ * @return  true if the header is valid for CPERSISTENT_LIST_VERSION
+ */
+static
+bool
+InIsValidHeader(
+   IN CPERSISTENT_LIST_IMPL* List)
+{
+   const CPERSISTENT_HEADER* header = InGetHeader(List);
+
+   if ((header->Magic != CPERSISTENT_MAGIC) ||
+       (header->Version != CPERSISTENT_LIST_VERSION) ||
+       (header->HeaderSize != sizeof(CPERSISTENT_HEADER)) ||
+       (header->End < sizeof(CPERSISTENT_HEADER)) ||
+       (header->End > List->MapSize) ||
+       (header->End % CPERSISTENT_ALIGNMENT != 0) ||
+       (header->Count > (header->End - sizeof(CPERSISTENT_HEADER)) / sizeof(CPERSISTENT_BLOCK)))
+   {
+      return false;
+   }
+
+   for (unsigned i = 0; i < CPERSISTENT_CLASS_COUNT; ++i)
+   {
+      if ((header->FreeHeads[i] != CPERSISTENT_NONE) && !InIsFreeBlock(List, header->FreeHeads[i]))
+      {
+         return false;
+      }
+   }
+
+   if (0 == header->Count)
+   {
+      return (CPERSISTENT_NONE == header->Head) && (CPERSISTENT_NONE == header->Tail);
+   }
+
+   uint64_t head = InToOffset(List, InToHandle(header->Head));
+   uint64_t tail = InToOffset(List, InToHandle(header->Tail));
+
+   return (head != CPERSISTENT_NONE) && (tail != CPERSISTENT_NONE) &&
+          (CPERSISTENT_NONE == InGetBlock(List, head)->Prev) &&
+          (CPERSISTENT_NONE == InGetBlock(List, tail)->Next);
+}
+
+
+/**
+ * Walks all nodes and free blocks of a file left unsynced and checks that
+ * every link is consistent.
+ *
+ * @param[in]  List  List with a valid header
+ *
+ * @return  true if the list and the free lists are consistent
+ */
+static
+bool
+InIsConsistent(
+   IN CPERSISTENT_LIST_IMPL* List)
+{
+   const CPERSISTENT_HEADER* header = InGetHeader(List);
+
+   // Every block takes at least sizeof(CPERSISTENT_BLOCK), more steps mean a cycle
+   uint64_t limit = (header->End - sizeof(CPERSISTENT_HEADER)) / sizeof(CPERSISTENT_BLOCK);
+   uint64_t steps = 0;
+
+   uint64_t prev = CPERSISTENT_NONE;
+   for (uint64_t offset = header->Head; offset != CPERSISTENT_NONE; ++steps)
+   {
+      if ((steps >= header->Count) ||
+          (CPERSISTENT_NONE == InToOffset(List, InToHandle(offset))) ||
+          (InGetBlock(List, offset)->Prev != prev))
+      {
+         return false;
+      }
+
+      prev = offset;
+      offset = InGetBlock(List, offset)->Next;
+   }
+
+   if ((steps != header->Count) || (prev != header->Tail)) { return false; }
+
+   for (unsigned i = 0; i < CPERSISTENT_CLASS_COUNT; ++i)
+   {
+      for (uint64_t offset = header->FreeHeads[i]; offset != CPERSISTENT_NONE; ++steps)
+      {
+         if ((steps >= limit) || !InIsFreeBlock(List, offset) ||
+             (InGetClass(InGetBlock(List, offset)->Capacity) != i))
+         {
+            return false;
+         }
+
+         offset = InGetBlock(List, offset)->Next;
+      }
+   }
+
+   return true;
+}
+
+
+/**
+ * Allocates and initializes CPERSISTENT_LIST_IMPL for the mapped File.
+ *
+ * @param[in]  File          Descriptor of the locked file
+ * @param[in]  Base          Mapping of the whole file
+ * @param[in]  MapSize       Size of the file
+ * @param[in]  SyncInterval  Number of changes between flushes
+ *
+ * @retval  CPERSISTENT_LIST_IMPL*  If the list is successfully created
+ * @retval  NULL                    On failure
+ */
+static
+CPERSISTENT_LIST_IMPL*
+InCreateList(
+   IN int            File,
+   IN unsigned char* Base,
+   IN size_t         MapSize,
+   IN size_t         SyncInterval)
+{
+   CPERSISTENT_LIST_IMPL* this = malloc(sizeof(CPERSISTENT_LIST_IMPL));
+   if (NULL == this) { return NULL; }
+
+   this->StructureId = CPERSISTENT_LIST_IMPL_STRUCT_ID;
+   this->File = File;
+   this->Base = Base;
+   this->MapSize = MapSize;
+   this->SyncInterval = SyncInterval;
+   this->Changes = 0;
+   this->RefData = NULL;
+   this->RefDataSize = 0;
+
+   this->VTable.PushFront    = CPersistentListPushFront;
+   this->VTable.PushBack     = CPersistentListPushBack;
+   this->VTable.Front        = CPersistentListFront;
+   this->VTable.Back         = CPersistentListBack;
+   this->VTable.PopFront     = CPersistentListPopFront;
+   this->VTable.PopBack      = CPersistentListPopBack;
+   this->VTable.Next         = CPersistentListNext;
+   this->VTable.Prev         = CPersistentListPrev;
+   this->VTable.GetRefToData = CPersistentListGetRefToData;
+   this->VTable.GetCopyData  = CPersistentListGetCopyData;
+   this->VTable.InsertBefore = CPersistentListInsertBefore;
+   this->VTable.InsertAfter  = CPersistentListInsertAfter;
+   this->VTable.Size         = CPersistentListSize;
+   this->VTable.Remove       = CPersistentListRemove;
+   this->VTable.Clear        = CPersistentListClear;
+
+   this->VTable.PushFrontTake   = CPersistentListPushFrontTake;
+   this->VTable.PushBackTake    = CPersistentListPushBackTake;
+   this->VTable.PopFrontTake    = CPersistentListPopFrontTake;
+   this->VTable.PopBackTake     = CPersistentListPopBackTake;
+   this->VTable.GetCopyDataInto = CPersistentListGetCopyDataInto;
+
+   this->VTable.PushFrontBatch   = NULL;
+   this->VTable.PushBackBatch    = NULL;
+   this->VTable.InsertAfterBatch = NULL;
+
+   this->VTable.Splice     = NULL;
+   this->VTable.SplitAfter = NULL;
+   this->VTable.Append     = NULL;
+
+   this->VTable.Sort         = NULL;
+   this->VTable.SortParallel = NULL;
+
+   this->VTable.ForEach   = CPersistentListForEach;
+   this->VTable.NextBatch = CPersistentListNextBatch;
+
+   this->VTable.ParallelForEach = NULL;
+   this->VTable.ParallelReduce  = NULL;
+
+   this->VTable.GetStats = NULL;
+
+   this->VTable.Compact = NULL;
+
+   return this;
+}
+
+
+/**
+ * Maps the File of FileSize bytes and creates the list for it. An empty
+ * file gets CPERSISTENT_INITIAL_SIZE bytes and an empty list, as does a
+ * file whose header is still zeros after a crash during its creation.
+ *
+ * @param[in]  File          Descriptor of the locked file
+ * @param[in]  FileSize      Size of the file
+ * @param[in]  SyncInterval  Number of changes between flushes
+ *
+ * @retval  CPERSISTENT_LIST_IMPL*  If the list is successfully opened
+ * @retval  NULL                    On failure or if the file isn't a valid list
+ */
+static
+CPERSISTENT_LIST_IMPL*
+InMapFile(
+   IN int    File,
+   IN off_t  FileSize,
+   IN size_t SyncInterval)
+{
+   if (0 == FileSize)
+   {
+      if (posix_fallocate(File, 0, CPERSISTENT_INITIAL_SIZE) != 0) { return NULL; }
+      FileSize = CPERSISTENT_INITIAL_SIZE;
+   }
+
+   if ((FileSize < (off_t)sizeof(CPERSISTENT_HEADER)) || ((uint64_t)FileSize > SIZE_MAX))
+   {
+      return NULL;
+   }
+
+   size_t mapSize = (size_t)FileSize;
+   void* base = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, File, 0);
+   if (MAP_FAILED == base) { return NULL; }
+
+   CPERSISTENT_LIST_IMPL* this = InCreateList(File, base, mapSize, SyncInterval);
+   if (NULL == this) { munmap(base, mapSize); return NULL; }
+
+   CPERSISTENT_HEADER* header = InGetHeader(this);
+   bool isValid = true;
+
+   if ((0 == header->Magic) && (0 == header->Version) && (0 == header->HeaderSize))
+   {
+      header->Version = CPERSISTENT_LIST_VERSION;
+      header->HeaderSize = sizeof(CPERSISTENT_HEADER);
+      header->End = sizeof(CPERSISTENT_HEADER);
+      header->Unsynced = 1;
+      header->Magic = CPERSISTENT_MAGIC;
+      isValid = !SC_ERROR(InFlush(this));
+   }
+   else
+   {
+      isValid = InIsValidHeader(this) && ((0 == header->Unsynced) || InIsConsistent(this));
+   }
+
+   if (!isValid)
+   {
+      munmap(base, mapSize);
+      free(this);
+      return NULL;
+   }
+
+   return this;
+}
+
+
+CLIST*
+CPersistentListOpen(
+   IN const char* Path,
+   IN size_t      SyncInterval)
+{
+   if (NULL == Path) { return NULL; }
+
+   int file = open(Path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+   if (file < 0) { return NULL; }
+
+   // Another process that has the file open holds the lock
+   struct flock lock = { 0 };
+   lock.l_type = F_WRLCK;
+   lock.l_whence = SEEK_SET;
+
+   struct stat info;
+   CPERSISTENT_LIST_IMPL* this = NULL;
+   if ((0 == fcntl(file, F_SETLK, &lock)) && (0 == fstat(file, &info)))
+   {
+      this = InMapFile(file, info.st_size, SyncInterval);
+   }
+
+   if (NULL == this)
+   {
+      close(file);
+      return NULL;
+   }
+
+   return &this->VTable;
+}
+
+
+STATUS_CODE
+CPersistentListSync(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CPERSISTENT_LIST_IMPL);
+      status = InFlush(this);
+   } while (false);
+
+   return status;
+}
+
+
+void
+CPersistentListClose(
+   IN OPTIONAL CLIST* This)
+{
+   CPERSISTENT_LIST_IMPL* this = GET_STRUCT_FIELD(This, CPERSISTENT_LIST_IMPL, VTable);
+   if ((NULL == this) || (this->StructureId != CPERSISTENT_LIST_IMPL_STRUCT_ID)) { return; }
+
+   (void)InFlush(this);
+
+   this->StructureId = 0;
+   munmap(this->Base, this->MapSize);
+   close(this->File);
+   free(this);
+}
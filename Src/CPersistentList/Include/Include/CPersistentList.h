@@ -0,0 +1,101 @@
+/**
+ * @file     CPersistentList.h
+ * @brief    Doubly linked list kept in a memory-mapped file.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#ifndef  __CPERSISTENT_LIST_H__
+#define  __CPERSISTENT_LIST_H__
+
+#include "Include/CList.h"
+
+
+/** Version of the file layout used by CPersistentListOpen. */
+#define CPERSISTENT_LIST_VERSION 1U
+
+
+/**
+ * Opens the list stored in the file at Path. A new empty list is created
+ * if the file doesn't exist, is empty or has a header of zeros, as left by
+ * a crash during the creation.
+ *
+ * Nodes live in the mapped file itself, so opening costs the same for any
+ * number of nodes and changes need no separate save. Links and CLIST_NODE
+ * handles are offsets from the start of the file, so the file can be mapped
+ * at any address:
+ *    - Handles stay valid until their node is removed, also when the file
+ *      grows and is mapped again, and after the list is reopened;
+ *    - Pointers into the data are invalidated by any insertion, which may
+ *      grow the file. The Data passed to the list must not point into it;
+ *    - A node and its data take one block of the file. Blocks of removed
+ *      nodes are recycled through free lists stored in the file, grouped by
+ *      powers of 2 of their size. Blocks are never split or merged and the
+ *      file never shrinks; Clear makes the whole file free at once;
+ *    - The file grows by doubling, space is reserved with posix_fallocate,
+ *      so a full disk fails the insertion with SC_NOT_ENOUGH_MEMORY;
+ *    - GetRefToData links to a field of the list that points to the data,
+ *      the link is valid until the next call of GetRefToData. The data may
+ *      be modified in place, but *Data and *DataSize must not be changed;
+ *    - The Take methods copy the data in and out of the file, the buffers
+ *      are allocated and released with malloc and free;
+ *    - Data is aligned to 8 bytes, integers are in the byte order of the
+ *      host and files of the other byte order are rejected;
+ *    - PushFrontBatch, PushBackBatch, InsertAfterBatch, Splice, SplitAfter,
+ *      Append, Sort, SortParallel, ParallelForEach, ParallelReduce,
+ *      GetStats and Compact are not supported and are set to NULL.
+ *
+ * Changes reach the disk in batches. Every SyncInterval changes the list
+ * flushes the file with msync and waits for it; with SyncInterval 0 the
+ * file is flushed only by CPersistentListSync and CPersistentListClose.
+ * A failed flush after a change keeps the change, the next flush retries.
+ *
+ * The first change after a flush marks the file unsynced and waits until
+ * the mark is on the disk. Opening a file left unsynced, for example by a
+ * crash, walks all nodes and free blocks and rejects the file if a link is
+ * broken. A process crash between changes leaves a consistent file, changes
+ * not flushed before a system crash may be lost or leave a file that is
+ * rejected. Files closed cleanly are opened by their header alone.
+ *
+ * The file is locked with fcntl while it is open, a file open in another
+ * process is rejected. The list is not thread-safe.
+ *
+ * @param[in]  Path          Path of the file
+ * @param[in]  SyncInterval  Number of changes between flushes, 0 to flush
+ *                           only on request
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, or if the file is not a valid list of
+ *          CPERSISTENT_LIST_VERSION, returns a NULL pointer.
+ */
+CLIST*
+CPersistentListOpen(
+   IN const char* Path,
+   IN size_t      SyncInterval);
+
+
+/**
+ * Flushes all changes of the list to the disk and marks the file synced.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_UNSUCCESSFUL       The file can't be flushed
+ * @retval  SC_SUCCESS            On success
+ */
+STATUS_CODE
+CPersistentListSync(
+   IN CLIST* This);
+
+
+/**
+ * Flushes the list like CPersistentListSync, unmaps and closes the file
+ * and releases the list. Errors of the flush are not reported, call
+ * CPersistentListSync first to check them.
+ *
+ * @param[in]  This  Pointer to CList protocol. NULL is ignored.
+ */
+void
+CPersistentListClose(
+   IN OPTIONAL CLIST* This);
+
+#endif  // __CPERSISTENT_LIST_H__
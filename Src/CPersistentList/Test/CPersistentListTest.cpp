@@ -0,0 +1,460 @@
+/**
+ * @file  CPersistentListTest.cpp
+ * @brief Unit Tests for the list kept in a memory-mapped file
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+extern "C"
+{
+   #include "Include/CPersistentList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                       Helpers                         //
+///////////////////////////////////////////////////////////
+
+/** Data of one node: the first byte and the size. */
+typedef std::pair<unsigned char, size_t> Element;
+
+
+/** Offsets of the fields of the file header. */
+static const long g_EndOffset = 16;
+static const long g_UnsyncedOffset = 48;
+
+
+/** Pushes Count elements of 1..40 bytes filled with First + their index to the List. */
+static std::vector<Element> InFill(CLIST* List, size_t Count, size_t First = 0)
+{
+   std::vector<Element> elements;
+   for (size_t i = First; i < First + Count; ++i)
+   {
+      unsigned char data[40];
+      size_t dataSize = 1 + (i * 7) % sizeof(data);
+      memset(data, (int)i, dataSize);
+
+      EXPECT_FALSE(SC_ERROR(List->PushBack(List, data, dataSize)));
+      elements.push_back(Element((unsigned char)i, dataSize));
+   }
+
+   return elements;
+}
+
+
+/** Reads the elements of the List forward and checks that backward gives the same. */
+static std::vector<Element> InRead(CLIST* List)
+{
+   std::vector<Element> elements;
+   for (CLIST_NODE* position = List->Front(List);
+        position != NULL;
+        position = List->Next(List, position))
+   {
+      unsigned char data[64] = {};
+      size_t dataSize = 0;
+      EXPECT_FALSE(SC_ERROR(List->GetCopyDataInto(List, position, data, sizeof(data),
+                                                  &dataSize)));
+      for (size_t i = 1; i < dataSize; ++i) { EXPECT_EQ(data[0], data[i]); }
+      elements.push_back(Element(data[0], dataSize));
+   }
+
+   std::vector<Element> backward;
+   for (CLIST_NODE* position = List->Back(List);
+        position != NULL;
+        position = List->Prev(List, position))
+   {
+      unsigned char data[64] = {};
+      size_t dataSize = 0;
+      EXPECT_FALSE(SC_ERROR(List->GetCopyDataInto(List, position, data, sizeof(data),
+                                                  &dataSize)));
+      backward.insert(backward.begin(), Element(data[0], dataSize));
+   }
+   EXPECT_TRUE(elements == backward);
+
+   return elements;
+}
+
+
+/** Records the element in the std::vector<Element> Context. */
+static void InRecordElement(void* Data, size_t DataSize, void* Context)
+{
+   static_cast<std::vector<Element>*>(Context)->push_back(
+      Element(*(unsigned char*)Data, DataSize));
+}
+
+
+/** Reads the whole file at Path. */
+static std::vector<char> InReadFile(const std::string& Path)
+{
+   std::vector<char> content;
+   FILE* file = fopen(Path.c_str(), "rb");
+   EXPECT_FALSE(NULL == file);
+   if (NULL == file) { return content; }
+
+   char buffer[4096];
+   size_t read = 0;
+   while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+   {
+      content.insert(content.end(), buffer, buffer + read);
+   }
+   fclose(file);
+
+   return content;
+}
+
+
+/** Writes the Content into the file at Path. */
+static void InWriteFile(const std::string& Path, const std::vector<char>& Content)
+{
+   FILE* file = fopen(Path.c_str(), "wb");
+   ASSERT_FALSE(NULL == file);
+   ASSERT_EQ(Content.size(), fwrite(Content.data(), 1, Content.size(), file));
+   fclose(file);
+}
+
+
+/** Reads the 64-bit field at the Offset of the file at Path. */
+static uint64_t InReadField(const std::string& Path, long Offset)
+{
+   std::vector<char> content = InReadFile(Path);
+   uint64_t value = 0;
+   EXPECT_LE((size_t)Offset + sizeof(value), content.size());
+   if ((size_t)Offset + sizeof(value) <= content.size())
+   {
+      memcpy(&value, content.data() + Offset, sizeof(value));
+   }
+
+   return value;
+}
+
+
+///////////////////////////////////////////////////////////
+//               CPersistentList Fixtures                //
+///////////////////////////////////////////////////////////
+
+struct CPersistentListFile : public testing::Test
+{
+   std::string path;
+   CLIST* list = NULL;
+
+   // Per-test set-up
+   void SetUp() override
+   {
+      path = testing::TempDir() + "CPersistentListTest." +
+             testing::UnitTest::GetInstance()->current_test_info()->name();
+      remove(path.c_str());
+      list = CPersistentListOpen(path.c_str(), 0);
+      ASSERT_FALSE(list == NULL);
+   }
+
+   // Per-test tear-down
+   void TearDown() override
+   {
+      CPersistentListClose(list);
+      remove(path.c_str());
+   }
+
+   // Closes the list and opens the file again
+   void Reopen(size_t SyncInterval = 0)
+   {
+      CPersistentListClose(list);
+      list = CPersistentListOpen(path.c_str(), SyncInterval);
+      ASSERT_FALSE(list == NULL);
+   }
+};
+
+
+///////////////////////////////////////////////////////////
+//                       Tests                           //
+///////////////////////////////////////////////////////////
+
+TEST_F(CPersistentListFile, InvPrms)
+{
+   /*** Arrange ***/
+   unsigned char data[8] = {};
+   size_t dataSize = 0;
+   InFill(list, 1);
+   CLIST_NODE* front = list->Front(list);
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(NULL == CPersistentListOpen(NULL, 0));
+   EXPECT_TRUE(NULL == CPersistentListOpen((path + ".missing/list").c_str(), 0));
+   EXPECT_TRUE(SC_ERROR(CPersistentListSync(NULL)));
+   CPersistentListClose(NULL);
+
+   EXPECT_TRUE(SC_ERROR(list->PushBack(list, NULL, 1)));
+   EXPECT_TRUE(SC_ERROR(list->PushFront(list, data, 0)));
+   EXPECT_TRUE(SC_ERROR(list->InsertAfter(list, NULL, data, 1)));
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, (CLIST_NODE*)((char*)front + 8))));
+   EXPECT_TRUE(NULL == list->Next(list, (CLIST_NODE*)(uintptr_t)(1U << 30)));
+   EXPECT_TRUE(SC_ERROR(list->PopFrontTake(list, NULL, &dataSize)));
+   EXPECT_EQ(SC_BUFFER_TOO_SMALL, SC_CODE(list->GetCopyDataInto(list, front, data, 0,
+                                                                &dataSize)));
+   EXPECT_EQ(1U, list->Size(list));
+   EXPECT_TRUE(NULL == list->Sort);
+   EXPECT_TRUE(NULL == list->Splice);
+}
+
+
+TEST_F(CPersistentListFile, SurvivesReopen)
+{
+   /*** Arrange ***/
+   std::vector<Element> expected = InFill(list, 1000);
+   unsigned char data[4] = { 200, 200, 200, 200 };
+
+   CLIST_NODE* position = list->Front(list);
+   for (int i = 0; i < 10; ++i) { position = list->Next(list, position); }
+   ASSERT_FALSE(SC_ERROR(list->InsertBefore(list, position, data, sizeof(data))));
+   expected.insert(expected.begin() + 10, Element(200, sizeof(data)));
+
+   ASSERT_FALSE(SC_ERROR(list->Remove(list, list->Next(list, list->Front(list)))));
+   expected.erase(expected.begin() + 1);
+   list->PopBack(list);
+   expected.pop_back();
+
+   CLIST_NODE* back = list->Back(list);
+
+   /*** Act ***/
+   Reopen();
+
+   /*** Assert ***/
+   EXPECT_EQ(expected.size(), list->Size(list));
+   EXPECT_TRUE(expected == InRead(list));
+
+   // Handles are offsets, the same after the file is mapped again
+   EXPECT_EQ(back, list->Back(list));
+   EXPECT_EQ(position, list->Next(list, list->Prev(list, position)));
+}
+
+
+TEST_F(CPersistentListFile, ListMethods)
+{
+   /*** Arrange ***/
+   std::vector<Element> expected = InFill(list, 300);
+
+   /*** Act && Assert ***/
+   std::vector<Element> visited;
+   ASSERT_FALSE(SC_ERROR(list->ForEach(list, InRecordElement, &visited)));
+   EXPECT_TRUE(expected == visited);
+
+   // Data is read in place, aligned to 8 bytes
+   CLIST_NODE* position = list->Front(list);
+   CLIST_ITEM items[64] = {};
+   size_t count = 0;
+   visited.clear();
+   do
+   {
+      ASSERT_FALSE(SC_ERROR(list->NextBatch(list, &position, items, 64, &count)));
+      for (size_t i = 0; i < count; ++i)
+      {
+         EXPECT_EQ(0U, (uintptr_t)items[i].Data % 8);
+         InRecordElement(items[i].Data, items[i].DataSize, &visited);
+      }
+   } while (count > 0);
+   EXPECT_TRUE(expected == visited);
+
+   // The data may be changed in place
+   void** data = NULL;
+   size_t* dataSize = NULL;
+   ASSERT_FALSE(SC_ERROR(list->GetRefToData(list, list->Front(list), &data, &dataSize)));
+   EXPECT_EQ(expected.front().second, *dataSize);
+   memset(*data, 7, *dataSize);
+   expected.front().first = 7;
+
+   void* copy = NULL;
+   size_t copySize = 0;
+   ASSERT_FALSE(SC_ERROR(list->GetCopyData(list, list->Front(list), &copy, &copySize)));
+   EXPECT_EQ(0, memcmp(copy, *data, copySize));
+
+   ASSERT_FALSE(SC_ERROR(list->PushFrontTake(list, copy, copySize)));
+   expected.insert(expected.begin(), expected.front());
+
+   ASSERT_FALSE(SC_ERROR(list->PopBackTake(list, &copy, &copySize)));
+   EXPECT_EQ(expected.back().second, copySize);
+   EXPECT_EQ(expected.back().first, *(unsigned char*)copy);
+   expected.pop_back();
+   free(copy);
+
+   EXPECT_TRUE(expected == InRead(list));
+}
+
+
+TEST_F(CPersistentListFile, RecyclesRemovedBlocks)
+{
+   /*** Arrange ***/
+   InFill(list, 2000);
+   uint64_t end = InReadField(path, g_EndOffset);
+
+   /*** Act ***/
+   while (list->Size(list) > 0) { list->PopFront(list); }
+
+   // Elements of the smallest class fit any removed block
+   std::vector<Element> expected;
+   for (size_t i = 0; i < 2000; ++i)
+   {
+      unsigned char data[8];
+      memset(data, (int)i, sizeof(data));
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, data, sizeof(data))));
+      expected.push_back(Element((unsigned char)i, sizeof(data)));
+   }
+
+   /*** Assert ***/
+   EXPECT_EQ(end, InReadField(path, g_EndOffset));
+   EXPECT_TRUE(expected == InRead(list));
+
+   Reopen();
+   EXPECT_TRUE(expected == InRead(list));
+   list->PopFront(list);
+   InFill(list, 1);
+   EXPECT_EQ(end, InReadField(path, g_EndOffset));
+}
+
+
+TEST_F(CPersistentListFile, GrowsAndKeepsHandles)
+{
+   /*** Arrange ***/
+   std::vector<Element> expected = InFill(list, 1);
+   CLIST_NODE* front = list->Front(list);
+   size_t size = InReadFile(path).size();
+
+   /*** Act ***/
+   std::vector<Element> added = InFill(list, 8000, 1);
+   expected.insert(expected.end(), added.begin(), added.end());
+
+   /*** Assert ***/
+   EXPECT_LT(4 * size, InReadFile(path).size());
+   EXPECT_EQ(front, list->Front(list));
+
+   unsigned char data[64] = {};
+   size_t dataSize = 0;
+   ASSERT_FALSE(SC_ERROR(list->GetCopyDataInto(list, front, data, sizeof(data), &dataSize)));
+   EXPECT_EQ(expected.front(), Element(data[0], dataSize));
+
+   Reopen();
+   EXPECT_TRUE(expected == InRead(list));
+}
+
+
+TEST_F(CPersistentListFile, SyncInterval)
+{
+   /*** Arrange ***/
+   Reopen(4);
+   EXPECT_EQ(0U, InReadField(path, g_UnsyncedOffset));
+
+   /*** Act && Assert ***/
+   // The first change marks the file, every 4th change flushes it
+   InFill(list, 3);
+   EXPECT_EQ(1U, InReadField(path, g_UnsyncedOffset));
+   InFill(list, 1);
+   EXPECT_EQ(0U, InReadField(path, g_UnsyncedOffset));
+
+   // Without the interval only Sync flushes
+   Reopen(0);
+   InFill(list, 10);
+   EXPECT_EQ(1U, InReadField(path, g_UnsyncedOffset));
+   ASSERT_FALSE(SC_ERROR(CPersistentListSync(list)));
+   EXPECT_EQ(0U, InReadField(path, g_UnsyncedOffset));
+   EXPECT_EQ(14U, list->Size(list));
+}
+
+
+TEST_F(CPersistentListFile, UnsyncedFilesAreChecked)
+{
+   /*** Arrange ***/
+   // A copy of the open file is what a crash leaves
+   std::vector<Element> expected = InFill(list, 100);
+   list->PopFront(list);
+   expected.erase(expected.begin());
+   std::vector<char> content = InReadFile(path);
+   std::string copyPath = path + ".copy";
+   InWriteFile(copyPath, content);
+
+   /*** Act ***/
+   CLIST* copy = CPersistentListOpen(copyPath.c_str(), 0);
+
+   /*** Assert ***/
+   ASSERT_FALSE(NULL == copy);
+   EXPECT_TRUE(expected == InRead(copy));
+   CPersistentListClose(copy);
+
+   // A broken back link is found by the walk
+   uint64_t back = (uint64_t)(uintptr_t)list->Back(list);
+   uint64_t damaged = back + 8;
+   memcpy(content.data() + back + 8, &damaged, sizeof(damaged));
+   InWriteFile(copyPath, content);
+   EXPECT_TRUE(NULL == CPersistentListOpen(copyPath.c_str(), 0));
+
+   remove(copyPath.c_str());
+}
+
+
+TEST_F(CPersistentListFile, ClearFreesTheFile)
+{
+   /*** Arrange ***/
+   InFill(list, 500);
+   CLIST_NODE* back = list->Back(list);
+
+   /*** Act ***/
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+
+   /*** Assert ***/
+   EXPECT_EQ(0U, list->Size(list));
+   EXPECT_TRUE(NULL == list->Front(list));
+   EXPECT_TRUE(NULL == list->Next(list, back));
+
+   Reopen();
+   EXPECT_EQ(0U, list->Size(list));
+   std::vector<Element> expected = InFill(list, 10);
+   EXPECT_TRUE(expected == InRead(list));
+}
+
+
+TEST_F(CPersistentListFile, DamagedFilesAreRejected)
+{
+   /*** Arrange ***/
+   InFill(list, 10);
+   CPersistentListClose(list);
+   list = NULL;
+   std::vector<char> content = InReadFile(path);
+
+   /*** Act && Assert ***/
+   std::vector<char> damaged = content;
+   damaged[0] ^= 1;
+   InWriteFile(path, damaged);
+   EXPECT_TRUE(NULL == CPersistentListOpen(path.c_str(), 0));
+
+   damaged = content;
+   uint64_t end = (uint64_t)content.size() + 8;
+   memcpy(damaged.data() + g_EndOffset, &end, sizeof(end));
+   InWriteFile(path, damaged);
+   EXPECT_TRUE(NULL == CPersistentListOpen(path.c_str(), 0));
+
+   InWriteFile(path, std::vector<char>(content.begin(), content.begin() + 100));
+   EXPECT_TRUE(NULL == CPersistentListOpen(path.c_str(), 0));
+
+   // Files that aren't lists are not overwritten
+   InWriteFile(path, std::vector<char>(4096, 'x'));
+   EXPECT_TRUE(NULL == CPersistentListOpen(path.c_str(), 0));
+   EXPECT_TRUE(std::vector<char>(4096, 'x') == InReadFile(path));
+
+   InWriteFile(path, content);
+   list = CPersistentListOpen(path.c_str(), 0);
+   ASSERT_FALSE(NULL == list);
+   EXPECT_EQ(10U, list->Size(list));
+}
+
+
+int main(int argc, char** argv)
+{
+   ::testing::InitGoogleTest(&argc, argv);
+
+   return RUN_ALL_TESTS();
+}
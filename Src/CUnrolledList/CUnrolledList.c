@@ -0,0 +1,2042 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file     CUnrolledList.c
+ * @brief    Unrolled doubly linked list implementation.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Include/CUnrolledList.h"
+
+
+///////////////////////////////////////////////////////////
+///                 Internal structures                 ///
+///////////////////////////////////////////////////////////
+
+
+/** Data up to this size is stored in the slot itself. */
+#define CUNROLLED_SMALL_DATA_SIZE 16U
+
+
+/**
+ * Element of an unrolled list. CLIST_NODE handles point to slots. Small
+ * data is kept in the slot, so slots are moved with memmove and memcpy
+ * as they are and the data moves with them.
+ */
+typedef struct CUNROLLED_SLOT
+{
+   void*         Data;     /** Buffer of the data, NULL if it's in Small */
+   size_t        DataSize; /** Size of data stored in the slot */
+   unsigned char Small[CUNROLLED_SMALL_DATA_SIZE]; /** Data without a buffer */
+} CUNROLLED_SLOT;
+
+
+/** Number of slots ForEach prefetches the data buffers of ahead of the visited one. */
+#define CUNROLLED_PREFETCH_DISTANCE 8U
+
+/** Starts loading the cache line at Address, never faults. */
+#if defined(__GNUC__) || defined(__clang__)
+#define CUNROLLED_PREFETCH(Address) __builtin_prefetch(Address)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CUNROLLED_PREFETCH(Address) _mm_prefetch((const char*)(Address), _MM_HINT_T0)
+#else
+#define CUNROLLED_PREFETCH(Address) ((void)(Address))
+#endif
+
+
+/** Size and alignment of a block. Blocks are found by masking a slot address. */
+#define CUNROLLED_BLOCK_SIZE 2048U
+
+
+/** Number of slots in a block. */
+#define CUNROLLED_BLOCK_CAPACITY \
+   ((CUNROLLED_BLOCK_SIZE - 4 * sizeof(size_t)) / sizeof(CUNROLLED_SLOT))
+
+
+/** Block with up to CUNROLLED_BLOCK_CAPACITY elements in [Begin, End). */
+typedef struct CUNROLLED_BLOCK
+{
+   struct CUNROLLED_BLOCK* Prev;  /** Pointer to previous block   */
+   struct CUNROLLED_BLOCK* Next;  /** Pointer to next block       */
+   size_t                  Begin; /** Index of the first element  */
+   size_t                  End;   /** Index after the last element */
+   CUNROLLED_SLOT          Slots[CUNROLLED_BLOCK_CAPACITY]; /** Elements */
+} CUNROLLED_BLOCK;
+
+
+/** Unrolled list implementation of the CList protocol. */
+typedef struct CUNROLLED_LIST_IMPL
+{
+   STRUCT_ID StructureId; /** Structure unique id */
+   CLIST     VTable;      /** API                 */
+
+   CUNROLLED_BLOCK* Head; /** Pointer to the first block */
+   CUNROLLED_BLOCK* Tail; /** Pointer to the last block  */
+   size_t           Size; /** Number of elements         */
+} CUNROLLED_LIST_IMPL;
+
+
+/** Unique identificator for CUNROLLED_LIST_IMPL */
+#define CUNROLLED_LIST_IMPL_STRUCT_ID \
+   STRUCT_ID_64('C', 'U', 'N', 'R', 'O', 'L', 'L', '.')
+
+
+///////////////////////////////////////////////////////////
+///                 Internal functions                  ///
+///////////////////////////////////////////////////////////
+
+
+/**
+ * Returns the block that contains the Slot.
+ *
+ * @param[in]  Slot  Element slot
+ *
+ * @return  Block of the slot
+ */
+static
+CUNROLLED_BLOCK*
+InGetBlock(
+   IN CUNROLLED_SLOT* Slot)
+{
+   return (CUNROLLED_BLOCK*)((uintptr_t)Slot & ~(uintptr_t)(CUNROLLED_BLOCK_SIZE - 1));
+}
+
+
+/**
+ * Returns the data stored in the Slot.
+ *
+ * @param[in]  Slot  Element slot
+ *
+ * @return  Pointer to the data
+ */
+static
+void*
+InGetSlotData(
+   IN CUNROLLED_SLOT* Slot)
+{
+   return (Slot->Data != NULL) ? Slot->Data : Slot->Small;
+}
+
+
+/**
+ * Moves the data stored in the Slot itself into a malloc'ed buffer.
+ *
+ * @param[in]  Slot  Element slot
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InMoveDataOut(
+   IN CUNROLLED_SLOT* Slot)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      if (Slot->Data != NULL) { break; }
+
+      void* buffer = malloc(Slot->DataSize);
+      if (NULL == buffer) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(buffer, Slot->Small, Slot->DataSize);
+      Slot->Data = buffer;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the index of the Slot in its Block.
+ *
+ * @param[in]  Block  Block of the slot
+ * @param[in]  Slot   Element slot
+ *
+ * @return  Slot index
+ */
+static
+size_t
+InGetSlotIndex(
+   IN CUNROLLED_BLOCK* Block,
+   IN CUNROLLED_SLOT*  Slot)
+{
+   return (size_t)(Slot - Block->Slots);
+}
+
+
+/**
+ * Creates an empty block aligned to its size.
+ *
+ * @retval  CUNROLLED_BLOCK*  If the block is successfully created
+ * @retval  NULL              On failure
+ */
+static
+CUNROLLED_BLOCK*
+InCreateBlock()
+{
+#ifdef _WIN32
+   CUNROLLED_BLOCK* block = _aligned_malloc(CUNROLLED_BLOCK_SIZE, CUNROLLED_BLOCK_SIZE);
+#else
+   CUNROLLED_BLOCK* block = aligned_alloc(CUNROLLED_BLOCK_SIZE, CUNROLLED_BLOCK_SIZE);
+#endif
+   if (NULL == block) { return NULL; }
+
+   block->Prev = block->Next = NULL;
+   block->Begin = block->End = 0;
+
+   return block;
+}
+
+
+/**
+ * Releases a block. Data of the slots is not released.
+ *
+ * @param[in]  Block  Block to release
+ */
+static
+void
+InDeleteBlock(
+   IN CUNROLLED_BLOCK* Block)
+{
+#ifdef _WIN32
+   _aligned_free(Block);
+#else
+   free(Block);
+#endif
+}
+
+
+/**
+ * Links NewBlock after Block, or as the only block if Block is NULL.
+ *
+ * @param[in]  List      Unrolled list
+ * @param[in]  Block     Block in the list
+ * @param[in]  NewBlock  Block to link
+ */
+static
+void
+InLinkBlockAfter(
+   IN CUNROLLED_LIST_IMPL* List,
+   IN CUNROLLED_BLOCK*     Block,
+   IN CUNROLLED_BLOCK*     NewBlock)
+{
+   NewBlock->Prev = Block;
+   NewBlock->Next = (Block != NULL) ? Block->Next : NULL;
+
+   if (NewBlock->Next != NULL) { NewBlock->Next->Prev = NewBlock; }
+   else                        { List->Tail = NewBlock; }
+
+   if (Block != NULL) { Block->Next = NewBlock; }
+   else               { List->Head = NewBlock; }
+}
+
+
+/**
+ * Links NewBlock before Block.
+ *
+ * @param[in]  List      Unrolled list
+ * @param[in]  Block     Block in the list
+ * @param[in]  NewBlock  Block to link
+ */
+static
+void
+InLinkBlockBefore(
+   IN CUNROLLED_LIST_IMPL* List,
+   IN CUNROLLED_BLOCK*     Block,
+   IN CUNROLLED_BLOCK*     NewBlock)
+{
+   NewBlock->Next = Block;
+   NewBlock->Prev = Block->Prev;
+
+   if (NewBlock->Prev != NULL) { NewBlock->Prev->Next = NewBlock; }
+   else                        { List->Head = NewBlock; }
+
+   Block->Prev = NewBlock;
+}
+
+
+/**
+ * Unlinks and releases an empty Block.
+ *
+ * @param[in]  List   Unrolled list
+ * @param[in]  Block  Block to remove
+ */
+static
+void
+InRemoveBlock(
+   IN CUNROLLED_LIST_IMPL* List,
+   IN CUNROLLED_BLOCK*     Block)
+{
+   if (Block->Prev != NULL) { Block->Prev->Next = Block->Next; }
+   else                     { List->Head = Block->Next; }
+
+   if (Block->Next != NULL) { Block->Next->Prev = Block->Prev; }
+   else                     { List->Tail = Block->Prev; }
+
+   InDeleteBlock(Block);
+}
+
+
+/**
+ * Moves the elements of a small Block into its neighbour and releases it.
+ *
+ * @param[in]  List   Unrolled list
+ * @param[in]  Block  Block that lost an element
+ */
+static
+void
+InMergeBlock(
+   IN CUNROLLED_LIST_IMPL* List,
+   IN CUNROLLED_BLOCK*     Block)
+{
+   size_t count = Block->End - Block->Begin;
+
+   if (0 == count)
+   {
+      InRemoveBlock(List, Block);
+      return;
+   }
+
+   if (count > CUNROLLED_BLOCK_CAPACITY / 4) { return; }
+
+   CUNROLLED_BLOCK* next = Block->Next;
+   CUNROLLED_BLOCK* prev = Block->Prev;
+
+   if ((next != NULL) &&
+       (next->End - next->Begin + count <= CUNROLLED_BLOCK_CAPACITY))
+   {
+      // Make room at the beginning of the next block
+      if (next->Begin < count)
+      {
+         size_t shift = CUNROLLED_BLOCK_CAPACITY - next->End;
+         memmove(&next->Slots[next->Begin + shift],
+                 &next->Slots[next->Begin],
+                 (next->End - next->Begin) * sizeof(CUNROLLED_SLOT));
+         next->Begin += shift;
+         next->End += shift;
+      }
+
+      next->Begin -= count;
+      memcpy(&next->Slots[next->Begin],
+             &Block->Slots[Block->Begin],
+             count * sizeof(CUNROLLED_SLOT));
+   }
+   else if ((prev != NULL) &&
+            (prev->End - prev->Begin + count <= CUNROLLED_BLOCK_CAPACITY))
+   {
+      // Make room at the end of the previous block
+      if (CUNROLLED_BLOCK_CAPACITY - prev->End < count)
+      {
+         memmove(&prev->Slots[0],
+                 &prev->Slots[prev->Begin],
+                 (prev->End - prev->Begin) * sizeof(CUNROLLED_SLOT));
+         prev->End -= prev->Begin;
+         prev->Begin = 0;
+      }
+
+      memcpy(&prev->Slots[prev->End],
+             &Block->Slots[Block->Begin],
+             count * sizeof(CUNROLLED_SLOT));
+      prev->End += count;
+   }
+   else
+   {
+      return;
+   }
+
+   InRemoveBlock(List, Block);
+}
+
+
+/**
+ * Puts a new element right after the Index slot of the Block.
+ *
+ * @param[in]  List   Unrolled list
+ * @param[in]  Block  Block of the position
+ * @param[in]  Index  Index of the position
+ * @param[in]  Slot   New element
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InInsertAfter(
+   IN CUNROLLED_LIST_IMPL* List,
+   IN CUNROLLED_BLOCK*     Block,
+   IN size_t               Index,
+   IN CUNROLLED_SLOT       Slot)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      // Shift the elements after Index to the right
+      if (Block->End < CUNROLLED_BLOCK_CAPACITY)
+      {
+         memmove(&Block->Slots[Index + 2],
+                 &Block->Slots[Index + 1],
+                 (Block->End - Index - 1) * sizeof(CUNROLLED_SLOT));
+         Block->Slots[Index + 1] = Slot;
+         ++Block->End;
+         break;
+      }
+
+      // Split the block after Index
+      if (Index + 1 < Block->End)
+      {
+         CUNROLLED_BLOCK* newBlock = InCreateBlock();
+         if (NULL == newBlock) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+         newBlock->End = Block->End - Index - 1;
+         memcpy(&newBlock->Slots[0],
+                &Block->Slots[Index + 1],
+                newBlock->End * sizeof(CUNROLLED_SLOT));
+         InLinkBlockAfter(List, Block, newBlock);
+
+         Block->End = Index + 1;
+         Block->Slots[Block->End++] = Slot;
+         break;
+      }
+
+      // Index is the last slot of a full block
+      CUNROLLED_BLOCK* next = Block->Next;
+      if ((next != NULL) && (next->Begin > 0))
+      {
+         next->Slots[--next->Begin] = Slot;
+         break;
+      }
+
+      if ((next != NULL) && (next->End < CUNROLLED_BLOCK_CAPACITY))
+      {
+         memmove(&next->Slots[next->Begin + 1],
+                 &next->Slots[next->Begin],
+                 (next->End - next->Begin) * sizeof(CUNROLLED_SLOT));
+         next->Slots[next->Begin] = Slot;
+         ++next->End;
+         break;
+      }
+
+      CUNROLLED_BLOCK* newBlock = InCreateBlock();
+      if (NULL == newBlock) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      newBlock->Slots[newBlock->End++] = Slot;
+      InLinkBlockAfter(List, Block, newBlock);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Puts a new element right before the Index slot of the Block.
+ *
+ * @param[in]  List   Unrolled list
+ * @param[in]  Block  Block of the position
+ * @param[in]  Index  Index of the position
+ * @param[in]  Slot   New element
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InInsertBefore(
+   IN CUNROLLED_LIST_IMPL* List,
+   IN CUNROLLED_BLOCK*     Block,
+   IN size_t               Index,
+   IN CUNROLLED_SLOT       Slot)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      // Shift the elements before Index to the left
+      if (Block->Begin > 0)
+      {
+         memmove(&Block->Slots[Block->Begin - 1],
+                 &Block->Slots[Block->Begin],
+                 (Index - Block->Begin) * sizeof(CUNROLLED_SLOT));
+         --Block->Begin;
+         Block->Slots[Index - 1] = Slot;
+         break;
+      }
+
+      // Split the block before Index
+      if (Index > Block->Begin)
+      {
+         CUNROLLED_BLOCK* newBlock = InCreateBlock();
+         if (NULL == newBlock) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+         size_t count = Index - Block->Begin;
+         newBlock->Begin = CUNROLLED_BLOCK_CAPACITY - count;
+         newBlock->End = CUNROLLED_BLOCK_CAPACITY;
+         memcpy(&newBlock->Slots[newBlock->Begin],
+                &Block->Slots[Block->Begin],
+                count * sizeof(CUNROLLED_SLOT));
+         InLinkBlockBefore(List, Block, newBlock);
+
+         Block->Begin = Index;
+         Block->Slots[--Block->Begin] = Slot;
+         break;
+      }
+
+      // Index is the first slot of a block without room at the beginning
+      CUNROLLED_BLOCK* prev = Block->Prev;
+      if ((prev != NULL) && (prev->End < CUNROLLED_BLOCK_CAPACITY))
+      {
+         prev->Slots[prev->End++] = Slot;
+         break;
+      }
+
+      if ((prev != NULL) && (prev->Begin > 0))
+      {
+         memmove(&prev->Slots[prev->Begin - 1],
+                 &prev->Slots[prev->Begin],
+                 (prev->End - prev->Begin) * sizeof(CUNROLLED_SLOT));
+         --prev->Begin;
+         prev->Slots[prev->End - 1] = Slot;
+         break;
+      }
+
+      CUNROLLED_BLOCK* newBlock = InCreateBlock();
+      if (NULL == newBlock) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      newBlock->Begin = CUNROLLED_BLOCK_CAPACITY - 1;
+      newBlock->End = CUNROLLED_BLOCK_CAPACITY;
+      newBlock->Slots[newBlock->Begin] = Slot;
+      InLinkBlockBefore(List, Block, newBlock);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Makes a slot with a copy of the Data. Data up to CUNROLLED_SMALL_DATA_SIZE
+ * bytes is copied into the slot itself.
+ *
+ * @param[in]   Data      Data
+ * @param[in]   DataSize  Data size
+ * @param[out]  Slot      Slot to fill
+ *
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+InMakeSlot(
+   IN  void*           Data,
+   IN  size_t          DataSize,
+   OUT CUNROLLED_SLOT* Slot)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      Slot->DataSize = DataSize;
+
+      if (DataSize <= CUNROLLED_SMALL_DATA_SIZE)
+      {
+         Slot->Data = NULL;
+         memcpy(Slot->Small, Data, DataSize);
+         break;
+      }
+
+      Slot->Data = malloc(DataSize);
+      if (NULL == Slot->Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(Slot->Data, Data, DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Inserts a slot with the Data next to the Position.
+ *
+ * @param[in]  List      Unrolled list
+ * @param[in]  Position  Position in the list, NULL if the list is empty
+ * @param[in]  After     true to insert after Position, false to insert before
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ * @param[in]  TakeData  Adopt the Data buffer instead of copying it
+ *
+ * @retval  SC_UNSUCCESSFUL  Memory allocation error
+ * @retval  SC_SUCCESS       On success
+ */
+static
+STATUS_CODE
+InInsert(
+   IN CUNROLLED_LIST_IMPL* List,
+   IN CUNROLLED_SLOT*      Position,
+   IN bool                 After,
+   IN void*                Data,
+   IN size_t               DataSize,
+   IN bool                 TakeData)
+{
+   STATUS_CODE status = SC_SUCCESS;
+   CUNROLLED_SLOT slot = { Data, DataSize, { 0 } };
+
+   do
+   {
+      if (!TakeData)
+      {
+         status = InMakeSlot(Data, DataSize, &slot);
+         if (SC_ERROR(status)) { SET_SC(SC_UNSUCCESSFUL); break; }
+      }
+
+      if (NULL == Position)
+      {
+         CUNROLLED_BLOCK* block = InCreateBlock();
+         if (NULL == block)
+         {
+            if (!TakeData) { free(slot.Data); }
+            SET_SC(SC_UNSUCCESSFUL);
+            break;
+         }
+
+         // Leave room in the direction the list grows
+         block->Begin = After ? 0 : CUNROLLED_BLOCK_CAPACITY - 1;
+         block->End = block->Begin + 1;
+         block->Slots[block->Begin] = slot;
+         InLinkBlockAfter(List, NULL, block);
+      }
+      else
+      {
+         CUNROLLED_BLOCK* block = InGetBlock(Position);
+         size_t index = InGetSlotIndex(block, Position);
+
+         status = After ? InInsertAfter(List, block, index, slot) :
+                          InInsertBefore(List, block, index, slot);
+         if (SC_ERROR(status))
+         {
+            if (!TakeData) { free(slot.Data); }
+            SET_SC(SC_UNSUCCESSFUL);
+            break;
+         }
+      }
+
+      ++List->Size;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes and releases the element that follows the Position.
+ *
+ * Blocks are not merged, so the Position and the elements before it
+ * keep their slots.
+ *
+ * @param[in]  List      Unrolled list
+ * @param[in]  Position  Position in the list that has a next element
+ */
+static
+void
+InRemoveAfter(
+   IN CUNROLLED_LIST_IMPL* List,
+   IN CUNROLLED_SLOT*      Position)
+{
+   CUNROLLED_BLOCK* block = InGetBlock(Position);
+   size_t index = InGetSlotIndex(block, Position) + 1;
+
+   if (index == block->End)
+   {
+      block = block->Next;
+      index = block->Begin;
+   }
+
+   free(block->Slots[index].Data);
+   memmove(&block->Slots[index],
+           &block->Slots[index + 1],
+           (block->End - index - 1) * sizeof(CUNROLLED_SLOT));
+   --block->End;
+   --List->Size;
+
+   if (block->Begin == block->End) { InRemoveBlock(List, block); }
+}
+
+
+///////////////////////////////////////////////////////////
+///              CList API implementation               ///
+///////////////////////////////////////////////////////////
+
+/**
+ * Creates an element with a copy of the Data at the head of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CUnrolledListPushFront(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CUNROLLED_SLOT* head = (this->Head != NULL) ?
+                             &this->Head->Slots[this->Head->Begin] : NULL;
+
+      status = InInsert(this, head, false, Data, DataSize, false);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates an element with a copy of the Data at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CUnrolledListPushBack(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CUNROLLED_SLOT* tail = (this->Tail != NULL) ?
+                             &this->Tail->Slots[this->Tail->End - 1] : NULL;
+
+      status = InInsert(this, tail, true, Data, DataSize, false);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the first element in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  NULL         If This is invalid or the list is empty
+ * @retval  CLIST_NODE*  List head
+ */
+static
+CLIST_NODE*
+CUnrolledListFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == this->Head) { break; }
+
+      return (CLIST_NODE*)&this->Head->Slots[this->Head->Begin];
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the last element in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  NULL         If This is invalid or the list is empty
+ * @retval  CLIST_NODE*  List tail
+ */
+static
+CLIST_NODE*
+CUnrolledListBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == this->Tail) { break; }
+
+      return (CLIST_NODE*)&this->Tail->Slots[this->Tail->End - 1];
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Removes the first element in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CUnrolledListPopFront(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == this->Head) { break; }
+
+      CUNROLLED_BLOCK* head = this->Head;
+      free(head->Slots[head->Begin].Data);
+      ++head->Begin;
+      --this->Size;
+
+      InMergeBlock(this, head);
+
+   } while (false);
+}
+
+
+/**
+ * Removes the last element in the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ */
+static
+void
+CUnrolledListPopBack(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == this->Tail) { break; }
+
+      CUNROLLED_BLOCK* tail = this->Tail;
+      --tail->End;
+      free(tail->Slots[tail->End].Data);
+      --this->Size;
+
+      InMergeBlock(this, tail);
+
+   } while (false);
+}
+
+
+/**
+ * Removes the Position element from the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListRemove(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CUNROLLED_SLOT* slot = (CUNROLLED_SLOT*)Position;
+      CUNROLLED_BLOCK* block = InGetBlock(slot);
+      size_t index = InGetSlotIndex(block, slot);
+
+      free(slot->Data);
+      memmove(&block->Slots[index],
+              &block->Slots[index + 1],
+              (block->End - index - 1) * sizeof(CUNROLLED_SLOT));
+      --block->End;
+      --this->Size;
+
+      InMergeBlock(this, block);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes all elements and releases all blocks of the list.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListClear(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+
+      CUNROLLED_BLOCK* block = this->Head;
+      while (block != NULL)
+      {
+         CUNROLLED_BLOCK* next = block->Next;
+         for (size_t i = block->Begin; i < block->End; ++i)
+         {
+            free(block->Slots[i].Data);
+         }
+
+         InDeleteBlock(block);
+         block = next;
+      }
+
+      this->Head = this->Tail = NULL;
+      this->Size = 0;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the next element in the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  CLIST_NODE*  Next element
+ * @retval  NULL         If Invalid input parameter or there is no next element
+ */
+static
+CLIST_NODE*
+CUnrolledListNext(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CUNROLLED_SLOT* slot = (CUNROLLED_SLOT*)Position;
+      CUNROLLED_BLOCK* block = InGetBlock(slot);
+
+      if (InGetSlotIndex(block, slot) + 1 < block->End)
+      {
+         return (CLIST_NODE*)(slot + 1);
+      }
+
+      if (block->Next != NULL)
+      {
+         return (CLIST_NODE*)&block->Next->Slots[block->Next->Begin];
+      }
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Returns the previous element in the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  CLIST_NODE*  Previous element
+ * @retval  NULL         If Invalid input parameter or there is no previous element
+ */
+static
+CLIST_NODE*
+CUnrolledListPrev(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CUNROLLED_SLOT* slot = (CUNROLLED_SLOT*)Position;
+      CUNROLLED_BLOCK* block = InGetBlock(slot);
+
+      if (InGetSlotIndex(block, slot) > block->Begin)
+      {
+         return (CLIST_NODE*)(slot - 1);
+      }
+
+      if (block->Prev != NULL)
+      {
+         return (CLIST_NODE*)&block->Prev->Slots[block->Prev->End - 1];
+      }
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Gets a link to the data stored in the Position element.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Triple pointer to data
+ * @param[in]  DataSize  Pointer to pointer to data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  No memory for the buffer of small data
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListGetRefToData(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void***     Data,
+   IN size_t**    DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // The link can replace the buffer, so small data gets one first
+      CUNROLLED_SLOT* slot = (CUNROLLED_SLOT*)Position;
+      status = InMoveDataOut(slot);
+      if (SC_ERROR(status)) { break; }
+
+      *Data = &slot->Data;
+      *DataSize = &slot->DataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Gets a copy of the data stored in the Position element.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[in]   Position  Position in the list
+ * @param[out]  Data      Data
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListGetCopyData(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   OUT void**     Data,
+   OUT size_t*    DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CUNROLLED_SLOT* slot = (CUNROLLED_SLOT*)Position;
+
+      *Data = malloc(slot->DataSize);
+      if (NULL == *Data) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      memcpy(*Data, InGetSlotData(slot), slot->DataSize);
+      *DataSize = slot->DataSize;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates an element with a copy of the Data before Position element.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       Otherwise
+ */
+static
+STATUS_CODE
+CUnrolledListInsertBefore(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Data,
+   IN size_t      DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, (CUNROLLED_SLOT*)Position, false, Data, DataSize, false);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates an element with a copy of the Data after Position element.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Data      Data
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       Otherwise
+ */
+static
+STATUS_CODE
+CUnrolledListInsertAfter(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Data,
+   IN size_t      DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      status = InInsert(this, (CUNROLLED_SLOT*)Position, true, Data, DataSize, false);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Returns the number of elements.
+ *
+ * @param[in]  This  Pointer to CList protocol
+ *
+ * @return  Number of elements. If This is invalid then returns 0.
+ */
+static
+size_t
+CUnrolledListSize(
+   IN CLIST* This)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      return this->Size;
+   } while (false);
+
+   return 0;
+}
+
+
+/**
+ * Creates an element that adopts the malloc'ed Data buffer at the head.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data buffer
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CUnrolledListPushFrontTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CUNROLLED_SLOT* head = (this->Head != NULL) ?
+                             &this->Head->Slots[this->Head->Begin] : NULL;
+
+      status = InInsert(this, head, false, Data, DataSize, true);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates an element that adopts the malloc'ed Data buffer at the end.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Data      Data buffer
+ * @param[in]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CUnrolledListPushBackTake(
+   IN CLIST* This,
+   IN void*  Data,
+   IN size_t DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Data) || (0 == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CUNROLLED_SLOT* tail = (this->Tail != NULL) ?
+                             &this->Tail->Slots[this->Tail->End - 1] : NULL;
+
+      status = InInsert(this, tail, true, Data, DataSize, true);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the first element and hands its malloc'ed buffer to the caller.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListPopFrontTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (NULL == this->Head) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      CUNROLLED_BLOCK* head = this->Head;
+      status = InMoveDataOut(&head->Slots[head->Begin]);
+      if (SC_ERROR(status)) { break; }
+
+      *Data = head->Slots[head->Begin].Data;
+      *DataSize = head->Slots[head->Begin].DataSize;
+      ++head->Begin;
+      --this->Size;
+
+      InMergeBlock(this, head);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Removes the last element and hands its malloc'ed buffer to the caller.
+ *
+ * @param[in]   This      Pointer to CList protocol
+ * @param[out]  Data      Data buffer
+ * @param[out]  DataSize  Data size
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error
+ * @retval  SC_UNSUCCESSFUL       The list is empty
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListPopBackTake(
+   IN  CLIST*  This,
+   OUT void**  Data,
+   OUT size_t* DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Data) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (NULL == this->Tail) { SET_SC(SC_UNSUCCESSFUL); break; }
+
+      CUNROLLED_BLOCK* tail = this->Tail;
+      status = InMoveDataOut(&tail->Slots[tail->End - 1]);
+      if (SC_ERROR(status)) { break; }
+
+      --tail->End;
+      *Data = tail->Slots[tail->End].Data;
+      *DataSize = tail->Slots[tail->End].DataSize;
+      --this->Size;
+
+      InMergeBlock(this, tail);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Copies the data stored in the Position element into the caller's Buffer.
+ *
+ * @param[in]   This        Pointer to CList protocol
+ * @param[in]   Position    Position in the list
+ * @param[out]  Buffer      Buffer for the data
+ * @param[in]   BufferSize  Buffer size
+ * @param[out]  DataSize    Data size, also set if the buffer is too small
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_BUFFER_TOO_SMALL   BufferSize is less than the data size
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListGetCopyDataInto(
+   IN  CLIST*      This,
+   IN  CLIST_NODE* Position,
+   OUT void*       Buffer,
+   IN  size_t      BufferSize,
+   OUT size_t*     DataSize)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Position) || (NULL == DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      CUNROLLED_SLOT* slot = (CUNROLLED_SLOT*)Position;
+
+      *DataSize = slot->DataSize;
+      if ((NULL == Buffer) || (BufferSize < slot->DataSize))
+      {
+         SET_SC(SC_BUFFER_TOO_SMALL);
+         break;
+      }
+
+      memcpy(Buffer, InGetSlotData(slot), slot->DataSize);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates elements with copies of Count records at the head of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CUnrolledListPushFrontBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Records) || (0 == DataSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // Push in reverse so that the records keep their order
+      char* record = (char*)Records + Count * Stride;
+      size_t pushed = 0;
+      for (; pushed < Count; ++pushed)
+      {
+         record -= Stride;
+
+         CUNROLLED_SLOT* head = (this->Head != NULL) ?
+                                &this->Head->Slots[this->Head->Begin] : NULL;
+
+         status = InInsert(this, head, false, record, DataSize, false);
+         if (SC_ERROR(status)) { break; }
+      }
+
+      if (SC_ERROR(status))
+      {
+         while (pushed-- > 0) { CUnrolledListPopFront(This); }
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates elements with copies of Count records at the end of the list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CUnrolledListPushBackBatch(
+   IN CLIST* This,
+   IN void*  Records,
+   IN size_t DataSize,
+   IN size_t Stride,
+   IN size_t Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Records) || (0 == DataSize) || (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      char* record = Records;
+      size_t pushed = 0;
+      for (; pushed < Count; ++pushed, record += Stride)
+      {
+         CUNROLLED_SLOT* tail = (this->Tail != NULL) ?
+                                &this->Tail->Slots[this->Tail->End - 1] : NULL;
+
+         status = InInsert(this, tail, true, record, DataSize, false);
+         if (SC_ERROR(status)) { break; }
+      }
+
+      if (SC_ERROR(status))
+      {
+         while (pushed-- > 0) { CUnrolledListPopBack(This); }
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Creates elements with copies of Count records after Position element.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ * @param[in]  Records   Array of records
+ * @param[in]  DataSize  Size of one record
+ * @param[in]  Stride    Distance between records, not less than DataSize
+ * @param[in]  Count     Number of records
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ * @retval  SC_UNSUCCESSFUL       On failure
+ */
+static
+STATUS_CODE
+CUnrolledListInsertAfterBatch(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position,
+   IN void*       Records,
+   IN size_t      DataSize,
+   IN size_t      Stride,
+   IN size_t      Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Records) || (0 == DataSize) ||
+          (Stride < DataSize))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      // Insertion keeps Position in place, so insert in reverse right after it
+      CUNROLLED_SLOT* position = (CUNROLLED_SLOT*)Position;
+      char* record = (char*)Records + Count * Stride;
+      size_t inserted = 0;
+      for (; inserted < Count; ++inserted)
+      {
+         record -= Stride;
+
+         status = InInsert(this, position, true, record, DataSize, false);
+         if (SC_ERROR(status)) { break; }
+      }
+
+      if (SC_ERROR(status))
+      {
+         while (inserted-- > 0) { InRemoveAfter(this, position); }
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Moves the elements after Position element into a new unrolled list.
+ *
+ * @param[in]  This      Pointer to CList protocol
+ * @param[in]  Position  Position in the list
+ *
+ * @retval  CLIST*  New list with the elements after Position
+ * @retval  NULL    If Invalid input parameter or on failure
+ */
+static
+CLIST*
+CUnrolledListSplitAfter(
+   IN CLIST*      This,
+   IN CLIST_NODE* Position)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == Position) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      CLIST* list = CUnrolledListCreate();
+      if (NULL == list) { break; }
+
+      CUNROLLED_LIST_IMPL* other = GET_STRUCT_FIELD(list, CUNROLLED_LIST_IMPL, VTable);
+      CUNROLLED_BLOCK* block = InGetBlock((CUNROLLED_SLOT*)Position);
+      size_t index = InGetSlotIndex(block, (CUNROLLED_SLOT*)Position);
+
+      // Move the rest of the Position block into a block of its own
+      if (index + 1 < block->End)
+      {
+         CUNROLLED_BLOCK* newBlock = InCreateBlock();
+         if (NULL == newBlock)
+         {
+            free(other);
+            break;
+         }
+
+         newBlock->End = block->End - index - 1;
+         memcpy(&newBlock->Slots[0],
+                &block->Slots[index + 1],
+                newBlock->End * sizeof(CUNROLLED_SLOT));
+         block->End = index + 1;
+         InLinkBlockAfter(this, block, newBlock);
+      }
+
+      if (NULL == block->Next) { return list; }
+
+      // Whole blocks change the list without moving their elements
+      size_t count = 0;
+      for (CUNROLLED_BLOCK* next = block->Next; next != NULL; next = next->Next)
+      {
+         count += next->End - next->Begin;
+      }
+
+      other->Head = block->Next;
+      other->Tail = this->Tail;
+      other->Size = count;
+      other->Head->Prev = NULL;
+
+      block->Next = NULL;
+      this->Tail = block;
+      this->Size -= count;
+
+      return list;
+
+   } while (false);
+
+   return NULL;
+}
+
+
+/**
+ * Moves all elements of the Other unrolled list to the end of This list.
+ *
+ * @param[in]  This   Pointer to CList protocol
+ * @param[in]  Other  Unrolled list to empty into This
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListAppend(
+   IN CLIST* This,
+   IN CLIST* Other)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      CUNROLLED_LIST_IMPL* other = GET_STRUCT_FIELD(Other, CUNROLLED_LIST_IMPL, VTable);
+      if ((NULL == other) ||
+          (other->StructureId != CUNROLLED_LIST_IMPL_STRUCT_ID) ||
+          (other == this))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      if (NULL == other->Head) { break; }
+
+      // Blocks are relinked, so the handles of all elements stay valid
+      if (this->Tail != NULL) { this->Tail->Next = other->Head; }
+      else                    { this->Head = other->Head; }
+
+      other->Head->Prev = this->Tail;
+      this->Tail = other->Tail;
+      this->Size += other->Size;
+
+      other->Head = other->Tail = NULL;
+      other->Size = 0;
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Sorts the elements in ascending order defined by the Comparator.
+ *
+ * @param[in]  This        Pointer to CList protocol
+ * @param[in]  Comparator  Comparator of the element data
+ * @param[in]  Context     Context for the Comparator, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_NOT_ENOUGH_MEMORY  Memory allocation error, the list is unchanged
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListSort(
+   IN          CLIST*           This,
+   IN          CLIST_COMPARATOR Comparator,
+   IN OPTIONAL void*            Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == Comparator) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      size_t size = this->Size;
+      if (size < 2) { break; }
+
+      CUNROLLED_SLOT* slots = malloc(2 * size * sizeof(CUNROLLED_SLOT));
+      if (NULL == slots) { SET_SC(SC_NOT_ENOUGH_MEMORY); break; }
+
+      size_t count = 0;
+      for (CUNROLLED_BLOCK* block = this->Head; block != NULL; block = block->Next)
+      {
+         memcpy(&slots[count],
+                &block->Slots[block->Begin],
+                (block->End - block->Begin) * sizeof(CUNROLLED_SLOT));
+         count += block->End - block->Begin;
+      }
+
+      // Bottom-up merge sort, the left run wins among equivalent elements
+      CUNROLLED_SLOT* from = slots;
+      CUNROLLED_SLOT* to = slots + size;
+      for (size_t width = 1; width < size; width *= 2)
+      {
+         for (size_t begin = 0; begin < size; begin += 2 * width)
+         {
+            size_t middle = (begin + width < size) ? begin + width : size;
+            size_t end = (begin + 2 * width < size) ? begin + 2 * width : size;
+            size_t left = begin;
+            size_t right = middle;
+
+            for (size_t i = begin; i < end; ++i)
+            {
+               if ((left < middle) &&
+                   ((right >= end) ||
+                    (Comparator(InGetSlotData(&from[right]), from[right].DataSize,
+                                InGetSlotData(&from[left]), from[left].DataSize,
+                                Context) >= 0)))
+               {
+                  to[i] = from[left++];
+               }
+               else
+               {
+                  to[i] = from[right++];
+               }
+            }
+         }
+
+         CUNROLLED_SLOT* swap = from;
+         from = to;
+         to = swap;
+      }
+
+      count = 0;
+      for (CUNROLLED_BLOCK* block = this->Head; block != NULL; block = block->Next)
+      {
+         memcpy(&block->Slots[block->Begin],
+                &from[count],
+                (block->End - block->Begin) * sizeof(CUNROLLED_SLOT));
+         count += block->End - block->Begin;
+      }
+
+      free(slots);
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Calls the Visitor for the data of every element in list order.
+ *
+ * @param[in]  This     Pointer to CList protocol
+ * @param[in]  Visitor  Function called for every element
+ * @param[in]  Context  Context for the Visitor, may be NULL
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListForEach(
+   IN          CLIST*        This,
+   IN          CLIST_VISITOR Visitor,
+   IN OPTIONAL void*         Context)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if (NULL == Visitor) { SET_SC(SC_INVALID_PARAMETER); break; }
+
+      for (CUNROLLED_BLOCK* block = this->Head; block != NULL; block = block->Next)
+      {
+         // Slots of a block are contiguous, only the next block and the
+         // buffers of big data are away from the visited slot
+         if (block->Next != NULL)
+         {
+            CUNROLLED_PREFETCH(block->Next);
+            CUNROLLED_PREFETCH(&block->Next->Slots[block->Next->Begin]);
+         }
+
+         for (size_t i = block->Begin; i < block->End; ++i)
+         {
+            size_t ahead = i + CUNROLLED_PREFETCH_DISTANCE;
+            if ((ahead < block->End) && (block->Slots[ahead].Data != NULL))
+            {
+               CUNROLLED_PREFETCH(block->Slots[ahead].Data);
+            }
+
+            CUNROLLED_SLOT* slot = &block->Slots[i];
+            Visitor(InGetSlotData(slot), slot->DataSize, Context);
+         }
+      }
+
+   } while (false);
+
+   return status;
+}
+
+
+/**
+ * Reads the data of up to Capacity elements starting from *Position.
+ *
+ * @param[in]      This      Pointer to CList protocol
+ * @param[in,out]  Position  First element to read, the element after the
+ *                           last read one on output
+ * @param[out]     Items     Array of Capacity items
+ * @param[in]      Capacity  Maximum number of elements to read
+ * @param[out]     Count     Number of read elements
+ *
+ * @retval  SC_INVALID_PARAMETER  Invalid input parameter
+ * @retval  SC_SUCCESS            On success
+ */
+static
+STATUS_CODE
+CUnrolledListNextBatch(
+   IN     CLIST*       This,
+   IN OUT CLIST_NODE** Position,
+   OUT    CLIST_ITEM*  Items,
+   IN     size_t       Capacity,
+   OUT    size_t*      Count)
+{
+   STATUS_CODE status = SC_SUCCESS;
+
+   do
+   {
+      GET_THIS(This, CUNROLLED_LIST_IMPL);
+      if ((NULL == Position) || (NULL == Items) || (0 == Capacity) || (NULL == Count))
+      {
+         SET_SC(SC_INVALID_PARAMETER);
+         break;
+      }
+
+      size_t count = 0;
+      CUNROLLED_SLOT* slot = (CUNROLLED_SLOT*)*Position;
+      if (NULL == slot)
+      {
+         *Count = 0;
+         break;
+      }
+
+      // The slots are read a block at a time, the buffers of big data are
+      // loading while the rest of the batch is collected and processed
+      CUNROLLED_BLOCK* block = InGetBlock(slot);
+      size_t i = InGetSlotIndex(block, slot);
+      while ((block != NULL) && (count < Capacity))
+      {
+         for (; (i < block->End) && (count < Capacity); ++i, ++count)
+         {
+            slot = &block->Slots[i];
+            if (slot->Data != NULL) { CUNROLLED_PREFETCH(slot->Data); }
+
+            Items[count].Data = InGetSlotData(slot);
+            Items[count].DataSize = slot->DataSize;
+         }
+
+         if (i < block->End) { break; }
+
+         block = block->Next;
+         if (block != NULL)
+         {
+            CUNROLLED_PREFETCH(block->Next);
+            i = block->Begin;
+         }
+      }
+
+      *Position = (block != NULL) ? (CLIST_NODE*)&block->Slots[i] : NULL;
+      *Count = count;
+
+   } while (false);
+
+   return status;
+}
+
+
+CLIST*
+CUnrolledListCreate()
+{
+   CUNROLLED_LIST_IMPL* this = malloc(sizeof(CUNROLLED_LIST_IMPL));
+   if (NULL == this) { return NULL; }
+
+   this->StructureId = CUNROLLED_LIST_IMPL_STRUCT_ID;
+   this->Head = this->Tail = NULL;
+   this->Size = 0;
+
+   this->VTable.PushFront    = CUnrolledListPushFront;
+   this->VTable.PushBack     = CUnrolledListPushBack;
+   this->VTable.Front        = CUnrolledListFront;
+   this->VTable.Back         = CUnrolledListBack;
+   this->VTable.PopFront     = CUnrolledListPopFront;
+   this->VTable.PopBack      = CUnrolledListPopBack;
+   this->VTable.Next         = CUnrolledListNext;
+   this->VTable.Prev         = CUnrolledListPrev;
+   this->VTable.GetRefToData = CUnrolledListGetRefToData;
+   this->VTable.GetCopyData  = CUnrolledListGetCopyData;
+   this->VTable.InsertBefore = CUnrolledListInsertBefore;
+   this->VTable.InsertAfter  = CUnrolledListInsertAfter;
+   this->VTable.Size         = CUnrolledListSize;
+   this->VTable.Remove       = CUnrolledListRemove;
+   this->VTable.Clear        = CUnrolledListClear;
+
+   this->VTable.PushFrontTake   = CUnrolledListPushFrontTake;
+   this->VTable.PushBackTake    = CUnrolledListPushBackTake;
+   this->VTable.PopFrontTake    = CUnrolledListPopFrontTake;
+   this->VTable.PopBackTake     = CUnrolledListPopBackTake;
+   this->VTable.GetCopyDataInto = CUnrolledListGetCopyDataInto;
+
+   this->VTable.PushFrontBatch   = CUnrolledListPushFrontBatch;
+   this->VTable.PushBackBatch    = CUnrolledListPushBackBatch;
+   this->VTable.InsertAfterBatch = CUnrolledListInsertAfterBatch;
+
+   this->VTable.Splice     = NULL;
+   this->VTable.SplitAfter = CUnrolledListSplitAfter;
+   this->VTable.Append     = CUnrolledListAppend;
+
+   this->VTable.Sort         = CUnrolledListSort;
+   this->VTable.SortParallel = NULL;
+
+   this->VTable.ForEach   = CUnrolledListForEach;
+   this->VTable.NextBatch = CUnrolledListNextBatch;
+
+   this->VTable.ParallelForEach = NULL;
+   this->VTable.ParallelReduce  = NULL;
+
+   this->VTable.GetStats = NULL;
+
+   this->VTable.Compact = NULL;
+
+   return &this->VTable;
+}
+
+
+void
+CUnrolledListDelete(
+   IN OPTIONAL CLIST* This)
+{
+   CUNROLLED_LIST_IMPL* this = GET_STRUCT_FIELD(This, CUNROLLED_LIST_IMPL, VTable);
+   if ((NULL == this) || (this->StructureId != CUNROLLED_LIST_IMPL_STRUCT_ID)) { return; }
+
+   CUnrolledListClear(This);
+
+   this->StructureId = 0;
+   free(this);
+}
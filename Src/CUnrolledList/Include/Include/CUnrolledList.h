@@ -0,0 +1,51 @@
+/**
+ * @file     CUnrolledList.h
+ * @brief    Unrolled doubly linked list implementation of the CList protocol.
+ * @ingroup  DATA_STRUCTURES
+ */
+
+#ifndef  __CUNROLLED_LIST_H__
+#define  __CUNROLLED_LIST_H__
+
+#include "Include/CList.h"
+
+
+/**
+ * Creates an unrolled doubly linked list that implements the CList protocol.
+ *
+ * Elements are stored many per block, so traversal with Next/Prev walks
+ * contiguous memory. Data up to 16 bytes is stored in the element slot
+ * itself; bigger data, and buffers adopted by PushFrontTake and
+ * PushBackTake, live in malloc'ed buffers that a scan reaches through one
+ * pointer per element. GetRefToData and the Pop*Take methods first move
+ * small data into a buffer of its own. CLIST_NODE handles point to element
+ * slots of a block:
+ *    - The Position passed to InsertBefore/InsertAfter stays valid;
+ *    - InsertBefore, InsertAfter, PopFront, PopBack and Remove may move
+ *      other elements of the affected block and its neighbours, which
+ *      invalidates their handles;
+ *    - Append relinks whole blocks and keeps all handles valid, SplitAfter
+ *      moves the elements after Position in its block;
+ *    - Sort moves the data between slots and needs a temporary array of
+ *      all elements;
+ *    - ForEach and NextBatch walk the slots of each block in place;
+ *    - Splice, SortParallel, ParallelForEach, ParallelReduce, GetStats and
+ *      Compact are not supported and are set to NULL.
+ *
+ * @return  On success, returns the pointer to doubly linked list protocol.
+ *          On failure, returns a NULL pointer.
+ */
+CLIST*
+CUnrolledListCreate();
+
+
+/**
+ * Releases the list created by CUnrolledListCreate, its blocks and data.
+ *
+ * @param[in]  This  Pointer to CList protocol. NULL is ignored.
+ */
+void
+CUnrolledListDelete(
+   IN OPTIONAL CLIST* This);
+
+#endif  // __CUNROLLED_LIST_H__
@@ -0,0 +1,631 @@
+/**
+ * @file  CUnrolledListTest.cpp
+ * @brief Unit Tests for the unrolled CLIST implementation
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <random>
+
+extern "C"
+{
+   #include "Include/CUnrolledList.h"
+}
+
+
+///////////////////////////////////////////////////////////
+//                       Helpers                         //
+///////////////////////////////////////////////////////////
+
+/** Checks that the list holds the same values as the model in both directions. */
+static void InExpectEqual(CLIST* List, const std::list<size_t>& Model)
+{
+   ASSERT_TRUE(Model.size() == List->Size(List));
+
+   CLIST_NODE* position = List->Front(List);
+   for (size_t expected : Model)
+   {
+      ASSERT_TRUE(NULL != position);
+
+      size_t data = 0;
+      size_t dataSize = 0;
+      ASSERT_FALSE(SC_ERROR(List->GetCopyDataInto(List, position, &data,
+                                                  sizeof(data), &dataSize)));
+      ASSERT_TRUE(sizeof(size_t) == dataSize);
+      ASSERT_TRUE(expected == data);
+
+      position = List->Next(List, position);
+   }
+   ASSERT_TRUE(NULL == position);
+
+   position = List->Back(List);
+   for (auto it = Model.rbegin(); it != Model.rend(); ++it)
+   {
+      ASSERT_TRUE(NULL != position);
+
+      void** data = NULL;
+      size_t* dataSize = NULL;
+      ASSERT_FALSE(SC_ERROR(List->GetRefToData(List, position, &data, &dataSize)));
+      ASSERT_TRUE(*it == **((size_t**)data));
+
+      position = List->Prev(List, position);
+   }
+   ASSERT_TRUE(NULL == position);
+}
+
+
+///////////////////////////////////////////////////////////
+//                  CUnrolledList Fixtures               //
+///////////////////////////////////////////////////////////
+
+struct CUnrolledListEmpty : public testing::Test
+{
+   CLIST* list = NULL;
+
+   // Per-test set-up
+   void SetUp() override
+   {
+      list = CUnrolledListCreate();
+      ASSERT_FALSE(list == NULL);
+   }
+
+   // Per-test tear-down
+   void TearDown() override
+   {
+      CUnrolledListDelete(list);
+   }
+};
+
+
+///////////////////////////////////////////////////////////
+//                       Tests                           //
+///////////////////////////////////////////////////////////
+
+TEST_F(CUnrolledListEmpty, InvPrms)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   size_t data = 25;
+
+   /*** Act && Assert ***/
+   status = list->PushFront(NULL, &data, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->PushBack(list, NULL, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->PushBack(list, &data, 0);
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->InsertAfter(list, NULL, &data, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+   status = list->InsertBefore(list, NULL, &data, sizeof(size_t));
+   EXPECT_TRUE(SC_ERROR(status));
+
+   EXPECT_TRUE(NULL == list->Front(list));
+   EXPECT_TRUE(NULL == list->Back(list));
+   EXPECT_TRUE(0 == list->Size(list));
+}
+
+
+TEST_F(CUnrolledListEmpty, PushAndPop)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+
+   /*** Act && Assert ***/
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      model.push_back(i);
+
+      size_t front = i + 100000;
+      ASSERT_FALSE(SC_ERROR(list->PushFront(list, &front, sizeof(size_t))));
+      model.push_front(front);
+   }
+   InExpectEqual(list, model);
+
+   for (size_t i = 0; i < 700; ++i)
+   {
+      list->PopFront(list);
+      model.pop_front();
+      list->PopBack(list);
+      model.pop_back();
+   }
+   InExpectEqual(list, model);
+
+   while (!model.empty())
+   {
+      list->PopFront(list);
+      model.pop_front();
+   }
+   InExpectEqual(list, model);
+   list->PopFront(list);
+   list->PopBack(list);
+   EXPECT_TRUE(0 == list->Size(list));
+}
+
+
+TEST_F(CUnrolledListEmpty, InsertKeepsPosition)
+{
+   /*** Arrange ***/
+   size_t data = 0;
+   ASSERT_FALSE(SC_ERROR(list->PushFront(list, &data, sizeof(size_t))));
+
+   /*** Act && Assert ***/
+   // Same pattern as with CList: the position stays valid after insertion
+   CLIST_NODE* position = list->Front(list);
+   while (data++ != 500)
+   {
+      ASSERT_FALSE(SC_ERROR(list->InsertAfter(list, position, &data, sizeof(size_t))));
+      position = list->Next(list, position);
+      ASSERT_FALSE(NULL == position);
+   }
+
+   position = list->Back(list);
+   while (data++ != 1000)
+   {
+      ASSERT_FALSE(SC_ERROR(list->InsertBefore(list, position, &data, sizeof(size_t))));
+      position = list->Prev(list, position);
+      ASSERT_FALSE(NULL == position);
+   }
+
+   std::list<size_t> model;
+   for (size_t i = 0; i < 500; ++i) { model.push_back(i); }
+   for (size_t i = 1000; i > 501; --i) { model.push_back(i); }
+   model.push_back(500);
+
+   InExpectEqual(list, model);
+}
+
+
+TEST_F(CUnrolledListEmpty, RandomOperations)
+{
+   /*** Arrange ***/
+   std::mt19937 generator(25);
+   std::list<size_t> model;
+
+   /*** Act && Assert ***/
+   for (size_t i = 0; i < 20000; ++i)
+   {
+      size_t operation = generator() % 6;
+
+      if (model.empty() || operation == 0)
+      {
+         ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+         model.push_back(i);
+         continue;
+      }
+
+      // Walk to a random position in both containers
+      size_t index = generator() % model.size();
+      auto it = std::next(model.begin(), index);
+      CLIST_NODE* position = list->Front(list);
+      for (size_t j = 0; j < index; ++j) { position = list->Next(list, position); }
+
+      switch (operation)
+      {
+      case 1:
+      {
+         ASSERT_FALSE(SC_ERROR(list->PushFront(list, &i, sizeof(size_t))));
+         model.push_front(i);
+         break;
+      }
+      case 2:
+      {
+         ASSERT_FALSE(SC_ERROR(list->InsertAfter(list, position, &i, sizeof(size_t))));
+         model.insert(std::next(it), i);
+         break;
+      }
+      case 3:
+      {
+         ASSERT_FALSE(SC_ERROR(list->InsertBefore(list, position, &i, sizeof(size_t))));
+         model.insert(it, i);
+         break;
+      }
+      case 4:
+      {
+         list->PopFront(list);
+         model.pop_front();
+         break;
+      }
+
+      default:
+         list->PopBack(list);
+         model.pop_back();
+         break;
+      }
+   }
+
+   InExpectEqual(list, model);
+}
+
+
+TEST_F(CUnrolledListEmpty, RemoveAndClear)
+{
+   /*** Arrange ***/
+   std::mt19937 generator(25);
+   std::list<size_t> model;
+   for (size_t i = 0; i < 3000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      model.push_back(i);
+   }
+
+   /*** Act && Assert ***/
+   EXPECT_TRUE(SC_ERROR(list->Remove(list, NULL)));
+   EXPECT_TRUE(SC_ERROR(list->Remove(NULL, list->Front(list))));
+
+   // Removal empties and merges blocks in the middle of the list
+   while (model.size() > 10)
+   {
+      size_t index = generator() % model.size();
+      CLIST_NODE* position = list->Front(list);
+      for (size_t j = 0; j < index; ++j) { position = list->Next(list, position); }
+
+      ASSERT_FALSE(SC_ERROR(list->Remove(list, position)));
+      model.erase(std::next(model.begin(), index));
+   }
+   InExpectEqual(list, model);
+
+   EXPECT_TRUE(SC_ERROR(list->Clear(NULL)));
+   ASSERT_FALSE(SC_ERROR(list->Clear(list)));
+   model.clear();
+   InExpectEqual(list, model);
+
+   size_t data = 25;
+   ASSERT_FALSE(SC_ERROR(list->PushFront(list, &data, sizeof(size_t))));
+   model.push_front(data);
+   InExpectEqual(list, model);
+   CUnrolledListDelete(NULL);
+}
+
+
+TEST_F(CUnrolledListEmpty, GetCopyData)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   for (size_t i = 0; i < 25; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+   }
+
+   /*** Act && Assert ***/
+   status = list->GetCopyData(NULL, NULL, NULL, NULL);
+   EXPECT_TRUE(SC_ERROR(status));
+
+   size_t expected = 0;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      size_t* data = NULL;
+      size_t dataSize = 0;
+      status = list->GetCopyData(list, position, (void**)&data, &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      EXPECT_TRUE(expected++ == *data);
+      EXPECT_TRUE(sizeof(size_t) == dataSize);
+      free(data);
+   }
+}
+
+
+TEST_F(CUnrolledListEmpty, Take)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   std::list<size_t> model;
+
+   /*** Act ***/
+   for (size_t i = 0; i < 500; ++i)
+   {
+      size_t* buffer = (size_t*)malloc(sizeof(size_t));
+      ASSERT_FALSE(NULL == buffer);
+      *buffer = i;
+      status = (i % 2) ? list->PushBackTake(list, buffer, sizeof(size_t)) :
+                         list->PushFrontTake(list, buffer, sizeof(size_t));
+      ASSERT_FALSE(SC_ERROR(status));
+      (i % 2) ? model.push_back(i) : model.push_front(i);
+   }
+
+   /*** Assert ***/
+   InExpectEqual(list, model);
+
+   size_t buffer = 0;
+   size_t dataSize = 0;
+   status = list->GetCopyDataInto(list, list->Back(list), &buffer, 1,
+                                  &dataSize);
+   EXPECT_TRUE(SC_BUFFER_TOO_SMALL == SC_CODE(status));
+   EXPECT_TRUE(sizeof(size_t) == dataSize);
+   status = list->GetCopyDataInto(list, list->Back(list), &buffer,
+                                  sizeof(buffer), &dataSize);
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(model.back() == buffer);
+
+   while (!model.empty())
+   {
+      void* data = NULL;
+      status = list->PopBackTake(list, &data, &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      EXPECT_TRUE(model.back() == *(size_t*)data);
+      model.pop_back();
+      free(data);
+
+      if (model.empty()) { break; }
+
+      status = list->PopFrontTake(list, &data, &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      EXPECT_TRUE(model.front() == *(size_t*)data);
+      model.pop_front();
+      free(data);
+   }
+
+   void* data = NULL;
+   status = list->PopFrontTake(list, &data, &dataSize);
+   EXPECT_TRUE(SC_UNSUCCESSFUL == SC_CODE(status));
+   EXPECT_TRUE(0 == list->Size(list));
+}
+
+
+TEST_F(CUnrolledListEmpty, SmallAndBigData)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   char big[64];
+   for (size_t i = 0; i < 200; ++i)
+   {
+      // Inserts at the front shift the slots with small data in them
+      memset(big, (int)i, sizeof(big));
+      status = (i % 2) ? list->PushFront(list, big, sizeof(big)) :
+                         list->PushFront(list, &i, sizeof(size_t));
+      ASSERT_FALSE(SC_ERROR(status));
+   }
+
+   /*** Act && Assert ***/
+   size_t i = 200;
+   for (CLIST_NODE* position = list->Front(list);
+        position != NULL;
+        position = list->Next(list, position))
+   {
+      --i;
+      char buffer[64] = { 0 };
+      size_t dataSize = 0;
+      status = list->GetCopyDataInto(list, position, buffer, sizeof(buffer), &dataSize);
+      ASSERT_FALSE(SC_ERROR(status));
+      if (i % 2)
+      {
+         memset(big, (int)i, sizeof(big));
+         EXPECT_TRUE(sizeof(big) == dataSize);
+         EXPECT_TRUE(0 == memcmp(big, buffer, sizeof(big)));
+      }
+      else
+      {
+         EXPECT_TRUE(sizeof(size_t) == dataSize);
+         EXPECT_TRUE(i == *(size_t*)buffer);
+      }
+   }
+
+   // The link to small data points to a buffer that can be replaced
+   void** data = NULL;
+   size_t* dataSize = NULL;
+   ASSERT_FALSE(SC_ERROR(list->GetRefToData(list, list->Back(list), &data, &dataSize)));
+   EXPECT_TRUE(0 == **((size_t**)data));
+   free(*data);
+   *data = malloc(sizeof(big));
+   ASSERT_FALSE(NULL == *data);
+   memset(*data, 0x5A, sizeof(big));
+   *dataSize = sizeof(big);
+
+   void* taken = NULL;
+   size_t takenSize = 0;
+   ASSERT_FALSE(SC_ERROR(list->PopBackTake(list, &taken, &takenSize)));
+   EXPECT_TRUE(sizeof(big) == takenSize);
+   EXPECT_TRUE(0x5A == *(unsigned char*)taken);
+   free(taken);
+
+   // Small data is copied into a buffer for the caller
+   ASSERT_FALSE(SC_ERROR(list->PopBackTake(list, &taken, &takenSize)));
+   EXPECT_TRUE(sizeof(big) == takenSize);
+   free(taken);
+   ASSERT_FALSE(SC_ERROR(list->PopBackTake(list, &taken, &takenSize)));
+   EXPECT_TRUE(sizeof(size_t) == takenSize);
+   EXPECT_TRUE(2 == *(size_t*)taken);
+   free(taken);
+}
+
+
+TEST_F(CUnrolledListEmpty, Batch)
+{
+   /*** Arrange ***/
+   STATUS_CODE status = SC_SUCCESS;
+   std::list<size_t> model;
+   size_t records[2][1000];
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      records[0][i] = i;
+      records[1][i] = 0;
+   }
+
+   /*** Act ***/
+   // Every other element of the first half, stored with a stride
+   status = list->PushBackBatch(list, &records[0][0], sizeof(size_t),
+                                2 * sizeof(size_t), 250);
+   ASSERT_FALSE(SC_ERROR(status));
+   for (size_t i = 0; i < 500; i += 2) { model.push_back(i); }
+
+   status = list->PushFrontBatch(list, &records[0][500], sizeof(size_t),
+                                 sizeof(size_t), 200);
+   ASSERT_FALSE(SC_ERROR(status));
+   model.insert(model.begin(), &records[0][500], &records[0][700]);
+
+   CLIST_NODE* position = list->Front(list);
+   for (size_t i = 0; i < 150; ++i) { position = list->Next(list, position); }
+   status = list->InsertAfterBatch(list, position, &records[0][700],
+                                   sizeof(size_t), sizeof(size_t), 300);
+   ASSERT_FALSE(SC_ERROR(status));
+   model.insert(std::next(model.begin(), 151), &records[0][700], &records[0][1000]);
+
+   /*** Assert ***/
+   InExpectEqual(list, model);
+
+   status = list->InsertAfterBatch(list, position, &records[0][0], 0,
+                                   sizeof(size_t), 1);
+   EXPECT_TRUE(SC_ERROR(status));
+}
+
+
+TEST_F(CUnrolledListEmpty, SplitAfterAndAppend)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushBack(list, &i, sizeof(size_t))));
+      model.push_back(i);
+   }
+
+   CLIST_NODE* position = list->Front(list);
+   for (size_t i = 0; i < 300; ++i) { position = list->Next(list, position); }
+   CLIST_NODE* last = list->Back(list);
+
+   /*** Act ***/
+   CLIST* tail = list->SplitAfter(list, position);
+   ASSERT_FALSE(NULL == tail);
+
+   /*** Assert ***/
+   std::list<size_t> tailModel;
+   tailModel.splice(tailModel.begin(), model, std::next(model.begin(), 301), model.end());
+   InExpectEqual(list, model);
+   InExpectEqual(tail, tailModel);
+   EXPECT_TRUE(last == tail->Back(tail));
+
+   CLIST* empty = tail->SplitAfter(tail, tail->Back(tail));
+   ASSERT_FALSE(NULL == empty);
+   EXPECT_TRUE(0 == empty->Size(empty));
+
+   EXPECT_TRUE(SC_ERROR(list->Append(list, list)));
+   ASSERT_FALSE(SC_ERROR(list->Append(list, empty)));
+   ASSERT_FALSE(SC_ERROR(list->Append(list, tail)));
+   model.splice(model.end(), tailModel);
+   InExpectEqual(list, model);
+   InExpectEqual(tail, tailModel);
+   EXPECT_TRUE(last == list->Back(list));
+
+   CUnrolledListDelete(empty);
+   CUnrolledListDelete(tail);
+}
+
+
+TEST_F(CUnrolledListEmpty, Sort)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+   std::mt19937 random(25);
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      size_t value = random() % 100;
+      ASSERT_FALSE(SC_ERROR(list->PushFront(list, &value, sizeof(size_t))));
+      model.push_front(value);
+   }
+
+   auto compare = [](void* Left, size_t, void* Right, size_t, void*) -> int
+   {
+      size_t left = *(size_t*)Left;
+      size_t right = *(size_t*)Right;
+      return (left < right) ? -1 : (left > right) ? 1 : 0;
+   };
+
+   /*** Act ***/
+   STATUS_CODE status = list->Sort(list, compare, NULL);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   model.sort();
+   InExpectEqual(list, model);
+   EXPECT_TRUE(SC_ERROR(list->Sort(list, NULL, NULL)));
+}
+
+
+TEST_F(CUnrolledListEmpty, ForEach)
+{
+   /*** Arrange ***/
+   // Big data lives in buffers, the rest in the slots, over many blocks
+   std::list<size_t> model;
+   size_t big[4] = {0};
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      big[0] = i;
+      ASSERT_FALSE(SC_ERROR((i % 3 == 0) ?
+                            list->PushBack(list, big, sizeof(big)) :
+                            list->PushBack(list, &i, sizeof(size_t))));
+      model.push_back(i);
+   }
+
+   auto visitor = [](void* Data, size_t DataSize, void* Context)
+   {
+      std::list<size_t>& visited = *(std::list<size_t>*)Context;
+      EXPECT_TRUE(((visited.size() % 3 == 0) ? 4 * sizeof(size_t) : sizeof(size_t)) == DataSize);
+      visited.push_back(*(size_t*)Data);
+   };
+   std::list<size_t> visited;
+
+   /*** Act ***/
+   STATUS_CODE status = list->ForEach(list, visitor, &visited);
+
+   /*** Assert ***/
+   ASSERT_FALSE(SC_ERROR(status));
+   EXPECT_TRUE(model == visited);
+   EXPECT_TRUE(SC_ERROR(list->ForEach(list, NULL, NULL)));
+}
+
+
+TEST_F(CUnrolledListEmpty, NextBatch)
+{
+   /*** Arrange ***/
+   std::list<size_t> model;
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      ASSERT_FALSE(SC_ERROR(list->PushFront(list, &i, sizeof(size_t))));
+      model.push_front(i);
+   }
+
+   CLIST_ITEM items[7];
+   size_t count = 0;
+   std::list<size_t> read;
+
+   /*** Act ***/
+   // An odd capacity makes batches cross the block boundaries
+   CLIST_NODE* position = list->Front(list);
+   do
+   {
+      ASSERT_FALSE(SC_ERROR(list->NextBatch(list, &position, items, 7, &count)));
+      for (size_t i = 0; i < count; ++i)
+      {
+         EXPECT_TRUE(sizeof(size_t) == items[i].DataSize);
+         read.push_back(*(size_t*)items[i].Data);
+      }
+   } while (count != 0);
+
+   /*** Assert ***/
+   EXPECT_TRUE(NULL == position);
+   EXPECT_TRUE(model == read);
+
+   position = list->Back(list);
+   ASSERT_FALSE(SC_ERROR(list->NextBatch(list, &position, items, 7, &count)));
+   EXPECT_TRUE(1 == count);
+   EXPECT_TRUE(NULL == position);
+
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(list, NULL, items, 7, &count)));
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(list, &position, NULL, 7, &count)));
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(list, &position, items, 0, &count)));
+   EXPECT_TRUE(SC_ERROR(list->NextBatch(list, &position, items, 7, NULL)));
+}
+
+
+int main(int argc, char** argv)
+{
+   ::testing::InitGoogleTest(&argc, argv);
+
+   return RUN_ALL_TESTS();
+}
@@ -63,6 +63,7 @@ typedef uint32_t STATUS_CODE;
 #define SC_INVALID_PARAMETER (SC_ERROR_BIT | 0x00010000)
 #define SC_NOT_ENOUGH_MEMORY (SC_ERROR_BIT | 0x00020000)
 #define SC_UNSUCCESSFUL      (SC_ERROR_BIT | 0x00030000)
+#define SC_BUFFER_TOO_SMALL  (SC_ERROR_BIT | 0x00040000)
 
 
 /** Sets the return status to the desired state(StatusCode). */
@@ -72,6 +73,9 @@ typedef uint32_t STATUS_CODE;
 /** Returns true if the status code(StatusCode) is an error. */
 #define SC_ERROR(StatusCode) ((int32_t)StatusCode < 0)
 
+/** Returns the status code(StatusCode) without the line number. */
+#define SC_CODE(StatusCode) ((StatusCode) & 0xFFFF0000U)
+
 
 ///////////////////////////////////////////////////////////
 ///                 Encapsulation in C                  ///
@@ -115,4 +119,51 @@ typedef uint64_t STRUCT_ID;
    if (this->StructureId != ClassName ## _STRUCT_ID)            \
    { SET_SC(SC_INVALID_PARAMETER); break; }
 
+
+///////////////////////////////////////////////////////////
+///                  Memory allocation                  ///
+///////////////////////////////////////////////////////////
+
+/** Memory allocator protocol. */
+typedef struct ALLOCATOR ALLOCATOR;
+
+
+/**
+ * Allocates Size bytes of memory aligned for any fundamental type.
+ *
+ * @param[in]  This  Pointer to Allocator protocol
+ * @param[in]  Size  Number of bytes to allocate
+ *
+ * @retval  void*  Pointer to the allocated memory
+ * @retval  NULL   If This is invalid or memory can't be allocated
+ */
+typedef
+void*
+(*ALLOCATOR_ALLOC)(
+   IN ALLOCATOR* This,
+   IN size_t     Size);
+
+
+/**
+ * Releases memory previously returned by Alloc of the same allocator.
+ *
+ * @param[in]  This    Pointer to Allocator protocol
+ * @param[in]  Memory  Memory to release. NULL is ignored.
+ * @param[in]  Size    Size passed to Alloc when the memory was allocated
+ */
+typedef
+void
+(*ALLOCATOR_FREE)(
+   IN ALLOCATOR* This,
+   IN void*      Memory,
+   IN size_t     Size);
+
+
+/** Memory allocator protocol. */
+typedef struct ALLOCATOR
+{
+   ALLOCATOR_ALLOC Alloc; /** Allocates memory */
+   ALLOCATOR_FREE  Free;  /** Releases memory  */
+} ALLOCATOR;
+
 #endif // __MISC_H__
\ No newline at end of file